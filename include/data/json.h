@@ -711,6 +711,265 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+#ifdef CONFIG_JSON_STREAMING
+
+/** @cond INTERNAL_HIDDEN */
+
+/* Object or array being decoded by a streaming parser */
+struct json_parser_frame {
+	/* Fields of an object, element of an array, NULL if skipped */
+	const struct json_obj_descr *descr;
+
+	/* Object being decoded, or next array element */
+	void *val;
+
+	union {
+		struct {
+			size_t descr_len;
+			uint32_t decoded;
+			int field;
+		} obj;
+		struct {
+			void *parent;
+			void *last;
+			size_t elem_size;
+		} arr;
+	};
+
+	bool is_array;
+};
+
+/** @endcond */
+
+/**
+ * @brief Streaming JSON parser
+ *
+ * State of an object being decoded by json_parser_feed().  All fields
+ * are private.
+ */
+struct json_parser {
+	/** @cond INTERNAL_HIDDEN */
+	struct json_parser_frame stack[CONFIG_JSON_STREAMING_MAX_DEPTH];
+	const struct json_obj_descr *descr;
+	void *field;
+	char *str_buf;
+	size_t str_buf_size;
+	size_t str_used;
+	size_t str_start;
+	const char *literal;
+	size_t tok_len;
+	uint32_t key_match;
+	char num[12];
+	uint8_t depth;
+	uint8_t state;
+	uint8_t lex;
+	uint8_t tok_type;
+	uint8_t escape_len;
+	bool is_key;
+	int err;
+	/** @endcond */
+};
+
+/**
+ * @brief Streaming JSON encoder
+ *
+ * State of an output being produced by the json_encoder_*() functions.
+ * All fields are private.
+ */
+struct json_encoder {
+	/** @cond INTERNAL_HIDDEN */
+	json_append_bytes_t flush;
+	void *data;
+	char *buf;
+	size_t size;
+	size_t used;
+	uint32_t in_array;
+	uint32_t has_members;
+	uint8_t depth;
+	/** @endcond */
+};
+
+/**
+ * @brief Initializes a streaming JSON parser
+ *
+ * Prepares @a parser to decode an object, received in any number of
+ * chunks passed to json_parser_feed(), with the same descriptors and
+ * the same rules as json_obj_parse().  Unlike json_obj_parse(), the
+ * input is not modified and does not have to be kept once fed: decoded
+ * strings are copied, NUL terminated, to @a str_buf.  Values of keys
+ * not in the descriptor are skipped, including nested objects and
+ * arrays.
+ *
+ * @param parser Parser to initialize
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array. Must be
+ * less than 31.
+ *
+ * @param val Pointer to the struct to hold the decoded values
+ *
+ * @param str_buf Buffer to hold the decoded strings, may be NULL if the
+ * descriptor has no string
+ *
+ * @param str_buf_size Size of @a str_buf, in bytes
+ */
+void json_parser_init(struct json_parser *parser,
+		      const struct json_obj_descr *descr, size_t descr_len,
+		      void *val, char *str_buf, size_t str_buf_size);
+
+/**
+ * @brief Feeds a chunk of JSON-encoded data to a streaming parser
+ *
+ * Decodes as much of the object as the chunk allows.  Tokens split
+ * across chunks are resumed on the next call.  Data following the end
+ * of the object is ignored.
+ *
+ * @param parser Parser initialized with json_parser_init()
+ *
+ * @param data Chunk of JSON-encoded data
+ *
+ * @param len Length of the chunk
+ *
+ * @return 0 on success, or a negative error code.  Once an error is
+ * returned, it is returned again by every call.  -ENOMEM is returned
+ * when the string buffer is full or the object nests deeper than
+ * CONFIG_JSON_STREAMING_MAX_DEPTH and -ENOSPC when an array has more
+ * elements than its descriptor allows.
+ */
+int json_parser_feed(struct json_parser *parser, const char *data,
+		     size_t len);
+
+/**
+ * @brief Finishes decoding with a streaming parser
+ *
+ * @param parser Parser fed with json_parser_feed()
+ *
+ * @return < 0 if error, or if the object is not complete, bitmap of
+ * decoded fields on success, as returned by json_obj_parse().
+ */
+int json_parser_finish(struct json_parser *parser);
+
+/**
+ * @brief Initializes a streaming JSON encoder
+ *
+ * The encoder builds its output in @a buf and passes it to @a flush
+ * each time it is full, so that values can be sent in chunks as they
+ * are produced, instead of encoding them all at once.  Objects and
+ * arrays are opened and closed explicitly, their members are encoded
+ * with descriptors.
+ *
+ * @param encoder Encoder to initialize
+ *
+ * @param buf Buffer for the output, or NULL to call @a flush for
+ * every token
+ *
+ * @param size Size of @a buf, in bytes
+ *
+ * @param flush Function called with each chunk of output
+ *
+ * @param data Data pointer to be passed to the @a flush callback
+ */
+void json_encoder_init(struct json_encoder *encoder, char *buf, size_t size,
+		       json_append_bytes_t flush, void *data);
+
+/**
+ * @brief Opens an object with a streaming encoder
+ *
+ * @param encoder Encoder
+ *
+ * @param key Key of the object inside an object, NULL otherwise
+ *
+ * @return 0 on success, -EINVAL if @a key does not match the enclosing
+ * value, -ENOMEM if objects and arrays nest deeper than
+ * CONFIG_JSON_STREAMING_MAX_DEPTH, or an error returned by the flush
+ * callback.
+ */
+int json_encoder_obj_start(struct json_encoder *encoder, const char *key);
+
+/**
+ * @brief Closes the object opened last with json_encoder_obj_start()
+ *
+ * @param encoder Encoder
+ *
+ * @return 0 on success, -EINVAL if no object is open, or an error
+ * returned by the flush callback.
+ */
+int json_encoder_obj_end(struct json_encoder *encoder);
+
+/**
+ * @brief Opens an array with a streaming encoder
+ *
+ * @param encoder Encoder
+ *
+ * @param key Key of the array inside an object, NULL otherwise
+ *
+ * @return 0 on success, or an error as json_encoder_obj_start().
+ */
+int json_encoder_arr_start(struct json_encoder *encoder, const char *key);
+
+/**
+ * @brief Closes the array opened last with json_encoder_arr_start()
+ *
+ * @param encoder Encoder
+ *
+ * @return 0 on success, -EINVAL if no array is open, or an error
+ * returned by the flush callback.
+ */
+int json_encoder_arr_end(struct json_encoder *encoder);
+
+/**
+ * @brief Encodes an object with a streaming encoder
+ *
+ * @param encoder Encoder
+ *
+ * @param key Key of the object inside an object, NULL otherwise
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array
+ *
+ * @param val Struct holding the values
+ *
+ * @return 0 on success, or an error as json_encoder_obj_start().
+ */
+int json_encoder_obj(struct json_encoder *encoder, const char *key,
+		     const struct json_obj_descr *descr, size_t descr_len,
+		     const void *val);
+
+/**
+ * @brief Encodes fields of the object opened last
+ *
+ * Adds the values described by @a descr to the object opened last with
+ * json_encoder_obj_start(), after the ones already added.
+ *
+ * @param encoder Encoder
+ *
+ * @param descr Pointer to the descriptor array
+ *
+ * @param descr_len Number of elements in the descriptor array
+ *
+ * @param val Struct holding the values
+ *
+ * @return 0 on success, -EINVAL if no object is open, or an error
+ * returned by the flush callback.
+ */
+int json_encoder_fields(struct json_encoder *encoder,
+			const struct json_obj_descr *descr, size_t descr_len,
+			const void *val);
+
+/**
+ * @brief Passes the output buffered by a streaming encoder to its flush
+ * callback
+ *
+ * @param encoder Encoder
+ *
+ * @return 0 on success, or an error returned by the flush callback.
+ */
+int json_encoder_flush(struct json_encoder *encoder);
+
+#endif /* CONFIG_JSON_STREAMING */
+
 #ifdef __cplusplus
 }
 #endif
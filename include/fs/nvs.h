@@ -43,6 +43,10 @@ extern "C" {
  * @param write_block_size Alignment size
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param lookup_cache Lookup table from ID hash to the address of the most
+ * recent allocation table entry written for any ID with that hash
+ * @param write_gen Write generation, incremented whenever an allocation table
+ * entry is written or a sector is erased
  */
 struct nvs_fs {
 	off_t offset;		/* filesystem offset in flash */
@@ -53,12 +57,50 @@ struct nvs_fs {
 				 */
 	uint16_t sector_count;	/* amount of sectors in the filesystem */
 	bool ready;		/* is the filesystem initialized ? */
+	uint32_t write_gen;	/* write and erase generation */
 
 	struct k_mutex nvs_lock;
 	const struct device *flash_device;
 	const struct flash_parameters *flash_parameters;
+#if CONFIG_NVS_LOOKUP_CACHE
+	uint32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+#endif
+};
+
+/**
+ * @brief Non-volatile Storage entry descriptor, as reported by nvs_walk()
+ *
+ * @param id Id of the entry
+ * @param len Data length of the entry, 0 for a deleted entry
+ * @param data_addr Address of the entry data. Only valid while the write_gen
+ * of the file system is unchanged.
+ */
+struct nvs_entry {
+	uint16_t id;
+	uint16_t len;
+	uint32_t data_addr;
 };
 
+/**
+ * @brief Number of 32-bit words needed for a nvs_walk() bitmap
+ *
+ * @param id_count Number of ids covered by the walk
+ */
+#define NVS_WALK_BITMAP_SIZE(id_count) ceiling_fraction(id_count, 32)
+
+/**
+ * @brief Callback called by nvs_walk() for the most recent entry of an id
+ *
+ * @param fs Pointer to file system
+ * @param entry Most recent entry written for the id
+ * @param param Parameter passed to nvs_walk()
+ *
+ * @return 0 to continue the walk, any other value stops the walk and is
+ * returned by nvs_walk().
+ */
+typedef int (*nvs_walk_cb_t)(struct nvs_fs *fs, const struct nvs_entry *entry,
+			     void *param);
+
 /**
  * @}
  */
@@ -156,6 +198,52 @@ ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len);
 ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 		  uint16_t cnt);
 
+/**
+ * @brief nvs_walk
+ *
+ * Walk once over all entries of the file system, from the most recent to the
+ * oldest, and call a callback for the most recent entry of every id in the
+ * range [first_id, first_id + id_count). Deleted entries are reported with a
+ * length of 0. Reading all entries this way is linear in the size of the file
+ * system, while reading them one by one with nvs_read() is not.
+ *
+ * The callback must not write to or delete from the file system.
+ *
+ * @param fs Pointer to file system
+ * @param first_id First id to report
+ * @param id_count Number of ids to report
+ * @param seen Bitmap of at least NVS_WALK_BITMAP_SIZE(id_count) words, used
+ * to skip entries that are not the most recent of their id. It is cleared by
+ * nvs_walk().
+ * @param cb Callback to call for every reported entry
+ * @param param Parameter passed to the callback
+ *
+ * @retval 0 Success
+ * @retval -ERRNO errno code if error
+ * @return Any other value returned by the callback to stop the walk.
+ */
+int nvs_walk(struct nvs_fs *fs, uint16_t first_id, uint16_t id_count,
+	     uint32_t *seen, nvs_walk_cb_t cb, void *param);
+
+/**
+ * @brief nvs_entry_read
+ *
+ * Read the data of an entry reported by nvs_walk(). The entry must be read
+ * before the file system is written to again.
+ *
+ * @param fs Pointer to file system
+ * @param entry Entry reported by nvs_walk()
+ * @param data Pointer to data buffer
+ * @param len Number of bytes to be read
+ *
+ * @return Number of bytes read. On success, it will be equal to the number
+ * of bytes requested to be read. When the return value is larger than the
+ * number of bytes requested to read this indicates not all bytes were read,
+ * and more data is available. On error returns -ERRNO code.
+ */
+ssize_t nvs_entry_read(struct nvs_fs *fs, const struct nvs_entry *entry,
+		       void *data, size_t len);
+
 /**
  * @brief nvs_calc_free_space
  *
@@ -4901,12 +4901,39 @@ static inline uint32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  * @{
  */
 
+#ifdef CONFIG_HEAP_CACHE
+/* Per-CPU cache of free blocks of a k_heap */
+struct z_heap_cache {
+	/* Only contended when another CPU flushes the cache */
+	struct k_spinlock lock;
+	void *blocks[CONFIG_HEAP_CACHE_CLASSES][CONFIG_HEAP_CACHE_DEPTH];
+	uint8_t count[CONFIG_HEAP_CACHE_CLASSES];
+	uint32_t hits;
+	uint32_t misses;
+};
+
+/**
+ * @brief k_heap per-CPU cache statistics
+ */
+struct k_heap_cache_stats {
+	/** Allocations served from a per-CPU cache */
+	uint32_t hits;
+	/** Cacheable allocations that had to go to the heap */
+	uint32_t misses;
+	/** Blocks currently held in the per-CPU caches */
+	uint32_t cached;
+};
+#endif
+
 /* kernel synchronized heap struct */
 
 struct k_heap {
 	struct sys_heap heap;
 	_wait_q_t wait_q;
 	struct k_spinlock lock;
+#ifdef CONFIG_HEAP_CACHE
+	struct z_heap_cache cache[CONFIG_MP_NUM_CPUS];
+#endif
 };
 
 /**
@@ -4981,6 +5008,20 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes,
  */
 void k_heap_free(struct k_heap *h, void *mem);
 
+#ifdef CONFIG_HEAP_CACHE
+/**
+ * @brief Get the per-CPU cache statistics of a k_heap
+ *
+ * The counters are summed over all CPUs.  They are read without
+ * synchronization and are only meant for diagnostics.
+ *
+ * @param h Heap to query
+ * @param stats Statistics to fill
+ */
+void k_heap_cache_stats_get(struct k_heap *h,
+			    struct k_heap_cache_stats *stats);
+#endif
+
 /* Hand-calculated minimum heap sizes needed to return a successful
  * 1-byte allocation.  See details in lib/os/heap.[ch]
  */
@@ -5627,6 +5668,54 @@ int k_thread_runtime_stats_get(k_tid_t thread,
  */
 int k_thread_runtime_stats_all_get(k_thread_runtime_stats_t *stats);
 
+/**
+ * @brief Get the runtime statistics of a CPU
+ *
+ * @param cpu CPU number.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if null pointer or invalid CPU number, otherwise 0
+ */
+int k_cpu_runtime_stats_get(int cpu, k_cpu_runtime_stats_t *stats);
+
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_STATS
+
+/**
+ * @brief Get the scheduling latency statistics of a thread
+ *
+ * The statistics hold histograms of the time, in timing cycles, from the
+ * moment the thread was made ready to run until it was switched in.
+ * Latencies are accounted separately when the thread was made ready by
+ * another thread and by an ISR.
+ *
+ * @param thread ID of thread.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if null pointers, otherwise 0
+ */
+int k_thread_sched_latency_get(k_tid_t thread,
+			       k_sched_latency_stats_t *stats);
+
+/**
+ * @brief Get the scheduling latency statistics of a priority level
+ *
+ * Latencies of all threads are also accounted to the priority they were
+ * switched in with.
+ *
+ * @param prio Thread priority.
+ * @param stats Pointer to struct to copy statistics into.
+ * @return -EINVAL if null pointer or invalid priority, otherwise 0
+ */
+int k_sched_latency_prio_get(int prio, k_sched_latency_stats_t *stats);
+
+/**
+ * @brief Reset the scheduling latency statistics
+ *
+ * Clears the statistics of all priority levels and, if
+ * CONFIG_THREAD_MONITOR is enabled, of all threads.
+ */
+void k_sched_latency_reset(void);
+
 #endif
 
 #ifdef __cplusplus
@@ -60,4 +60,23 @@ void z_priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
 void z_priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
 struct k_thread *z_priq_mq_best(struct _priq_mq *pq);
 
+/* Multi-queue with CPU affinity, used by the MULTIQ scheduler when CPU
+ * masks are enabled.  Threads pinned to a single CPU are kept in a
+ * multi-queue of their own CPU, all other threads in a shared one, so
+ * that picking the best thread for a CPU is a comparison of the heads of
+ * two bitmap queues instead of a walk of every runnable thread.  Threads
+ * in the shared queue which may run on some, but not all, CPUs still
+ * need their priority level to be walked.  Order keys preserve FIFO
+ * order between the two queues for threads of equal priority.
+ */
+struct _priq_mq_cpu {
+	struct _priq_mq shared;
+	struct _priq_mq cpu[CONFIG_MP_NUM_CPUS];
+	uint32_t next_order_key;
+};
+
+void z_priq_mq_cpu_add(struct _priq_mq_cpu *pq, struct k_thread *thread);
+void z_priq_mq_cpu_remove(struct _priq_mq_cpu *pq, struct k_thread *thread);
+struct k_thread *z_priq_mq_cpu_best(struct _priq_mq_cpu *pq);
+
 #endif /* ZEPHYR_INCLUDE_SCHED_PRIQ_H_ */
@@ -166,6 +166,9 @@ struct _thread_userspace_local_data {
 #endif
 
 #ifdef CONFIG_THREAD_RUNTIME_STATS
+/* Number of CPU usage averaging windows: 1, 10 and 60 seconds */
+#define K_THREAD_USAGE_WINDOWS 3
+
 struct k_thread_runtime_stats {
 	/* Thread execution cycles */
 #ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
@@ -173,10 +176,38 @@ struct k_thread_runtime_stats {
 #else
 	uint64_t execution_cycles;
 #endif
+
+#ifdef CONFIG_SMP
+	/* Thread execution cycles on each CPU */
+	uint64_t cpu_cycles[CONFIG_MP_NUM_CPUS];
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WINDOWS
+	/* Average usage of one CPU over the last 1, 10 and 60 seconds,
+	 * in hundredths of a percent
+	 */
+	uint16_t usage[K_THREAD_USAGE_WINDOWS];
+#endif
 };
 
 typedef struct k_thread_runtime_stats k_thread_runtime_stats_t;
 
+struct k_cpu_runtime_stats {
+	/* Cycles spent running threads other than the idle thread */
+	uint64_t execution_cycles;
+	/* Cycles spent running the idle thread */
+	uint64_t idle_cycles;
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WINDOWS
+	/* Average usage of the CPU (outside the idle thread) over the
+	 * last 1, 10 and 60 seconds, in hundredths of a percent
+	 */
+	uint16_t usage[K_THREAD_USAGE_WINDOWS];
+#endif
+};
+
+typedef struct k_cpu_runtime_stats k_cpu_runtime_stats_t;
+
 struct _thread_runtime_stats {
 	/* Timestamp when last switched in */
 #ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
@@ -186,6 +217,47 @@ struct _thread_runtime_stats {
 #endif
 
 	k_thread_runtime_stats_t stats;
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WINDOWS
+	/* Execution cycles at the last usage sample */
+	uint64_t sampled_cycles;
+	/* Usage averages, in hundredths of a percent scaled by 1024 */
+	uint32_t usage_avg[K_THREAD_USAGE_WINDOWS];
+#endif
+};
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_STATS
+/**
+ * Scheduling latency histogram. Bucket 0 counts latencies of 0 and 1
+ * cycles, bucket n latencies of [2^n, 2^(n+1)) cycles and the last bucket
+ * all longer latencies.
+ */
+struct k_sched_latency_hist {
+	/* Number of latencies in each log2 bucket */
+	uint32_t buckets[CONFIG_SCHED_LATENCY_BUCKETS];
+	/* Longest latency, in cycles */
+	uint64_t max_cycles;
+};
+
+struct k_sched_latency_stats {
+	/* Made ready by a thread until switched in */
+	struct k_sched_latency_hist wakeup;
+	/* Made ready by an ISR until switched in */
+	struct k_sched_latency_hist isr;
+};
+
+typedef struct k_sched_latency_stats k_sched_latency_stats_t;
+
+struct _thread_sched_latency {
+	/* Timestamp when made ready */
+	timing_t ready_stamp;
+	/* Made ready and waiting for the CPU, ready_stamp is valid */
+	bool readied;
+	/* Made ready from an ISR */
+	bool ready_from_isr;
+
+	k_sched_latency_stats_t stats;
 };
 #endif
 
@@ -283,6 +355,11 @@ struct k_thread {
 	struct _thread_runtime_stats rt_stats;
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_STATS
+	/** Scheduling latency statistics */
+	struct _thread_sched_latency sched_latency;
+#endif
+
 #ifdef CONFIG_DEMAND_PAGING_THREAD_STATS
 	/** Paging statistics */
 	struct k_mem_paging_stats_t paging_stats;
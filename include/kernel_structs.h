@@ -94,6 +94,8 @@ struct _ready_q {
 	sys_dlist_t runq;
 #elif defined(CONFIG_SCHED_SCALABLE)
 	struct _priq_rb runq;
+#elif defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_CPU_MASK)
+	struct _priq_mq_cpu runq;
 #elif defined(CONFIG_SCHED_MULTIQ)
 	struct _priq_mq runq;
 #endif
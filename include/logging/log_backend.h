@@ -32,6 +32,8 @@ struct log_backend;
 struct log_backend_api {
 	void (*process)(const struct log_backend *const backend,
 			union log_msg2_generic *msg);
+	void (*process_batch)(const struct log_backend *const backend,
+			      union log_msg2_generic **msgs, uint32_t cnt);
 
 	void (*put)(const struct log_backend *const backend,
 		    struct log_msg *msg);
@@ -118,6 +120,36 @@ static inline void log_backend_msg2_process(
 	backend->api->process(backend, msg);
 }
 
+/**
+ * @brief Process a batch of log messages.
+ *
+ * Used when CONFIG_LOG_PROCESS_BATCH_SIZE is larger than 1. Messages are in
+ * the order they were logged and already filtered for the backend. If the
+ * backend does not implement batch processing, messages are processed one
+ * by one.
+ *
+ * @param[in] backend  Pointer to the backend instance.
+ * @param[in] msgs     Array of messages.
+ * @param[in] cnt      Number of messages in the array.
+ */
+static inline void log_backend_msg2_process_batch(
+					const struct log_backend *const backend,
+					union log_msg2_generic **msgs,
+					uint32_t cnt)
+{
+	__ASSERT_NO_MSG(backend != NULL);
+	__ASSERT_NO_MSG(msgs != NULL);
+
+	if (backend->api->process_batch) {
+		backend->api->process_batch(backend, msgs, cnt);
+		return;
+	}
+
+	for (uint32_t i = 0; i < cnt; i++) {
+		backend->api->process(backend, msgs[i]);
+	}
+}
+
 
 /**
  * @brief Synchronously process log message.
@@ -95,6 +95,29 @@ __syscall bool log_process(bool bypass);
  */
 __syscall uint32_t log_buffered_cnt(void);
 
+/** @brief Statistics of batch log processing. */
+struct log_process_batch_stats {
+	/** Number of processed batches. */
+	uint32_t batch_cnt;
+
+	/** Number of messages processed in batches. */
+	uint32_t msg_cnt;
+
+	/** Number of messages in the largest batch. */
+	uint32_t max_size;
+};
+
+/** @brief Get statistics of batch log processing.
+ *
+ * Statistics are collected only if CONFIG_LOG_PROCESS_BATCH_SIZE is larger
+ * than 1, otherwise all fields are zero.
+ *
+ * @param[out] stats Statistics.
+ * @param reset If true, statistics are cleared after reading.
+ */
+void log_process_batch_stats_get(struct log_process_batch_stats *stats,
+				 bool reset);
+
 /** @brief Get number of independent logger sources (modules and instances)
  *
  * @param domain_id Domain ID.
@@ -70,6 +70,10 @@ struct log_output_control_block {
 	atomic_t offset;
 	void *ctx;
 	const char *hostname;
+#if defined(CONFIG_LOG_DICTIONARY_COMPACT)
+	log_timestamp_t timestamp;
+	uint32_t sync_cnt;
+#endif
 };
 
 /** @brief Log_output instance structure. */
@@ -47,6 +47,38 @@ struct log_dict_output_dropped_msg_t {
 	uint16_t num_dropped_messages;
 } __packed;
 
+/**
+ * Compact encoding (CONFIG_LOG_DICTIONARY_COMPACT).
+ *
+ * Each message starts with one header byte. For a normal message it holds
+ * the level (bits 0-2), the domain ID (bits 3-5) and a flag (bit 6) set
+ * when the message carries hexdump data. The header byte of a message
+ * about dropped messages is LOG_DICT_COMPACT_DROPPED, followed by the
+ * number of dropped messages.
+ *
+ * A normal message continues with the source ID, the difference to the
+ * timestamp of the previous message, the two bytes of the package header
+ * holding the argument list length in words and the number of appended
+ * strings, each 32-bit word of the argument list after the header, the
+ * length of the appended strings followed by the strings themselves and,
+ * if flagged, the length of the hexdump data followed by the data. IDs,
+ * words, lengths and timestamps are encoded as unsigned LEB128.
+ *
+ * A sync record starts with LOG_DICT_COMPACT_SYNC and the two bytes of
+ * LOG_DICT_COMPACT_SYNC_MAGIC, followed by the absolute timestamp the
+ * timestamp difference of the next message refers to. It is sent before
+ * the first message, every CONFIG_LOG_DICTIONARY_COMPACT_SYNC_INTERVAL
+ * messages and after dropped messages, so that a host that lost part of
+ * the data can find the start of a message and the timestamp again.
+ */
+#define LOG_DICT_COMPACT_LEVEL_MASK	0x07
+#define LOG_DICT_COMPACT_DOMAIN_SHIFT	3
+#define LOG_DICT_COMPACT_DOMAIN_MASK	0x38
+#define LOG_DICT_COMPACT_DATA		BIT(6)
+#define LOG_DICT_COMPACT_DROPPED	BIT(7)
+#define LOG_DICT_COMPACT_SYNC		(BIT(7) | 1)
+#define LOG_DICT_COMPACT_SYNC_MAGIC	0x5AA5
+
 /** @brief Process log messages v2 for dictionary-basde logging.
  *
  * Function is using provided context with the buffer and output function to
@@ -211,6 +211,30 @@ struct coap_resource {
 	int age;
 };
 
+/**
+ * @brief Node of a resource trie, see coap_resource_trie_init().
+ */
+struct coap_resource_trie_node {
+	const char *segment; /* Path segment leading to the node */
+	uint16_t len; /* Length of the segment */
+	uint16_t children; /* Index of the first child node */
+	uint16_t num_children; /* Number of child nodes, sorted by segment */
+	uint16_t resource; /* 1 + index of the resource of the node, or 0 */
+#if defined(CONFIG_COAP_URI_WILDCARD)
+	uint16_t subtree; /* Lowest resource of the node and its children */
+#endif
+};
+
+/**
+ * @brief Trie of the paths of a resource table.
+ */
+struct coap_resource_trie {
+	sys_snode_t node;
+	struct coap_resource *resources;
+	struct coap_resource_trie_node *nodes;
+	uint16_t max_nodes;
+};
+
 /**
  * @brief Represents a remote device that is observing a local resource.
  */
@@ -221,6 +245,15 @@ struct coap_observer {
 	uint8_t tkl;
 };
 
+/**
+ * @brief Location of an option in the data of a CoAP packet.
+ */
+struct coap_option_ref {
+	uint16_t code; /* Option number */
+	uint16_t offset; /* Offset of the option value in the packet data */
+	uint16_t len; /* Length of the option value */
+};
+
 /**
  * @brief Representation of a CoAP Packet.
  */
@@ -231,6 +264,12 @@ struct coap_packet {
 	uint8_t hdr_len; /* CoAP header length */
 	uint16_t opt_len; /* Total options length (delta + len + value) */
 	uint16_t delta; /* Used for delta calculation in CoAP packet */
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Options of the packet, in order, if opt_indexed is set */
+	struct coap_option_ref opt_index[CONFIG_COAP_OPTION_INDEX_SIZE];
+	uint8_t opt_count; /* Number of options in opt_index */
+	bool opt_indexed; /* False if the options did not fit in opt_index */
+#endif
 #if defined(CONFIG_COAP_KEEP_USER_DATA)
 	void *user_data; /* Application specific user data */
 #endif
@@ -355,6 +394,11 @@ const uint8_t *coap_packet_get_payload(const struct coap_packet *cpkt,
  * @param options Parse options and cache its details.
  * @param opt_num Number of options
  *
+ * With CONFIG_COAP_OPTION_INDEX, the location of the options in @a data
+ * is also recorded in @a cpkt, so that coap_find_options() and
+ * coap_handle_request() do not have to walk them again.  @a options may
+ * then be NULL if the option values are not needed.
+ *
  * @return 0 in case of success or negative in case of error.
  */
 int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
@@ -501,7 +545,8 @@ int coap_packet_append_payload(struct coap_packet *cpkt, const uint8_t *payload,
  *
  * @param cpkt Packet received
  * @param resources Array of known resources
- * @param options Parsed options from coap_packet_parse()
+ * @param options Parsed options from coap_packet_parse(), only used if
+ * the options of @a cpkt are not indexed, see CONFIG_COAP_OPTION_INDEX
  * @param opt_num Number of options
  * @param addr Peer address
  * @param addr_len Peer address length
@@ -514,6 +559,47 @@ int coap_handle_request(struct coap_packet *cpkt,
 			uint8_t opt_num,
 			struct sockaddr *addr, socklen_t addr_len);
 
+/**
+ * @brief Build a trie to find the resources of a table.
+ *
+ * Once built, coap_handle_request() finds the resource matching a
+ * request for @a resources by walking the trie, in a time depending on
+ * the depth of the request path rather than on the number of resources.
+ * The resource found is the same as without the trie: the first one of
+ * @a resources matching the request.
+ *
+ * The trie is registered until coap_resource_trie_deinit() is called,
+ * so @a trie, @a resources and @a nodes must stay valid until then. The
+ * trie must be built again when the paths of @a resources change, and
+ * must not be built or removed while requests for @a resources are
+ * handled. Requires CONFIG_COAP_RESOURCE_TRIE.
+ *
+ * @param trie Trie to build
+ * @param resources Array of resources, as passed to coap_handle_request()
+ * @param nodes Storage for the nodes of the trie
+ * @param max_nodes Number of elements of @a nodes, one more than the
+ * number of path segments of all @a resources is always enough
+ *
+ * @return 0 in case of success, -ENOMEM if @a nodes is too small, or
+ * negative in case of other error.
+ */
+int coap_resource_trie_init(struct coap_resource_trie *trie,
+			    struct coap_resource *resources,
+			    struct coap_resource_trie_node *nodes,
+			    uint16_t max_nodes);
+
+/**
+ * @brief Remove a trie built with coap_resource_trie_init().
+ *
+ * coap_handle_request() then finds the resources of the table by
+ * comparing the request path with each of them, and the memory of the
+ * trie can be reused. Removing a trie which is not registered has no
+ * effect.
+ *
+ * @param trie Trie to remove
+ */
+void coap_resource_trie_deinit(struct coap_resource_trie *trie);
+
 /**
  * Represents the size of each block that will be transferred using
  * block-wise transfers [RFC7959]:
@@ -653,6 +739,153 @@ int coap_update_from_block(const struct coap_packet *cpkt,
 size_t coap_next_block(const struct coap_packet *cpkt,
 		       struct coap_block_context *ctx);
 
+#if defined(CONFIG_COAP_BLOCK_DOWNLOAD)
+struct coap_block_download;
+
+/**
+ * @typedef coap_block_download_request_t
+ * @brief Type of the callback sending the request for a block of a
+ * download.
+ *
+ * The callback builds a request for the resource, appends the Block2
+ * option described by @a block with coap_append_block2_option() and
+ * sends it.
+ *
+ * @param dl Download the request is part of
+ * @param block Block context of the requested block, @a block->current
+ * being the offset of the block
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+typedef int (*coap_block_download_request_t)(struct coap_block_download *dl,
+					     struct coap_block_context *block);
+
+/**
+ * @typedef coap_block_download_sink_t
+ * @brief Type of the callback receiving the data of a download.
+ *
+ * The data is received in order, the total size of the resource,
+ * if known, being in @a dl->ctx.total_size.
+ *
+ * @param dl Download the data is part of
+ * @param data Data received
+ * @param len Length of @a data
+ * @param offset Offset of @a data in the resource
+ * @param last True if @a data is the end of the resource
+ *
+ * @return 0 in case of success or negative to abort the download.
+ */
+typedef int (*coap_block_download_sink_t)(struct coap_block_download *dl,
+					  const uint8_t *data, uint16_t len,
+					  size_t offset, bool last);
+
+/**
+ * @brief State of a block-wise download, see coap_block_download_init().
+ */
+struct coap_block_download {
+	/** Block context of the data delivered so far */
+	struct coap_block_context ctx;
+	coap_block_download_request_t request;
+	coap_block_download_sink_t sink;
+	/** Free for the application */
+	void *user_data;
+	uint8_t *buf;
+	uint32_t next_deliver; /* Number of the next block to deliver */
+	uint32_t next_request; /* Number of the next block to request */
+	uint32_t last; /* Number of the last block, UINT32_MAX if unknown */
+	uint32_t buffered; /* Blocks stored in buf, by slot */
+	uint16_t buf_len[CONFIG_COAP_BLOCK_DOWNLOAD_MAX_WINDOW];
+	uint8_t retries[CONFIG_COAP_BLOCK_DOWNLOAD_MAX_WINDOW];
+	uint8_t window;
+	bool negotiated; /* Block size set by the first response */
+};
+
+/**
+ * @brief Initializes a block-wise download of a resource.
+ *
+ * The download requests up to @a window blocks of the resource at a
+ * time with Block2 options, each block being requested by its number
+ * (RFC 7959). The blocks received out of order are stored in @a buf
+ * until the blocks before them are received, and the data is delivered
+ * in order to @a sink. More than one block is only requested once the
+ * size of the resource is known from the Size2 option of the first
+ * response, so that no block past the end of the resource is requested.
+ *
+ * Requires CONFIG_COAP_BLOCK_DOWNLOAD.
+ *
+ * @param dl Download to initialize
+ * @param request Callback sending the request for a block
+ * @param sink Callback receiving the data
+ * @param block_size Size of the blocks to request, the server may
+ * choose a smaller one in the first response
+ * @param window Maximum number of blocks requested at a time
+ * @param buf Storage for the blocks received out of order, of
+ * @a window - 1 blocks of @a block_size, may be NULL if @a window is 1
+ * @param buf_len Size of @a buf
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_block_download_init(struct coap_block_download *dl,
+			     coap_block_download_request_t request,
+			     coap_block_download_sink_t sink,
+			     enum coap_block_size block_size, uint8_t window,
+			     uint8_t *buf, size_t buf_len);
+
+/**
+ * @brief Starts a block-wise download by requesting its first block.
+ *
+ * @param dl Download to start
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_block_download_start(struct coap_block_download *dl);
+
+/**
+ * @brief Handles a response to a request of a block-wise download.
+ *
+ * The data of @a response and of the blocks stored after it is
+ * delivered if it is the next one expected, and further blocks are
+ * requested. Duplicate responses are ignored. A response without Block2
+ * option is taken as the whole resource.
+ *
+ * @param dl Download the response is for
+ * @param response Successful response to one of the requests of @a dl
+ *
+ * @return 0 if more blocks are expected, 1 once the whole resource has
+ * been delivered, -EBADMSG if the Block2 option of @a response is
+ * invalid, or negative error returned by the callbacks.
+ */
+int coap_block_download_response(struct coap_block_download *dl,
+				 const struct coap_packet *response);
+
+/**
+ * @brief Requests again a block for which no response has been received.
+ *
+ * To be called when a request of a block-wise download is given up by
+ * the transport. Each block is requested at most
+ * CONFIG_COAP_BLOCK_DOWNLOAD_MAX_RETRIES more times.
+ *
+ * @param dl Download the request is part of
+ * @param request Request given up
+ *
+ * @return 0 in case of success or if the block has been received since,
+ * -ETIMEDOUT if the block has been requested too many times, or
+ * negative in case of other error.
+ */
+int coap_block_download_timeout(struct coap_block_download *dl,
+				const struct coap_packet *request);
+
+/**
+ * @brief Requests again all the blocks for which no response has been
+ * received, e.g. after the transport has been reset.
+ *
+ * @param dl Download to resume
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_block_download_resend(struct coap_block_download *dl);
+#endif /* CONFIG_COAP_BLOCK_DOWNLOAD */
+
 /**
  * @brief Indicates that the remote device referenced by @a addr, with
  * @a request, wants to observe a resource.
@@ -163,6 +163,34 @@ enum dns_resolve_context_state {
 	DNS_RESOLVE_CONTEXT_INACTIVE,
 };
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE) || defined(__DOXYGEN__)
+/**
+ * Cached result of a DNS query. Entry is unused if query[0] is 0.
+ */
+struct dns_cache_entry {
+	/** Name that was queried */
+	char query[CONFIG_DNS_RESOLVER_CACHE_NAME_LEN + 1];
+
+	/** Query type */
+	enum dns_query_type query_type;
+
+	/** Uptime (in ms) when this entry expires */
+	int64_t expiry;
+
+	/** Smallest TTL (in seconds) of the received answers */
+	uint32_t ttl;
+
+	/** Number of addresses in info. Zero for a negative answer. */
+	uint8_t count;
+
+	/** Set when the query has finished and the entry can be used */
+	bool complete;
+
+	/** Cached addresses */
+	struct dns_addrinfo info[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+};
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /**
  * DNS resolve context structure.
  */
@@ -240,8 +268,20 @@ struct dns_resolve_context {
 		 * cannot be used to find correct pending query.
 		 */
 		uint16_t query_hash;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE) || defined(__DOXYGEN__)
+		/** Cache entry receiving the answers, NULL if they are not
+		 * cached.
+		 */
+		struct dns_cache_entry *cache_entry;
+#endif
 	} queries[CONFIG_DNS_NUM_CONCUR_QUERIES];
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE) || defined(__DOXYGEN__)
+	/** Answer cache. Accessed only when the lock is held. */
+	struct dns_cache_entry cache[CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES];
+#endif
+
 	/** Is this context in use */
 	enum dns_resolve_context_state state;
 };
@@ -352,6 +392,9 @@ int dns_resolve_cancel_with_name(struct dns_resolve_context *ctx,
  * We might send the query to multiple servers (if there are more than one
  * server configured), but we only use the result of the first received
  * response.
+ * If CONFIG_DNS_RESOLVER_CACHE is enabled and a valid answer for the query
+ * is found in the cache, the callback is called before this function
+ * returns and dns_id is set to 0.
  *
  * @param ctx DNS context
  * @param query What the caller wants to resolve.
@@ -377,6 +420,49 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 		     void *user_data,
 		     int32_t timeout);
 
+struct dns_cache_entry;
+
+/**
+ * @typedef dns_resolve_cache_cb_t
+ * @brief Callback used when iterating over the DNS answer cache.
+ *
+ * @param entry Cached entry. A negative answer has entry->count set to 0.
+ * @param remaining Time in ms until the entry expires.
+ * @param user_data User data given to dns_resolve_cache_foreach().
+ */
+typedef void (*dns_resolve_cache_cb_t)(const struct dns_cache_entry *entry,
+				       int32_t remaining,
+				       void *user_data);
+
+/**
+ * @brief Go through all valid entries of the DNS answer cache.
+ *
+ * @details Expired entries and entries of queries that are still
+ * running are skipped. The context lock is held while the callback is
+ * called so the callback must not call DNS resolver functions.
+ * This is only available if CONFIG_DNS_RESOLVER_CACHE is enabled.
+ *
+ * @param ctx DNS context
+ * @param cb Callback to call for each cached entry.
+ * @param user_data User data passed to the callback.
+ *
+ * @return Number of entries passed to the callback, <0 if error.
+ */
+int dns_resolve_cache_foreach(struct dns_resolve_context *ctx,
+			      dns_resolve_cache_cb_t cb,
+			      void *user_data);
+
+/**
+ * @brief Remove all entries from the DNS answer cache.
+ *
+ * @details This is only available if CONFIG_DNS_RESOLVER_CACHE is enabled.
+ *
+ * @param ctx DNS context
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int dns_resolve_cache_flush(struct dns_resolve_context *ctx);
+
 /**
  * @brief Get default DNS context.
  *
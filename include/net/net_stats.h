@@ -205,6 +205,17 @@ struct net_stats_ipv6_mld {
 	net_stats_t drop;
 };
 
+/**
+ * @brief Connection handler lookup statistics
+ */
+struct net_stats_conn {
+	/** Number of connection hash table lookups */
+	net_stats_t lookups;
+
+	/** Number of handlers skipped because of a hash collision */
+	net_stats_t collisions;
+};
+
 /**
  * @brief IPv4 IGMP daemon statistics
  */
@@ -342,6 +353,11 @@ struct net_stats {
 	struct net_stats_ipv4_igmp ipv4_igmp;
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_CONN)
+	/** Connection lookup statistics */
+	struct net_stats_conn conn;
+#endif
+
 #if NET_TC_COUNT > 1
 	/** Traffic class statistics */
 	struct net_stats_tc tc;
@@ -27,8 +27,10 @@
 #include <net/net_ip.h>
 #include <net/dns_resolve.h>
 #include <net/socket_select.h>
+#include <net/socket_epoll.h>
 #include <net/socket_ncs.h>
 #include <stdlib.h>
+#include <errno.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,6 +67,9 @@ struct zsock_pollfd {
 /** zsock_recv: block until the full amount of data can be returned */
 #define ZSOCK_MSG_WAITALL 0x100
 
+/** zsock_sendmmsg/zsock_recvmmsg: max number of messages handled per call */
+#define ZSOCK_MMSG_MAX_VLEN 1024
+
 /* Well-known values, e.g. from Linux man 2 shutdown:
  * "The constants SHUT_RD, SHUT_WR, SHUT_RDWR have the value 0, 1, 2,
  * respectively". Some software uses numeric values.
@@ -371,6 +376,55 @@ static inline ssize_t zsock_send(int sock, const void *buf, size_t len,
 __syscall ssize_t zsock_sendmsg(int sock, const struct msghdr *msg,
 				int flags);
 
+/**
+ * @brief Send multiple messages with one call
+ *
+ * @details
+ * @rst
+ * Send up to ``vlen`` messages described by ``msgvec``, like calling
+ * :c:func:`zsock_sendmsg` for each of them, but the socket is looked up
+ * and locked only once. The number of bytes sent for each message is
+ * stored in its ``msg_len`` field. At most :c:macro:`ZSOCK_MMSG_MAX_VLEN`
+ * messages are sent per call. Socket types without a native implementation,
+ * such as TLS, packet or offloaded sockets, send the messages one by one
+ * with :c:func:`zsock_sendmsg`.
+ * This function is also exposed as ``sendmmsg()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of messages sent. If an error happens after the first
+ *         message has been sent, the number of messages sent so far is
+ *         returned. Otherwise -1 is returned and errno is set.
+ */
+__syscall int zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
+/**
+ * @brief Receive multiple datagrams with one call
+ *
+ * @details
+ * @rst
+ * Receive up to ``vlen`` datagrams into the buffers described by
+ * ``msgvec``. Only the first datagram is waited for (according to the
+ * ``flags`` and the socket blocking mode); after that the call returns as
+ * soon as the receive queue is empty. The length of each datagram is
+ * stored in the ``msg_len`` field, ``msg_namelen`` is updated if
+ * ``msg_name`` was given and ``ZSOCK_MSG_TRUNC`` is set in ``msg_flags``
+ * if the datagram did not fit into the buffers. Ancillary data is not
+ * supported. At most :c:macro:`ZSOCK_MMSG_MAX_VLEN` datagrams are received
+ * per call. Only native datagram sockets are supported, and
+ * ``ZSOCK_MSG_PEEK`` cannot be used. Other sockets, such as stream, TLS,
+ * DTLS, packet, CAN or offloaded sockets, fail with ``EOPNOTSUPP``.
+ * This function is also exposed as ``recvmmsg()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ *
+ * @return Number of datagrams received, or -1 with errno set if no
+ *         datagram could be received.
+ */
+__syscall int zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			     unsigned int vlen, int flags);
+
 /**
  * @brief Receive data from an arbitrary network address
  *
@@ -719,6 +773,27 @@ static inline ssize_t sendmsg(int sock, const struct msghdr *message,
 	return zsock_sendmsg(sock, message, flags);
 }
 
+static inline int sendmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+struct timespec;
+
+/* The timeout argument is not supported, use SO_RCVTIMEO instead. */
+static inline int recvmmsg(int sock, struct mmsghdr *msgvec,
+			   unsigned int vlen, int flags,
+			   struct timespec *timeout)
+{
+	if (timeout) {
+		errno = ENOTSUP;
+		return -1;
+	}
+
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
 static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 			       struct sockaddr *src_addr, socklen_t *addrlen)
 {
@@ -853,8 +928,10 @@ struct ifreq {
 #define SO_PROTOCOL 38
 
 /* Socket options for IPPROTO_TCP level */
-/** sockopt: Disable TCP buffering (ignored, for compatibility) */
+/** sockopt: Disable Nagle's algorithm, send small segments right away */
 #define TCP_NODELAY 1
+/** sockopt: Do not send partial segments until uncorked or for 200 ms */
+#define TCP_CORK 3
 
 /* Socket options for IPPROTO_IPV6 level */
 /** sockopt: Don't support IPv4 access (ignored, for compatibility) */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+#define ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_
+
+/**
+ * @brief BSD Sockets compatible API
+ * @defgroup bsd_sockets BSD Sockets compatible API
+ * @ingroup networking
+ * @{
+ */
+
+#include <toolchain.h>
+#include <zephyr/types.h>
+#include <errno.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event values match the ZSOCK_POLL* values and are compatible with Linux */
+/** zsock_epoll_ctl/zsock_epoll_wait: Data can be read */
+#define ZSOCK_EPOLLIN 0x001
+/** zsock_epoll_ctl/zsock_epoll_wait: Out-of-band data can be read */
+#define ZSOCK_EPOLLPRI 0x002
+/** zsock_epoll_ctl/zsock_epoll_wait: Data can be written */
+#define ZSOCK_EPOLLOUT 0x004
+/** zsock_epoll_wait: Error condition, always reported */
+#define ZSOCK_EPOLLERR 0x008
+/** zsock_epoll_wait: Hang up, always reported */
+#define ZSOCK_EPOLLHUP 0x010
+/** zsock_epoll_ctl: Disable the descriptor after one event is reported */
+#define ZSOCK_EPOLLONESHOT (1U << 30)
+/** zsock_epoll_ctl: Edge triggered notification (not supported) */
+#define ZSOCK_EPOLLET (1U << 31)
+
+/** zsock_epoll_ctl: Add a descriptor to the interest list */
+#define ZSOCK_EPOLL_CTL_ADD 1
+/** zsock_epoll_ctl: Remove a descriptor from the interest list */
+#define ZSOCK_EPOLL_CTL_DEL 2
+/** zsock_epoll_ctl: Change the events of a descriptor in the interest list */
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+/** zsock_epoll_create1: Close on exec, accepted for compatibility only */
+#define ZSOCK_EPOLL_CLOEXEC 02000000
+
+/** User data attached to a descriptor in the interest list */
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	uint32_t u32;
+	uint64_t u64;
+} zsock_epoll_data_t;
+
+/** Event description used by zsock_epoll_ctl() and zsock_epoll_wait() */
+struct zsock_epoll_event {
+	/** ZSOCK_EPOLL* event mask */
+	uint32_t events;
+	/** User data, returned as is by zsock_epoll_wait() */
+	zsock_epoll_data_t data;
+};
+
+/**
+ * @brief Create an epoll instance
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_create.2.html>`__
+ * for normative description. The returned descriptor keeps a persistent
+ * list of sockets (the interest list) that can be waited on with
+ * :c:func:`zsock_epoll_wait()`. Unlike with :c:func:`zsock_poll()`, the
+ * sockets are set up for waiting once, when they are added, and they put
+ * themselves on a ready list of the instance from the system work queue
+ * when they are signaled. A wait only checks the sockets of the ready list.
+ * The descriptor is released with :c:func:`zsock_close()`.
+ * This function is also exposed as ``epoll_create1()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_create1(int flags);
+
+/**
+ * @brief Add, modify or remove a socket in the epoll interest list
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_ctl.2.html>`__
+ * for normative description. Only level triggered notification is
+ * supported, ``ZSOCK_EPOLLET`` is rejected with ``EINVAL``. A socket
+ * closed with :c:func:`zsock_close()` is removed from the interest list.
+ * Offloaded sockets are not supported.
+ * This function is also exposed as ``epoll_ctl()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_ctl(int epfd, int op, int fd,
+			      struct zsock_epoll_event *event);
+
+/**
+ * @brief Wait for events on the sockets of an epoll interest list
+ *
+ * @details
+ * @rst
+ * See `Linux man page
+ * <https://man7.org/linux/man-pages/man2/epoll_wait.2.html>`__
+ * for normative description. Only the ready sockets are returned, at most
+ * ``maxevents`` of them. When more sockets are ready, the following call
+ * continues after the last one reported. The timeout is given in
+ * milliseconds, ``SYS_FOREVER_MS`` waits forever. As sockets are put on
+ * the ready list from the system work queue, this function must not be
+ * called from a work item of the system work queue with a timeout.
+ * This function is also exposed as ``epoll_wait()``
+ * if :kconfig:`CONFIG_NET_SOCKETS_POSIX_NAMES` is defined.
+ * @endrst
+ */
+__syscall int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			       int maxevents, int timeout);
+
+#ifdef CONFIG_NET_SOCKETS_POSIX_NAMES
+
+#define epoll_event zsock_epoll_event
+#define epoll_data zsock_epoll_data
+#define epoll_data_t zsock_epoll_data_t
+
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLPRI ZSOCK_EPOLLPRI
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLERR ZSOCK_EPOLLERR
+#define EPOLLHUP ZSOCK_EPOLLHUP
+#define EPOLLONESHOT ZSOCK_EPOLLONESHOT
+#define EPOLLET ZSOCK_EPOLLET
+
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
+#define EPOLL_CLOEXEC ZSOCK_EPOLL_CLOEXEC
+
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+static inline int epoll_create(int size)
+{
+	/* The size is only a hint and must be positive */
+	if (size <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	return zsock_epoll_create1(0);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#endif /* CONFIG_NET_SOCKETS_POSIX_NAMES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#include <syscalls/socket_epoll.h>
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_SOCKET_EPOLL_H_ */
@@ -87,7 +87,9 @@ typedef int (*cbprintf_cb)(/* int c, void *ctx */);
  * Static packaging can be applied if size of the package can be determined
  * at compile time. In general, package size can be determined at compile time
  * if there are no string arguments which might be copied into package body if
- * they are considered transient.
+ * they are considered transient. When building with GCC, string literals
+ * passed directly as arguments are known to be read only and do not prevent
+ * static packaging.
  *
  * @param skip number of read only string arguments in the parameter list. It
  * shall be non-zero if there are known read only string arguments present
@@ -101,6 +101,33 @@ extern "C" {
 			0)
 #endif
 
+/** @brief Return 1 if argument is known to point to a string literal.
+ *
+ * GCC treats only addresses derived from string literals as compile time
+ * constants, so such a string is in read only memory and a pointer to it can
+ * be packaged without copying the string. Other compilers may consider any
+ * address constant, so the check is disabled for them.
+ *
+ * @param x argument.
+ *
+ * @return 1 if @p x points to a string literal, 0 otherwise.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define Z_CBPRINTF_IS_RO_STR(x) __builtin_constant_p(x)
+#else
+#define Z_CBPRINTF_IS_RO_STR(x) 0
+#endif
+
+/** @brief Return 1 if argument is a string pointer which may point to RW memory.
+ *
+ * @param x argument.
+ *
+ * @return 1 if char * or wchar_t * not known to point to a string literal,
+ * 0 otherwise.
+ */
+#define Z_CBPRINTF_IS_RW_PCHAR(x) \
+	(Z_CBPRINTF_IS_PCHAR(x) && !Z_CBPRINTF_IS_RO_STR(x))
+
 /** @brief Calculate number of char * or wchar_t * arguments in the arguments.
  *
  * @param fmt string.
@@ -112,9 +139,26 @@ extern "C" {
 #define Z_CBPRINTF_HAS_PCHAR_ARGS(fmt, ...) \
 	(FOR_EACH(Z_CBPRINTF_IS_PCHAR, (+),  __VA_ARGS__))
 
+/** @brief Calculate number of string arguments which may point to RW memory.
+ *
+ * String literals passed directly as arguments are not counted.
+ *
+ * @param fmt string.
+ *
+ * @param ... string arguments.
+ *
+ * @return number of arguments which are char * or wchar_t * and are not known
+ * to point to a string literal.
+ */
+#define Z_CBPRINTF_HAS_RW_PCHAR_ARGS(fmt, ...) \
+	(FOR_EACH(Z_CBPRINTF_IS_RW_PCHAR, (+),  __VA_ARGS__))
+
 /**
  * @brief Check if formatted string must be packaged in runtime.
  *
+ * String literals passed as arguments do not require runtime packaging since
+ * only a pointer to the string is stored in the package.
+ *
  * @param skip number of char/wchar_t pointers in the argument list which are
  * accepted for static packaging.
  *
@@ -129,7 +173,7 @@ extern "C" {
 	_Pragma("GCC diagnostic ignored \"-Wpointer-arith\"") \
 	int _rv = COND_CODE_0(NUM_VA_ARGS_LESS_1(__VA_ARGS__), \
 			(0), \
-			(((Z_CBPRINTF_HAS_PCHAR_ARGS(__VA_ARGS__) - skip) > 0))); \
+			(((Z_CBPRINTF_HAS_RW_PCHAR_ARGS(__VA_ARGS__) - skip) > 0))); \
 	_Pragma("GCC diagnostic pop")\
 	_rv; \
 })
@@ -204,6 +204,49 @@ uint8_t crc8_ccitt(uint8_t initial_value, const void *buf, size_t len);
  */
 uint8_t crc7_be(uint8_t seed, const uint8_t *src, size_t len);
 
+/** CRC computations which can be handled by hardware */
+enum crc_type {
+	/** crc32_ieee() and crc32_ieee_update() */
+	CRC_TYPE_CRC32_IEEE,
+	/** crc32_c() */
+	CRC_TYPE_CRC32C,
+	/** crc16_ccitt() */
+	CRC_TYPE_CRC16_CCITT,
+	/** crc16_itu_t() */
+	CRC_TYPE_CRC16_ITU_T,
+};
+
+/**
+ * @brief Hardware CRC handler
+ *
+ * Updates a CRC register over a buffer, without the initial and final
+ * inversions some of the CRC functions apply, and in the bit order of
+ * the CRC: reflected (least significant bit first) for all types but
+ * CRC_TYPE_CRC16_ITU_T.
+ *
+ * @param type CRC to compute
+ * @param crc CRC register, updated on success
+ * @param src Input bytes for the computation
+ * @param len Length of the input in bytes
+ *
+ * @return 0 on success, or a negative error code, e.g. if the type is
+ * not supported or the unit is busy, to fall back to software.
+ */
+typedef int (*crc_hw_handler_t)(enum crc_type type, uint32_t *crc,
+				const uint8_t *src, size_t len);
+
+/**
+ * @brief Route CRC computations to hardware
+ *
+ * Once set, the handler is tried first by crc32_ieee_update(), crc32_c(),
+ * crc16_ccitt() and crc16_itu_t() for buffers of at least
+ * CONFIG_CRC_HW_MIN_LEN bytes.  It is meant to be set by the driver of a
+ * hardware CRC unit.  Requires CONFIG_CRC_HW.
+ *
+ * @param handler Handler, or NULL to compute all CRCs in software
+ */
+void crc_hw_handler_set(crc_hw_handler_t handler);
+
 /**
  * @}
  */
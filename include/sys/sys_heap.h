@@ -120,6 +120,22 @@ void *sys_heap_aligned_alloc(struct sys_heap *heap, size_t align, size_t bytes);
  */
 void sys_heap_free(struct sys_heap *heap, void *mem);
 
+/** @brief Return allocated memory size
+ *
+ * Returns the size, in bytes, of a block returned from a successful
+ * sys_heap_alloc() or sys_heap_aligned_alloc() call.  The value
+ * returned is the size of the heap-managed memory, which may be
+ * larger than the number of bytes requested due to allocation
+ * granularity.  The heap code is guaranteed to make no access to this
+ * region of memory until a subsequent sys_heap_free() on the same
+ * pointer.
+ *
+ * @param heap Heap containing the block
+ * @param mem Pointer to memory allocated from this heap
+ * @return Size in bytes of the memory region
+ */
+size_t sys_heap_usable_size(struct sys_heap *heap, void *mem);
+
 /** @brief Expand the size of an existing allocation
  *
  * Returns a pointer to a new memory region with the same contents,
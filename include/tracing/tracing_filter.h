@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_TRACING_TRACING_FILTER_H_
+#define ZEPHYR_INCLUDE_TRACING_TRACING_FILTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <toolchain.h>
+#include <sys/util.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Runtime tracing filter
+ * @defgroup tracing_filter_apis Runtime Tracing Filter APIs
+ * @ingroup tracing_apis
+ * @{
+ */
+
+/** @brief Classes of tracing events which can be enabled at runtime. */
+enum tracing_class {
+	TRACING_CLASS_THREAD,
+	TRACING_CLASS_ISR,
+	TRACING_CLASS_IDLE,
+	TRACING_CLASS_WORK,
+	TRACING_CLASS_POLL,
+	TRACING_CLASS_SEMAPHORE,
+	TRACING_CLASS_MUTEX,
+	TRACING_CLASS_CONDVAR,
+	TRACING_CLASS_QUEUE,
+	TRACING_CLASS_FIFO,
+	TRACING_CLASS_LIFO,
+	TRACING_CLASS_STACK,
+	TRACING_CLASS_MESSAGE_QUEUE,
+	TRACING_CLASS_MAILBOX,
+	TRACING_CLASS_PIPE,
+	TRACING_CLASS_HEAP,
+	TRACING_CLASS_MEMORY_SLAB,
+	TRACING_CLASS_TIMER,
+	TRACING_CLASS_PM,
+
+	TRACING_CLASS_COUNT
+};
+
+/** @brief Mask with all tracing classes set. */
+#define TRACING_CLASS_ALL BIT_MASK(TRACING_CLASS_COUNT)
+
+/** @cond INTERNAL_HIDDEN */
+
+extern uint32_t z_tracing_class_mask;
+extern uint32_t z_tracing_object_mask;
+
+bool z_tracing_object_is_selected(const void *obj);
+bool z_tracing_current_is_selected(void);
+
+static ALWAYS_INLINE bool z_tracing_class_enabled(enum tracing_class cls)
+{
+	return (z_tracing_class_mask & BIT(cls)) != 0U;
+}
+
+static ALWAYS_INLINE bool z_tracing_object_enabled(enum tracing_class cls,
+						   const void *obj)
+{
+	if (!z_tracing_class_enabled(cls)) {
+		return false;
+	}
+
+	if ((z_tracing_object_mask & BIT(cls)) == 0U) {
+		return true;
+	}
+
+	return z_tracing_object_is_selected(obj);
+}
+
+/* Events which do not refer to an object. Thread events refer to the
+ * current thread, the events of other classes are not restricted.
+ */
+static ALWAYS_INLINE bool z_tracing_func_enabled(enum tracing_class cls)
+{
+	if (!z_tracing_class_enabled(cls)) {
+		return false;
+	}
+
+	if (cls != TRACING_CLASS_THREAD ||
+	    (z_tracing_object_mask & BIT(cls)) == 0U) {
+		return true;
+	}
+
+	return z_tracing_current_is_selected();
+}
+
+/** @endcond */
+
+/**
+ * @brief Set the mask of enabled tracing classes.
+ *
+ * @param mask Bit mask of @ref tracing_class values.
+ */
+void tracing_class_mask_set(uint32_t mask);
+
+/**
+ * @brief Get the mask of enabled tracing classes.
+ *
+ * @return Bit mask of @ref tracing_class values.
+ */
+uint32_t tracing_class_mask_get(void);
+
+/**
+ * @brief Enable or disable tracing of a class of events.
+ *
+ * @param cls Tracing class.
+ * @param enable True to enable, false to disable.
+ */
+void tracing_class_set(enum tracing_class cls, bool enable);
+
+/**
+ * @brief Get the name of a tracing class.
+ *
+ * @param cls Tracing class.
+ *
+ * @return Class name or NULL if @p cls is out of range.
+ */
+const char *tracing_class_name_get(enum tracing_class cls);
+
+/**
+ * @brief Restrict a class of events to selected objects.
+ *
+ * When restricted, events of the class are only traced for objects
+ * selected with @ref tracing_object_select. For the thread class, the
+ * object is the thread the event refers to, or the current thread for
+ * events which do not refer to a thread, such as context switches, sleeps
+ * and yields. Events of other classes which do not refer to an object are
+ * not restricted.
+ *
+ * @param cls Tracing class.
+ * @param enable True to restrict the class, false to trace all objects.
+ */
+void tracing_object_filter_set(enum tracing_class cls, bool enable);
+
+/**
+ * @brief Select an object (kernel object or thread) for tracing.
+ *
+ * @param obj Object.
+ *
+ * @retval 0 on success or if the object was already selected.
+ * @retval -EINVAL if @p obj is NULL.
+ * @retval -ENOMEM if CONFIG_TRACING_RUNTIME_FILTER_OBJECTS objects are
+ *	   already selected.
+ */
+int tracing_object_select(const void *obj);
+
+/**
+ * @brief Remove an object from the selected objects.
+ *
+ * @param obj Object.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if the object was not selected.
+ */
+int tracing_object_deselect(const void *obj);
+
+/**
+ * @brief Iterate over the selected objects.
+ *
+ * @param cb Callback called for each selected object.
+ * @param user_data User data passed to @p cb.
+ */
+void tracing_object_foreach(void (*cb)(const void *obj, void *user_data),
+			    void *user_data);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_TRACING_TRACING_FILTER_H_ */
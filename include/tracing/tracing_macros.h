@@ -145,7 +145,74 @@
 	#define sys_port_trace_type_mask_k_timer(trace_call)
 #endif
 
+#if defined(CONFIG_TRACING_RUNTIME_FILTER)
+#include <tracing/tracing_filter.h>
 
+/* Runtime tracing class of each event or object type
+ */
+#define sys_port_trace_class_k_thread TRACING_CLASS_THREAD
+#define sys_port_trace_class_k_work TRACING_CLASS_WORK
+#define sys_port_trace_class_k_work_queue TRACING_CLASS_WORK
+#define sys_port_trace_class_k_work_delayable TRACING_CLASS_WORK
+#define sys_port_trace_class_k_work_poll TRACING_CLASS_WORK
+#define sys_port_trace_class_k_poll_api TRACING_CLASS_POLL
+#define sys_port_trace_class_k_sem TRACING_CLASS_SEMAPHORE
+#define sys_port_trace_class_k_mutex TRACING_CLASS_MUTEX
+#define sys_port_trace_class_k_condvar TRACING_CLASS_CONDVAR
+#define sys_port_trace_class_k_queue TRACING_CLASS_QUEUE
+#define sys_port_trace_class_k_fifo TRACING_CLASS_FIFO
+#define sys_port_trace_class_k_lifo TRACING_CLASS_LIFO
+#define sys_port_trace_class_k_stack TRACING_CLASS_STACK
+#define sys_port_trace_class_k_msgq TRACING_CLASS_MESSAGE_QUEUE
+#define sys_port_trace_class_k_mbox TRACING_CLASS_MAILBOX
+#define sys_port_trace_class_k_pipe TRACING_CLASS_PIPE
+#define sys_port_trace_class_k_heap TRACING_CLASS_HEAP
+#define sys_port_trace_class_k_heap_sys TRACING_CLASS_HEAP
+#define sys_port_trace_class_k_mem_slab TRACING_CLASS_MEMORY_SLAB
+#define sys_port_trace_class_k_timer TRACING_CLASS_TIMER
+#define sys_port_trace_class_pm TRACING_CLASS_PM
+
+#define _SYS_PORT_TRACING_CLASS(type) \
+	sys_port_trace_class_ ## type
+
+/**
+ * @def SYS_PORT_TRACING_CLASS_ENABLED
+ *
+ * @brief Checks at runtime if events of a type should be traced. When the
+ * class of the type is disabled this costs a single load and branch.
+ *
+ * @param type Tracing event type/object
+ */
+#define SYS_PORT_TRACING_CLASS_ENABLED(type) \
+	z_tracing_class_enabled(_SYS_PORT_TRACING_CLASS(type))
+
+/**
+ * @def SYS_PORT_TRACING_FUNC_ENABLED
+ *
+ * @brief Checks at runtime if events of a type which do not refer to an
+ * object should be traced. Thread events are checked against the current
+ * thread.
+ *
+ * @param type Tracing event type/object
+ */
+#define SYS_PORT_TRACING_FUNC_ENABLED(type) \
+	z_tracing_func_enabled(_SYS_PORT_TRACING_CLASS(type))
+
+/**
+ * @def SYS_PORT_TRACING_OBJ_ENABLED
+ *
+ * @brief Checks at runtime if events of an object should be traced.
+ *
+ * @param obj_type The type of object associated with the call
+ * @param obj Object
+ */
+#define SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj) \
+	z_tracing_object_enabled(_SYS_PORT_TRACING_CLASS(obj_type), obj)
+#else
+#define SYS_PORT_TRACING_CLASS_ENABLED(type) true
+#define SYS_PORT_TRACING_FUNC_ENABLED(type) true
+#define SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj) true
+#endif
 
 
 /**
@@ -176,7 +243,9 @@
  */
 #define SYS_PORT_TRACING_FUNC(type, func, ...) \
 	do { \
-		_SYS_PORT_TRACING_FUNC(type, func)(__VA_ARGS__); \
+		if (SYS_PORT_TRACING_FUNC_ENABLED(type)) { \
+			_SYS_PORT_TRACING_FUNC(type, func)(__VA_ARGS__); \
+		} \
 	} while (false)
 
 /**
@@ -193,7 +262,9 @@
  */
 #define SYS_PORT_TRACING_FUNC_ENTER(type, func, ...) \
 	do { \
-		_SYS_PORT_TRACING_FUNC_ENTER(type, func)(__VA_ARGS__); \
+		if (SYS_PORT_TRACING_FUNC_ENABLED(type)) { \
+			_SYS_PORT_TRACING_FUNC_ENTER(type, func)(__VA_ARGS__); \
+		} \
 	} while (false)
 
 /**
@@ -209,7 +280,9 @@
  */
 #define SYS_PORT_TRACING_FUNC_BLOCKING(type, func, ...) \
 	do { \
-		_SYS_PORT_TRACING_FUNC_BLOCKING(type, func)(__VA_ARGS__); \
+		if (SYS_PORT_TRACING_FUNC_ENABLED(type)) { \
+			_SYS_PORT_TRACING_FUNC_BLOCKING(type, func)(__VA_ARGS__); \
+		} \
 	} while (false)
 
 /**
@@ -226,7 +299,9 @@
  */
 #define SYS_PORT_TRACING_FUNC_EXIT(type, func, ...) \
 	do { \
-		_SYS_PORT_TRACING_FUNC_EXIT(type, func)(__VA_ARGS__); \
+		if (SYS_PORT_TRACING_FUNC_ENABLED(type)) { \
+			_SYS_PORT_TRACING_FUNC_EXIT(type, func)(__VA_ARGS__); \
+		} \
 	} while (false)
 
 /**
@@ -240,7 +315,9 @@
 #define SYS_PORT_TRACING_OBJ_INIT(obj_type, obj, ...) \
 	do { \
 		SYS_PORT_TRACING_TYPE_MASK(obj_type, \
-			_SYS_PORT_TRACING_OBJ_INIT(obj_type)(obj, ##__VA_ARGS__)); \
+			if (SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj)) { \
+				_SYS_PORT_TRACING_OBJ_INIT(obj_type)(obj, ##__VA_ARGS__); \
+			}); \
 	} while (false)
 
 /**
@@ -258,7 +335,9 @@
 #define SYS_PORT_TRACING_OBJ_FUNC(obj_type, func, obj, ...) \
 	do { \
 		SYS_PORT_TRACING_TYPE_MASK(obj_type, \
-			_SYS_PORT_TRACING_OBJ_FUNC(obj_type, func)(obj, ##__VA_ARGS__)); \
+			if (SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj)) { \
+				_SYS_PORT_TRACING_OBJ_FUNC(obj_type, func)(obj, ##__VA_ARGS__); \
+			}); \
 	} while (false)
 
 /**
@@ -277,7 +356,9 @@
 #define SYS_PORT_TRACING_OBJ_FUNC_ENTER(obj_type, func, obj, ...) \
 	do { \
 		SYS_PORT_TRACING_TYPE_MASK(obj_type, \
-			_SYS_PORT_TRACING_OBJ_FUNC_ENTER(obj_type, func)(obj, ##__VA_ARGS__)); \
+			if (SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj)) { \
+				_SYS_PORT_TRACING_OBJ_FUNC_ENTER(obj_type, func)(obj, ##__VA_ARGS__); \
+			}); \
 	} while (false)
 
 /**
@@ -295,8 +376,10 @@
 #define SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(obj_type, func, obj, timeout, ...) \
 	do { \
 		SYS_PORT_TRACING_TYPE_MASK(obj_type, \
-			_SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(obj_type, func) \
-			(obj, timeout, ##__VA_ARGS__)); \
+			if (SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj)) { \
+				_SYS_PORT_TRACING_OBJ_FUNC_BLOCKING(obj_type, func) \
+				(obj, timeout, ##__VA_ARGS__); \
+			}); \
 	} while (false)
 
 /**
@@ -315,7 +398,9 @@
 #define SYS_PORT_TRACING_OBJ_FUNC_EXIT(obj_type, func, obj, ...) \
 	do { \
 		SYS_PORT_TRACING_TYPE_MASK(obj_type, \
-			_SYS_PORT_TRACING_OBJ_FUNC_EXIT(obj_type, func)(obj, ##__VA_ARGS__)); \
+			if (SYS_PORT_TRACING_OBJ_ENABLED(obj_type, obj)) { \
+				_SYS_PORT_TRACING_OBJ_FUNC_EXIT(obj_type, func)(obj, ##__VA_ARGS__); \
+			}); \
 	} while (false)
 #endif /* CONFIG_TRACING */
 #endif
@@ -280,6 +280,27 @@ void z_paging_histogram_inc(struct k_mem_paging_histogram_t *hist,
 			    uint32_t cycles);
 #endif /* CONFIG_DEMAND_PAGING_TIMING_HISTOGRAM */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WINDOWS
+/**
+ * Start sampling the CPU usage of threads and CPUs.
+ */
+void z_thread_usage_init(void);
+#endif
+
+#ifdef CONFIG_SCHED_LATENCY_STATS
+/**
+ * Record that a thread has been made ready to run.
+ *
+ * @param thread Thread added to the run queue.
+ */
+void z_sched_latency_mark_ready(struct k_thread *thread);
+
+/**
+ * Account the scheduling latency of the thread being switched in.
+ */
+void z_sched_latency_mark_switched_in(void);
+#endif /* CONFIG_SCHED_LATENCY_STATS */
+
 #ifdef __cplusplus
 }
 #endif
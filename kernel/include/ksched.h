@@ -142,14 +142,14 @@ static inline void z_mark_thread_as_suspended(struct k_thread *thread)
 {
 	thread->base.thread_state |= _THREAD_SUSPENDED;
 
-	SYS_PORT_TRACING_FUNC(k_thread, sched_suspend, thread);
+	SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_suspend, thread);
 }
 
 static inline void z_mark_thread_as_not_suspended(struct k_thread *thread)
 {
 	thread->base.thread_state &= ~_THREAD_SUSPENDED;
 
-	SYS_PORT_TRACING_FUNC(k_thread, sched_resume, thread);
+	SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_resume, thread);
 }
 
 static inline void z_mark_thread_as_started(struct k_thread *thread)
@@ -192,6 +192,9 @@ static void bg_thread_main(void *unused1, void *unused2, void *unused3)
 	z_sys_post_kernel = true;
 
 	z_sys_init_run_level(_SYS_INIT_LEVEL_POST_KERNEL);
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WINDOWS
+	z_thread_usage_init();
+#endif
 #if CONFIG_STACK_POINTER_RANDOM
 	z_stack_adjust_initialized = 1;
 #endif
@@ -8,11 +8,169 @@
 #include <ksched.h>
 #include <wait_q.h>
 #include <init.h>
+#include <string.h>
+
+#ifdef CONFIG_HEAP_CACHE
+
+/* Size classes are powers of two, from 8 bytes up to HEAP_CACHE_MAX.
+ * Cached blocks are always pointer-aligned, so that they can serve
+ * any request for the default k_heap_alloc() alignment.
+ */
+#define HEAP_CACHE_MIN 8U
+#define HEAP_CACHE_MAX (HEAP_CACHE_MIN << (CONFIG_HEAP_CACHE_CLASSES - 1))
+#define HEAP_CACHE_ALIGN sizeof(void *)
+
+/* Smallest class fitting a request of @bytes */
+static inline int cache_class_alloc(size_t bytes)
+{
+	if (bytes <= HEAP_CACHE_MIN) {
+		return 0;
+	}
+
+	return 32 - __builtin_clz((uint32_t)bytes - 1U) - 3;
+}
+
+/* Largest class fully served by a block of @bytes */
+static inline int cache_class_free(size_t bytes)
+{
+	return 31 - __builtin_clz((uint32_t)bytes) - 3;
+}
+
+/* The cache of the current CPU, locked against flushes from other
+ * CPUs.  Interrupts stay locked until cache_unlock() so that the thread
+ * cannot migrate meanwhile.
+ */
+static struct z_heap_cache *cache_lock(struct k_heap *h, unsigned int *key,
+				       k_spinlock_key_t *cache_key)
+{
+	struct z_heap_cache *cache;
+
+	*key = arch_irq_lock();
+	cache = &h->cache[_current_cpu->id];
+	*cache_key = k_spin_lock(&cache->lock);
+
+	return cache;
+}
+
+static void cache_unlock(struct z_heap_cache *cache, unsigned int key,
+			 k_spinlock_key_t cache_key)
+{
+	k_spin_unlock(&cache->lock, cache_key);
+	arch_irq_unlock(key);
+}
+
+static void *cache_alloc(struct k_heap *h, int class)
+{
+	struct z_heap_cache *cache;
+	k_spinlock_key_t cache_key;
+	unsigned int key;
+	void *ret = NULL;
+
+	cache = cache_lock(h, &key, &cache_key);
+	if (cache->count[class] > 0U) {
+		ret = cache->blocks[class][--cache->count[class]];
+		cache->hits++;
+	} else {
+		cache->misses++;
+	}
+
+	cache_unlock(cache, key, cache_key);
+	return ret;
+}
+
+static bool cache_free(struct k_heap *h, void *mem)
+{
+	struct z_heap_cache *cache;
+	k_spinlock_key_t cache_key;
+	unsigned int key;
+	size_t bytes;
+	bool cached = false;
+	int class;
+
+	/* Blocks must go back to the heap when somebody waits for
+	 * memory.  This is an unlocked peek: a thread starting to wait
+	 * right now is woken by the next uncached free.
+	 */
+	if (mem == NULL || ((uintptr_t)mem & (HEAP_CACHE_ALIGN - 1)) != 0U ||
+	    (IS_ENABLED(CONFIG_MULTITHREADING) &&
+	     z_waitq_head(&h->wait_q) != NULL)) {
+		return false;
+	}
+
+	/* The heap never touches the header of a used block */
+	bytes = sys_heap_usable_size(&h->heap, mem);
+	if (bytes < HEAP_CACHE_MIN || bytes >= 2U * HEAP_CACHE_MAX) {
+		return false;
+	}
+
+	class = cache_class_free(bytes);
+
+	cache = cache_lock(h, &key, &cache_key);
+	if (cache->count[class] < CONFIG_HEAP_CACHE_DEPTH) {
+		cache->blocks[class][cache->count[class]++] = mem;
+		cached = true;
+	}
+	cache_unlock(cache, key, cache_key);
+
+	return cached;
+}
+
+/* Returns the cached blocks of all CPUs to the heap, so that an
+ * allocation only fails if the heap and the caches together lack the
+ * memory.  Must be called with the heap lock held, which is always
+ * taken before the cache locks.  Returns true if anything was flushed.
+ */
+static bool cache_flush(struct k_heap *h)
+{
+	struct z_heap_cache *cache;
+	k_spinlock_key_t key;
+	bool flushed = false;
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		cache = &h->cache[cpu];
+		key = k_spin_lock(&cache->lock);
+
+		for (int class = 0; class < CONFIG_HEAP_CACHE_CLASSES;
+		     class++) {
+			while (cache->count[class] > 0U) {
+				sys_heap_free(&h->heap,
+					      cache->blocks[class][--cache->count[class]]);
+				flushed = true;
+			}
+		}
+
+		k_spin_unlock(&cache->lock, key);
+	}
+
+	return flushed;
+}
+
+void k_heap_cache_stats_get(struct k_heap *h,
+			    struct k_heap_cache_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+
+	for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		struct z_heap_cache *cache = &h->cache[cpu];
+
+		stats->hits += cache->hits;
+		stats->misses += cache->misses;
+		for (int class = 0; class < CONFIG_HEAP_CACHE_CLASSES;
+		     class++) {
+			stats->cached += cache->count[class];
+		}
+	}
+}
+
+#endif /* CONFIG_HEAP_CACHE */
 
 void k_heap_init(struct k_heap *h, void *mem, size_t bytes)
 {
 	z_waitq_init(&h->wait_q);
 	sys_heap_init(&h->heap, mem, bytes);
+#ifdef CONFIG_HEAP_CACHE
+	memset(h->cache, 0, sizeof(h->cache));
+#endif
 
 	SYS_PORT_TRACING_OBJ_INIT(k_heap, h);
 }
@@ -33,7 +191,29 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 {
 	int64_t now, end = sys_clock_timeout_end_calc(timeout);
 	void *ret = NULL;
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_HEAP_CACHE
+	size_t cache_bytes = 0U;
+
+	if (align <= HEAP_CACHE_ALIGN && bytes != 0U &&
+	    bytes <= HEAP_CACHE_MAX) {
+		int class = cache_class_alloc(bytes);
+
+		ret = cache_alloc(h, class);
+		if (ret != NULL) {
+			SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc,
+							h, timeout);
+			SYS_PORT_TRACING_OBJ_FUNC_EXIT(k_heap, aligned_alloc,
+						       h, timeout, ret);
+			return ret;
+		}
+
+		cache_bytes = HEAP_CACHE_MIN << class;
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
 
 	SYS_PORT_TRACING_OBJ_FUNC_ENTER(k_heap, aligned_alloc, h, timeout);
 
@@ -42,7 +222,25 @@ void *k_heap_aligned_alloc(struct k_heap *h, size_t align, size_t bytes,
 	bool blocked_alloc = false;
 
 	while (ret == NULL) {
+#ifdef CONFIG_HEAP_CACHE
+		/* Preferably allocate the whole size class, so that the
+		 * block can be cached once freed.
+		 */
+		if (cache_bytes != 0U) {
+			ret = sys_heap_aligned_alloc(&h->heap, HEAP_CACHE_ALIGN,
+						     cache_bytes);
+		}
+
+		if (ret == NULL && cache_flush(h)) {
+			continue;
+		}
+
+		if (ret == NULL) {
+			ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+		}
+#else
 		ret = sys_heap_aligned_alloc(&h->heap, align, bytes);
+#endif
 
 		now = sys_clock_tick_get();
 		if (!IS_ENABLED(CONFIG_MULTITHREADING) ||
@@ -84,7 +282,16 @@ void *k_heap_alloc(struct k_heap *h, size_t bytes, k_timeout_t timeout)
 
 void k_heap_free(struct k_heap *h, void *mem)
 {
-	k_spinlock_key_t key = k_spin_lock(&h->lock);
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_HEAP_CACHE
+	if (cache_free(h, mem)) {
+		SYS_PORT_TRACING_OBJ_FUNC(k_heap, free, h);
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&h->lock);
 
 	sys_heap_free(&h->heap, mem);
 
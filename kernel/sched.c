@@ -30,6 +30,10 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 #define _priq_run_add		z_priq_rb_add
 #define _priq_run_remove	z_priq_rb_remove
 #define _priq_run_best		z_priq_rb_best
+#elif defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_CPU_MASK)
+#define _priq_run_add		z_priq_mq_cpu_add
+#define _priq_run_remove	z_priq_mq_cpu_remove
+#define _priq_run_best		z_priq_mq_cpu_best
 #elif defined(CONFIG_SCHED_MULTIQ)
 #define _priq_run_add		z_priq_mq_add
 #define _priq_run_remove	z_priq_mq_remove
@@ -476,6 +480,9 @@ static void ready_thread(struct k_thread *thread)
 	if (!z_is_thread_queued(thread) && z_is_thread_ready(thread)) {
 		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_ready, thread);
 
+#ifdef CONFIG_SCHED_LATENCY_STATS
+		z_sched_latency_mark_ready(thread);
+#endif
 		queue_thread(&_kernel.ready_q.runq, thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
@@ -594,7 +601,7 @@ static void add_to_waitq_locked(struct k_thread *thread, _wait_q_t *wait_q)
 	unready_thread(thread);
 	z_mark_thread_as_pending(thread);
 
-	SYS_PORT_TRACING_FUNC(k_thread, sched_pend, thread);
+	SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_pend, thread);
 
 	if (wait_q != NULL) {
 		thread->base.pended_on = wait_q;
@@ -1067,6 +1074,77 @@ struct k_thread *z_priq_mq_best(struct _priq_mq *pq)
 	return thread;
 }
 
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_CPU_MASK)
+/* Returns the CPU a thread is pinned to, or the shared queue */
+static ALWAYS_INLINE struct _priq_mq *priq_mq_cpu_queue(struct _priq_mq_cpu *pq,
+							struct k_thread *thread)
+{
+	uint32_t mask = thread->base.cpu_mask & BIT_MASK(CONFIG_MP_NUM_CPUS);
+
+	if ((mask != 0U) && ((mask & (mask - 1U)) == 0U)) {
+		return &pq->cpu[__builtin_ctz(mask)];
+	}
+	return &pq->shared;
+}
+
+ALWAYS_INLINE void z_priq_mq_cpu_add(struct _priq_mq_cpu *pq,
+				     struct k_thread *thread)
+{
+	thread->base.order_key = pq->next_order_key++;
+	z_priq_mq_add(priq_mq_cpu_queue(pq, thread), thread);
+}
+
+/* The CPU mask cannot change while a thread is runnable, so it is
+ * removed from the queue it was added to
+ */
+ALWAYS_INLINE void z_priq_mq_cpu_remove(struct _priq_mq_cpu *pq,
+					struct k_thread *thread)
+{
+	z_priq_mq_remove(priq_mq_cpu_queue(pq, thread), thread);
+}
+
+static struct k_thread *priq_mq_shared_best(struct _priq_mq *pq, int cpu)
+{
+	unsigned int bitmask = pq->bitmask;
+	struct k_thread *thread;
+
+	/* Threads allowed on every CPU match at the head of their list,
+	 * only partially masked ones make us look further
+	 */
+	while (bitmask != 0U) {
+		int prio = __builtin_ctz(bitmask);
+
+		SYS_DLIST_FOR_EACH_CONTAINER(&pq->queues[prio], thread,
+					     base.qnode_dlist) {
+			if ((thread->base.cpu_mask & BIT(cpu)) != 0) {
+				return thread;
+			}
+		}
+		bitmask &= ~BIT(prio);
+	}
+	return NULL;
+}
+
+struct k_thread *z_priq_mq_cpu_best(struct _priq_mq_cpu *pq)
+{
+	int cpu = _current_cpu->id;
+	struct k_thread *local = z_priq_mq_best(&pq->cpu[cpu]);
+	struct k_thread *shared = priq_mq_shared_best(&pq->shared, cpu);
+	int32_t cmp;
+
+	if (local == NULL || shared == NULL) {
+		return (local != NULL) ? local : shared;
+	}
+
+	cmp = z_sched_prio_cmp(local, shared);
+	if (cmp == 0) {
+		/* Same priority: the one queued first */
+		cmp = (int32_t)(shared->base.order_key - local->base.order_key);
+	}
+	return (cmp > 0) ? local : shared;
+}
+#endif
+
 int z_unpend_all(_wait_q_t *wait_q)
 {
 	int need_sched = 0;
@@ -1095,7 +1173,14 @@ void z_sched_init(void)
 	};
 #endif
 
-#ifdef CONFIG_SCHED_MULTIQ
+#if defined(CONFIG_SCHED_MULTIQ) && defined(CONFIG_SCHED_CPU_MASK)
+	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.shared.queues); i++) {
+		sys_dlist_init(&_kernel.ready_q.runq.shared.queues[i]);
+		for (int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+			sys_dlist_init(&_kernel.ready_q.runq.cpu[cpu].queues[i]);
+		}
+	}
+#elif defined(CONFIG_SCHED_MULTIQ)
 	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
 		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
 	}
@@ -1478,7 +1563,7 @@ static void end_thread(struct k_thread *thread)
 		unpend_all(&thread->join_queue);
 		update_cache(1);
 
-		SYS_PORT_TRACING_FUNC(k_thread, sched_abort, thread);
+		SYS_PORT_TRACING_OBJ_FUNC(k_thread, sched_abort, thread);
 
 		z_thread_monitor_exit(thread);
 
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <string.h>
+#include <timing/timing.h>
+
+static struct k_spinlock latency_lock;
+
+/* Statistics of each priority level, indexed from the highest priority */
+static k_sched_latency_stats_t prio_stats[K_NUM_PRIORITIES];
+
+static void hist_add(struct k_sched_latency_hist *hist, uint64_t cycles)
+{
+	unsigned int bucket = 0U;
+
+	if (cycles > 1U) {
+		bucket = 63U - __builtin_clzll(cycles);
+	}
+
+	hist->buckets[MIN(bucket, CONFIG_SCHED_LATENCY_BUCKETS - 1)]++;
+
+	if (cycles > hist->max_cycles) {
+		hist->max_cycles = cycles;
+	}
+}
+
+/* Called with the scheduler lock held when a thread is added to the run
+ * queue. A thread which was made ready, then pended again before it could
+ * run, is stamped again the next time it is made ready.
+ */
+void z_sched_latency_mark_ready(struct k_thread *thread)
+{
+	thread->sched_latency.ready_stamp = timing_counter_get();
+	thread->sched_latency.readied = true;
+	thread->sched_latency.ready_from_isr = k_is_in_isr();
+}
+
+/* Called with interrupts locked when _current has just been switched in */
+void z_sched_latency_mark_switched_in(void)
+{
+	struct k_thread *thread = _current;
+	struct _thread_sched_latency *latency = &thread->sched_latency;
+	int prio = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+	k_sched_latency_stats_t *stats;
+	k_spinlock_key_t key;
+	uint64_t cycles;
+	timing_t now;
+
+	if (!latency->readied) {
+		/* Preempted thread resumed, or not made ready through the
+		 * scheduler
+		 */
+		return;
+	}
+
+	now = timing_counter_get();
+	cycles = timing_cycles_get(&latency->ready_stamp, &now);
+	latency->readied = false;
+
+	key = k_spin_lock(&latency_lock);
+
+	stats = &latency->stats;
+	if (latency->ready_from_isr) {
+		hist_add(&stats->isr, cycles);
+	} else {
+		hist_add(&stats->wakeup, cycles);
+	}
+
+	if (prio >= 0 && prio < K_NUM_PRIORITIES) {
+		stats = &prio_stats[prio];
+		if (latency->ready_from_isr) {
+			hist_add(&stats->isr, cycles);
+		} else {
+			hist_add(&stats->wakeup, cycles);
+		}
+	}
+
+	k_spin_unlock(&latency_lock, key);
+}
+
+int k_thread_sched_latency_get(k_tid_t thread,
+			       k_sched_latency_stats_t *stats)
+{
+	k_spinlock_key_t key;
+
+	if ((thread == NULL) || (stats == NULL)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&latency_lock);
+	(void)memcpy(stats, &thread->sched_latency.stats, sizeof(*stats));
+	k_spin_unlock(&latency_lock, key);
+
+	return 0;
+}
+
+int k_sched_latency_prio_get(int prio, k_sched_latency_stats_t *stats)
+{
+	k_spinlock_key_t key;
+
+	if ((stats == NULL) || (prio < K_HIGHEST_THREAD_PRIO) ||
+	    (prio > K_LOWEST_THREAD_PRIO)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&latency_lock);
+	(void)memcpy(stats, &prio_stats[prio - K_HIGHEST_THREAD_PRIO],
+		     sizeof(*stats));
+	k_spin_unlock(&latency_lock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_THREAD_MONITOR
+static void thread_stats_reset(const struct k_thread *thread, void *user_data)
+{
+	struct k_thread *t = (struct k_thread *)thread;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(user_data);
+
+	key = k_spin_lock(&latency_lock);
+	(void)memset(&t->sched_latency.stats, 0, sizeof(t->sched_latency.stats));
+	k_spin_unlock(&latency_lock, key);
+}
+#endif
+
+void k_sched_latency_reset(void)
+{
+	k_spinlock_key_t key;
+
+#ifdef CONFIG_THREAD_MONITOR
+	k_thread_foreach(thread_stats_reset, NULL);
+#endif
+
+	key = k_spin_lock(&latency_lock);
+	(void)memset(prio_stats, 0, sizeof(prio_stats));
+	k_spin_unlock(&latency_lock, key);
+}
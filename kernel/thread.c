@@ -33,6 +33,7 @@ LOG_MODULE_DECLARE(os, CONFIG_KERNEL_LOG_LEVEL);
 
 #ifdef CONFIG_THREAD_RUNTIME_STATS
 k_thread_runtime_stats_t threads_runtime_stats;
+k_cpu_runtime_stats_t z_cpu_runtime_stats[CONFIG_MP_NUM_CPUS];
 #endif
 
 #ifdef CONFIG_THREAD_MONITOR
@@ -609,6 +610,11 @@ char *z_setup_new_thread(struct k_thread *new_thread,
 	memset(&new_thread->rt_stats, 0, sizeof(new_thread->rt_stats));
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY_STATS
+	memset(&new_thread->sched_latency, 0,
+	       sizeof(new_thread->sched_latency));
+#endif
+
 	return stack_ptr;
 }
 
@@ -1019,6 +1025,10 @@ void z_thread_mark_switched_in(void)
 #endif /* CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS */
 
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
+
+#ifdef CONFIG_SCHED_LATENCY_STATS
+	z_sched_latency_mark_switched_in();
+#endif
 }
 
 void z_thread_mark_switched_out(void)
@@ -1032,6 +1042,7 @@ void z_thread_mark_switched_out(void)
 
 	uint64_t diff;
 	struct k_thread *thread;
+	int cpu;
 
 	thread = k_current_get();
 
@@ -1057,6 +1068,18 @@ void z_thread_mark_switched_out(void)
 	thread->rt_stats.stats.execution_cycles += diff;
 
 	threads_runtime_stats.execution_cycles += diff;
+
+	cpu = _current_cpu->id;
+#ifdef CONFIG_SMP
+	thread->rt_stats.stats.cpu_cycles[cpu] += diff;
+	threads_runtime_stats.cpu_cycles[cpu] += diff;
+#endif
+
+	if (z_is_idle_thread_object(thread)) {
+		z_cpu_runtime_stats[cpu].idle_cycles += diff;
+	} else {
+		z_cpu_runtime_stats[cpu].execution_cycles += diff;
+	}
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
 
 #ifdef CONFIG_TRACING
@@ -1089,6 +1112,18 @@ int k_thread_runtime_stats_all_get(k_thread_runtime_stats_t *stats)
 
 	return 0;
 }
+
+int k_cpu_runtime_stats_get(int cpu, k_cpu_runtime_stats_t *stats)
+{
+	if ((stats == NULL) || (cpu < 0) || (cpu >= CONFIG_MP_NUM_CPUS)) {
+		return -EINVAL;
+	}
+
+	(void)memcpy(stats, &z_cpu_runtime_stats[cpu],
+		     sizeof(z_cpu_runtime_stats[cpu]));
+
+	return 0;
+}
 #endif /* CONFIG_THREAD_RUNTIME_STATS */
 
 #endif /* CONFIG_INSTRUMENT_THREAD_SWITCHING */
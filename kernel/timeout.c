@@ -14,8 +14,6 @@
 
 static uint64_t curr_tick;
 
-static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
-
 static struct k_spinlock timeout_lock;
 
 #define MAX_WAIT (IS_ENABLED(CONFIG_SYSTEM_CLOCK_SLOPPY_IDLE) \
@@ -36,6 +34,210 @@ static inline int z_vrfy_sys_clock_hw_cycles_per_sec_runtime_get(void)
 #endif /* CONFIG_USERSPACE */
 #endif /* CONFIG_TIMER_READS_ITS_FREQUENCY_AT_RUNTIME */
 
+static int32_t elapsed(void)
+{
+	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
+}
+
+#ifdef CONFIG_TIMEOUT_QUEUE_WHEEL
+
+/* Hierarchical timer wheel.  The dticks field of a queued timeout
+ * holds its absolute expiry tick.  A timeout is stored at the lowest
+ * level whose range still includes both its expiry and wheel_base,
+ * i.e. level L holds the timeouts whose expiry differs from wheel_base
+ * in bits [L * WHEEL_BITS, (L + 1) * WHEEL_BITS) but not above, in the
+ * slot given by those bits of the expiry.  All timeouts in a level 0
+ * slot thus expire on the same tick, and the timeouts of a lower level
+ * always expire before the ones of a higher level.
+ *
+ * wheel_base lags behind curr_tick: it only moves forward when a slot
+ * above level 0 that has become due is cascaded, i.e. its timeouts are
+ * redistributed to the lower levels.  This keeps the position of every
+ * queued timeout computable from its expiry and wheel_base alone.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS BIT(WHEEL_BITS)
+#define WHEEL_LEVELS CONFIG_TIMEOUT_QUEUE_WHEEL_LEVELS
+
+/* List heads are initialized when a slot becomes used */
+static sys_dlist_t wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint64_t wheel_used[WHEEL_LEVELS];
+static sys_dlist_t wheel_overflow = SYS_DLIST_STATIC_INIT(&wheel_overflow);
+static uint64_t wheel_base;
+
+/* Returns WHEEL_LEVELS for timeouts on the overflow list */
+static int wheel_level(uint64_t expiry)
+{
+	uint64_t diff = (expiry ^ wheel_base) >> WHEEL_BITS;
+	int level = 0;
+
+	while (diff != 0U && level < WHEEL_LEVELS) {
+		diff >>= WHEEL_BITS;
+		level++;
+	}
+
+	return level;
+}
+
+static int wheel_slot(uint64_t expiry, int level)
+{
+	return (expiry >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1);
+}
+
+static void wheel_insert(struct _timeout *to)
+{
+	int level = wheel_level(to->dticks);
+	int slot;
+
+	if (level == WHEEL_LEVELS) {
+		sys_dlist_append(&wheel_overflow, &to->node);
+		return;
+	}
+
+	slot = wheel_slot(to->dticks, level);
+	if ((wheel_used[level] & BIT64(slot)) == 0U) {
+		wheel_used[level] |= BIT64(slot);
+		sys_dlist_init(&wheel[level][slot]);
+	}
+
+	sys_dlist_append(&wheel[level][slot], &to->node);
+}
+
+static bool wheel_is_empty(void)
+{
+	for (int level = 0; level < WHEEL_LEVELS; level++) {
+		if (wheel_used[level] != 0U) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* With no timeout left in the wheel itself, wheel_base can catch up
+ * with curr_tick.  The overflow timeouts only need to be redistributed
+ * when this moves wheel_base to a new range of the top level.
+ */
+static void wheel_rebase(void)
+{
+	uint64_t old_base = wheel_base;
+	sys_dlist_t overflow;
+	sys_dnode_t *node;
+
+	if (!wheel_is_empty()) {
+		return;
+	}
+
+	wheel_base = curr_tick;
+
+	if (wheel_level(old_base) == WHEEL_LEVELS &&
+	    !sys_dlist_is_empty(&wheel_overflow)) {
+		sys_dlist_init(&overflow);
+		while ((node = sys_dlist_get(&wheel_overflow)) != NULL) {
+			sys_dlist_append(&overflow, node);
+		}
+		while ((node = sys_dlist_get(&overflow)) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+	}
+}
+
+static struct _timeout *list_min(sys_dlist_t *list)
+{
+	struct _timeout *t, *min = NULL;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(list, t, node) {
+		if (min == NULL || t->dticks < min->dticks) {
+			min = t;
+		}
+	}
+
+	return min;
+}
+
+static struct _timeout *first(void)
+{
+	sys_dlist_t *list;
+	sys_dnode_t *node;
+	uint64_t due;
+	int level, slot;
+
+	wheel_rebase();
+
+	for (level = 0; level < WHEEL_LEVELS; level++) {
+		if (wheel_used[level] == 0U) {
+			continue;
+		}
+
+		slot = __builtin_ctzll(wheel_used[level]);
+		list = &wheel[level][slot];
+
+		if (level == 0) {
+			node = sys_dlist_peek_head(list);
+			return CONTAINER_OF(node, struct _timeout, node);
+		}
+
+		/* Tick at which the slot range starts */
+		due = wheel_base & ~(BIT64((level + 1) * WHEEL_BITS) - 1U);
+		due |= (uint64_t)slot << (level * WHEEL_BITS);
+
+		if (due > curr_tick) {
+			return list_min(list);
+		}
+
+		/* Cascade the slot to the lower levels and start over
+		 * from there.
+		 */
+		wheel_used[level] &= ~BIT64(slot);
+		wheel_base = due;
+		while ((node = sys_dlist_get(list)) != NULL) {
+			wheel_insert(CONTAINER_OF(node, struct _timeout, node));
+		}
+		level = -1;
+	}
+
+	return list_min(&wheel_overflow);
+}
+
+static void remove_timeout(struct _timeout *t)
+{
+	int level = wheel_level(t->dticks);
+	int slot;
+
+	sys_dlist_remove(&t->node);
+
+	if (level < WHEEL_LEVELS) {
+		slot = wheel_slot(t->dticks, level);
+		if (sys_dlist_is_empty(&wheel[level][slot])) {
+			wheel_used[level] &= ~BIT64(slot);
+		}
+	}
+}
+
+/* to->dticks holds the ticks to wait from curr_tick */
+static void insert_timeout(struct _timeout *to)
+{
+	wheel_rebase();
+	to->dticks += curr_tick;
+	wheel_insert(to);
+}
+
+/* Ticks from curr_tick until the timeout expires, must be locked */
+static k_ticks_t timeout_ticks(const struct _timeout *timeout)
+{
+	return timeout->dticks - curr_tick;
+}
+
+/* Expiries are absolute, nothing to update when time moves forward */
+static void queue_advance(k_ticks_t ticks)
+{
+	ARG_UNUSED(ticks);
+}
+
+#else /* CONFIG_TIMEOUT_QUEUE_DUMB */
+
+static sys_dlist_t timeout_list = SYS_DLIST_STATIC_INIT(&timeout_list);
+
 static struct _timeout *first(void)
 {
 	sys_dnode_t *t = sys_dlist_peek_head(&timeout_list);
@@ -59,17 +261,58 @@ static void remove_timeout(struct _timeout *t)
 	sys_dlist_remove(&t->node);
 }
 
-static int32_t elapsed(void)
+/* to->dticks holds the ticks to wait from curr_tick */
+static void insert_timeout(struct _timeout *to)
 {
-	return announce_remaining == 0 ? sys_clock_elapsed() : 0U;
+	struct _timeout *t;
+
+	for (t = first(); t != NULL; t = next(t)) {
+		if (t->dticks > to->dticks) {
+			t->dticks -= to->dticks;
+			sys_dlist_insert(&t->node, &to->node);
+			break;
+		}
+		to->dticks -= t->dticks;
+	}
+
+	if (t == NULL) {
+		sys_dlist_append(&timeout_list, &to->node);
+	}
+}
+
+/* Ticks from curr_tick until the timeout expires, must be locked */
+static k_ticks_t timeout_ticks(const struct _timeout *timeout)
+{
+	k_ticks_t ticks = 0;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		ticks += t->dticks;
+		if (timeout == t) {
+			break;
+		}
+	}
+
+	return ticks;
+}
+
+/* Moves the queue forward by at most the ticks left until the first
+ * timeout expires
+ */
+static void queue_advance(k_ticks_t ticks)
+{
+	if (first() != NULL) {
+		first()->dticks -= ticks;
+	}
 }
 
+#endif /* CONFIG_TIMEOUT_QUEUE_WHEEL */
+
 static int32_t next_timeout(void)
 {
 	struct _timeout *to = first();
 	int32_t ticks_elapsed = elapsed();
 	int32_t ret = to == NULL ? MAX_WAIT
-		: CLAMP(to->dticks - ticks_elapsed, 0, MAX_WAIT);
+		: CLAMP(timeout_ticks(to) - ticks_elapsed, 0, MAX_WAIT);
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -94,8 +337,6 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 	to->fn = fn;
 
 	LOCKED(&timeout_lock) {
-		struct _timeout *t;
-
 		if (IS_ENABLED(CONFIG_TIMEOUT_64BIT) &&
 		    Z_TICK_ABS(timeout.ticks) >= 0) {
 			k_ticks_t ticks = Z_TICK_ABS(timeout.ticks) - curr_tick;
@@ -105,18 +346,7 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 			to->dticks = timeout.ticks + 1 + elapsed();
 		}
 
-		for (t = first(); t != NULL; t = next(t)) {
-			if (t->dticks > to->dticks) {
-				t->dticks -= to->dticks;
-				sys_dlist_insert(&t->node, &to->node);
-				break;
-			}
-			to->dticks -= t->dticks;
-		}
-
-		if (t == NULL) {
-			sys_dlist_append(&timeout_list, &to->node);
-		}
+		insert_timeout(to);
 
 		if (to == first()) {
 #if CONFIG_TIMESLICING
@@ -158,20 +388,11 @@ int z_abort_timeout(struct _timeout *to)
 /* must be locked */
 static k_ticks_t timeout_rem(const struct _timeout *timeout)
 {
-	k_ticks_t ticks = 0;
-
 	if (z_is_inactive_timeout(timeout)) {
 		return 0;
 	}
 
-	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
-		ticks += t->dticks;
-		if (timeout == t) {
-			break;
-		}
-	}
-
-	return ticks - elapsed();
+	return timeout_ticks(timeout) - elapsed();
 }
 
 k_ticks_t z_timeout_remaining(const struct _timeout *timeout)
@@ -240,13 +461,13 @@ void sys_clock_announce(int32_t ticks)
 
 	announce_remaining = ticks;
 
-	while (first() != NULL && first()->dticks <= announce_remaining) {
+	while (first() != NULL && timeout_ticks(first()) <= announce_remaining) {
 		struct _timeout *t = first();
-		int dt = t->dticks;
+		int dt = timeout_ticks(t);
 
+		queue_advance(dt);
 		curr_tick += dt;
 		announce_remaining -= dt;
-		t->dticks = 0;
 		remove_timeout(t);
 
 		k_spin_unlock(&timeout_lock, key);
@@ -254,10 +475,7 @@ void sys_clock_announce(int32_t ticks)
 		key = k_spin_lock(&timeout_lock);
 	}
 
-	if (first() != NULL) {
-		first()->dticks -= announce_remaining;
-	}
-
+	queue_advance(announce_remaining);
 	curr_tick += announce_remaining;
 	announce_remaining = 0;
 
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <ksched.h>
+#include <kernel_internal.h>
+#include <timing/timing.h>
+
+/* CPU usage averages.  Once a second the execution cycles of each thread
+ * and CPU are sampled, the usage over the last second is computed and
+ * folded into exponentially decaying averages over 10 and 60 seconds, in
+ * the same way as the load averages of Unix.  The context switch path is
+ * not involved: the cycles of a thread which is running when the sample is
+ * taken are computed from the time it was switched in.
+ */
+
+#define USAGE_PERIOD K_SECONDS(1)
+#define USAGE_FULL 10000U
+#define USAGE_SHIFT 10
+
+/* 1024 * (1 - exp(-1 / window)), window in seconds */
+static const uint32_t usage_decay[K_THREAD_USAGE_WINDOWS] = {
+	1024, /* 1 s */
+	97, /* 10 s */
+	17, /* 60 s */
+};
+
+extern k_cpu_runtime_stats_t z_cpu_runtime_stats[CONFIG_MP_NUM_CPUS];
+
+static uint64_t cpu_sampled_cycles[CONFIG_MP_NUM_CPUS];
+static uint32_t cpu_usage_avg[CONFIG_MP_NUM_CPUS][K_THREAD_USAGE_WINDOWS];
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+static timing_t last_sample;
+
+static uint64_t usage_elapsed(timing_t *now)
+{
+	*now = timing_counter_get();
+
+	return timing_cycles_get(&last_sample, now);
+}
+
+static uint64_t running_cycles(struct k_thread *thread, timing_t *now)
+{
+	return timing_cycles_get(&thread->rt_stats.last_switched_in, now);
+}
+#else
+static uint32_t last_sample;
+
+static uint64_t usage_elapsed(uint32_t *now)
+{
+	*now = k_cycle_get_32();
+
+	return *now - last_sample;
+}
+
+static uint64_t running_cycles(struct k_thread *thread, uint32_t *now)
+{
+	uint32_t switched_in = thread->rt_stats.last_switched_in;
+
+	return (switched_in == 0U) ? 0U : (uint32_t)(*now - switched_in);
+}
+#endif
+
+struct usage_sample {
+	uint64_t elapsed;
+#ifdef CONFIG_THREAD_RUNTIME_STATS_USE_TIMING_FUNCTIONS
+	timing_t now;
+#else
+	uint32_t now;
+#endif
+};
+
+static void usage_update(uint32_t *avg, uint16_t *usage, uint64_t *sampled,
+			 uint64_t cycles, uint64_t elapsed)
+{
+	int64_t sample = 0;
+
+	/* The cycles of a thread which was switched out on another CPU
+	 * while being sampled may have been counted twice
+	 */
+	if (cycles > *sampled) {
+		sample = MIN((cycles - *sampled) * USAGE_FULL / elapsed,
+			     USAGE_FULL);
+	}
+	*sampled = cycles;
+
+	sample <<= USAGE_SHIFT;
+
+	for (int i = 0; i < K_THREAD_USAGE_WINDOWS; i++) {
+		avg[i] += ((sample - (int64_t)avg[i]) * usage_decay[i]) >>
+			  USAGE_SHIFT;
+		usage[i] = avg[i] >> USAGE_SHIFT;
+	}
+}
+
+/* Cycles the thread has run for, including its current time slice */
+static uint64_t thread_cycles(struct k_thread *thread, struct usage_sample *s)
+{
+	uint64_t cycles = thread->rt_stats.stats.execution_cycles;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (_kernel.cpus[i].current == thread) {
+			cycles += running_cycles(thread, &s->now);
+			break;
+		}
+	}
+
+	return cycles;
+}
+
+static void thread_sample(const struct k_thread *cthread, void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	struct _thread_runtime_stats *rt = &thread->rt_stats;
+	struct usage_sample *s = user_data;
+
+	usage_update(rt->usage_avg, rt->stats.usage, &rt->sampled_cycles,
+		     thread_cycles(thread, s), s->elapsed);
+}
+
+static void cpu_sample(int cpu, struct usage_sample *s)
+{
+	k_cpu_runtime_stats_t *stats = &z_cpu_runtime_stats[cpu];
+	struct k_thread *current = _kernel.cpus[cpu].current;
+	uint64_t cycles = stats->execution_cycles;
+
+	if (current != NULL && !z_is_idle_thread_object(current)) {
+		cycles += running_cycles(current, &s->now);
+	}
+
+	usage_update(cpu_usage_avg[cpu], stats->usage, &cpu_sampled_cycles[cpu],
+		     cycles, s->elapsed);
+}
+
+static void usage_timer_expiry(struct k_timer *timer)
+{
+	struct usage_sample s;
+
+	ARG_UNUSED(timer);
+
+	s.elapsed = usage_elapsed(&s.now);
+	if (s.elapsed == 0U) {
+		return;
+	}
+
+	k_thread_foreach(thread_sample, &s);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cpu_sample(i, &s);
+	}
+
+	last_sample = s.now;
+}
+
+static K_TIMER_DEFINE(usage_timer, usage_timer_expiry, NULL);
+
+void z_thread_usage_init(void)
+{
+	struct usage_sample s;
+
+	(void)usage_elapsed(&s.now);
+	last_sample = s.now;
+
+	k_timer_start(&usage_timer, USAGE_PERIOD, USAGE_PERIOD);
+}
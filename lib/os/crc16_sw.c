@@ -6,6 +6,8 @@
 
 #include <sys/crc.h>
 
+#include "crc_internal.h"
+
 uint16_t crc16(const uint8_t *src, size_t len, uint16_t polynomial,
 	    uint16_t initial_value, bool pad)
 {
@@ -37,6 +39,16 @@ uint16_t crc16(const uint8_t *src, size_t len, uint16_t polynomial,
 
 uint16_t crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len)
 {
+	uint32_t crc = seed;
+
+	if (z_crc_hw_update(CRC_TYPE_CRC16_CCITT, &crc, src, len)) {
+		return (uint16_t)crc;
+	}
+
+#ifdef CRC16_CCITT_SLICES
+	return crc16_slice_update(crc16_ccitt_slice_table, CRC16_CCITT_SLICES,
+				  seed, src, len);
+#else
 	for (; len > 0; len--) {
 		uint8_t e, f;
 
@@ -46,10 +58,21 @@ uint16_t crc16_ccitt(uint16_t seed, const uint8_t *src, size_t len)
 	}
 
 	return seed;
+#endif
 }
 
 uint16_t crc16_itu_t(uint16_t seed, const uint8_t *src, size_t len)
 {
+	uint32_t crc = seed;
+
+	if (z_crc_hw_update(CRC_TYPE_CRC16_ITU_T, &crc, src, len)) {
+		return (uint16_t)crc;
+	}
+
+#ifdef CRC16_ITU_T_SLICES
+	return crc16_be_slice_update(crc16_itu_t_slice_table,
+				     CRC16_ITU_T_SLICES, seed, src, len);
+#else
 	for (; len > 0; len--) {
 		seed = (seed >> 8U) | (seed << 8U);
 		seed ^= *src++;
@@ -59,4 +82,5 @@ uint16_t crc16_itu_t(uint16_t seed, const uint8_t *src, size_t len)
 	}
 
 	return seed;
+#endif
 }
@@ -6,6 +6,8 @@
 
 #include <sys/crc.h>
 
+#include "crc_internal.h"
+
 uint32_t crc32_ieee(const uint8_t *data, size_t len)
 {
 	return crc32_ieee_update(0x0, data, len);
@@ -13,6 +15,16 @@ uint32_t crc32_ieee(const uint8_t *data, size_t len)
 
 uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
 {
+#ifdef CRC32_IEEE_SLICES
+	crc = ~crc;
+
+	if (!z_crc_hw_update(CRC_TYPE_CRC32_IEEE, &crc, data, len)) {
+		crc = crc32_slice_update(crc32_ieee_slice_table,
+					 CRC32_IEEE_SLICES, crc, data, len);
+	}
+
+	return (~crc);
+#else
 	/* crc table generated from polynomial 0xedb88320 */
 	static const uint32_t table[16] = {
 		0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
@@ -23,6 +35,10 @@ uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
 
 	crc = ~crc;
 
+	if (z_crc_hw_update(CRC_TYPE_CRC32_IEEE, &crc, data, len)) {
+		return (~crc);
+	}
+
 	for (size_t i = 0; i < len; i++) {
 		uint8_t byte = data[i];
 
@@ -31,4 +47,5 @@ uint32_t crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
 	}
 
 	return (~crc);
+#endif
 }
@@ -0,0 +1,14 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sys/crc.h>
+
+crc_hw_handler_t z_crc_hw_handler;
+
+void crc_hw_handler_set(crc_hw_handler_t handler)
+{
+	z_crc_hw_handler = handler;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_LIB_OS_CRC_INTERNAL_H_
+#define ZEPHYR_LIB_OS_CRC_INTERNAL_H_
+
+#include <sys/crc.h>
+#include <sys/byteorder.h>
+#include <toolchain.h>
+
+#include "crc_tables.h"
+
+/* Slice-by-N updates: each table k of a CRC gives the contribution of a
+ * byte followed by k zero bytes, so that the lookups of N bytes do not
+ * depend on each other and the CRC is folded in once per N bytes.
+ */
+
+static ALWAYS_INLINE uint32_t crc32_slice_update(const uint32_t (*table)[256],
+						 size_t slices, uint32_t crc,
+						 const uint8_t *data,
+						 size_t len)
+{
+	for (; len >= slices; data += slices, len -= slices) {
+		uint32_t one = sys_get_le32(data) ^ crc;
+
+		if (slices == 8U) {
+			uint32_t two = sys_get_le32(data + 4);
+
+			crc = table[7][one & 0xff] ^
+			      table[6][(one >> 8) & 0xff] ^
+			      table[5][(one >> 16) & 0xff] ^
+			      table[4][one >> 24] ^
+			      table[3][two & 0xff] ^
+			      table[2][(two >> 8) & 0xff] ^
+			      table[1][(two >> 16) & 0xff] ^
+			      table[0][two >> 24];
+		} else {
+			crc = table[3][one & 0xff] ^
+			      table[2][(one >> 8) & 0xff] ^
+			      table[1][(one >> 16) & 0xff] ^
+			      table[0][one >> 24];
+		}
+	}
+
+	for (; len > 0; len--) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
+	}
+
+	return crc;
+}
+
+/* Reflected 16 bit CRCs only differ from 32 bit ones by the table type */
+static ALWAYS_INLINE uint16_t crc16_slice_update(const uint16_t (*table)[256],
+						 size_t slices, uint16_t crc,
+						 const uint8_t *data,
+						 size_t len)
+{
+	for (; len >= slices; data += slices, len -= slices) {
+		uint32_t one = sys_get_le32(data) ^ crc;
+
+		if (slices == 8U) {
+			uint32_t two = sys_get_le32(data + 4);
+
+			crc = table[7][one & 0xff] ^
+			      table[6][(one >> 8) & 0xff] ^
+			      table[5][(one >> 16) & 0xff] ^
+			      table[4][one >> 24] ^
+			      table[3][two & 0xff] ^
+			      table[2][(two >> 8) & 0xff] ^
+			      table[1][(two >> 16) & 0xff] ^
+			      table[0][two >> 24];
+		} else {
+			crc = table[3][one & 0xff] ^
+			      table[2][(one >> 8) & 0xff] ^
+			      table[1][(one >> 16) & 0xff] ^
+			      table[0][one >> 24];
+		}
+	}
+
+	for (; len > 0; len--) {
+		crc = (crc >> 8) ^ table[0][(crc ^ *data++) & 0xff];
+	}
+
+	return crc;
+}
+
+/* Most significant bit first 16 bit CRCs: the CRC is folded into the
+ * first two bytes of each slice
+ */
+static ALWAYS_INLINE uint16_t crc16_be_slice_update(const uint16_t (*table)[256],
+						    size_t slices, uint16_t crc,
+						    const uint8_t *data,
+						    size_t len)
+{
+	for (; len >= slices; data += slices, len -= slices) {
+		uint8_t b0 = data[0] ^ (crc >> 8);
+		uint8_t b1 = data[1] ^ (crc & 0xff);
+
+		if (slices == 8U) {
+			crc = table[7][b0] ^ table[6][b1] ^
+			      table[5][data[2]] ^ table[4][data[3]] ^
+			      table[3][data[4]] ^ table[2][data[5]] ^
+			      table[1][data[6]] ^ table[0][data[7]];
+		} else {
+			crc = table[3][b0] ^ table[2][b1] ^
+			      table[1][data[2]] ^ table[0][data[3]];
+		}
+	}
+
+	for (; len > 0; len--) {
+		crc = (crc << 8) ^ table[0][((crc >> 8) ^ *data++) & 0xff];
+	}
+
+	return crc;
+}
+
+#ifdef CONFIG_CRC_HW
+extern crc_hw_handler_t z_crc_hw_handler;
+
+/* Returns true if the hardware has updated the CRC register */
+static inline bool z_crc_hw_update(enum crc_type type, uint32_t *crc,
+				   const uint8_t *data, size_t len)
+{
+	crc_hw_handler_t handler = z_crc_hw_handler;
+
+	return (handler != NULL) && (len >= CONFIG_CRC_HW_MIN_LEN) &&
+	       (handler(type, crc, data, len) == 0);
+}
+#else
+static inline bool z_crc_hw_update(enum crc_type type, uint32_t *crc,
+				   const uint8_t *data, size_t len)
+{
+	ARG_UNUSED(type);
+	ARG_UNUSED(crc);
+	ARG_UNUSED(data);
+	ARG_UNUSED(len);
+
+	return false;
+}
+#endif
+
+#endif /* ZEPHYR_LIB_OS_CRC_INTERNAL_H_ */
@@ -936,3 +936,758 @@ ssize_t json_calc_encoded_len(const struct json_obj_descr *descr,
 
 	return total;
 }
+
+#ifdef CONFIG_JSON_STREAMING
+
+BUILD_ASSERT(CONFIG_JSON_STREAMING_MAX_DEPTH <= 32,
+	     "Encoder nesting state is kept in 32 bit words");
+
+/* What the next character of a streamed payload belongs to */
+enum json_parser_lex {
+	JSON_LEX_TOKEN,
+	JSON_LEX_STRING,
+	JSON_LEX_ESCAPE,
+	JSON_LEX_UNICODE,
+	JSON_LEX_NUMBER,
+	JSON_LEX_LITERAL,
+};
+
+/* Which token is expected next, following the leniency of obj_next()
+ * and arr_next() about separators
+ */
+enum json_parser_state {
+	JSON_PS_START,
+	JSON_PS_OBJ_FIRST,
+	JSON_PS_OBJ_KEY,
+	JSON_PS_OBJ_COLON,
+	JSON_PS_OBJ_VALUE,
+	JSON_PS_OBJ_NEXT,
+	JSON_PS_ARR_FIRST,
+	JSON_PS_ARR_VALUE,
+	JSON_PS_ARR_NEXT,
+	JSON_PS_DONE,
+};
+
+void json_parser_init(struct json_parser *parser,
+		      const struct json_obj_descr *descr, size_t descr_len,
+		      void *val, char *str_buf, size_t str_buf_size)
+{
+	struct json_parser_frame *frame = &parser->stack[0];
+
+	__ASSERT_NO_MSG(descr_len < (sizeof(int) * CHAR_BIT - 1));
+
+	memset(parser, 0, sizeof(*parser));
+
+	frame->descr = descr;
+	frame->val = val;
+	frame->obj.descr_len = descr_len;
+	frame->obj.field = -1;
+
+	parser->depth = 1;
+	parser->state = JSON_PS_START;
+	parser->lex = JSON_LEX_TOKEN;
+	parser->str_buf = str_buf;
+	parser->str_buf_size = str_buf_size;
+}
+
+static inline struct json_parser_frame *parser_frame(struct json_parser *parser)
+{
+	return &parser->stack[parser->depth - 1];
+}
+
+static inline size_t *parser_arr_elements(struct json_parser_frame *frame)
+{
+	return (size_t *)((char *)frame->arr.parent + frame->descr->offset);
+}
+
+/* Finds the field, if any, the value of a new token is decoded to */
+static int parser_value_begin(struct json_parser *parser,
+			      enum json_tokens type)
+{
+	struct json_parser_frame *frame = parser_frame(parser);
+	const struct json_obj_descr *descr = NULL;
+	void *field = NULL;
+
+	switch (parser->state) {
+	case JSON_PS_OBJ_VALUE:
+		if (frame->obj.field >= 0) {
+			descr = &frame->descr[frame->obj.field];
+			field = (char *)frame->val + descr->offset;
+		}
+		break;
+	case JSON_PS_ARR_FIRST:
+	case JSON_PS_ARR_VALUE:
+	case JSON_PS_ARR_NEXT:
+		if (frame->descr != NULL) {
+			if (frame->val == frame->arr.last) {
+				return -ENOSPC;
+			}
+
+			descr = frame->descr;
+			field = frame->val;
+		}
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (descr != NULL && !equivalent_types(type, descr->type)) {
+		return -EINVAL;
+	}
+
+	parser->descr = descr;
+	parser->field = field;
+	parser->tok_type = type;
+
+	return 0;
+}
+
+static void parser_value_end(struct json_parser *parser)
+{
+	struct json_parser_frame *frame = parser_frame(parser);
+
+	if (frame->is_array) {
+		if (frame->descr != NULL) {
+			(*parser_arr_elements(frame))++;
+			frame->val = (char *)frame->val + frame->arr.elem_size;
+		}
+		parser->state = JSON_PS_ARR_NEXT;
+	} else {
+		if (frame->obj.field >= 0) {
+			frame->obj.decoded |= BIT(frame->obj.field);
+		}
+		parser->state = JSON_PS_OBJ_NEXT;
+	}
+}
+
+static int parser_push(struct json_parser *parser, bool is_array)
+{
+	const struct json_obj_descr *descr = parser->descr;
+	struct json_parser_frame *parent = parser_frame(parser);
+	struct json_parser_frame *frame;
+
+	if (parser->depth == ARRAY_SIZE(parser->stack)) {
+		return -ENOMEM;
+	}
+
+	frame = &parser->stack[parser->depth++];
+	frame->is_array = is_array;
+	frame->val = parser->field;
+
+	if (!is_array) {
+		frame->descr = (descr != NULL) ? descr->object.sub_descr : NULL;
+		frame->obj.descr_len =
+			(descr != NULL) ? descr->object.sub_descr_len : 0;
+		frame->obj.decoded = 0U;
+		frame->obj.field = -1;
+		parser->state = JSON_PS_OBJ_FIRST;
+
+		return 0;
+	}
+
+	/* As in arr_parse(), the element count lives in the struct holding
+	 * the outermost array
+	 */
+	frame->arr.parent = parent->is_array ? parent->arr.parent : parent->val;
+	frame->descr = NULL;
+	if (descr != NULL) {
+		frame->descr = descr->array.element_descr;
+		frame->arr.elem_size = get_elem_size(frame->descr);
+		frame->arr.last = (char *)frame->val +
+			frame->arr.elem_size * descr->array.n_elements;
+		*parser_arr_elements(frame) = 0;
+	}
+	parser->state = JSON_PS_ARR_FIRST;
+
+	return 0;
+}
+
+static void parser_pop(struct json_parser *parser)
+{
+	if (--parser->depth == 0U) {
+		parser->state = JSON_PS_DONE;
+		return;
+	}
+
+	parser_value_end(parser);
+}
+
+/* Narrows down the fields a key being received can match */
+static void parser_key_match(struct json_parser *parser, const char *run,
+			     size_t len)
+{
+	const struct json_obj_descr *descr = parser_frame(parser)->descr;
+	uint32_t match = parser->key_match;
+
+	while (match != 0U) {
+		int i = __builtin_ctz(match);
+
+		match &= match - 1U;
+		if (parser->tok_len + len > descr[i].field_name_len ||
+		    memcmp(descr[i].field_name + parser->tok_len, run, len)) {
+			parser->key_match &= ~BIT(i);
+		}
+	}
+}
+
+static void parser_key_end(struct json_parser *parser)
+{
+	struct json_parser_frame *frame = parser_frame(parser);
+	uint32_t match = parser->key_match;
+
+	frame->obj.field = -1;
+	while (match != 0U) {
+		int i = __builtin_ctz(match);
+
+		if (frame->descr[i].field_name_len == parser->tok_len) {
+			frame->obj.field = i;
+			break;
+		}
+		match &= match - 1U;
+	}
+
+	parser->state = JSON_PS_OBJ_COLON;
+}
+
+/* Contents of a string, stored as is since strings are not unescaped */
+static int parser_string_run(struct json_parser *parser, const char *run,
+			     size_t len)
+{
+	if (parser->is_key) {
+		parser_key_match(parser, run, len);
+	} else if (parser->field != NULL) {
+		/* Keep room for the terminating NUL */
+		if (len >= parser->str_buf_size - parser->str_used) {
+			return -ENOMEM;
+		}
+
+		memcpy(parser->str_buf + parser->str_used, run, len);
+		parser->str_used += len;
+	}
+
+	parser->tok_len += len;
+
+	return 0;
+}
+
+static int parser_string_begin(struct json_parser *parser, bool is_key)
+{
+	parser->is_key = is_key;
+	parser->tok_len = 0;
+	parser->lex = JSON_LEX_STRING;
+
+	if (is_key) {
+		struct json_parser_frame *frame = parser_frame(parser);
+
+		/* Fields decoded already are skipped, as in obj_parse() */
+		parser->key_match = BIT_MASK(frame->obj.descr_len) &
+				    ~frame->obj.decoded;
+		return 0;
+	}
+
+	if (parser->field != NULL) {
+		if (parser->str_used >= parser->str_buf_size) {
+			return -ENOMEM;
+		}
+		parser->str_start = parser->str_used;
+	}
+
+	return 0;
+}
+
+static void parser_string_end(struct json_parser *parser)
+{
+	parser->lex = JSON_LEX_TOKEN;
+
+	if (parser->is_key) {
+		parser_key_end(parser);
+		return;
+	}
+
+	if (parser->field != NULL) {
+		char **str = parser->field;
+
+		parser->str_buf[parser->str_used++] = '\0';
+		*str = parser->str_buf + parser->str_start;
+	}
+
+	parser_value_end(parser);
+}
+
+static int parser_number_char(struct json_parser *parser, char chr)
+{
+	if (parser->tok_len == 1U && parser->num[0] == '-' && !isdigit(chr)) {
+		return -EINVAL;
+	}
+
+	if (parser->tok_len < sizeof(parser->num) - 1) {
+		parser->num[parser->tok_len] = chr;
+	} else if (parser->field != NULL) {
+		return -ERANGE;
+	}
+	parser->tok_len++;
+
+	return 0;
+}
+
+static int parser_number_begin(struct json_parser *parser, char chr)
+{
+	int ret;
+
+	ret = parser_value_begin(parser, JSON_TOK_NUMBER);
+	if (ret < 0) {
+		return ret;
+	}
+
+	parser->tok_len = 0;
+	parser->lex = JSON_LEX_NUMBER;
+
+	return parser_number_char(parser, chr);
+}
+
+static int parser_number_end(struct json_parser *parser)
+{
+	parser->lex = JSON_LEX_TOKEN;
+
+	if (parser->tok_len == 1U && parser->num[0] == '-') {
+		return -EINVAL;
+	}
+
+	if (parser->field != NULL) {
+		int32_t *num = parser->field;
+		char *endptr;
+
+		parser->num[parser->tok_len] = '\0';
+
+		errno = 0;
+		*num = strtol(parser->num, &endptr, 10);
+
+		if (errno != 0) {
+			return -errno;
+		}
+
+		if (*endptr != '\0') {
+			return -EINVAL;
+		}
+	}
+
+	parser_value_end(parser);
+
+	return 0;
+}
+
+static int parser_token(struct json_parser *parser, char chr)
+{
+	int ret;
+
+	switch (chr) {
+	case '{':
+		if (parser->state == JSON_PS_START) {
+			parser->state = JSON_PS_OBJ_FIRST;
+			return 0;
+		}
+
+		ret = parser_value_begin(parser, JSON_TOK_OBJECT_START);
+		if (ret < 0) {
+			return ret;
+		}
+
+		return parser_push(parser, false);
+	case '[':
+		ret = parser_value_begin(parser, JSON_TOK_LIST_START);
+		if (ret < 0) {
+			return ret;
+		}
+
+		return parser_push(parser, true);
+	case '}':
+		if (parser->state != JSON_PS_OBJ_FIRST &&
+		    parser->state != JSON_PS_OBJ_NEXT) {
+			return -EINVAL;
+		}
+
+		parser_pop(parser);
+		return 0;
+	case ']':
+		if (parser->state != JSON_PS_ARR_FIRST &&
+		    parser->state != JSON_PS_ARR_NEXT) {
+			return -EINVAL;
+		}
+
+		parser_pop(parser);
+		return 0;
+	case ',':
+		if (parser->state == JSON_PS_OBJ_FIRST ||
+		    parser->state == JSON_PS_OBJ_NEXT) {
+			parser->state = JSON_PS_OBJ_KEY;
+		} else if (parser->state == JSON_PS_ARR_FIRST ||
+			   parser->state == JSON_PS_ARR_NEXT) {
+			parser->state = JSON_PS_ARR_VALUE;
+		} else {
+			return -EINVAL;
+		}
+
+		return 0;
+	case ':':
+		if (parser->state != JSON_PS_OBJ_COLON) {
+			return -EINVAL;
+		}
+
+		parser->state = JSON_PS_OBJ_VALUE;
+		return 0;
+	case '"':
+		if (parser->state == JSON_PS_OBJ_FIRST ||
+		    parser->state == JSON_PS_OBJ_KEY ||
+		    parser->state == JSON_PS_OBJ_NEXT) {
+			return parser_string_begin(parser, true);
+		}
+
+		ret = parser_value_begin(parser, JSON_TOK_STRING);
+		if (ret < 0) {
+			return ret;
+		}
+
+		return parser_string_begin(parser, false);
+	case 't':
+	case 'f':
+		ret = parser_value_begin(parser, (enum json_tokens)chr);
+		if (ret < 0) {
+			return ret;
+		}
+
+		parser->literal = (chr == 't') ? "rue" : "alse";
+		parser->lex = JSON_LEX_LITERAL;
+		return 0;
+	case '-':
+		return parser_number_begin(parser, chr);
+	default:
+		if (isdigit((unsigned char)chr)) {
+			return parser_number_begin(parser, chr);
+		}
+
+		if (isspace((unsigned char)chr)) {
+			return 0;
+		}
+
+		/* Including null, which json_obj_parse() refuses as well */
+		return -EINVAL;
+	}
+}
+
+static int parser_char(struct json_parser *parser, char chr)
+{
+	int ret;
+
+	switch (parser->lex) {
+	case JSON_LEX_STRING:
+		/* Other characters are consumed by parser_string_run() */
+		if (chr == '"') {
+			parser_string_end(parser);
+			return 0;
+		}
+
+		if (chr == '\\') {
+			parser->lex = JSON_LEX_ESCAPE;
+			return parser_string_run(parser, &chr, 1);
+		}
+
+		return -EINVAL;
+	case JSON_LEX_ESCAPE:
+		switch (chr) {
+		case '"':
+		case '\\':
+		case '/':
+		case 'b':
+		case 'f':
+		case 'n':
+		case 'r':
+		case 't':
+			parser->lex = JSON_LEX_STRING;
+			break;
+		case 'u':
+			parser->escape_len = 4U;
+			parser->lex = JSON_LEX_UNICODE;
+			break;
+		default:
+			return -EINVAL;
+		}
+
+		return parser_string_run(parser, &chr, 1);
+	case JSON_LEX_UNICODE:
+		if (!isxdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+
+		if (--parser->escape_len == 0U) {
+			parser->lex = JSON_LEX_STRING;
+		}
+
+		return parser_string_run(parser, &chr, 1);
+	case JSON_LEX_LITERAL:
+		if (chr != *parser->literal) {
+			return -EINVAL;
+		}
+
+		if (*++parser->literal == '\0') {
+			if (parser->field != NULL) {
+				bool *v = parser->field;
+
+				*v = parser->tok_type == JSON_TOK_TRUE;
+			}
+
+			parser->lex = JSON_LEX_TOKEN;
+			parser_value_end(parser);
+		}
+
+		return 0;
+	case JSON_LEX_NUMBER:
+		if (isdigit((unsigned char)chr) || chr == '.') {
+			return parser_number_char(parser, chr);
+		}
+
+		ret = parser_number_end(parser);
+		if (ret < 0) {
+			return ret;
+		}
+
+		/* The character ending a number starts the next token */
+		__fallthrough;
+	default:
+		return parser_token(parser, chr);
+	}
+}
+
+int json_parser_feed(struct json_parser *parser, const char *data,
+		     size_t len)
+{
+	const char *end = data + len;
+	int ret = parser->err;
+
+	while (ret == 0 && data < end && parser->state != JSON_PS_DONE) {
+		if (parser->lex == JSON_LEX_STRING) {
+			const char *run = data;
+
+			while (data < end && *data != '"' && *data != '\\' &&
+			       *data != '\0') {
+				data++;
+			}
+
+			if (data > run) {
+				ret = parser_string_run(parser, run,
+							(size_t)(data - run));
+			}
+
+			if (ret < 0 || data == end) {
+				break;
+			}
+		}
+
+		ret = parser_char(parser, *data++);
+	}
+
+	parser->err = ret;
+
+	return ret;
+}
+
+int json_parser_finish(struct json_parser *parser)
+{
+	if (parser->err < 0) {
+		return parser->err;
+	}
+
+	if (parser->state != JSON_PS_DONE) {
+		return -EINVAL;
+	}
+
+	return parser->stack[0].obj.decoded;
+}
+
+void json_encoder_init(struct json_encoder *encoder, char *buf, size_t size,
+		       json_append_bytes_t flush, void *data)
+{
+	memset(encoder, 0, sizeof(*encoder));
+
+	encoder->flush = flush;
+	encoder->data = data;
+	encoder->buf = buf;
+	encoder->size = (buf != NULL) ? size : 0;
+}
+
+int json_encoder_flush(struct json_encoder *encoder)
+{
+	int ret;
+
+	if (encoder->used == 0U) {
+		return 0;
+	}
+
+	ret = encoder->flush(encoder->buf, encoder->used, encoder->data);
+	encoder->used = 0;
+
+	return ret;
+}
+
+static int encoder_append(const char *bytes, size_t len, void *data)
+{
+	struct json_encoder *encoder = data;
+	size_t n;
+	int ret;
+
+	if (encoder->size == 0U) {
+		return encoder->flush(bytes, len, encoder->data);
+	}
+
+	while (len > 0) {
+		if (encoder->used == encoder->size) {
+			ret = json_encoder_flush(encoder);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		n = MIN(len, encoder->size - encoder->used);
+		memcpy(encoder->buf + encoder->used, bytes, n);
+		encoder->used += n;
+		bytes += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+/* Separator and key in front of a value added to the open container */
+static int encoder_member(struct json_encoder *encoder, const char *key)
+{
+	uint32_t level;
+	int ret;
+
+	if (encoder->depth == 0U) {
+		return (key == NULL) ? 0 : -EINVAL;
+	}
+
+	level = BIT(encoder->depth - 1);
+	if ((key == NULL) != ((encoder->in_array & level) != 0U)) {
+		return -EINVAL;
+	}
+
+	if (encoder->has_members & level) {
+		ret = encoder_append(",", 1, encoder);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+	encoder->has_members |= level;
+
+	if (key == NULL) {
+		return 0;
+	}
+
+	ret = str_encode(&key, encoder_append, encoder);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return encoder_append(":", 1, encoder);
+}
+
+static int encoder_start(struct json_encoder *encoder, const char *key,
+			 bool is_array)
+{
+	uint32_t level;
+	int ret;
+
+	if (encoder->depth == CONFIG_JSON_STREAMING_MAX_DEPTH) {
+		return -ENOMEM;
+	}
+
+	ret = encoder_member(encoder, key);
+	if (ret < 0) {
+		return ret;
+	}
+
+	level = BIT(encoder->depth++);
+	encoder->has_members &= ~level;
+	if (is_array) {
+		encoder->in_array |= level;
+	} else {
+		encoder->in_array &= ~level;
+	}
+
+	return encoder_append(is_array ? "[" : "{", 1, encoder);
+}
+
+static int encoder_end(struct json_encoder *encoder, bool is_array)
+{
+	if (encoder->depth == 0U ||
+	    ((encoder->in_array & BIT(encoder->depth - 1)) != 0U) != is_array) {
+		return -EINVAL;
+	}
+
+	encoder->depth--;
+
+	return encoder_append(is_array ? "]" : "}", 1, encoder);
+}
+
+int json_encoder_obj_start(struct json_encoder *encoder, const char *key)
+{
+	return encoder_start(encoder, key, false);
+}
+
+int json_encoder_obj_end(struct json_encoder *encoder)
+{
+	return encoder_end(encoder, false);
+}
+
+int json_encoder_arr_start(struct json_encoder *encoder, const char *key)
+{
+	return encoder_start(encoder, key, true);
+}
+
+int json_encoder_arr_end(struct json_encoder *encoder)
+{
+	return encoder_end(encoder, true);
+}
+
+int json_encoder_obj(struct json_encoder *encoder, const char *key,
+		     const struct json_obj_descr *descr, size_t descr_len,
+		     const void *val)
+{
+	int ret;
+
+	ret = encoder_member(encoder, key);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return json_obj_encode(descr, descr_len, val, encoder_append, encoder);
+}
+
+int json_encoder_fields(struct json_encoder *encoder,
+			const struct json_obj_descr *descr, size_t descr_len,
+			const void *val)
+{
+	size_t i;
+	int ret;
+
+	if (encoder->depth == 0U ||
+	    (encoder->in_array & BIT(encoder->depth - 1)) != 0U) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < descr_len; i++) {
+		ret = encoder_member(encoder, descr[i].field_name);
+		if (ret < 0) {
+			return ret;
+		}
+
+		ret = encode(&descr[i], val, encoder_append, encoder);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_JSON_STREAMING */
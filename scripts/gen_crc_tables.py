@@ -0,0 +1,112 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2021 Intellinium
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generate the slice-by-N CRC tables of lib/os/crc_tables.h
+
+Table k of a CRC gives the contribution of a byte followed by k zero
+bytes, so that N bytes can be folded into the CRC with N lookups and no
+dependency between them.
+
+Usage: gen_crc_tables.py > lib/os/crc_tables.h
+"""
+
+import sys
+
+SLICES = 8
+
+# name, Kconfig prefix, width, polynomial (reflected if lsb_first), lsb_first
+CRCS = [
+    ("crc32_ieee", "CRC32_IEEE", 32, 0xEDB88320, True),
+    ("crc32c", "CRC32C", 32, 0x82F63B78, True),
+    ("crc16_ccitt", "CRC16_CCITT", 16, 0x8408, True),
+    ("crc16_itu_t", "CRC16_ITU_T", 16, 0x1021, False),
+]
+
+HEADER = """/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Generated by scripts/gen_crc_tables.py, do not edit */
+
+#ifndef ZEPHYR_LIB_OS_CRC_TABLES_H_
+#define ZEPHYR_LIB_OS_CRC_TABLES_H_
+
+#include <zephyr/types.h>
+"""
+
+
+def byte_table(width, poly, lsb_first):
+    mask = (1 << width) - 1
+    table = []
+    for i in range(256):
+        if lsb_first:
+            c = i
+            for _ in range(8):
+                c = (c >> 1) ^ (poly if c & 1 else 0)
+        else:
+            c = i << (width - 8)
+            for _ in range(8):
+                top = c & (1 << (width - 1))
+                c = ((c << 1) & mask) ^ (poly if top else 0)
+        table.append(c)
+    return table
+
+
+def slice_tables(width, poly, lsb_first):
+    mask = (1 << width) - 1
+    tables = [byte_table(width, poly, lsb_first)]
+    for _ in range(1, SLICES):
+        prev = tables[-1]
+        if lsb_first:
+            tables.append([(c >> 8) ^ tables[0][c & 0xff] for c in prev])
+        else:
+            tables.append([((c << 8) & mask) ^ tables[0][c >> (width - 8)]
+                           for c in prev])
+    return tables
+
+
+def emit_table(out, table, width):
+    per_line = 4 if width == 32 else 8
+    digits = width // 4
+    out.append("\t{")
+    for i in range(0, 256, per_line):
+        row = ", ".join(f"0x{v:0{digits}x}" for v in table[i:i + per_line])
+        out.append(f"\t\t{row},")
+    out.append("\t},")
+
+
+def main():
+    out = [HEADER]
+    for name, prefix, width, poly, lsb_first in CRCS:
+        tables = slice_tables(width, poly, lsb_first)
+        macro = f"{prefix}_SLICES"
+        out.append(f"#if defined(CONFIG_{prefix}_SLICE_BY_8)")
+        out.append(f"#define {macro} 8")
+        out.append(f"#elif defined(CONFIG_{prefix}_SLICE_BY_4)")
+        out.append(f"#define {macro} 4")
+        out.append("#endif")
+        out.append("")
+        out.append(f"#ifdef {macro}")
+        order = "lsb first" if lsb_first else "msb first"
+        out.append(f"/* polynomial 0x{poly:0{width // 4}x}, {order} */")
+        out.append(f"static const uint{width}_t {name}_slice_table"
+                   f"[{macro}][256] = {{")
+        for k, table in enumerate(tables):
+            if k == 4:
+                out.append(f"#if {macro} == 8")
+            emit_table(out, table, width)
+        out.append("#endif")
+        out.append("};")
+        out.append(f"#endif /* {macro} */")
+        out.append("")
+    out.append("#endif /* ZEPHYR_LIB_OS_CRC_TABLES_H_ */")
+    sys.stdout.write("\n".join(out) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -187,6 +187,11 @@ def process_kconfigs(elf, database):
         database.add_kconfig("CONFIG_LOG_TIMESTAMP_64BIT",
                              kconfigs['CONFIG_LOG_TIMESTAMP_64BIT'])
 
+    # Compact encoding of log messages?
+    if "CONFIG_LOG_DICTIONARY_COMPACT" in kconfigs:
+        database.add_kconfig("CONFIG_LOG_DICTIONARY_COMPACT",
+                             kconfigs['CONFIG_LOG_DICTIONARY_COMPACT'])
+
 
 def extract_static_string_sections(elf, database):
     """Extract sections containing static strings"""
@@ -56,6 +56,16 @@ MSG_TYPE_DROPPED = 1
 # Number of dropped messages
 FMT_DROPPED_CNT = "H"
 
+# Compact encoding (CONFIG_LOG_DICTIONARY_COMPACT), keep in sync with
+# LOG_DICT_COMPACT_* in include/logging/log_output_dict.h.
+COMPACT_LEVEL_MASK = 0x07
+COMPACT_DOMAIN_SHIFT = 3
+COMPACT_DOMAIN_MASK = 0x38
+COMPACT_DATA = 0x40
+COMPACT_DROPPED = 0x80
+COMPACT_SYNC = 0x81
+COMPACT_SYNC_RECORD = bytes([COMPACT_SYNC, 0x5A, 0xA5])
+
 
 logger = logging.getLogger("parser")
 
@@ -177,8 +187,13 @@ class LogParserV1(LogParser):
 
         if "CONFIG_LOG_TIMESTAMP_64BIT" in self.database.get_kconfigs():
             self.fmt_msg_timestamp = endian + FMT_MSG_TIMESTAMP_64
+            self.timestamp_mask = (1 << 64) - 1
         else:
             self.fmt_msg_timestamp = endian + FMT_MSG_TIMESTAMP_32
+            self.timestamp_mask = (1 << 32) - 1
+
+        self.compact = "CONFIG_LOG_DICTIONARY_COMPACT" in self.database.get_kconfigs()
+        self.fmt_word = endian + "I"
 
         self.data_types = DataTypes(self.database)
 
@@ -359,29 +374,40 @@ class LogParserV1(LogParser):
         pkg_len = (log_desc >> 6) & int(math.pow(2, 10) - 1)
         data_len = (log_desc >> 16) & int(math.pow(2, 12) - 1)
 
+        # Skip over data to point to next message (save as return value)
+        next_msg_offset = offset + pkg_len + data_len
+
+        # Extra data after packaged log
+        extra_data = logdata[(offset + pkg_len):next_msg_offset]
+
+        if not self.print_one_msg(level, domain_id, source_id, timestamp,
+                                  logdata[offset:(offset + pkg_len)], extra_data):
+            return None
+
+        # Point to next message
+        return next_msg_offset
+
+
+    def print_one_msg(self, level, domain_id, source_id, timestamp, pkg, extra_data):
+        """Print one log message from its packaged format string and arguments"""
         level_str, color = get_log_level_str_color(level)
         source_id_str = self.database.get_log_source_string(domain_id, source_id)
 
-        # Skip over data to point to next message (save as return value)
-        next_msg_offset = offset + pkg_len + data_len
+        offset = 0
 
         # Offset from beginning of cbprintf_packaged data to end of va_list arguments
-        offset_end_of_args = struct.unpack_from("B", logdata, offset)[0]
+        offset_end_of_args = struct.unpack_from("B", pkg, offset)[0]
         offset_end_of_args *= self.data_types.get_sizeof(DataTypes.INT)
-        offset_end_of_args += offset
-
-        # Extra data after packaged log
-        extra_data = logdata[(offset + pkg_len):next_msg_offset]
 
         # Number of packaged strings
-        num_packed_strings = struct.unpack_from("B", logdata, offset+1)[0]
+        num_packed_strings = struct.unpack_from("B", pkg, offset+1)[0]
 
         # Extract the string table in the packaged log message
-        string_tbl = self.extract_string_table(logdata[offset_end_of_args:(offset + pkg_len)])
+        string_tbl = self.extract_string_table(pkg[offset_end_of_args:])
 
         if len(string_tbl) != num_packed_strings:
             logger.error("------ Error extracting string table")
-            return None
+            return False
 
         # Skip packaged string header
         offset += self.data_types.get_sizeof(DataTypes.PTR)
@@ -393,7 +419,7 @@ class LogParserV1(LogParser):
         # itself is before the va_list, so need to go back the width of
         # a pointer.
         fmt_str_ptr = struct.unpack_from(self.data_types.get_formatter(DataTypes.PTR),
-                                         logdata, offset)[0]
+                                         pkg, offset)[0]
         fmt_str = self.__get_string(fmt_str_ptr,
                                     -self.data_types.get_sizeof(DataTypes.PTR),
                                     string_tbl)
@@ -401,9 +427,9 @@ class LogParserV1(LogParser):
 
         if not fmt_str:
             logger.error("------ Error getting format string at 0x%x", fmt_str_ptr)
-            return None
+            return False
 
-        args = self.process_one_fmt_str(fmt_str, logdata[offset:offset_end_of_args], string_tbl)
+        args = self.process_one_fmt_str(fmt_str, pkg[offset:offset_end_of_args], string_tbl)
 
         fmt_str = formalize_fmt_string(fmt_str)
         log_msg = fmt_str % args
@@ -414,16 +440,128 @@ class LogParserV1(LogParser):
             log_prefix = f"[{timestamp:>10}] <{level_str}> {source_id_str}: "
             print(f"{color}%s%s{Fore.RESET}" % (log_prefix, log_msg))
 
-        if data_len > 0:
+        if len(extra_data) > 0:
             # Has hexdump data
             self.print_hexdump(extra_data, len(log_prefix), color)
 
-        # Point to next message
-        return next_msg_offset
+        return True
+
+
+    @staticmethod
+    def read_num(logdata, offset):
+        """Read one unsigned LEB128 encoded number, return it with
+        the offset following it"""
+        num = 0
+        shift = 0
+
+        while True:
+            byte = logdata[offset]
+            offset += 1
+
+            num |= (byte & 0x7F) << shift
+            shift += 7
+
+            if byte < 0x80:
+                return num, offset
+
+
+    def parse_one_compact_msg(self, logdata, offset, msg_hdr, timestamp):
+        """Parse one log message in compact encoding and print it.
+        Returns the offset of the next message and the timestamp of
+        this message."""
+        level = msg_hdr & COMPACT_LEVEL_MASK
+        domain_id = (msg_hdr & COMPACT_DOMAIN_MASK) >> COMPACT_DOMAIN_SHIFT
+
+        source_id, offset = self.read_num(logdata, offset)
+        delta, offset = self.read_num(logdata, offset)
+        timestamp = (timestamp + delta) & self.timestamp_mask
+
+        # Rebuild the package: header, argument words and strings
+        args_words = logdata[offset]
+        str_cnt = logdata[offset + 1]
+        offset += 2
+
+        hdr_len = self.data_types.get_sizeof(DataTypes.PTR)
+        pkg = bytearray(hdr_len)
+        pkg[0] = args_words
+        pkg[1] = str_cnt
+
+        args_len = args_words * self.data_types.get_sizeof(DataTypes.INT)
+        for _ in range(hdr_len, args_len, struct.calcsize(self.fmt_word)):
+            word, offset = self.read_num(logdata, offset)
+            pkg += struct.pack(self.fmt_word, word)
+
+        str_len, offset = self.read_num(logdata, offset)
+        pkg += logdata[offset:(offset + str_len)]
+        offset += str_len
+
+        extra_data = b''
+        if msg_hdr & COMPACT_DATA:
+            data_len, offset = self.read_num(logdata, offset)
+            extra_data = logdata[offset:(offset + data_len)]
+            offset += data_len
+
+        if args_words == 0:
+            # Nothing to format
+            if len(extra_data) > 0:
+                self.print_hexdump(extra_data, 0, get_log_level_str_color(level)[1])
+        elif not self.print_one_msg(level, domain_id, source_id, timestamp,
+                                    pkg, extra_data):
+            return None, timestamp
+
+        return offset, timestamp
+
+
+    def parse_compact_log_data(self, logdata):
+        """Parse log data in compact encoding and print the log messages.
+        After an error, parsing continues from the next sync record."""
+        offset = 0
+        timestamp = 0
+
+        while offset < len(logdata):
+            msg_start = offset
+
+            try:
+                msg_hdr = logdata[offset]
+                offset += 1
+
+                if msg_hdr == COMPACT_DROPPED:
+                    num_dropped, offset = self.read_num(logdata, offset)
+
+                    print("--- %d messages dropped ---" % num_dropped)
+
+                elif msg_hdr == COMPACT_SYNC and \
+                     logdata[msg_start:(offset + 2)] == COMPACT_SYNC_RECORD:
+                    timestamp, offset = self.read_num(logdata, offset + 2)
+
+                elif msg_hdr & COMPACT_DROPPED:
+                    logger.error("------ Unknown message header: 0x%x", msg_hdr)
+                    offset = None
+
+                else:
+                    offset, timestamp = self.parse_one_compact_msg(logdata, offset,
+                                                                   msg_hdr, timestamp)
+
+            except IndexError:
+                logger.error("------ Log data ends in the middle of a message")
+                offset = None
+
+            if offset is None:
+                offset = logdata.find(COMPACT_SYNC_RECORD, msg_start + 1)
+                if offset < 0:
+                    return False
+
+                logger.error("------ Skipped %d bytes to the next sync record",
+                             offset - msg_start)
+
+        return True
 
 
     def parse_log_data(self, logdata, debug=False):
         """Parse binary log data and print the encoded log messages"""
+        if self.compact:
+            return self.parse_compact_log_data(logdata)
+
         offset = 0
 
         while offset < len(logdata):
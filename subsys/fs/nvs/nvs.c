@@ -27,6 +27,25 @@ static inline size_t nvs_al_size(struct nvs_fs *fs, size_t len)
 	}
 	return (len + (write_block_size - 1U)) & ~(write_block_size - 1U);
 }
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* nvs_lookup_cache_pos returns the lookup cache position for an id */
+static inline size_t nvs_lookup_cache_pos(uint16_t id)
+{
+	size_t pos;
+
+#if CONFIG_NVS_LOOKUP_CACHE_SIZE <= UINT8_MAX
+	/* crc8_ccitt is already used for the ATE checksums and spreads the
+	 * ids well enough to also serve as the hash function.
+	 */
+	pos = crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, &id, sizeof(id));
+#else
+	pos = crc16_ccitt(0xffff, (const uint8_t *)&id, sizeof(id));
+#endif
+
+	return pos % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+}
+#endif
 /* end basic routines */
 
 /* flash routines */
@@ -96,6 +115,15 @@ static int nvs_flash_ate_wrt(struct nvs_fs *fs, const struct nvs_ate *entry)
 
 	rc = nvs_flash_al_wrt(fs, fs->ate_wra, entry,
 			       sizeof(struct nvs_ate));
+	fs->write_gen++;
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* 0xFFFF is used by the close and gc done ate's, keep it out of the
+	 * cache.
+	 */
+	if (entry->id != 0xFFFF) {
+		fs->lookup_cache[nvs_lookup_cache_pos(entry->id)] = fs->ate_wra;
+	}
+#endif
 	fs->ate_wra -= nvs_al_size(fs, sizeof(struct nvs_ate));
 
 	return rc;
@@ -226,6 +254,7 @@ static int nvs_flash_erase_sector(struct nvs_fs *fs, uint32_t addr)
 	LOG_DBG("Erasing flash at %lx, len %d", (long int) offset,
 		fs->sector_size);
 	rc = flash_erase(fs->flash_device, offset, fs->sector_size);
+	fs->write_gen++;
 
 	if (rc) {
 		return rc;
@@ -457,6 +486,55 @@ static void nvs_sector_advance(struct nvs_fs *fs, uint32_t *addr)
 	}
 }
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* rebuild the lookup cache by walking all ate's from newest to oldest, the
+ * first valid ate found for a cache position is the one that is stored.
+ */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc;
+	uint32_t addr, ate_addr;
+	uint32_t *cache_entry;
+	struct nvs_ate ate;
+
+	(void)memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+	addr = fs->ate_wra;
+
+	while (1) {
+		/* addr is modified by nvs_prev_ate, keep the ate address */
+		ate_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, &ate);
+		if (rc) {
+			return rc;
+		}
+
+		cache_entry = &fs->lookup_cache[nvs_lookup_cache_pos(ate.id)];
+
+		if ((ate.id != 0xFFFF) &&
+		    (*cache_entry == NVS_LOOKUP_CACHE_NO_ADDR) &&
+		    (nvs_ate_valid(fs, &ate))) {
+			*cache_entry = ate_addr;
+		}
+
+		if (addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/* drop all cache entries pointing into a sector that is about to be erased */
+static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, uint32_t sector)
+{
+	for (size_t i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs->lookup_cache[i] >> ADDR_SECT_SHIFT) == sector) {
+			fs->lookup_cache[i] = NVS_LOOKUP_CACHE_NO_ADDR;
+		}
+	}
+}
+#endif
+
 /* allocation entry close (this closes the current sector) by writing offset
  * of last ate to the sector end.
  */
@@ -551,7 +629,15 @@ static int nvs_gc(struct nvs_fs *fs)
 			continue;
 		}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+		wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(gc_ate.id)];
+
+		if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+			wlk_addr = fs->ate_wra;
+		}
+#else
 		wlk_addr = fs->ate_wra;
+#endif
 		do {
 			wlk_prev_addr = wlk_addr;
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
@@ -609,6 +695,9 @@ gc_done:
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	nvs_lookup_cache_invalidate(fs, sec_addr >> ADDR_SECT_SHIFT);
+#endif
 	/* Erase the gc'ed sector */
 	rc = nvs_flash_erase_sector(fs, sec_addr);
 	if (rc) {
@@ -777,6 +866,13 @@ static int nvs_startup(struct nvs_fs *fs)
 		fs->ate_wra &= ADDR_SECT_MASK;
 		fs->ate_wra += (fs->sector_size - 2 * ate_size);
 		fs->data_wra = (fs->ate_wra & ADDR_SECT_MASK);
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+		/* gc relies on the cache to find the most recent ate's */
+		rc = nvs_lookup_cache_rebuild(fs);
+		if (rc) {
+			goto end;
+		}
+#endif
 		rc = nvs_gc(fs);
 		goto end;
 	}
@@ -811,6 +907,11 @@ static int nvs_startup(struct nvs_fs *fs)
 	}
 
 end:
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	if (!rc) {
+		rc = nvs_lookup_cache_rebuild(fs);
+	}
+#endif
 	/* If the sector is empty add a gc done ate to avoid having insufficient
 	 * space when doing gc.
 	 */
@@ -939,7 +1040,15 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	}
 
 	/* find latest entry with same id */
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		goto no_cached_entry;
+	}
+#else
 	wlk_addr = fs->ate_wra;
+#endif
 	rd_addr = wlk_addr;
 
 	while (1) {
@@ -957,6 +1066,10 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+no_cached_entry:
+#endif
+
 	if (prev_found) {
 		/* previous entry found */
 		rd_addr &= ADDR_SECT_MASK;
@@ -1057,7 +1170,16 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
+
+	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		rc = -ENOENT;
+		goto err;
+	}
+#else
 	wlk_addr = fs->ate_wra;
+#endif
 	rd_addr = wlk_addr;
 
 	while (cnt_his <= cnt) {
@@ -1100,6 +1222,85 @@ ssize_t nvs_read(struct nvs_fs *fs, uint16_t id, void *data, size_t len)
 	return rc;
 }
 
+int nvs_walk(struct nvs_fs *fs, uint16_t first_id, uint16_t id_count,
+	     uint32_t *seen, nvs_walk_cb_t cb, void *param)
+{
+	int rc;
+	uint32_t wlk_addr, rd_addr;
+	uint16_t bit;
+	struct nvs_ate wlk_ate;
+	struct nvs_entry entry;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	if ((cb == NULL) || (seen == NULL)) {
+		return -EINVAL;
+	}
+
+	(void)memset(seen, 0, NVS_WALK_BITMAP_SIZE(id_count) * sizeof(*seen));
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	wlk_addr = fs->ate_wra;
+
+	while (1) {
+		rd_addr = wlk_addr;
+		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+		if (rc) {
+			break;
+		}
+
+		/* ids below first_id wrap around and are skipped as well */
+		bit = wlk_ate.id - first_id;
+
+		if ((bit < id_count) && (wlk_ate.id != 0xFFFF) &&
+		    !(seen[bit / 32U] & BIT(bit % 32U)) &&
+		    (nvs_ate_valid(fs, &wlk_ate))) {
+			seen[bit / 32U] |= BIT(bit % 32U);
+
+			entry.id = wlk_ate.id;
+			entry.len = wlk_ate.len;
+			entry.data_addr = (rd_addr & ADDR_SECT_MASK) +
+					  wlk_ate.offset;
+
+			rc = cb(fs, &entry, param);
+			if (rc) {
+				break;
+			}
+		}
+
+		if (wlk_addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	k_mutex_unlock(&fs->nvs_lock);
+	return rc;
+}
+
+ssize_t nvs_entry_read(struct nvs_fs *fs, const struct nvs_entry *entry,
+		       void *data, size_t len)
+{
+	int rc;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	rc = nvs_flash_rd(fs, entry->data_addr, data, MIN(len, entry->len));
+	k_mutex_unlock(&fs->nvs_lock);
+	if (rc) {
+		return rc;
+	}
+
+	return entry->len;
+}
+
 ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 {
 
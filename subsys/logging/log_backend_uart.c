@@ -13,6 +13,7 @@
 #include <device.h>
 #include <drivers/uart.h>
 #include <sys/__assert.h>
+#include <string.h>
 
 /* Fixed size to avoid auto-added trailing '\0'.
  * Used if CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY_HEX.
@@ -21,10 +22,244 @@ static const char LOG_HEX_SEP[10] = "##ZLOGV1##";
 
 static const struct device *uart_dev;
 
+#if defined(CONFIG_LOG_BACKEND_UART_ASYNC)
+/* Output is collected in one buffer while the other one is transmitted. */
+struct async_tx {
+	struct k_spinlock lock;
+	struct k_sem done;
+	uint8_t buf[2][CONFIG_LOG_BACKEND_UART_ASYNC_BUFFER_SIZE];
+	size_t fill_len;
+	uint8_t fill_idx;
+	/* Transfer in progress. */
+	bool busy;
+	/* Do not start a transfer before the buffer is full (batch). */
+	bool hold;
+	/* Asynchronous API is used, false after panic. */
+	bool enabled;
+	/* Length of the transfer in progress and number of bytes reported
+	 * as sent when it completed or was aborted.
+	 */
+	size_t tx_len;
+	size_t tx_sent;
+	/* Position of the current message in the fill buffer. */
+	size_t msg_len;
+	/* Part of the current message has been handed to the UART. */
+	bool msg_sent;
+	/* Part of the current message has been dropped. */
+	bool msg_dropped;
+	/* Dropped message was partially sent and must be terminated. */
+	bool msg_truncated;
+	uint32_t dropped_cnt;
+};
+
+static struct async_tx async_tx;
+
+/* Start transmitting the filled buffer unless a transfer is in progress. */
+static void async_tx_kick(bool force)
+{
+	k_spinlock_key_t key = k_spin_lock(&async_tx.lock);
+	uint8_t *buf = async_tx.buf[async_tx.fill_idx];
+	size_t len = async_tx.fill_len;
+
+	if (!async_tx.enabled || async_tx.busy || len == 0 ||
+	    (async_tx.hold && !force)) {
+		k_spin_unlock(&async_tx.lock, key);
+		return;
+	}
+
+	async_tx.busy = true;
+	async_tx.tx_len = len;
+	async_tx.tx_sent = 0;
+	async_tx.fill_idx ^= 1;
+	async_tx.fill_len = 0;
+	async_tx.msg_len = 0;
+	async_tx.msg_sent = true;
+	k_spin_unlock(&async_tx.lock, key);
+
+	if (uart_tx(uart_dev, buf, len, SYS_FOREVER_MS) != 0) {
+		async_tx.busy = false;
+		async_tx.msg_dropped = true;
+		async_tx.msg_truncated = true;
+	}
+}
+
+static void async_callback(const struct device *dev, struct uart_event *evt,
+			   void *user_data)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(user_data);
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED: {
+		k_spinlock_key_t key = k_spin_lock(&async_tx.lock);
+
+		async_tx.busy = false;
+		async_tx.tx_sent = (evt->type == UART_TX_DONE) ?
+				   async_tx.tx_len : evt->data.tx.len;
+		k_spin_unlock(&async_tx.lock, key);
+		k_sem_give(&async_tx.done);
+		async_tx_kick(false);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/* Remove the current message from the fill buffer if none of it has been
+ * handed to the UART. Otherwise, it is terminated before the next output.
+ */
+static void async_drop(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&async_tx.lock);
+
+	if (async_tx.msg_sent) {
+		async_tx.msg_truncated = true;
+	} else {
+		async_tx.fill_len = async_tx.msg_len;
+	}
+
+	async_tx.msg_dropped = true;
+	k_spin_unlock(&async_tx.lock, key);
+}
+
+static void async_out(uint8_t *data, size_t length)
+{
+	k_timeout_t timeout = k_is_in_isr() ? K_NO_WAIT :
+		SYS_TIMEOUT_MS(CONFIG_LOG_BACKEND_UART_ASYNC_TIMEOUT);
+
+	while (length > 0 && !async_tx.msg_dropped) {
+		k_spinlock_key_t key = k_spin_lock(&async_tx.lock);
+		size_t len = MIN(length, sizeof(async_tx.buf[0]) -
+					 async_tx.fill_len);
+
+		memcpy(&async_tx.buf[async_tx.fill_idx][async_tx.fill_len],
+		       data, len);
+		async_tx.fill_len += len;
+		k_spin_unlock(&async_tx.lock, key);
+
+		data += len;
+		length -= len;
+
+		/* Both buffers are full, wait for the transfer to complete. */
+		if (length > 0) {
+			async_tx_kick(true);
+			if (async_tx.fill_len == sizeof(async_tx.buf[0]) &&
+			    k_sem_take(&async_tx.done, timeout) != 0) {
+				async_drop();
+			}
+		}
+	}
+}
+
+static void async_flush(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&async_tx.lock);
+
+	async_tx.enabled = false;
+	k_spin_unlock(&async_tx.lock, key);
+
+	/* Output the part of the transfer in progress which has not been sent.
+	 * If the driver does not report the aborted transfer, it is output
+	 * again entirely rather than lost.
+	 */
+	if (async_tx.busy) {
+		uint8_t *buf = async_tx.buf[async_tx.fill_idx ^ 1];
+
+		(void)uart_tx_abort(uart_dev);
+		for (size_t i = async_tx.tx_sent; i < async_tx.tx_len; i++) {
+			uart_poll_out(uart_dev, buf[i]);
+		}
+	}
+
+	for (size_t i = 0; i < async_tx.fill_len; i++) {
+		uart_poll_out(uart_dev, async_tx.buf[async_tx.fill_idx][i]);
+	}
+
+	async_tx.fill_len = 0;
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt);
+
+static void async_msg_begin(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&async_tx.lock);
+
+	async_tx.msg_len = async_tx.fill_len;
+	async_tx.msg_sent = false;
+	async_tx.msg_dropped = false;
+	k_spin_unlock(&async_tx.lock, key);
+}
+
+/* Terminate a partially sent message and report messages which did not fit
+ * in the transmit buffers. In dictionary mode, the report is followed by a
+ * sync record where the parser resumes after the truncated message.
+ */
+static void async_msg_start(const struct log_backend *const backend)
+{
+	if (async_tx.msg_truncated &&
+	    !IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY)) {
+		async_msg_begin();
+		async_out((uint8_t *)"\r\n", 2);
+	}
+
+	async_tx.msg_truncated = false;
+
+	if (async_tx.dropped_cnt > 0) {
+		uint32_t cnt = async_tx.dropped_cnt;
+
+		async_msg_begin();
+		dropped(backend, cnt);
+		if (!async_tx.msg_dropped) {
+			async_tx.dropped_cnt -= cnt;
+		}
+	}
+
+	async_msg_begin();
+}
+
+static void async_msg_end(void)
+{
+	if (async_tx.msg_dropped) {
+		async_tx.dropped_cnt++;
+	}
+}
+
+static void async_init(void)
+{
+	k_sem_init(&async_tx.done, 0, 1);
+	async_tx.enabled =
+		(uart_callback_set(uart_dev, async_callback, NULL) == 0);
+}
+#else
+#define async_msg_start(backend)
+#define async_msg_end()
+#endif /* CONFIG_LOG_BACKEND_UART_ASYNC */
+
 static int char_out(uint8_t *data, size_t length, void *ctx)
 {
 	ARG_UNUSED(ctx);
 
+#if defined(CONFIG_LOG_BACKEND_UART_ASYNC)
+	if (async_tx.enabled) {
+		if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY_HEX)) {
+			for (size_t i = 0; i < length; i++) {
+				char hex[2];
+
+				(void)hex2char(data[i] >> 4, &hex[0]);
+				(void)hex2char(data[i] & 0x0FU, &hex[1]);
+				async_out((uint8_t *)hex, sizeof(hex));
+			}
+		} else {
+			async_out(data, length);
+		}
+
+		async_tx_kick(false);
+		return length;
+	}
+#endif
+
 	for (size_t i = 0; i < length; i++) {
 #if defined(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY_HEX)
 		char c;
@@ -47,9 +282,12 @@ static int char_out(uint8_t *data, size_t length, void *ctx)
 	return length;
 }
 
-static uint8_t uart_output_buf;
+/* Bytes are copied to the transmit buffers in chunks in asynchronous mode. */
+static uint8_t uart_output_buf[IS_ENABLED(CONFIG_LOG_BACKEND_UART_ASYNC) ?
+			       32 : 1];
 
-LOG_OUTPUT_DEFINE(log_output_uart, char_out, &uart_output_buf, 1);
+LOG_OUTPUT_DEFINE(log_output_uart, char_out, uart_output_buf,
+		  sizeof(uart_output_buf));
 
 static void put(const struct log_backend *const backend,
 		struct log_msg *msg)
@@ -57,7 +295,9 @@ static void put(const struct log_backend *const backend,
 	uint32_t flag = IS_ENABLED(CONFIG_LOG_BACKEND_UART_SYST_ENABLE) ?
 		LOG_OUTPUT_FLAG_FORMAT_SYST : 0;
 
+	async_msg_start(backend);
 	log_backend_std_put(&log_output_uart, flag, msg);
+	async_msg_end();
 }
 
 static void process(const struct log_backend *const backend,
@@ -65,19 +305,42 @@ static void process(const struct log_backend *const backend,
 {
 	uint32_t flags = log_backend_std_get_flags();
 
+	async_msg_start(backend);
+
 	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY)) {
 		log_dict_output_msg2_process(&log_output_uart,
 					     &msg->log, flags);
 	} else {
 		log_output_msg2_process(&log_output_uart, &msg->log, flags);
 	}
+
+	async_msg_end();
 }
 
+#if defined(CONFIG_LOG_BACKEND_UART_ASYNC)
+/* Transmit the whole batch at once if it fits in the buffer. */
+static void process_batch(const struct log_backend *const backend,
+			  union log_msg2_generic **msgs, uint32_t cnt)
+{
+	async_tx.hold = true;
+	for (uint32_t i = 0; i < cnt; i++) {
+		process(backend, msgs[i]);
+	}
+	async_tx.hold = false;
+
+	async_tx_kick(false);
+}
+#endif
+
 static void log_backend_uart_init(struct log_backend const *const backend)
 {
 	uart_dev = device_get_binding(CONFIG_UART_CONSOLE_ON_DEV_NAME);
 	__ASSERT_NO_MSG((void *)uart_dev);
 
+#if defined(CONFIG_LOG_BACKEND_UART_ASYNC)
+	async_init();
+#endif
+
 	if (IS_ENABLED(CONFIG_LOG_BACKEND_UART_OUTPUT_DICTIONARY_HEX)) {
 		/* Print a separator so the output can be fed into
 		 * log parser directly. This is useful when capturing
@@ -92,6 +355,9 @@ static void log_backend_uart_init(struct log_backend const *const backend)
 
 static void panic(struct log_backend const *const backend)
 {
+#if defined(CONFIG_LOG_BACKEND_UART_ASYNC)
+	async_flush();
+#endif
 	log_backend_std_panic(&log_output_uart);
 }
 
@@ -130,6 +396,9 @@ static void sync_hexdump(const struct log_backend *const backend,
 
 const struct log_backend_api log_backend_uart_api = {
 	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+#if defined(CONFIG_LOG_BACKEND_UART_ASYNC)
+	.process_batch = IS_ENABLED(CONFIG_LOG2) ? process_batch : NULL,
+#endif
 	.put = IS_ENABLED(CONFIG_LOG_MODE_DEFERRED) ? put : NULL,
 	.put_sync_string = IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE) ?
 			sync_string : NULL,
@@ -94,22 +94,25 @@ static struct k_timer log_process_thread_timer;
 static log_timestamp_t dummy_timestamp(void);
 static log_timestamp_get_t timestamp_func = dummy_timestamp;
 
-struct mpsc_pbuf_buffer log_buffer;
+#if defined(CONFIG_LOG_PER_CPU_BUFFERS) && defined(CONFIG_SMP)
+#define LOG_BUFFER_COUNT CONFIG_MP_NUM_CPUS
+#else
+#define LOG_BUFFER_COUNT 1
+#endif
+
+static struct mpsc_pbuf_buffer log_buffers[LOG_BUFFER_COUNT];
 static uint32_t __aligned(Z_LOG_MSG2_ALIGNMENT)
-	buf32[CONFIG_LOG_BUFFER_SIZE / sizeof(int)];
+	buf32[LOG_BUFFER_COUNT][CONFIG_LOG_BUFFER_SIZE / sizeof(int) /
+				LOG_BUFFER_COUNT];
+
+#if defined(CONFIG_LOG_PER_CPU_BUFFERS)
+/* Oldest message claimed from each buffer, waiting to be processed. */
+static union mpsc_pbuf_generic *log_heads[LOG_BUFFER_COUNT];
+#endif
 
 static void notify_drop(struct mpsc_pbuf_buffer *buffer,
 			union mpsc_pbuf_generic *item);
 
-static const struct mpsc_pbuf_buffer_config mpsc_config = {
-	.buf = (uint32_t *)buf32,
-	.size = ARRAY_SIZE(buf32),
-	.notify_drop = notify_drop,
-	.get_wlen = log_msg2_generic_get_wlen,
-	.flags = IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
-		MPSC_PBUF_MODE_OVERWRITE : 0
-};
-
 bool log_is_strdup(const void *buf);
 static void msg_process(union log_msgs msg, bool bypass);
 
@@ -763,6 +766,99 @@ static void msg_process(union log_msgs msg, bool bypass)
 	}
 }
 
+#if defined(CONFIG_LOG_PROCESS_BATCH_SIZE) && (CONFIG_LOG_PROCESS_BATCH_SIZE > 1)
+#define LOG_PROCESS_BATCH 1
+
+static struct log_process_batch_stats batch_stats;
+static struct k_spinlock batch_stats_lock;
+
+static void batch_process(union log_msg2_generic **msgs, uint32_t cnt)
+{
+	union log_msg2_generic *filtered[CONFIG_LOG_PROCESS_BATCH_SIZE];
+	struct log_backend const *backend;
+	k_spinlock_key_t key;
+
+	for (int i = 0; i < log_backend_count_get(); i++) {
+		uint32_t n = 0;
+
+		backend = log_backend_get(i);
+		if (!log_backend_is_active(backend)) {
+			continue;
+		}
+
+		for (uint32_t j = 0; j < cnt; j++) {
+			union log_msgs msg = { .msg2 = msgs[j] };
+
+			if (msg_filter_check(backend, msg)) {
+				filtered[n++] = msgs[j];
+			}
+		}
+
+		if (n > 0) {
+			log_backend_msg2_process_batch(backend, filtered, n);
+		}
+	}
+
+	for (uint32_t j = 0; j < cnt; j++) {
+		z_log_msg2_free(msgs[j]);
+	}
+
+	key = k_spin_lock(&batch_stats_lock);
+
+	batch_stats.batch_cnt++;
+	batch_stats.msg_cnt += cnt;
+	batch_stats.max_size = MAX(batch_stats.max_size, cnt);
+
+	k_spin_unlock(&batch_stats_lock, key);
+}
+
+/* Claim up to CONFIG_LOG_PROCESS_BATCH_SIZE messages and process them. */
+static void batch_get_and_process(void)
+{
+	union log_msg2_generic *msgs[CONFIG_LOG_PROCESS_BATCH_SIZE];
+	uint32_t cnt = 0;
+
+	while (cnt < ARRAY_SIZE(msgs)) {
+		msgs[cnt] = z_log_msg2_claim();
+		if (msgs[cnt] == NULL) {
+			break;
+		}
+		cnt++;
+	}
+
+	if (cnt > 0) {
+		atomic_sub(&buffered_cnt, cnt);
+		batch_process(msgs, cnt);
+	}
+}
+#else
+#define LOG_PROCESS_BATCH 0
+
+static void batch_get_and_process(void)
+{
+}
+#endif
+
+void log_process_batch_stats_get(struct log_process_batch_stats *stats,
+				 bool reset)
+{
+#if LOG_PROCESS_BATCH
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&batch_stats_lock);
+
+	*stats = batch_stats;
+	if (reset) {
+		batch_stats = (struct log_process_batch_stats){ 0 };
+	}
+
+	k_spin_unlock(&batch_stats_lock, key);
+#else
+	ARG_UNUSED(reset);
+	*stats = (struct log_process_batch_stats){ 0 };
+#endif
+}
+
 void dropped_notify(void)
 {
 	uint32_t dropped = z_log_dropped_read_and_clear();
@@ -811,10 +907,14 @@ bool z_impl_log_process(bool bypass)
 		return false;
 	}
 
-	msg = get_msg();
-	if (msg.msg) {
-		atomic_dec(&buffered_cnt);
-		msg_process(msg, bypass);
+	if (LOG_PROCESS_BATCH && !bypass) {
+		batch_get_and_process();
+	} else {
+		msg = get_msg();
+		if (msg.msg) {
+			atomic_dec(&buffered_cnt);
+			msg_process(msg, bypass);
+		}
 	}
 
 	if (!bypass && z_log_dropped_pending()) {
@@ -1311,7 +1411,41 @@ void log_hexdump_from_user(struct log_msg_ids src_level, const char *metadata,
 
 void z_log_msg2_init(void)
 {
-	mpsc_pbuf_init(&log_buffer, &mpsc_config);
+	struct mpsc_pbuf_buffer_config config = {
+		.size = ARRAY_SIZE(buf32[0]),
+		.notify_drop = notify_drop,
+		.get_wlen = log_msg2_generic_get_wlen,
+		.flags = IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW) ?
+			MPSC_PBUF_MODE_OVERWRITE : 0
+	};
+
+	for (int i = 0; i < LOG_BUFFER_COUNT; i++) {
+		config.buf = buf32[i];
+		mpsc_pbuf_init(&log_buffers[i], &config);
+#if defined(CONFIG_LOG_PER_CPU_BUFFERS)
+		log_heads[i] = NULL;
+#endif
+	}
+}
+
+/* Buffer used for new messages. The thread may migrate to another CPU
+ * after reading the CPU id, which is harmless as every message is later
+ * committed and freed using the buffer that contains it.
+ */
+static struct mpsc_pbuf_buffer *log_buffer_get(void)
+{
+#if LOG_BUFFER_COUNT > 1
+	return &log_buffers[arch_curr_cpu()->id];
+#else
+	return &log_buffers[0];
+#endif
+}
+
+static struct mpsc_pbuf_buffer *log_buffer_of(const void *item)
+{
+	uintptr_t offset = (uintptr_t)item - (uintptr_t)buf32;
+
+	return &log_buffers[offset / sizeof(buf32[0])];
 }
 
 static uint32_t log_diff_timestamp(void)
@@ -1329,7 +1463,7 @@ void z_log_msg2_put_trace(struct log_msg2_trace trace)
 
 	trace.hdr.timestamp = IS_ENABLED(CONFIG_LOG_TRACE_SHORT_TIMESTAMP) ?
 				log_diff_timestamp() : timestamp_func();
-	mpsc_pbuf_put_word(&log_buffer, generic.buf);
+	mpsc_pbuf_put_word(log_buffer_get(), generic.buf);
 }
 
 void z_log_msg2_put_trace_ptr(struct log_msg2_trace trace, void *data)
@@ -1340,12 +1474,12 @@ void z_log_msg2_put_trace_ptr(struct log_msg2_trace trace, void *data)
 
 	trace.hdr.timestamp = IS_ENABLED(CONFIG_LOG_TRACE_SHORT_TIMESTAMP) ?
 				log_diff_timestamp() : timestamp_func();
-	mpsc_pbuf_put_word_ext(&log_buffer, generic.buf, data);
+	mpsc_pbuf_put_word_ext(log_buffer_get(), generic.buf, data);
 }
 
 struct log_msg2 *z_log_msg2_alloc(uint32_t wlen)
 {
-	return (struct log_msg2 *)mpsc_pbuf_alloc(&log_buffer, wlen,
+	return (struct log_msg2 *)mpsc_pbuf_alloc(log_buffer_get(), wlen,
 				K_MSEC(CONFIG_LOG_BLOCK_IN_THREAD_TIMEOUT_MS));
 }
 
@@ -1363,27 +1497,90 @@ void z_log_msg2_commit(struct log_msg2 *msg)
 		return;
 	}
 
-	mpsc_pbuf_commit(&log_buffer, (union mpsc_pbuf_generic *)msg);
+	mpsc_pbuf_commit(log_buffer_of(msg), (union mpsc_pbuf_generic *)msg);
 
 	if (IS_ENABLED(CONFIG_LOG2_MODE_DEFERRED)) {
 		z_log_msg_post_finalize();
 	}
 }
 
+#if defined(CONFIG_LOG_PER_CPU_BUFFERS)
+static log_timestamp_t msg2_timestamp(union mpsc_pbuf_generic *item)
+{
+	union log_msg2_generic *msg = (union log_msg2_generic *)item;
+
+	return z_log_item_is_msg(msg) ? log_msg2_get_timestamp(&msg->log) :
+					msg->trace.hdr.timestamp;
+}
+
+static bool msg2_is_older(union mpsc_pbuf_generic *a,
+			  union mpsc_pbuf_generic *b)
+{
+	log_timestamp_t ta = msg2_timestamp(a);
+	log_timestamp_t tb = msg2_timestamp(b);
+
+	if (IS_ENABLED(CONFIG_LOG_TIMESTAMP_64BIT)) {
+		return ta < tb;
+	}
+
+	/* 32 bit timestamps wrap around. */
+	return (int32_t)(ta - tb) < 0;
+}
+
+/* Messages are processed in timestamp order, by comparing the oldest
+ * message of each buffer. The message claimed from a buffer is kept until
+ * it is the oldest one, so every buffer is still freed in claim order.
+ */
+union log_msg2_generic *z_log_msg2_claim(void)
+{
+	union mpsc_pbuf_generic *oldest = NULL;
+	int oldest_idx = 0;
+
+	for (int i = 0; i < LOG_BUFFER_COUNT; i++) {
+		if (log_heads[i] == NULL) {
+			log_heads[i] = mpsc_pbuf_claim(&log_buffers[i]);
+		}
+
+		if (log_heads[i] != NULL &&
+		    (oldest == NULL || msg2_is_older(log_heads[i], oldest))) {
+			oldest = log_heads[i];
+			oldest_idx = i;
+		}
+	}
+
+	if (oldest != NULL) {
+		log_heads[oldest_idx] = NULL;
+	}
+
+	return (union log_msg2_generic *)oldest;
+}
+#else
 union log_msg2_generic *z_log_msg2_claim(void)
 {
-	return (union log_msg2_generic *)mpsc_pbuf_claim(&log_buffer);
+	return (union log_msg2_generic *)mpsc_pbuf_claim(&log_buffers[0]);
 }
+#endif /* CONFIG_LOG_PER_CPU_BUFFERS */
 
 void z_log_msg2_free(union log_msg2_generic *msg)
 {
-	mpsc_pbuf_free(&log_buffer, (union mpsc_pbuf_generic *)msg);
+	mpsc_pbuf_free(log_buffer_of(msg), (union mpsc_pbuf_generic *)msg);
 }
 
 
 bool z_log_msg2_pending(void)
 {
-	return mpsc_pbuf_is_pending(&log_buffer);
+	for (int i = 0; i < LOG_BUFFER_COUNT; i++) {
+#if defined(CONFIG_LOG_PER_CPU_BUFFERS)
+		if (log_heads[i] != NULL) {
+			return true;
+		}
+#endif
+		if (mpsc_pbuf_is_pending(&log_buffers[i])) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
 static void log_process_thread_timer_expiry_fn(struct k_timer *timer)
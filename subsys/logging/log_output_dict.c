@@ -11,6 +11,7 @@
 #include <logging/log_output_dict.h>
 #include <sys/__assert.h>
 #include <sys/util.h>
+#include <string.h>
 
 static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
 			 void *ctx)
@@ -24,11 +25,154 @@ static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
 	} while (len != 0);
 }
 
+static uint32_t source_id_get(struct log_msg2 *msg)
+{
+	void *source = (void *)log_msg2_get_source(msg);
+
+	if (source == NULL) {
+		return 0U;
+	}
+
+	return IS_ENABLED(CONFIG_LOG_RUNTIME_FILTERING) ?
+		log_dynamic_source_id(source) : log_const_source_id(source);
+}
+
+#if defined(CONFIG_LOG_DICTIONARY_COMPACT)
+/* Messages are encoded into a small buffer on the stack, so that the output
+ * function is called a few times per message rather than once per field.
+ */
+struct compact_out {
+	const struct log_output *output;
+	size_t len;
+	uint8_t buf[32];
+};
+
+static void compact_flush(struct compact_out *out)
+{
+	if (out->len > 0U) {
+		buffer_write(out->output->func, out->buf, out->len,
+			     (void *)out->output);
+		out->len = 0U;
+	}
+}
+
+static void compact_put(struct compact_out *out, uint8_t byte)
+{
+	if (out->len == sizeof(out->buf)) {
+		compact_flush(out);
+	}
+
+	out->buf[out->len++] = byte;
+}
+
+/* Timestamp type is used so that 64-bit timestamps are not truncated. */
+static void compact_put_num(struct compact_out *out, log_timestamp_t val)
+{
+	while (val >= 0x80U) {
+		compact_put(out, (uint8_t)val | 0x80U);
+		val >>= 7;
+	}
+
+	compact_put(out, (uint8_t)val);
+}
+
+static void compact_put_bytes(struct compact_out *out, uint8_t *data,
+			      size_t len)
+{
+	if (out->len + len > sizeof(out->buf)) {
+		compact_flush(out);
+	}
+
+	if (len > sizeof(out->buf)) {
+		buffer_write(out->output->func, data, len, (void *)out->output);
+	} else {
+		memcpy(&out->buf[out->len], data, len);
+		out->len += len;
+	}
+}
+
+static void compact_put_sync(struct compact_out *out,
+			     log_timestamp_t timestamp)
+{
+	struct log_output_control_block *cb = out->output->control_block;
+
+	if (CONFIG_LOG_DICTIONARY_COMPACT_SYNC_INTERVAL == 0) {
+		return;
+	}
+
+	if (cb->sync_cnt == 0U) {
+		compact_put(out, LOG_DICT_COMPACT_SYNC);
+		compact_put(out, LOG_DICT_COMPACT_SYNC_MAGIC >> 8);
+		compact_put(out, LOG_DICT_COMPACT_SYNC_MAGIC & 0xFF);
+		compact_put_num(out, timestamp);
+		cb->timestamp = timestamp;
+	}
+
+	cb->sync_cnt = (cb->sync_cnt + 1U) %
+		       CONFIG_LOG_DICTIONARY_COMPACT_SYNC_INTERVAL;
+}
+
+void log_dict_output_msg2_process(const struct log_output *output,
+				  struct log_msg2 *msg, uint32_t flags)
+{
+	struct log_output_control_block *cb = output->control_block;
+	struct compact_out out = { .output = output };
+	size_t plen, dlen, args_len;
+	uint8_t *package = log_msg2_get_package(msg, &plen);
+	uint8_t *data = log_msg2_get_data(msg, &dlen);
+
+	compact_put_sync(&out, msg->hdr.timestamp);
+	compact_put(&out, (msg->hdr.desc.level & LOG_DICT_COMPACT_LEVEL_MASK) |
+			  ((msg->hdr.desc.domain << LOG_DICT_COMPACT_DOMAIN_SHIFT) &
+			   LOG_DICT_COMPACT_DOMAIN_MASK) |
+			  ((dlen > 0U) ? LOG_DICT_COMPACT_DATA : 0));
+	compact_put_num(&out, source_id_get(msg));
+	compact_put_num(&out, msg->hdr.timestamp - cb->timestamp);
+	cb->timestamp = msg->hdr.timestamp;
+
+	if (plen > 0U) {
+		args_len = package[0] * sizeof(int);
+		compact_put(&out, package[0]);
+		compact_put(&out, package[1]);
+	} else {
+		args_len = 0U;
+		compact_put(&out, 0U);
+		compact_put(&out, 0U);
+	}
+
+	/* Argument list is aligned, skip the header which has been sent. */
+	for (size_t i = sizeof(void *); i < args_len; i += sizeof(uint32_t)) {
+		compact_put_num(&out, *(uint32_t *)&package[i]);
+	}
+
+	compact_put_num(&out, plen - args_len);
+	compact_put_bytes(&out, &package[args_len], plen - args_len);
+
+	if (dlen > 0U) {
+		compact_put_num(&out, dlen);
+		compact_put_bytes(&out, data, dlen);
+	}
+
+	compact_flush(&out);
+	log_output_flush(output);
+}
+
+void log_dict_output_dropped_process(const struct log_output *output, uint32_t cnt)
+{
+	struct compact_out out = { .output = output };
+
+	compact_put(&out, LOG_DICT_COMPACT_DROPPED);
+	compact_put_num(&out, cnt);
+	compact_flush(&out);
+
+	/* Next message is preceded by a sync record */
+	output->control_block->sync_cnt = 0U;
+}
+#else
 void log_dict_output_msg2_process(const struct log_output *output,
 				  struct log_msg2 *msg, uint32_t flags)
 {
 	struct log_dict_output_normal_msg_hdr_t output_hdr;
-	void *source = (void *)log_msg2_get_source(msg);
 
 	/* Keep sync with header in struct log_msg2 */
 	output_hdr.type = MSG_NORMAL;
@@ -38,11 +182,7 @@ void log_dict_output_msg2_process(const struct log_output *output,
 	output_hdr.data_len = msg->hdr.desc.data_len;
 	output_hdr.timestamp = msg->hdr.timestamp;
 
-	output_hdr.source = (source != NULL) ?
-				(IS_ENABLED(CONFIG_LOG_RUNTIME_FILTERING) ?
-					log_dynamic_source_id(source) :
-					log_const_source_id(source)) :
-				0U;
+	output_hdr.source = source_id_get(msg);
 
 	buffer_write(output->func, (uint8_t *)&output_hdr, sizeof(output_hdr),
 		     (void *)output);
@@ -72,3 +212,4 @@ void log_dict_output_dropped_process(const struct log_output *output, uint32_t c
 	buffer_write(output->func, (uint8_t *)&msg, sizeof(msg),
 		     (void *)output);
 }
+#endif /* CONFIG_LOG_DICTIONARY_COMPACT */
@@ -59,6 +59,32 @@ static struct net_conn conns[CONFIG_NET_MAX_CONN];
 static sys_slist_t conn_unused;
 static sys_slist_t conn_used;
 
+#if defined(CONFIG_NET_CONN_HASH)
+/* UDP and TCP connections bound to a local port, hashed on the protocol
+ * and the local port.  All the other connections are on the wildcard
+ * list.  Like conn_used, all lists are kept in reverse registration
+ * order so that a lookup visits the candidates in the same order as a
+ * conn_used walk, which the precedence rules of net_conn_input()
+ * depend on.
+ */
+static sys_slist_t conn_hash[CONFIG_NET_CONN_HASH_BUCKETS];
+static sys_slist_t conn_wildcard;
+static uint32_t conn_seq;
+#endif
+
+/* Iterator over the connections an incoming packet may match */
+struct conn_iter {
+	sys_snode_t *used;
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_snode_t *hashed;
+	sys_snode_t *wildcard;
+	struct net_if *iface;
+	uint16_t proto;
+	uint16_t port;
+	bool use_hash;
+#endif
+};
+
 #if (CONFIG_NET_CONN_LOG_LEVEL >= LOG_LEVEL_DBG)
 static inline
 void conn_register_debug(struct net_conn *conn,
@@ -141,6 +167,137 @@ static void conn_set_unused(struct net_conn *conn)
 	sys_slist_prepend(&conn_unused, &conn->node);
 }
 
+#if defined(CONFIG_NET_CONN_HASH)
+static inline bool conn_is_hashed(struct net_conn *conn)
+{
+	return (conn->proto == IPPROTO_UDP || conn->proto == IPPROTO_TCP) &&
+	       (conn->family == AF_INET || conn->family == AF_INET6 ||
+		conn->family == AF_UNSPEC) &&
+	       net_sin(&conn->local_addr)->sin_port != 0U;
+}
+
+/* The port is in network byte order */
+static inline sys_slist_t *conn_hash_bucket(uint16_t proto, uint16_t port)
+{
+	return &conn_hash[(port ^ (port >> 8) ^ proto) %
+			  CONFIG_NET_CONN_HASH_BUCKETS];
+}
+
+static void conn_hash_add(struct net_conn *conn)
+{
+	conn->seq = conn_seq++;
+
+	if (conn_is_hashed(conn)) {
+		sys_slist_prepend(conn_hash_bucket(conn->proto,
+				    net_sin(&conn->local_addr)->sin_port),
+				  &conn->hash_node);
+	} else {
+		sys_slist_prepend(&conn_wildcard, &conn->hash_node);
+	}
+}
+
+static void conn_hash_remove(struct net_conn *conn)
+{
+	if (conn_is_hashed(conn)) {
+		sys_slist_find_and_remove(conn_hash_bucket(conn->proto,
+				    net_sin(&conn->local_addr)->sin_port),
+				  &conn->hash_node);
+	} else {
+		sys_slist_find_and_remove(&conn_wildcard, &conn->hash_node);
+	}
+}
+
+static inline struct net_conn *conn_hash_node(sys_snode_t *node)
+{
+	return CONTAINER_OF(node, struct net_conn, hash_node);
+}
+#else
+#define conn_hash_add(...)
+#define conn_hash_remove(...)
+#endif /* CONFIG_NET_CONN_HASH */
+
+static void conn_iter_init(struct conn_iter *it, struct net_pkt *pkt,
+			   uint8_t proto, uint16_t dst_port)
+{
+	it->used = sys_slist_peek_head(&conn_used);
+
+#if defined(CONFIG_NET_CONN_HASH)
+	/* Only UDP and TCP packets over IP are looked up in the hash
+	 * table, the connections of the other families are never
+	 * matched by them.
+	 */
+	it->use_hash = (proto == IPPROTO_UDP || proto == IPPROTO_TCP) &&
+		       (net_pkt_family(pkt) == AF_INET ||
+			net_pkt_family(pkt) == AF_INET6);
+	it->iface = net_pkt_iface(pkt);
+	it->proto = proto;
+	it->port = dst_port;
+	it->hashed = NULL;
+	it->wildcard = NULL;
+
+	if (it->use_hash) {
+		it->hashed = sys_slist_peek_head(conn_hash_bucket(proto,
+								  dst_port));
+		it->wildcard = sys_slist_peek_head(&conn_wildcard);
+
+		net_stats_update_conn_lookup(it->iface);
+	}
+#endif
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *it)
+{
+	struct net_conn *conn;
+
+#if defined(CONFIG_NET_CONN_HASH)
+	if (it->use_hash) {
+		struct net_conn *hashed = NULL;
+		struct net_conn *wildcard = NULL;
+
+		/* Skip the other ports sharing the bucket */
+		while (it->hashed != NULL) {
+			hashed = conn_hash_node(it->hashed);
+			if (hashed->proto == it->proto &&
+			    net_sin(&hashed->local_addr)->sin_port ==
+								it->port) {
+				break;
+			}
+
+			net_stats_update_conn_collision(it->iface);
+			hashed = NULL;
+			it->hashed = sys_slist_peek_next(it->hashed);
+		}
+
+		if (it->wildcard != NULL) {
+			wildcard = conn_hash_node(it->wildcard);
+		}
+
+		/* Merge both lists, most recently registered first */
+		if (hashed != NULL &&
+		    (wildcard == NULL ||
+		     (int32_t)(hashed->seq - wildcard->seq) > 0)) {
+			it->hashed = sys_slist_peek_next(it->hashed);
+			return hashed;
+		}
+
+		if (wildcard != NULL) {
+			it->wildcard = sys_slist_peek_next(it->wildcard);
+		}
+
+		return wildcard;
+	}
+#endif
+
+	if (it->used == NULL) {
+		return NULL;
+	}
+
+	conn = CONTAINER_OF(it->used, struct net_conn, node);
+	it->used = sys_slist_peek_next(it->used);
+
+	return conn;
+}
+
 /* Check if we already have identical connection handler installed. */
 static struct net_conn *conn_find_handler(uint16_t proto, uint8_t family,
 					  const struct sockaddr *remote_addr,
@@ -356,6 +513,7 @@ int net_conn_register(uint16_t proto, uint8_t family,
 	}
 
 	conn_set_used(conn);
+	conn_hash_add(conn);
 
 	conn_register_debug(conn, remote_port, local_port);
 
@@ -380,6 +538,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	NET_DBG("Connection handler %p removed", conn);
 
 	sys_slist_find_and_remove(&conn_used, &conn->node);
+	conn_hash_remove(conn);
 
 	conn_set_unused(conn);
 
@@ -558,6 +717,7 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 	bool raw_pkt_delivered = false;
 	bool raw_pkt_continue = false;
 	int16_t best_rank = -1;
+	struct conn_iter it;
 	struct net_conn *conn;
 	enum net_verdict ret;
 	uint16_t src_port;
@@ -623,7 +783,9 @@ enum net_verdict net_conn_input(struct net_pkt *pkt,
 		}
 	}
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&conn_used, conn, node) {
+	conn_iter_init(&it, pkt, proto, dst_port);
+
+	while ((conn = conn_iter_next(&it)) != NULL) {
 		if (conn->context != NULL &&
 		    net_context_is_bound_to_iface(conn->context) &&
 		    net_pkt_iface(pkt) != net_context_get_iface(conn->context)) {
@@ -859,4 +1021,12 @@ void net_conn_init(void)
 	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
 		sys_slist_prepend(&conn_unused, &conns[i].node);
 	}
+
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_slist_init(&conn_wildcard);
+
+	for (i = 0; i < CONFIG_NET_CONN_HASH_BUCKETS; i++) {
+		sys_slist_init(&conn_hash[i]);
+	}
+#endif
 }
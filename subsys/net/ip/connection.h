@@ -76,6 +76,14 @@ struct net_conn {
 
 	/** Flags for the connection */
 	uint8_t flags;
+
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Internal slist node for the hash table */
+	sys_snode_t hash_node;
+
+	/** Registration sequence number, orders the lookup */
+	uint32_t seq;
+#endif
 };
 
 /**
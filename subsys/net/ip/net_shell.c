@@ -1276,6 +1276,12 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	PR("TCP pkt drop   %d\n", GET_STAT(iface, tcp.drop));
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_CONN)
+	PR("Conn lookups   %d\tcollisions\t%d\n",
+	   GET_STAT(iface, conn.lookups),
+	   GET_STAT(iface, conn.collisions));
+#endif
+
 	PR("Bytes received %u\n", GET_STAT(iface, bytes.received));
 	PR("Bytes sent     %u\n", GET_STAT(iface, bytes.sent));
 	PR("Processing err %d\n", GET_STAT(iface, processing_error));
@@ -2225,6 +2231,77 @@ static int cmd_net_dns_cancel(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_cb(const struct dns_cache_entry *entry,
+			 int32_t remaining, void *user_data)
+{
+	const struct shell *shell = user_data;
+	int i;
+
+	PR("%s %s expires in %d s\n", entry->query,
+	   entry->query_type == DNS_QUERY_TYPE_A ? "A" : "AAAA",
+	   remaining / MSEC_PER_SEC);
+
+	if (entry->count == 0) {
+		PR("\t<no data>\n");
+		return;
+	}
+
+	for (i = 0; i < entry->count; i++) {
+		const struct dns_addrinfo *info = &entry->info[i];
+
+		if (IS_ENABLED(CONFIG_NET_IPV4) && info->ai_family == AF_INET) {
+			PR("\t%s\n", net_sprint_ipv4_addr(
+				   &net_sin(&info->ai_addr)->sin_addr));
+		} else if (IS_ENABLED(CONFIG_NET_IPV6) &&
+			   info->ai_family == AF_INET6) {
+			PR("\t%s\n", net_sprint_ipv6_addr(
+				   &net_sin6(&info->ai_addr)->sin6_addr));
+		}
+	}
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (dns_resolve_cache_foreach(dns_resolve_get_default(), dns_cache_cb,
+				      (void *)shell) <= 0) {
+		PR("DNS cache is empty.\n");
+	}
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_flush(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (dns_resolve_cache_flush(dns_resolve_get_default()) < 0) {
+		PR_WARNING("Cannot flush DNS cache.\n");
+		return -ENOEXEC;
+	}
+
+	PR("DNS cache flushed.\n");
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns_query(const struct shell *shell, size_t argc,
 			     char *argv[])
 {
@@ -5687,6 +5764,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
+	SHELL_CMD(cache, NULL, "Show cached DNS answers.",
+		  cmd_net_dns_cache),
+	SHELL_CMD(flush, NULL, "Remove all cached DNS answers.",
+		  cmd_net_dns_flush),
 	SHELL_CMD(query, NULL,
 		  "'net dns <hostname> [A or AAAA]' queries IPv4 address "
 		  "(default) or IPv6 address for a host name.",
@@ -345,6 +345,21 @@ static inline void net_stats_update_ipv4_igmp_drop(struct net_if *iface)
 #define net_stats_update_ipv4_igmp_drop(iface)
 #endif /* CONFIG_NET_STATISTICS_IGMP */
 
+#if defined(CONFIG_NET_STATISTICS_CONN) && defined(CONFIG_NET_NATIVE)
+static inline void net_stats_update_conn_lookup(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.conn.lookups++);
+}
+
+static inline void net_stats_update_conn_collision(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.conn.collisions++);
+}
+#else
+#define net_stats_update_conn_lookup(iface)
+#define net_stats_update_conn_collision(iface)
+#endif /* CONFIG_NET_STATISTICS_CONN */
+
 #if defined(CONFIG_NET_PKT_TXTIME_STATS) && defined(CONFIG_NET_STATISTICS)
 static inline void net_stats_update_tx_time(struct net_if *iface,
 					    uint32_t start_time,
@@ -30,10 +30,13 @@ LOG_MODULE_REGISTER(net_tcp, CONFIG_NET_TCP_LOG_LEVEL);
 #define ACK_TIMEOUT K_MSEC(ACK_TIMEOUT_MS)
 #define FIN_TIMEOUT_MS MSEC_PER_SEC
 #define FIN_TIMEOUT K_MSEC(FIN_TIMEOUT_MS)
+#define CORK_TIMEOUT_MS 200
+#define CORK_TIMEOUT K_MSEC(CORK_TIMEOUT_MS)
 
 static int tcp_rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
 static int tcp_retries = CONFIG_NET_TCP_RETRY_COUNT;
-static int tcp_window = NET_IPV6_MTU;
+static int tcp_window = CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE ?
+	CONFIG_NET_TCP_MAX_RECV_WINDOW_SIZE : NET_IPV6_MTU;
 
 static sys_slist_t tcp_conns = SYS_SLIST_STATIC_INIT(&tcp_conns);
 
@@ -48,6 +51,23 @@ static K_KERNEL_STACK_DEFINE(work_q_stack, CONFIG_NET_TCP_WORKQ_STACK_SIZE);
 static void tcp_in(struct tcp *conn, struct net_pkt *pkt);
 
 int (*tcp_send_cb)(struct net_pkt *pkt) = NULL;
+
+/* net_buf reference counts are not atomic. The buffers of send_data can be
+ * referenced by segments that are freed in other threads, so references to
+ * them are taken and dropped with this lock held.
+ */
+static struct k_spinlock tcp_tx_ref_lock;
+
+#if defined(CONFIG_NET_TCP_TX_ZERO_COPY)
+static void tcp_tx_ref_destroy(struct net_buf *buf);
+
+/* Data buffers of the segments, pointing to the data in send_data */
+NET_BUF_POOL_DEFINE(tcp_tx_ref_pool, CONFIG_NET_TCP_TX_ZERO_COPY_BUF_COUNT,
+		    0, 0, tcp_tx_ref_destroy);
+
+/* The send_data buffer each tcp_tx_ref_pool buffer points to */
+static struct net_buf *tcp_tx_ref_bufs[CONFIG_NET_TCP_TX_ZERO_COPY_BUF_COUNT];
+#endif
 size_t (*tcp_recv_cb)(struct tcp *conn, struct net_pkt *pkt) = NULL;
 
 static uint32_t tcp_get_seq(struct net_buf *buf)
@@ -362,6 +382,8 @@ static int tcp_conn_unref(struct tcp *conn)
 #endif
 {
 	int ref_count = atomic_get(&conn->ref_count);
+	struct k_work_sync work_sync;
+	k_spinlock_key_t key;
 	struct net_pkt *pkt;
 
 #if CONFIG_NET_TCP_LOG_LEVEL >= LOG_LEVEL_DBG
@@ -414,9 +436,19 @@ static int tcp_conn_unref(struct tcp *conn)
 	tcp_send_queue_flush(conn);
 
 	k_work_cancel_delayable(&conn->send_data_timer);
+	k_work_cancel_delayable_sync(&conn->cork_timer, &work_sync);
+
+	key = k_spin_lock(&tcp_tx_ref_lock);
+	if (conn->send_data->buffer) {
+		net_buf_unref(conn->send_data->buffer);
+		conn->send_data->buffer = NULL;
+	}
+	k_spin_unlock(&tcp_tx_ref_lock, key);
+
 	tcp_pkt_unref(conn->send_data);
 
 	if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
+		k_work_cancel_delayable(&conn->recv_queue_timer);
 		tcp_pkt_unref(conn->queue_recv_data);
 	}
 
@@ -613,8 +645,9 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 
 	NET_DBG("len=%zd", len);
 
-	recv_options->mss_found = false;
-	recv_options->wnd_found = false;
+	/* The MSS and window scale options are only sent in SYN segments,
+	 * so the values found earlier are kept.
+	 */
 
 	for ( ; options && len >= 1; options += opt_len, len -= opt_len) {
 		opt = options[0];
@@ -658,8 +691,37 @@ static bool tcp_options_check(struct tcp_options *recv_options,
 				goto end;
 			}
 
-			recv_options->window = opt;
+			recv_options->window = MIN(options[2],
+						   TCP_MAX_WINDOW_SHIFT);
 			recv_options->wnd_found = true;
+			NET_DBG("WS=%hu", recv_options->window);
+			break;
+		case TCPOPT_SACK_PERM:
+			if (opt_len != 2) {
+				result = false;
+				goto end;
+			}
+
+			recv_options->sack_perm_found = true;
+			break;
+		case TCPOPT_SACK:
+			if (opt_len < 10 || ((opt_len - 2) % 8) != 0) {
+				result = false;
+				goto end;
+			}
+#if defined(CONFIG_NET_TCP_SACK)
+			for (int i = 2; i < opt_len &&
+			     recv_options->sack_count < TCP_SACK_MAX_BLOCKS;
+			     i += 8) {
+				struct tcp_sack_block *blk = &recv_options->sack[
+					recv_options->sack_count++];
+
+				blk->left = ntohl(UNALIGNED_GET(
+						(uint32_t *)(options + i)));
+				blk->right = ntohl(UNALIGNED_GET(
+						(uint32_t *)(options + i + 4)));
+			}
+#endif
 			break;
 		default:
 			continue;
@@ -755,11 +817,78 @@ static int tcp_finalize_pkt(struct net_pkt *pkt)
 	return -EINVAL;
 }
 
+/* Window scale and SACK permitted in a SYN, or one SACK block in an ACK */
+#define TCP_OPTIONS_MAX_LEN 12
+
+static size_t tcp_options_add(struct tcp *conn, uint8_t flags, uint8_t *opts)
+{
+	size_t len = 0;
+
+	if (flags & SYN) {
+		/* A SYN-ACK only carries the options offered in the SYN */
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+		if (!(flags & ACK) || conn->wnd_scale_ok) {
+			opts[len++] = TCPOPT_NOP;
+			opts[len++] = TCPOPT_WINDOW;
+			opts[len++] = 3;
+			opts[len++] = conn->recv_win_shift;
+		}
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+		if (!(flags & ACK) || conn->sack_ok) {
+			opts[len++] = TCPOPT_NOP;
+			opts[len++] = TCPOPT_NOP;
+			opts[len++] = TCPOPT_SACK_PERM;
+			opts[len++] = 2;
+		}
+#endif
+		return len;
+	}
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Report the out-of-order data waiting in the receive queue */
+	if ((flags & (ACK | RST)) == ACK && conn->sack_ok &&
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT &&
+	    !net_pkt_is_empty(conn->queue_recv_data)) {
+		struct net_buf *first = conn->queue_recv_data->buffer;
+		struct net_buf *last = net_buf_frag_last(first);
+
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_NOP;
+		opts[len++] = TCPOPT_SACK;
+		opts[len++] = 10;
+		UNALIGNED_PUT(htonl(tcp_get_seq(first)),
+			      (uint32_t *)(opts + len));
+		len += 4;
+		UNALIGNED_PUT(htonl(tcp_get_seq(last) + last->len),
+			      (uint32_t *)(opts + len));
+		len += 4;
+	}
+#endif
+
+	return len;
+}
+
+static uint16_t tcp_recv_win_field(struct tcp *conn, uint8_t flags)
+{
+	uint32_t win = conn->recv_win;
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	/* The window in a SYN segment is never scaled */
+	if (!(flags & SYN)) {
+		win >>= conn->recv_win_shift;
+	}
+#endif
+
+	return MIN(win, UINT16_MAX);
+}
+
 static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
-			  uint32_t seq)
+			  uint32_t seq, const uint8_t *opts, size_t opts_len)
 {
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct tcphdr *th;
+	int ret;
 
 	th = (struct tcphdr *)net_pkt_get_data(pkt, &tcp_access);
 	if (!th) {
@@ -770,16 +899,21 @@ static int tcp_header_add(struct tcp *conn, struct net_pkt *pkt, uint8_t flags,
 
 	UNALIGNED_PUT(conn->src.sin.sin_port, &th->th_sport);
 	UNALIGNED_PUT(conn->dst.sin.sin_port, &th->th_dport);
-	th->th_off = 5;
+	th->th_off = 5 + opts_len / 4;
 	UNALIGNED_PUT(flags, &th->th_flags);
-	UNALIGNED_PUT(htons(conn->recv_win), &th->th_win);
+	UNALIGNED_PUT(htons(tcp_recv_win_field(conn, flags)), &th->th_win);
 	UNALIGNED_PUT(htonl(seq), &th->th_seq);
 
 	if (ACK & flags) {
 		UNALIGNED_PUT(htonl(conn->ack), &th->th_ack);
 	}
 
-	return net_pkt_set_data(pkt, &tcp_access);
+	ret = net_pkt_set_data(pkt, &tcp_access);
+	if (ret < 0 || opts_len == 0) {
+		return ret;
+	}
+
+	return net_pkt_write(pkt, opts, opts_len);
 }
 
 static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
@@ -802,10 +936,12 @@ static int ip_header_add(struct tcp *conn, struct net_pkt *pkt)
 static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		       uint32_t seq)
 {
+	uint8_t opts[TCP_OPTIONS_MAX_LEN];
+	size_t opts_len = tcp_options_add(conn, flags, opts);
 	struct net_pkt *pkt;
 	int ret = 0;
 
-	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr));
+	pkt = tcp_pkt_alloc(conn, sizeof(struct tcphdr) + opts_len);
 	if (!pkt) {
 		ret = -ENOBUFS;
 		goto out;
@@ -823,7 +959,7 @@ static int tcp_out_ext(struct tcp *conn, uint8_t flags, struct net_pkt *data,
 		goto out;
 	}
 
-	ret = tcp_header_add(conn, pkt, flags, seq);
+	ret = tcp_header_add(conn, pkt, flags, seq, opts, opts_len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
 		goto out;
@@ -888,9 +1024,120 @@ static int tcp_pkt_peek(struct net_pkt *to, struct net_pkt *from, size_t pos,
 	return net_pkt_copy(to, from, len);
 }
 
+/* Remove acknowledged data from the head of send_data. Unlike
+ * tcp_pkt_pull(), the remaining data is not moved to the start of the
+ * buffer, as segments that are still queued for sending can point to it.
+ */
+static int tcp_send_data_pull(struct tcp *conn, size_t len)
+{
+	struct net_pkt *pkt = conn->send_data;
+	struct net_buf *buf;
+	k_spinlock_key_t key;
+
+	if (len > net_pkt_get_len(pkt)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&tcp_tx_ref_lock);
+
+	while (len > 0) {
+		buf = pkt->buffer;
+
+		if (buf->len > len) {
+			net_buf_pull(buf, len);
+			break;
+		}
+
+		len -= buf->len;
+		pkt->buffer = buf->frags;
+		buf->frags = NULL;
+		net_buf_unref(buf);
+	}
+
+	k_spin_unlock(&tcp_tx_ref_lock, key);
+
+	net_pkt_cursor_init(pkt);
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_TCP_TX_ZERO_COPY)
+static void tcp_tx_ref_destroy(struct net_buf *buf)
+{
+	struct net_buf *orig = tcp_tx_ref_bufs[net_buf_id(buf)];
+	k_spinlock_key_t key;
+
+	tcp_tx_ref_bufs[net_buf_id(buf)] = NULL;
+	net_buf_destroy(buf);
+
+	key = k_spin_lock(&tcp_tx_ref_lock);
+	net_buf_unref(orig);
+	k_spin_unlock(&tcp_tx_ref_lock, key);
+}
+
+/* Create a segment whose data buffers point to the data in send_data
+ * instead of holding a copy of it. Returns NULL if there are not enough
+ * reference buffers, the caller then copies the data.
+ */
+static struct net_pkt *tcp_send_data_ref(struct tcp *conn, size_t pos,
+					 size_t len)
+{
+	struct net_buf *frag = conn->send_data->buffer;
+	struct net_buf *ref;
+	struct net_pkt *pkt;
+	k_spinlock_key_t key;
+	size_t ref_len;
+
+	pkt = tcp_pkt_alloc(conn, 0);
+	if (!pkt) {
+		return NULL;
+	}
+
+	while (frag && pos >= frag->len) {
+		pos -= frag->len;
+		frag = frag->frags;
+	}
+
+	while (frag && len > 0) {
+		ref_len = MIN(len, frag->len - pos);
+
+		ref = net_buf_alloc_with_data(&tcp_tx_ref_pool,
+					      frag->data + pos, ref_len,
+					      K_NO_WAIT);
+		if (!ref) {
+			tcp_pkt_unref(pkt);
+			return NULL;
+		}
+
+		key = k_spin_lock(&tcp_tx_ref_lock);
+		tcp_tx_ref_bufs[net_buf_id(ref)] = net_buf_ref(frag);
+		k_spin_unlock(&tcp_tx_ref_lock, key);
+
+		net_pkt_append_buffer(pkt, ref);
+
+		len -= ref_len;
+		pos = 0;
+		frag = frag->frags;
+	}
+
+	if (len > 0) {
+		tcp_pkt_unref(pkt);
+		return NULL;
+	}
+
+	return pkt;
+}
+#else
+static inline struct net_pkt *tcp_send_data_ref(struct tcp *conn, size_t pos,
+						size_t len)
+{
+	return NULL;
+}
+#endif /* CONFIG_NET_TCP_TX_ZERO_COPY */
+
 static bool tcp_window_full(struct tcp *conn)
 {
-	bool window_full = !(conn->unacked_len < conn->send_win);
+	bool window_full = !((uint32_t)conn->unacked_len < conn->send_win);
 
 	NET_DBG("conn: %p window_full=%hu", conn, window_full);
 
@@ -915,37 +1162,85 @@ static int tcp_unsent_len(struct tcp *conn)
 	return unsent_len;
 }
 
-static int tcp_send_data(struct tcp *conn)
+/* Largest amount of data sent in one segment: the MSS of the peer, but
+ * no more than fits in a packet on the outgoing interface, less the TCP
+ * options the segment carries (RFC 6691).
+ */
+static uint16_t tcp_send_mss(struct tcp *conn)
+{
+	sa_family_t family = net_context_get_family(conn->context);
+	int mtu = net_if_get_mtu(conn->iface);
+	uint8_t opts[TCP_OPTIONS_MAX_LEN];
+	size_t opts_len = tcp_options_add(conn, PSH | ACK, opts);
+	int max_len;
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && family == AF_INET6) {
+		max_len = MAX(mtu, NET_IPV6_MTU) - NET_IPV6TCPH_LEN;
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && family == AF_INET) {
+		max_len = MAX(mtu, NET_IPV4_MTU) - NET_IPV4TCPH_LEN;
+	} else {
+		max_len = conn_mss(conn);
+	}
+
+	return MIN(conn_mss(conn), max_len) - opts_len;
+}
+
+/* Send len bytes of the queued data, starting at offset pos, in one segment */
+static int tcp_send_segment(struct tcp *conn, int pos, int len)
 {
-	int ret = 0;
-	int pos, len;
 	struct net_pkt *pkt;
+	int ret;
 
-	pos = conn->unacked_len;
-	len = MIN3(conn->send_data_total - conn->unacked_len,
-		   conn->send_win - conn->unacked_len,
-		   conn_mss(conn));
-	if (len == 0) {
-		NET_DBG("conn: %p no data to send", conn);
-		ret = -ENODATA;
-		goto out;
+	pkt = tcp_send_data_ref(conn, pos, len);
+	if (pkt) {
+		goto send;
 	}
 
 	pkt = tcp_pkt_alloc(conn, len);
 	if (!pkt) {
 		NET_ERR("conn: %p packet allocation failed, len=%d", conn, len);
-		ret = -ENOBUFS;
-		goto out;
+		return -ENOBUFS;
 	}
 
 	ret = tcp_pkt_peek(pkt, conn->send_data, pos, len);
 	if (ret < 0) {
 		tcp_pkt_unref(pkt);
-		ret = -ENOBUFS;
+		return -ENOBUFS;
+	}
+
+send:
+#if defined(CONFIG_NET_TEST_PROTOCOL)
+	if (tp_drop(TP_DROP_TX)) {
+		tcp_pkt_unref(pkt);
+		return 0;
+	}
+#endif
+	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + pos);
+
+	/* The data we want to send, has been moved to the send queue so we
+	 * can unref the head net_pkt. If there was an error, we need to remove
+	 * the packet anyway.
+	 */
+	tcp_pkt_unref(pkt);
+
+	return ret;
+}
+
+static int tcp_send_data(struct tcp *conn)
+{
+	int ret = 0;
+	int len;
+
+	len = MIN3(conn->send_data_total - conn->unacked_len,
+		   (int)conn->send_win - conn->unacked_len,
+		   tcp_send_mss(conn));
+	if (len <= 0) {
+		NET_DBG("conn: %p no data to send", conn);
+		ret = -ENODATA;
 		goto out;
 	}
 
-	ret = tcp_out_ext(conn, PSH | ACK, pkt, conn->seq + conn->unacked_len);
+	ret = tcp_send_segment(conn, conn->unacked_len, len);
 	if (ret == 0) {
 		conn->unacked_len += len;
 
@@ -958,21 +1253,40 @@ static int tcp_send_data(struct tcp *conn)
 		}
 	}
 
-	/* The data we want to send, has been moved to the send queue so we
-	 * can unref the head net_pkt. If there was an error, we need to remove
-	 * the packet anyway.
-	 */
-	tcp_pkt_unref(pkt);
-
 	conn_send_data_dump(conn);
 
  out:
 	return ret;
 }
 
+/* Unsent data that does not fill a full segment is held back to be sent
+ * together with later writes: while the connection is corked, and with
+ * Nagle's algorithm (RFC 1122 ch 4.2.3.4) while earlier data is still
+ * unacknowledged, unless TCP_NODELAY is set.
+ */
+static bool tcp_hold_partial_segment(struct tcp *conn)
+{
+	if (conn->in_close || tcp_unsent_len(conn) >= tcp_send_mss(conn)) {
+		return false;
+	}
+
+	if (conn->tcp_cork) {
+		/* Corked data is sent out when the timer expires at the
+		 * latest. An already running timer is not restarted.
+		 */
+		(void)k_work_schedule_for_queue(&tcp_work_q, &conn->cork_timer,
+						CORK_TIMEOUT);
+		return true;
+	}
+
+	return !conn->tcp_nodelay && conn->unacked_len > 0;
+}
+
 /* Send all queued but unsent data from the send_data packet by packet
- * until the receiver's window is full. */
-static int tcp_send_queued_data(struct tcp *conn)
+ * until the receiver's window is full. If push is set, a partial segment
+ * is not held back.
+ */
+static int tcp_send_queued_data_ext(struct tcp *conn, bool push)
 {
 	int ret = 0;
 	bool subscribe = false;
@@ -983,6 +1297,10 @@ static int tcp_send_queued_data(struct tcp *conn)
 
 	while (tcp_unsent_len(conn) > 0) {
 
+		if (!push && tcp_hold_partial_segment(conn)) {
+			break;
+		}
+
 		if (tcp_window_full(conn)) {
 			subscribe = true;
 			break;
@@ -1019,6 +1337,25 @@ static int tcp_send_queued_data(struct tcp *conn)
 	return ret;
 }
 
+static int tcp_send_queued_data(struct tcp *conn)
+{
+	return tcp_send_queued_data_ext(conn, false);
+}
+
+static void tcp_cork_timeout(struct k_work *work)
+{
+	struct tcp *conn = CONTAINER_OF(work, struct tcp, cork_timer);
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	if (conn->state == TCP_ESTABLISHED) {
+		NET_DBG("conn: %p sending corked data", conn);
+		(void)tcp_send_queued_data_ext(conn, true);
+	}
+
+	k_mutex_unlock(&conn->lock);
+}
+
 static void tcp_cleanup_recv_queue(struct k_work *work)
 {
 	struct tcp *conn = CONTAINER_OF(work, struct tcp, recv_queue_timer);
@@ -1035,6 +1372,195 @@ static void tcp_cleanup_recv_queue(struct k_work *work)
 	k_mutex_unlock(&conn->lock);
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* Add a block reported by the peer to the scoreboard, which is kept sorted
+ * and without overlapping blocks. If the scoreboard is full, the highest
+ * block is forgotten, the data in it is just retransmitted later.
+ */
+static void tcp_sack_block_add(struct tcp *conn, uint32_t left, uint32_t right)
+{
+	struct tcp_sack_block *sacked = conn->sacked;
+	int count = conn->sacked_count;
+	int i = 0, j;
+
+	while (i < count && net_tcp_seq_cmp(sacked[i].right, left) < 0) {
+		i++;
+	}
+
+	/* Merge the blocks i..j-1 that overlap or touch the new block */
+	for (j = i; j < count && net_tcp_seq_cmp(sacked[j].left, right) <= 0;
+	     j++) {
+		if (net_tcp_seq_cmp(sacked[j].left, left) < 0) {
+			left = sacked[j].left;
+		}
+
+		if (net_tcp_seq_cmp(sacked[j].right, right) > 0) {
+			right = sacked[j].right;
+		}
+	}
+
+	if (j == i) {
+		if (count == TCP_SACK_MAX_BLOCKS) {
+			if (i == count) {
+				return;
+			}
+
+			count--;
+		}
+
+		memmove(&sacked[i + 1], &sacked[i],
+			(count - i) * sizeof(*sacked));
+		count++;
+	} else {
+		memmove(&sacked[i + 1], &sacked[j],
+			(count - j) * sizeof(*sacked));
+		count -= j - i - 1;
+	}
+
+	sacked[i].left = left;
+	sacked[i].right = right;
+	conn->sacked_count = count;
+}
+
+static void tcp_sack_update(struct tcp *conn)
+{
+	struct tcp_options *options = &conn->recv_options;
+	uint32_t snd_max = conn->seq + conn->unacked_len;
+	int i, j;
+
+	/* Drop what the cumulative ACK has covered */
+	for (i = 0, j = 0; i < conn->sacked_count; i++) {
+		if (net_tcp_seq_cmp(conn->sacked[i].right, conn->seq) <= 0) {
+			continue;
+		}
+
+		conn->sacked[j] = conn->sacked[i];
+		if (net_tcp_seq_cmp(conn->sacked[j].left, conn->seq) < 0) {
+			conn->sacked[j].left = conn->seq;
+		}
+
+		j++;
+	}
+
+	conn->sacked_count = j;
+
+	for (i = 0; i < options->sack_count; i++) {
+		struct tcp_sack_block *blk = &options->sack[i];
+
+		/* Ignore duplicate (RFC 2883) and bogus blocks */
+		if (net_tcp_seq_cmp(blk->left, conn->seq) <= 0 ||
+		    net_tcp_seq_cmp(blk->right, blk->left) <= 0 ||
+		    net_tcp_seq_cmp(blk->right, snd_max) > 0) {
+			continue;
+		}
+
+		tcp_sack_block_add(conn, blk->left, blk->right);
+	}
+}
+
+/* Retransmit the data from the start of the send queue up to the first
+ * block that the peer has selectively acknowledged.
+ */
+static void tcp_sack_retransmit(struct tcp *conn)
+{
+	int len;
+
+	len = MIN3((int)(conn->sacked[0].left - conn->seq),
+		   conn->unacked_len, tcp_send_mss(conn));
+	if (len <= 0) {
+		return;
+	}
+
+	NET_DBG("conn: %p retransmit seq %u len %d", conn, conn->seq, len);
+
+	if (tcp_send_segment(conn, 0, len) < 0) {
+		return;
+	}
+
+	net_stats_update_tcp_resent(conn->iface, len);
+	net_stats_update_tcp_seg_rexmit(conn->iface);
+
+	k_work_reschedule_for_queue(&tcp_work_q, &conn->send_data_timer,
+				    K_MSEC(tcp_rto));
+}
+
+/* Loss recovery with selective acknowledgements: the first hole in the
+ * scoreboard is retransmitted after three duplicate ACKs (RFC 6675), and
+ * again after every partial ACK until all the reported data is acked.
+ */
+static void tcp_sack_ack_received(struct tcp *conn, struct tcphdr *th,
+				  size_t len, bool acked)
+{
+	if (!conn->sack_ok || conn->data_mode == TCP_DATA_MODE_RESEND) {
+		return;
+	}
+
+	tcp_sack_update(conn);
+
+	if (conn->sacked_count == 0) {
+		conn->dup_acks = 0;
+		conn->in_sack_recovery = false;
+		return;
+	}
+
+	if (acked) {
+		conn->dup_acks = 0;
+
+		if (conn->in_sack_recovery) {
+			tcp_sack_retransmit(conn);
+		}
+
+		return;
+	}
+
+	if (len > 0 || th_ack(th) != conn->seq ||
+	    conn->recv_options.sack_count == 0) {
+		return;
+	}
+
+	if (++conn->dup_acks == TCP_DUP_ACK_THRESHOLD &&
+	    !conn->in_sack_recovery) {
+		conn->in_sack_recovery = true;
+		tcp_sack_retransmit(conn);
+	}
+}
+
+static void tcp_sack_reset(struct tcp *conn)
+{
+	conn->sacked_count = 0;
+	conn->dup_acks = 0;
+	conn->in_sack_recovery = false;
+}
+#else
+static inline void tcp_sack_ack_received(struct tcp *conn, struct tcphdr *th,
+					 size_t len, bool acked)
+{
+}
+
+static inline void tcp_sack_reset(struct tcp *conn)
+{
+}
+#endif /* CONFIG_NET_TCP_SACK */
+
+/* Enable the options that both ends offered in the handshake */
+static void tcp_options_negotiate(struct tcp *conn)
+{
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	if (conn->recv_options.wnd_found) {
+		conn->send_win_shift = conn->recv_options.window;
+		conn->wnd_scale_ok = true;
+	} else {
+		/* The advertised window is capped to 65535 bytes */
+		conn->recv_win_shift = 0U;
+	}
+#endif
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->sack_ok = conn->recv_options.sack_perm_found;
+#endif
+	NET_DBG("conn: %p window scale %s, SACK %s", conn,
+		conn->wnd_scale_ok ? "on" : "off", conn->sack_ok ? "on" : "off");
+}
+
 static void tcp_resend_data(struct k_work *work)
 {
 	struct tcp *conn = CONTAINER_OF(work, struct tcp, send_data_timer);
@@ -1054,6 +1580,11 @@ static void tcp_resend_data(struct k_work *work)
 	conn->data_mode = TCP_DATA_MODE_RESEND;
 	conn->unacked_len = 0;
 
+	/* The peer may discard the data it has selectively acknowledged
+	 * (RFC 2018 ch 8), so everything is sent again.
+	 */
+	tcp_sack_reset(conn);
+
 	ret = tcp_send_data(conn);
 	if (ret == 0) {
 		conn->send_data_retries++;
@@ -1167,12 +1698,22 @@ static struct tcp *tcp_conn_alloc(void)
 	conn->in_connect = false;
 	conn->state = TCP_LISTEN;
 	conn->recv_win = tcp_window;
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	while ((conn->recv_win >> conn->recv_win_shift) > UINT16_MAX &&
+	       conn->recv_win_shift < TCP_MAX_WINDOW_SHIFT) {
+		conn->recv_win_shift++;
+	}
+#else
+	conn->recv_win = MIN(conn->recv_win, UINT16_MAX);
+#endif
 
 	/* The ISN value will be set when we get the connection attempt or
 	 * when trying to create a connection.
 	 */
 	conn->seq = 0U;
 
+	conn->tcp_nodelay = !IS_ENABLED(CONFIG_NET_TCP_NAGLE);
+
 	sys_slist_init(&conn->send_queue);
 
 	k_work_init_delayable(&conn->send_timer, tcp_send_process);
@@ -1180,6 +1721,7 @@ static struct tcp *tcp_conn_alloc(void)
 	k_work_init_delayable(&conn->fin_timer, tcp_fin_timeout);
 	k_work_init_delayable(&conn->send_data_timer, tcp_resend_data);
 	k_work_init_delayable(&conn->recv_queue_timer, tcp_cleanup_recv_queue);
+	k_work_init_delayable(&conn->cork_timer, tcp_cork_timeout);
 
 	tcp_conn_ref(conn);
 
@@ -1289,6 +1831,12 @@ static enum net_verdict tcp_recv(struct net_conn *net_conn,
 		net_ipaddr_copy(&conn_old->context->remote, &conn->dst.sa);
 
 		conn->accepted_conn = conn_old;
+
+		/* The accepted connection inherits the options set on the
+		 * listening socket.
+		 */
+		conn->tcp_nodelay = conn_old->tcp_nodelay;
+		conn->tcp_cork = conn_old->tcp_cork;
 	}
  in:
 	if (conn) {
@@ -1633,6 +2181,7 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 	uint8_t next = 0, fl = 0;
 	bool do_close = false;
 	bool connection_ok = false;
+	bool data_acked = false;
 	size_t tcp_options_len = th ? (th_off(th) - 5) * 4 : 0;
 	struct net_conn *conn_handler = NULL;
 	struct net_pkt *recv_pkt;
@@ -1669,6 +2218,10 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 		goto next_state;
 	}
 
+#if defined(CONFIG_NET_TCP_SACK)
+	conn->recv_options.sack_count = 0;
+#endif
+
 	if (tcp_options_len && !tcp_options_check(&conn->recv_options, pkt,
 						  tcp_options_len)) {
 		NET_DBG("DROP: Invalid TCP option list");
@@ -1682,6 +2235,12 @@ static void tcp_in(struct tcp *conn, struct net_pkt *pkt)
 
 		conn->send_win = ntohs(th_win(th));
 
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+		if (conn->wnd_scale_ok && !(th_flags(th) & SYN)) {
+			conn->send_win <<= conn->send_win_shift;
+		}
+#endif
+
 #if defined(CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE)
 		if (CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE) {
 			max_win = CONFIG_NET_TCP_MAX_SEND_WINDOW_SIZE;
@@ -1711,6 +2270,7 @@ next_state:
 	case TCP_LISTEN:
 		if (FL(&fl, ==, SYN)) {
 			conn_ack(conn, th_seq(th) + 1); /* capture peer's isn */
+			tcp_options_negotiate(conn);
 			tcp_out(conn, SYN | ACK);
 			conn_seq(conn, + 1);
 			next = TCP_SYN_RECEIVED;
@@ -1763,6 +2323,7 @@ next_state:
 		 */
 		if (FL(&fl, &, SYN | ACK, th && th_ack(th) == conn->seq)) {
 			tcp_send_timer_cancel(conn);
+			tcp_options_negotiate(conn);
 			conn_ack(conn, th_seq(th) + 1);
 			if (len) {
 				if (tcp_data_get(conn, pkt, &len) < 0) {
@@ -1823,8 +2384,8 @@ next_state:
 			NET_DBG("conn: %p len_acked=%u", conn, len_acked);
 
 			if ((conn->send_data_total < len_acked) ||
-					(tcp_pkt_pull(conn->send_data,
-						      len_acked) < 0)) {
+					(tcp_send_data_pull(conn,
+							    len_acked) < 0)) {
 				NET_ERR("conn: %p, Invalid len_acked=%u "
 					"(total=%zu)", conn, len_acked,
 					conn->send_data_total);
@@ -1842,6 +2403,7 @@ next_state:
 			}
 			conn_seq(conn, + len_acked);
 			net_stats_update_tcp_seg_recv(conn->iface);
+			data_acked = true;
 
 			conn_send_data_dump(conn);
 
@@ -1876,6 +2438,10 @@ next_state:
 			}
 		}
 
+		if (th && (th_flags(th) & ACK)) {
+			tcp_sack_ack_received(conn, th, len, data_acked);
+		}
+
 		if (th && len) {
 			if (th_seq(th) == conn->ack) {
 				if (!tcp_data_received(conn, pkt, &len)) {
@@ -1888,6 +2454,11 @@ next_state:
 			} else if (CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT) {
 				tcp_out_of_order_data(conn, pkt, len,
 						      th_seq(th));
+
+				/* Report the queued data to the peer */
+				if (conn->sack_ok) {
+					tcp_out(conn, ACK);
+				}
 			}
 		}
 		break;
@@ -2136,9 +2707,21 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		goto out;
 	}
 
+	if (ret == -ENOBUFS && conn->unacked_len > conn->send_data_total - len) {
+		/* Part of the pkt data has already been sent, and the segments
+		 * may still reference it. Keep all of it queued, the rest is
+		 * sent as the peer acknowledges the data or when the
+		 * retransmit timer expires.
+		 */
+		(void)k_work_schedule_for_queue(&tcp_work_q,
+						&conn->send_data_timer,
+						K_MSEC(tcp_rto));
+		ret = 0;
+	}
+
 	if (ret == -ENOBUFS) {
-		/* Restore the original data so that we do not resend the pkt
-		 * data multiple times.
+		/* None of the pkt data was sent, restore the original data so
+		 * that we do not resend the pkt data multiple times.
 		 */
 		conn->send_data_total -= len;
 
@@ -2161,6 +2744,91 @@ out:
 	return ret;
 }
 
+int net_tcp_set_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       const void *value, size_t len)
+{
+	struct tcp *conn = context->tcp;
+	int ret = 0;
+
+	if (!conn) {
+		/* Nothing to apply the option to, ignore it */
+		return 0;
+	}
+
+	if (len != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	switch (option) {
+	case TCP_OPT_NODELAY:
+		conn->tcp_nodelay = *(const int *)value != 0;
+		break;
+
+	case TCP_OPT_CORK:
+		conn->tcp_cork = *(const int *)value != 0;
+		if (!conn->tcp_cork) {
+			k_work_cancel_delayable(&conn->cork_timer);
+		}
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	/* Data that is no longer held back is sent out right away */
+	if (ret == 0 && conn->state == TCP_ESTABLISHED) {
+		(void)tcp_send_queued_data(conn);
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	return ret;
+}
+
+int net_tcp_get_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       void *value, size_t *len)
+{
+	struct tcp *conn = context->tcp;
+	int ret = 0;
+
+	if (!conn) {
+		return -ENOTCONN;
+	}
+
+	if (*len < sizeof(int)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&conn->lock, K_FOREVER);
+
+	switch (option) {
+	case TCP_OPT_NODELAY:
+		*(int *)value = conn->tcp_nodelay;
+		break;
+
+	case TCP_OPT_CORK:
+		*(int *)value = conn->tcp_cork;
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&conn->lock);
+
+	if (ret == 0) {
+		*len = sizeof(int);
+	}
+
+	return ret;
+}
+
 /* net context is about to send out queued data - inform caller only */
 int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
 		      void *user_data)
@@ -2449,6 +3117,10 @@ static enum net_verdict tcp_input(struct net_conn *net_conn,
 			tcp_conn_ref(conn);
 		}
 
+		if (conn && tcp_data_len(pkt) > 0 && tp_drop(TP_DROP_RX)) {
+			conn = NULL;
+		}
+
 		if (conn) {
 			conn->iface = pkt->iface;
 			tcp_in(conn, pkt);
@@ -2628,6 +3300,10 @@ enum net_verdict tp_input(struct net_conn *net_conn,
 		tp_new_find_and_apply(tp_new, "tcp_window", &tcp_window,
 					TP_INT);
 		tp_new_find_and_apply(tp_new, "tp_trace", &tp_trace, TP_BOOL);
+		tp_new_find_and_apply(tp_new, "tp_drop_tx", &tp_drop_tx,
+					TP_INT);
+		tp_new_find_and_apply(tp_new, "tp_drop_rx", &tp_drop_rx,
+					TP_INT);
 		break;
 	case TP_INTROSPECT_REQUEST:
 		json_len = sizeof(buf);
@@ -125,7 +125,7 @@
 #define conn_send_data_dump(_conn)                                             \
 	({                                                                     \
 		NET_DBG("conn: %p total=%zd, unacked_len=%d, "                 \
-			"send_win=%hu, mss=%hu",                               \
+			"send_win=%u, mss=%hu",                                \
 			(_conn), net_pkt_get_len((_conn)->send_data),          \
 			conn->unacked_len, conn->send_win,                     \
 			(uint16_t)conn_mss((_conn)));                          \
@@ -141,6 +141,17 @@
 #define TCPOPT_NOP	1
 #define TCPOPT_MAXSEG	2
 #define TCPOPT_WINDOW	3
+#define TCPOPT_SACK_PERM	4
+#define TCPOPT_SACK	5
+
+/* Largest window shift allowed by RFC 7323 */
+#define TCP_MAX_WINDOW_SHIFT 14
+
+/* A full option list without timestamps has room for 4 SACK blocks */
+#define TCP_SACK_MAX_BLOCKS 4
+
+/* Duplicate ACKs that mark the first unacknowledged segment as lost */
+#define TCP_DUP_ACK_THRESHOLD 3
 
 enum pkt_addr {
 	TCP_EP_SRC = 1,
@@ -196,17 +207,33 @@ enum tcp_data_mode {
 	TCP_DATA_MODE_RESEND = 1
 };
 
+/* Connection options set by the application, see net_tcp_set_option() */
+enum tcp_conn_option {
+	TCP_OPT_NODELAY = 1, /* Disable Nagle's algorithm, int value */
+	TCP_OPT_CORK = 2,    /* Do not send partial segments, int value */
+};
+
 union tcp_endpoint {
 	struct sockaddr sa;
 	struct sockaddr_in sin;
 	struct sockaddr_in6 sin6;
 };
 
+struct tcp_sack_block {
+	uint32_t left;  /* First sequence number of the block */
+	uint32_t right; /* Sequence number following the block */
+};
+
 struct tcp_options {
 	uint16_t mss;
 	uint16_t window;
+#if defined(CONFIG_NET_TCP_SACK)
+	struct tcp_sack_block sack[TCP_SACK_MAX_BLOCKS];
+	uint8_t sack_count;
+#endif
 	bool mss_found : 1;
 	bool wnd_found : 1;
+	bool sack_perm_found : 1;
 };
 
 struct tcp { /* TCP connection */
@@ -237,6 +264,7 @@ struct tcp { /* TCP connection */
 		struct k_work_delayable fin_timer;
 		struct k_work_delayable establish_timer;
 	};
+	struct k_work_delayable cork_timer;
 	union tcp_endpoint src;
 	union tcp_endpoint dst;
 	size_t send_data_total;
@@ -247,12 +275,27 @@ struct tcp { /* TCP connection */
 	enum tcp_data_mode data_mode;
 	uint32_t seq;
 	uint32_t ack;
-	uint16_t recv_win;
-	uint16_t send_win;
+	uint32_t recv_win;
+	uint32_t send_win;
+#if defined(CONFIG_NET_TCP_SACK)
+	/* Data above seq that the peer has selectively acknowledged */
+	struct tcp_sack_block sacked[TCP_SACK_MAX_BLOCKS];
+	uint8_t sacked_count;
+	uint8_t dup_acks;
+#endif
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	uint8_t recv_win_shift;
+	uint8_t send_win_shift;
+#endif
 	uint8_t send_data_retries;
 	bool in_retransmission : 1;
 	bool in_connect : 1;
 	bool in_close : 1;
+	bool tcp_nodelay : 1;
+	bool tcp_cork : 1;
+	bool wnd_scale_ok : 1; /* Window scale option negotiated */
+	bool sack_ok : 1;      /* SACK permitted option negotiated */
+	bool in_sack_recovery : 1;
 };
 
 #define _flags(_fl, _op, _mask, _cond)					\
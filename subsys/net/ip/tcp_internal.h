@@ -359,6 +359,68 @@ static inline int net_tcp_put(struct net_context *context)
 }
 #endif
 
+/**
+ * @brief Set TCP connection option
+ *
+ * @param context Network context
+ * @param option Option to set
+ * @param value Option value
+ * @param len Length of the option value
+ *
+ * The option is ignored if the context has no TCP connection.
+ *
+ * @return 0 on success, -EINVAL if the option or value is invalid or
+ *         -EPROTONOSUPPORT if TCP is not supported
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_set_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       const void *value, size_t len);
+#else
+static inline int net_tcp_set_option(struct net_context *context,
+				     enum tcp_conn_option option,
+				     const void *value, size_t len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(option);
+	ARG_UNUSED(value);
+	ARG_UNUSED(len);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
+/**
+ * @brief Get TCP connection option
+ *
+ * @param context Network context
+ * @param option Option to get
+ * @param value Option value
+ * @param len Length of the option value buffer, updated to the length of
+ *        the returned value
+ *
+ * @return 0 on success, -EINVAL if the option or length is invalid,
+ *         -ENOTCONN if there is no TCP connection or -EPROTONOSUPPORT
+ *         if TCP is not supported
+ */
+#if defined(CONFIG_NET_NATIVE_TCP)
+int net_tcp_get_option(struct net_context *context,
+		       enum tcp_conn_option option,
+		       void *value, size_t *len);
+#else
+static inline int net_tcp_get_option(struct net_context *context,
+				     enum tcp_conn_option option,
+				     void *value, size_t *len)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(option);
+	ARG_UNUSED(value);
+	ARG_UNUSED(len);
+
+	return -EPROTONOSUPPORT;
+}
+#endif
+
 #define NET_TCP_MAX_OPT_SIZE  8
 
 #if defined(CONFIG_NET_NATIVE_TCP)
@@ -20,6 +20,11 @@ static sys_slist_t tp_seq = SYS_SLIST_STATIC_INIT(&tp_seq);
 bool tp_trace;
 enum tp_type tp_state = TP_NONE;
 
+/* Drop every Nth TCP data segment sent or received, 0 disables */
+int tp_drop_tx;
+int tp_drop_rx;
+static int tp_drop_count[2];
+
 char *tp_basename(char *path)
 {
 	char *filename = strrchr(path, '/');
@@ -315,6 +320,21 @@ uint32_t tp_seq_track(int kind, uint32_t *pvalue, int req,
 	return seq->value;
 }
 
+bool tp_drop(int kind)
+{
+	int every = kind == TP_DROP_TX ? tp_drop_tx : tp_drop_rx;
+
+	if (every <= 0 || ++tp_drop_count[kind] < every) {
+		return false;
+	}
+
+	tp_drop_count[kind] = 0;
+
+	tp_dbg("dropped %s segment", kind == TP_DROP_TX ? "tx" : "rx");
+
+	return true;
+}
+
 void tp_seq_stat(void)
 {
 	struct tp_seq *seq;
@@ -24,6 +24,9 @@ extern "C" {
 #define TP_BOOL	1
 #define TP_INT	2
 
+#define TP_DROP_TX 0
+#define TP_DROP_RX 1
+
 enum tp_type { /* Test protocol message type */
 	TP_NONE = 0,
 	TP_COMMAND,
@@ -47,6 +50,8 @@ enum tp_type { /* Test protocol message type */
 
 extern bool tp_trace;
 extern enum tp_type tp_state;
+extern int tp_drop_tx;
+extern int tp_drop_rx;
 
 struct tp_msg {
 	const char *msg;
@@ -150,6 +155,8 @@ uint32_t tp_seq_track(int kind, uint32_t *pvalue, int req,
 			const char *file, int line, const char *func);
 void tp_seq_stat(void);
 
+bool tp_drop(int kind);
+
 struct tp *json_to_tp(void *data, size_t data_len);
 enum tp_type json_decode_msg(void *data, size_t data_len);
 struct tp_new *json_to_tp_new(void *data, size_t data_len);
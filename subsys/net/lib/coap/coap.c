@@ -49,6 +49,34 @@ LOG_MODULE_REGISTER(net_coap, CONFIG_COAP_LOG_LEVEL);
 /* The CoAP message ID that is incremented each time coap_next_id() is called. */
 static uint16_t message_id;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+static void option_index_reset(struct coap_packet *cpkt)
+{
+	cpkt->opt_count = 0U;
+	cpkt->opt_indexed = true;
+}
+
+static void option_index_add(struct coap_packet *cpkt, uint16_t code,
+			     uint16_t offset, uint16_t len)
+{
+	struct coap_option_ref *ref;
+
+	if (cpkt->opt_count == ARRAY_SIZE(cpkt->opt_index)) {
+		/* Options will be found by walking the packet */
+		cpkt->opt_indexed = false;
+		return;
+	}
+
+	ref = &cpkt->opt_index[cpkt->opt_count++];
+	ref->code = code;
+	ref->offset = offset;
+	ref->len = len;
+}
+#else
+#define option_index_reset(cpkt)
+#define option_index_add(cpkt, code, offset, len)
+#endif
+
 static inline bool append_u8(struct coap_packet *cpkt, uint8_t data)
 {
 	if (!cpkt) {
@@ -113,6 +141,7 @@ int coap_packet_init(struct coap_packet *cpkt, uint8_t *data, uint16_t max_len,
 	cpkt->offset = 0U;
 	cpkt->max_len = max_len;
 	cpkt->delta = 0U;
+	option_index_reset(cpkt);
 
 	hdr = (ver & 0x3) << 6;
 	hdr |= (type & 0x3) << 4;
@@ -282,6 +311,7 @@ int coap_packet_append_option(struct coap_packet *cpkt, uint16_t code,
 
 	cpkt->opt_len += r;
 	cpkt->delta += code;
+	option_index_add(cpkt, cpkt->delta, cpkt->offset - len, len);
 
 	return 0;
 }
@@ -446,7 +476,7 @@ static int decode_delta(uint8_t *data, uint16_t offset, uint16_t *pos, uint16_t
 
 static int parse_option(uint8_t *data, uint16_t offset, uint16_t *pos,
 			uint16_t max_len, uint16_t *opt_delta, uint16_t *opt_len,
-			struct coap_option *option)
+			struct coap_option *option, uint16_t *value_len)
 {
 	uint16_t hdr_len;
 	uint16_t delta;
@@ -517,6 +547,10 @@ static int parse_option(uint8_t *data, uint16_t offset, uint16_t *pos,
 		return -EINVAL;
 	}
 
+	if (value_len) {
+		*value_len = len;
+	}
+
 	if (option) {
 		/*
 		 * Make sure the option data will fit into the value field of
@@ -576,6 +610,7 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	cpkt->opt_len = 0U;
 	cpkt->hdr_len = 0U;
 	cpkt->delta = 0U;
+	option_index_reset(cpkt);
 
 	/* Token lengths 9-15 are reserved. */
 	tkl = cpkt->data[0] & 0x0f;
@@ -599,13 +634,22 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 
 	while (1) {
 		struct coap_option *option;
+		bool marker = cpkt->data[offset] == COAP_MARKER;
+		uint16_t value_len;
 
 		option = num < opt_num ? &options[num++] : NULL;
 		ret = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
-				   &delta, &opt_len, option);
+				   &delta, &opt_len, option, &value_len);
 		if (ret < 0) {
 			return ret;
-		} else if (ret == 0) {
+		}
+
+		if (!marker) {
+			option_index_add(cpkt, delta, offset - value_len,
+					 value_len);
+		}
+
+		if (ret == 0) {
 			break;
 		}
 	}
@@ -616,6 +660,38 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	return 0;
 }
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+static int find_indexed_options(const struct coap_packet *cpkt, uint16_t code,
+				struct coap_option *options, uint16_t veclen)
+{
+	uint16_t num = 0U;
+
+	for (uint8_t i = 0U; i < cpkt->opt_count && num < veclen; i++) {
+		const struct coap_option_ref *ref = &cpkt->opt_index[i];
+
+		/* Options are in ascending order */
+		if (ref->code < code) {
+			continue;
+		} else if (ref->code > code) {
+			break;
+		}
+
+		if (ref->len > sizeof(options[num].value)) {
+			NET_ERR("%u is > sizeof(coap_option->value)(%zu)!",
+				ref->len, sizeof(options[num].value));
+			return -EINVAL;
+		}
+
+		options[num].delta = code;
+		options[num].len = ref->len;
+		memcpy(options[num].value, cpkt->data + ref->offset, ref->len);
+		num++;
+	}
+
+	return num;
+}
+#endif
+
 int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 		      struct coap_option *options, uint16_t veclen)
 {
@@ -625,6 +701,12 @@ int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 	uint8_t num;
 	int r;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->opt_indexed) {
+		return find_indexed_options(cpkt, code, options, veclen);
+	}
+#endif
+
 	/* Check if there are options to parse */
 	if (cpkt->hdr_len == cpkt->max_len) {
 		return 0;
@@ -636,9 +718,14 @@ int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 	num = 0U;
 
 	while (delta <= code && num < veclen) {
+		/* The marker does not fill options[num] */
+		if (cpkt->data[offset] == COAP_MARKER) {
+			break;
+		}
+
 		r = parse_option(cpkt->data, offset, &offset,
 				 cpkt->max_len, &delta, &opt_len,
-				 &options[num]);
+				 &options[num], NULL);
 		if (r < 0) {
 			return -EINVAL;
 		}
@@ -817,6 +904,478 @@ static bool uri_path_eq(const struct coap_packet *cpkt,
 	return true;
 }
 
+/* Finds the Uri-Path options in the index, which are contiguous. Sets
+ * refs to NULL if the options of the packet are not indexed.
+ */
+static uint8_t uri_path_refs(const struct coap_packet *cpkt,
+			     const struct coap_option_ref **refs)
+{
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	uint8_t first;
+	uint8_t i;
+
+	if (!cpkt->opt_indexed) {
+		*refs = NULL;
+		return 0;
+	}
+
+	for (first = 0U; first < cpkt->opt_count; first++) {
+		if (cpkt->opt_index[first].code >= COAP_OPTION_URI_PATH) {
+			break;
+		}
+	}
+
+	for (i = first; i < cpkt->opt_count; i++) {
+		if (cpkt->opt_index[i].code != COAP_OPTION_URI_PATH) {
+			break;
+		}
+	}
+
+	*refs = &cpkt->opt_index[first];
+
+	return i - first;
+#else
+	*refs = NULL;
+
+	return 0;
+#endif
+}
+
+static bool uri_path_refs_eq(const struct coap_packet *cpkt,
+			     const char * const *path,
+			     const struct coap_option_ref *refs,
+			     uint8_t ref_num)
+{
+	uint8_t j;
+
+	for (j = 0U; j < ref_num && path[j]; j++) {
+		size_t len = strlen(path[j]);
+
+		if (IS_ENABLED(CONFIG_COAP_URI_WILDCARD) && len == 1) {
+			if (*path[j] == '+') {
+				/* Single-level wildcard */
+				continue;
+			} else if (*path[j] == '#') {
+				/* Multi-level wildcard */
+				return true;
+			}
+		}
+
+		if (refs[j].len != len ||
+		    memcmp(cpkt->data + refs[j].offset, path[j], len)) {
+			return false;
+		}
+	}
+
+	return j == ref_num && !path[j];
+}
+
+#if defined(CONFIG_COAP_RESOURCE_TRIE)
+static sys_slist_t resource_tries = SYS_SLIST_STATIC_INIT(&resource_tries);
+static struct k_spinlock resource_tries_lock;
+
+/* Uri-Path options of a request, from the option index or from the
+ * options parsed by the caller
+ */
+struct uri_segments {
+	const struct coap_packet *cpkt;
+	const struct coap_option_ref *refs;
+	const struct coap_option *options;
+	uint8_t num;
+};
+
+static void uri_segments_get(const struct coap_packet *cpkt,
+			     const struct coap_option *options,
+			     uint8_t opt_num, struct uri_segments *segs)
+{
+	uint8_t first;
+	uint8_t i;
+
+	segs->cpkt = cpkt;
+	segs->num = uri_path_refs(cpkt, &segs->refs);
+	if (segs->refs != NULL) {
+		return;
+	}
+
+	for (first = 0U; first < opt_num; first++) {
+		if (options[first].delta == COAP_OPTION_URI_PATH) {
+			break;
+		}
+	}
+
+	for (i = first; i < opt_num; i++) {
+		if (options[i].delta != COAP_OPTION_URI_PATH) {
+			break;
+		}
+	}
+
+	segs->options = (i > first) ? &options[first] : NULL;
+	segs->num = i - first;
+}
+
+static const uint8_t *uri_segment(const struct uri_segments *segs, uint8_t i,
+				  uint16_t *len)
+{
+	if (segs->refs != NULL) {
+		*len = segs->refs[i].len;
+		return segs->cpkt->data + segs->refs[i].offset;
+	}
+
+	*len = segs->options[i].len;
+	return segs->options[i].value;
+}
+
+static int trie_segment_cmp(const struct coap_resource_trie_node *node,
+			    const void *segment, uint16_t len)
+{
+	if (node->len != len) {
+		return node->len < len ? -1 : 1;
+	}
+
+	return memcmp(node->segment, segment, len);
+}
+
+/* Returns the index of the child of parent for the segment, 0 if none */
+static uint16_t trie_child(const struct coap_resource_trie_node *nodes,
+			   const struct coap_resource_trie_node *parent,
+			   const void *segment, uint16_t len)
+{
+	uint16_t lo = parent->children;
+	uint16_t hi = parent->children + parent->num_children;
+
+	while (lo < hi) {
+		uint16_t mid = lo + (hi - lo) / 2U;
+		int cmp = trie_segment_cmp(&nodes[mid], segment, len);
+
+		if (cmp == 0) {
+			return mid;
+		} else if (cmp < 0) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return 0;
+}
+
+/* Resources are stored as 1 + their index, 0 meaning none */
+static uint16_t trie_lowest(uint16_t a, uint16_t b)
+{
+	if (a == 0U || (b != 0U && b < a)) {
+		return b;
+	}
+
+	return a;
+}
+
+/* Returns the first resource of the table matching the segments of the
+ * request from depth on. Wildcards may match along with the segment
+ * itself, all of them are tried to find the first resource.
+ */
+static uint16_t trie_match(const struct coap_resource_trie_node *nodes,
+			   uint16_t node, const struct uri_segments *segs,
+			   uint8_t depth)
+{
+	const struct coap_resource_trie_node *n = &nodes[node];
+	const uint8_t *segment;
+	uint16_t resource = 0U;
+	uint16_t child;
+	uint16_t len;
+
+	if (depth == segs->num) {
+		return n->resource;
+	}
+
+	segment = uri_segment(segs, depth, &len);
+	child = trie_child(nodes, n, segment, len);
+	if (child != 0U) {
+		resource = trie_match(nodes, child, segs, depth + 1);
+	}
+
+#if defined(CONFIG_COAP_URI_WILDCARD)
+	/* Single-level wildcard */
+	child = trie_child(nodes, n, "+", 1);
+	if (child != 0U) {
+		resource = trie_lowest(resource,
+				       trie_match(nodes, child, segs, depth + 1));
+	}
+
+	/* Multi-level wildcard, whatever follows it */
+	child = trie_child(nodes, n, "#", 1);
+	if (child != 0U) {
+		resource = trie_lowest(resource, nodes[child].subtree);
+	}
+#endif
+
+	return resource;
+}
+
+/* Nodes of the level being built hold the index of their parent in
+ * children, and are ordered by parent then segment.
+ */
+static int trie_node_cmp(const struct coap_resource_trie_node *a,
+			 const struct coap_resource_trie_node *b)
+{
+	if (a->children != b->children) {
+		return a->children < b->children ? -1 : 1;
+	}
+
+	return trie_segment_cmp(a, b->segment, b->len);
+}
+
+static void trie_nodes_sort(struct coap_resource_trie_node *nodes, size_t n)
+{
+	/* Shell sort, the minimal libc has no qsort() */
+	for (size_t gap = n / 2U; gap > 0; gap /= 2U) {
+		for (size_t i = gap; i < n; i++) {
+			struct coap_resource_trie_node tmp = nodes[i];
+			size_t j;
+
+			for (j = i; j >= gap &&
+			     trie_node_cmp(&nodes[j - gap], &tmp) > 0; j -= gap) {
+				nodes[j] = nodes[j - gap];
+			}
+
+			nodes[j] = tmp;
+		}
+	}
+}
+
+/* Finds the node reached by the first depth segments of the path, returns
+ * false if the path does not have more than depth segments
+ */
+static bool trie_parent(const struct coap_resource_trie_node *nodes,
+			const char * const *path, uint8_t depth,
+			uint16_t *parent)
+{
+	uint16_t node = 0U;
+
+	for (uint8_t i = 0U; i < depth; i++) {
+		if (!path[i]) {
+			return false;
+		}
+
+		node = trie_child(nodes, &nodes[node], path[i],
+				  strlen(path[i]));
+	}
+
+	*parent = node;
+
+	return path[depth] != NULL;
+}
+
+/* Adds the nodes at depth + 1 to the trie, returns their number */
+static int trie_level_build(struct coap_resource_trie *trie,
+			    uint16_t num_resources, uint8_t depth,
+			    uint16_t *num_nodes)
+{
+	struct coap_resource_trie_node *nodes = trie->nodes;
+	uint16_t first = *num_nodes;
+	uint16_t last = first;
+	uint16_t i;
+
+	/* One node per resource having a path of more than depth
+	 * segments, the duplicates are merged after sorting
+	 */
+	for (uint16_t r = 0U; r < num_resources; r++) {
+		const char * const *path = trie->resources[r].path;
+		struct coap_resource_trie_node *node;
+		uint16_t parent;
+
+		if (!trie_parent(nodes, path, depth, &parent)) {
+			continue;
+		}
+
+		if (*num_nodes == trie->max_nodes) {
+			return -ENOMEM;
+		}
+
+		node = &nodes[(*num_nodes)++];
+		node->segment = path[depth];
+		node->len = strlen(path[depth]);
+		node->children = parent;
+		node->num_children = 0U;
+		node->resource = path[depth + 1] ? 0U : r + 1U;
+	}
+
+	trie_nodes_sort(&nodes[first], *num_nodes - first);
+
+	for (i = first; i < *num_nodes; i++) {
+		if (last > first && trie_node_cmp(&nodes[last - 1], &nodes[i]) == 0) {
+			nodes[last - 1].resource =
+				trie_lowest(nodes[last - 1].resource,
+					    nodes[i].resource);
+			continue;
+		}
+
+		nodes[last++] = nodes[i];
+	}
+
+	*num_nodes = last;
+
+	/* Children of a node are contiguous */
+	for (i = first; i < last; i++) {
+		struct coap_resource_trie_node *parent =
+			&nodes[nodes[i].children];
+
+		if (parent->num_children == 0U) {
+			parent->children = i;
+		}
+
+		parent->num_children++;
+		nodes[i].children = 0U;
+	}
+
+	return last - first;
+}
+
+int coap_resource_trie_init(struct coap_resource_trie *trie,
+			    struct coap_resource *resources,
+			    struct coap_resource_trie_node *nodes,
+			    uint16_t max_nodes)
+{
+	k_spinlock_key_t key;
+	uint16_t num_resources;
+	uint16_t num_nodes;
+	uint8_t depth;
+	int r;
+
+	if (!trie || !resources || !nodes || !max_nodes) {
+		return -EINVAL;
+	}
+
+	coap_resource_trie_deinit(trie);
+
+	for (num_resources = 0U; resources[num_resources].path;
+	     num_resources++) {
+		if (num_resources == UINT16_MAX - 1) {
+			return -EINVAL;
+		}
+	}
+
+	trie->resources = resources;
+	trie->nodes = nodes;
+	trie->max_nodes = max_nodes;
+
+	memset(&nodes[0], 0, sizeof(nodes[0]));
+	for (uint16_t i = 0U; i < num_resources; i++) {
+		if (!resources[i].path[0]) {
+			nodes[0].resource = i + 1U;
+			break;
+		}
+	}
+
+	num_nodes = 1U;
+	for (depth = 0U; depth < UINT8_MAX; depth++) {
+		r = trie_level_build(trie, num_resources, depth, &num_nodes);
+		if (r < 0) {
+			return r;
+		} else if (r == 0) {
+			break;
+		}
+	}
+
+#if defined(CONFIG_COAP_URI_WILDCARD)
+	/* Children come after their parent */
+	for (uint16_t i = num_nodes; i-- > 0;) {
+		struct coap_resource_trie_node *node = &nodes[i];
+
+		node->subtree = node->resource;
+		for (uint16_t c = 0U; c < node->num_children; c++) {
+			node->subtree = trie_lowest(node->subtree,
+					nodes[node->children + c].subtree);
+		}
+	}
+#endif
+
+	key = k_spin_lock(&resource_tries_lock);
+	sys_slist_append(&resource_tries, &trie->node);
+	k_spin_unlock(&resource_tries_lock, key);
+
+	return 0;
+}
+
+void coap_resource_trie_deinit(struct coap_resource_trie *trie)
+{
+	k_spinlock_key_t key;
+
+	if (!trie) {
+		return;
+	}
+
+	key = k_spin_lock(&resource_tries_lock);
+	(void)sys_slist_find_and_remove(&resource_tries, &trie->node);
+	k_spin_unlock(&resource_tries_lock, key);
+}
+
+static struct coap_resource_trie *
+resource_trie_get(const struct coap_resource *resources)
+{
+	struct coap_resource_trie *trie;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&resource_tries_lock);
+	SYS_SLIST_FOR_EACH_CONTAINER(&resource_tries, trie, node) {
+		if (trie->resources == resources) {
+			break;
+		}
+	}
+	k_spin_unlock(&resource_tries_lock, key);
+
+	return trie;
+}
+
+static struct coap_resource *
+resource_trie_find(const struct coap_resource_trie *trie,
+		   const struct coap_packet *cpkt,
+		   const struct coap_option *options, uint8_t opt_num)
+{
+	struct uri_segments segs;
+	uint16_t resource;
+
+	uri_segments_get(cpkt, options, opt_num, &segs);
+	resource = trie_match(trie->nodes, 0, &segs, 0);
+
+	return resource ? &trie->resources[resource - 1] : NULL;
+}
+#endif /* CONFIG_COAP_RESOURCE_TRIE */
+
+static struct coap_resource *resource_find(struct coap_resource *resources,
+					   const struct coap_packet *cpkt,
+					   struct coap_option *options,
+					   uint8_t opt_num)
+{
+	const struct coap_option_ref *refs;
+	struct coap_resource *resource;
+	uint8_t ref_num;
+
+#if defined(CONFIG_COAP_RESOURCE_TRIE)
+	struct coap_resource_trie *trie = resource_trie_get(resources);
+
+	if (trie) {
+		return resource_trie_find(trie, cpkt, options, opt_num);
+	}
+#endif
+
+	ref_num = uri_path_refs(cpkt, &refs);
+
+	/* FIXME: deal with hierarchical resources */
+	for (resource = resources; resource && resource->path; resource++) {
+		if (refs != NULL) {
+			if (uri_path_refs_eq(cpkt, resource->path, refs,
+					     ref_num)) {
+				return resource;
+			}
+		} else if (uri_path_eq(cpkt, resource->path, options,
+				       opt_num)) {
+			return resource;
+		}
+	}
+
+	return NULL;
+}
+
 static coap_method_t method_from_code(const struct coap_resource *resource,
 				      uint8_t code)
 {
@@ -848,31 +1407,26 @@ int coap_handle_request(struct coap_packet *cpkt,
 			struct sockaddr *addr, socklen_t addr_len)
 {
 	struct coap_resource *resource;
+	coap_method_t method;
+	uint8_t code;
 
 	if (!is_request(cpkt)) {
 		return 0;
 	}
 
-	/* FIXME: deal with hierarchical resources */
-	for (resource = resources; resource && resource->path; resource++) {
-		coap_method_t method;
-		uint8_t code;
-
-		if (!uri_path_eq(cpkt, resource->path, options, opt_num)) {
-			continue;
-		}
-
-		code = coap_header_get_code(cpkt);
-		method = method_from_code(resource, code);
-		if (!method) {
-			return -EPERM;
-		}
+	resource = resource_find(resources, cpkt, options, opt_num);
+	if (!resource) {
+		NET_DBG("%d", __LINE__);
+		return -ENOENT;
+	}
 
-		return method(resource, cpkt, addr, addr_len);
+	code = coap_header_get_code(cpkt);
+	method = method_from_code(resource, code);
+	if (!method) {
+		return -EPERM;
 	}
 
-	NET_DBG("%d", __LINE__);
-	return -ENOENT;
+	return method(resource, cpkt, addr, addr_len);
 }
 
 int coap_block_transfer_init(struct coap_block_context *ctx,
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(net_coap, CONFIG_COAP_LOG_LEVEL);
+
+#include <string.h>
+#include <errno.h>
+#include <sys/util.h>
+
+#include <net/net_core.h>
+#include <net/coap.h>
+
+/* Blocks [next_deliver, next_request) are in flight or stored. The
+ * block next_deliver is delivered as soon as it is received, so at most
+ * window - 1 blocks are stored, each in the slot of its number modulo
+ * window - 1 of buf.
+ */
+
+#define GET_BLOCK_SIZE(v) (((v) & 0x7))
+#define GET_MORE(v) (!!((v) & 0x08))
+#define GET_NUM(v) ((v) >> 4)
+
+#define LAST_UNKNOWN UINT32_MAX
+
+static inline uint16_t block_bytes(const struct coap_block_download *dl)
+{
+	return coap_block_size_to_bytes(dl->ctx.block_size);
+}
+
+static inline uint8_t buf_slot(const struct coap_block_download *dl,
+			       uint32_t num)
+{
+	return num % (dl->window - 1U);
+}
+
+/* With a window of one block, no block is ever stored */
+static inline bool stored(const struct coap_block_download *dl,
+			  uint32_t num)
+{
+	return dl->window > 1U && (dl->buffered & BIT(buf_slot(dl, num)));
+}
+
+static int request_block(struct coap_block_download *dl, uint32_t num)
+{
+	struct coap_block_context block = {
+		.total_size = dl->ctx.total_size,
+		.current = (size_t)num * block_bytes(dl),
+		.block_size = dl->ctx.block_size,
+	};
+
+	return dl->request(dl, &block);
+}
+
+static int deliver(struct coap_block_download *dl, const uint8_t *data,
+		   uint16_t len)
+{
+	size_t offset = dl->ctx.current;
+	bool last = dl->next_deliver == dl->last;
+	int r;
+
+	r = dl->sink(dl, data, len, offset, last);
+	if (r < 0) {
+		return r;
+	}
+
+	dl->ctx.current += len;
+	dl->next_deliver++;
+
+	return 0;
+}
+
+/* Fill the window, only requesting a block at a time while the number
+ * of blocks is unknown.
+ */
+static int request_more(struct coap_block_download *dl)
+{
+	uint32_t window = dl->last == LAST_UNKNOWN ? 1U : dl->window;
+	int r;
+
+	while (dl->next_request - dl->next_deliver < window &&
+	       dl->next_request <= dl->last) {
+		dl->retries[dl->next_request % dl->window] = 0U;
+
+		r = request_block(dl, dl->next_request);
+		if (r < 0) {
+			return r;
+		}
+
+		dl->next_request++;
+	}
+
+	return 0;
+}
+
+static int update_size(struct coap_block_download *dl,
+		       const struct coap_packet *response, int block,
+		       uint16_t len)
+{
+	uint16_t bytes;
+	int size;
+
+	if (!dl->negotiated) {
+		/* The server may use smaller blocks than requested */
+		if (GET_BLOCK_SIZE(block) > dl->ctx.block_size) {
+			return -EBADMSG;
+		}
+
+		dl->ctx.block_size = GET_BLOCK_SIZE(block);
+		dl->negotiated = true;
+
+		size = coap_get_option_int(response, COAP_OPTION_SIZE2);
+		if (size > 0) {
+			dl->ctx.total_size = size;
+			dl->last = (size - 1) / block_bytes(dl);
+		}
+	} else if (GET_BLOCK_SIZE(block) != dl->ctx.block_size) {
+		return -EBADMSG;
+	}
+
+	bytes = block_bytes(dl);
+
+	if (GET_MORE(block)) {
+		if (len != bytes || GET_NUM(block) >= dl->last) {
+			return -EBADMSG;
+		}
+	} else {
+		if (len > bytes || GET_NUM(block) > dl->last) {
+			return -EBADMSG;
+		}
+
+		dl->last = GET_NUM(block);
+		dl->ctx.total_size = (size_t)dl->last * bytes + len;
+	}
+
+	return 0;
+}
+
+int coap_block_download_init(struct coap_block_download *dl,
+			     coap_block_download_request_t request,
+			     coap_block_download_sink_t sink,
+			     enum coap_block_size block_size, uint8_t window,
+			     uint8_t *buf, size_t buf_len)
+{
+	if (!dl || !request || !sink || window == 0U ||
+	    window > CONFIG_COAP_BLOCK_DOWNLOAD_MAX_WINDOW) {
+		return -EINVAL;
+	}
+
+	if (buf_len < (size_t)(window - 1U) *
+		      coap_block_size_to_bytes(block_size)) {
+		return -ENOMEM;
+	}
+
+	memset(dl, 0, sizeof(*dl));
+
+	dl->request = request;
+	dl->sink = sink;
+	dl->buf = buf;
+	dl->window = window;
+
+	return coap_block_transfer_init(&dl->ctx, block_size, 0);
+}
+
+int coap_block_download_start(struct coap_block_download *dl)
+{
+	dl->ctx.total_size = 0;
+	dl->ctx.current = 0;
+	dl->next_deliver = 0U;
+	dl->next_request = 0U;
+	dl->last = LAST_UNKNOWN;
+	dl->buffered = 0U;
+	dl->negotiated = false;
+
+	return request_more(dl);
+}
+
+int coap_block_download_response(struct coap_block_download *dl,
+				 const struct coap_packet *response)
+{
+	const uint8_t *payload;
+	uint16_t len;
+	uint32_t num;
+	uint8_t slot;
+	int block;
+	int r;
+
+	payload = coap_packet_get_payload(response, &len);
+
+	block = coap_get_option_int(response, COAP_OPTION_BLOCK2);
+	if (block == -ENOENT) {
+		/* The server sent the whole resource at once */
+		if (dl->negotiated) {
+			return -EBADMSG;
+		}
+
+		dl->negotiated = true;
+		dl->last = 0U;
+		dl->ctx.total_size = len;
+
+		r = deliver(dl, payload, len);
+
+		return r < 0 ? r : 1;
+	} else if (block < 0) {
+		return -EBADMSG;
+	}
+
+	num = GET_NUM(block);
+	if (num < dl->next_deliver || num >= dl->next_request) {
+		NET_DBG("Ignoring block %u", num);
+		return 0;
+	}
+
+	if (num != dl->next_deliver && stored(dl, num)) {
+		NET_DBG("Ignoring duplicate block %u", num);
+		return 0;
+	}
+
+	r = update_size(dl, response, block, len);
+	if (r < 0) {
+		return r;
+	}
+
+	/* Only reached with several blocks in flight, so window > 1 */
+	if (num != dl->next_deliver) {
+		slot = buf_slot(dl, num);
+		memcpy(dl->buf + slot * block_bytes(dl), payload, len);
+		dl->buf_len[slot] = len;
+		dl->buffered |= BIT(slot);
+
+		return request_more(dl);
+	}
+
+	r = deliver(dl, payload, len);
+	if (r < 0) {
+		return r;
+	}
+
+	while (dl->next_deliver < dl->next_request &&
+	       stored(dl, dl->next_deliver)) {
+		slot = buf_slot(dl, dl->next_deliver);
+		dl->buffered &= ~BIT(slot);
+
+		r = deliver(dl, dl->buf + slot * block_bytes(dl),
+			    dl->buf_len[slot]);
+		if (r < 0) {
+			return r;
+		}
+	}
+
+	if (dl->next_deliver > dl->last) {
+		return 1;
+	}
+
+	return request_more(dl);
+}
+
+int coap_block_download_timeout(struct coap_block_download *dl,
+				const struct coap_packet *request)
+{
+	uint32_t num;
+	int block;
+
+	block = coap_get_option_int(request, COAP_OPTION_BLOCK2);
+	if (block < 0) {
+		return -EINVAL;
+	}
+
+	num = GET_NUM(block);
+	if (num < dl->next_deliver || num >= dl->next_request ||
+	    (num != dl->next_deliver && stored(dl, num))) {
+		return 0;
+	}
+
+	if (dl->retries[num % dl->window]++ >=
+	    CONFIG_COAP_BLOCK_DOWNLOAD_MAX_RETRIES) {
+		return -ETIMEDOUT;
+	}
+
+	NET_DBG("Requesting block %u again", num);
+
+	return request_block(dl, num);
+}
+
+int coap_block_download_resend(struct coap_block_download *dl)
+{
+	uint32_t num;
+	int r;
+
+	for (num = dl->next_deliver; num < dl->next_request; num++) {
+		if (num != dl->next_deliver && stored(dl, num)) {
+			continue;
+		}
+
+		r = request_block(dl, num);
+		if (r < 0) {
+			return r;
+		}
+	}
+
+	return 0;
+}
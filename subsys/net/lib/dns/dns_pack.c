@@ -221,9 +221,10 @@ int dns_unpack_response_header(struct dns_msg_t *msg, int src_id)
 	ancount = dns_unpack_header_ancount(dns_header);
 
 	/* For mDNS (when src_id == 0) the query count is 0 so accept
-	 * the packet in that case.
+	 * the packet in that case. A DNS answer without any record tells
+	 * that the name has no data of the requested type.
 	 */
-	if ((qdcount < 1 && src_id > 0) || ancount < 1) {
+	if ((qdcount < 1 && src_id > 0) || (ancount < 1 && src_id == 0)) {
 		return -EINVAL;
 	}
 
@@ -338,7 +339,7 @@ int dns_unpack_response_query(struct dns_msg_t *dns_msg)
 
 	/* 4 bytes more due to qtype and qclass */
 	offset += DNS_QTYPE_LEN + DNS_QCLASS_LEN;
-	if (offset >= dns_msg->msg_size) {
+	if (offset > dns_msg->msg_size) {
 		return -ENOMEM;
 	}
 
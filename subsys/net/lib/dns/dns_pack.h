@@ -359,7 +359,8 @@ int dns_unpack_answer(struct dns_msg_t *dns_msg, int dname_ptr, uint32_t *ttl,
  * @retval -EINVAL if the src_id does not match the header's id, or if the
  *         header's QR value is not DNS_RESPONSE or if the header's OPCODE
  *         value is not DNS_QUERY, or if the header's Z value is not 0 or if
- *         the question counter is not 1 or the answer counter is less than 1.
+ *         the question counter is not 1 or, for mDNS (src_id 0), the answer
+ *         counter is less than 1.
  * @retval RFC 1035 RCODEs (> 0) 1 Format error, 2 Server failure, 3 Name Error,
  *         4 Not Implemented and 5 Refused.
  */
@@ -460,6 +460,226 @@ static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 	return -ENOENT;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Must be invoked with context lock held */
+static struct dns_cache_entry *dns_cache_find(struct dns_resolve_context *ctx,
+					      const char *query,
+					      enum dns_query_type type)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES; i++) {
+		struct dns_cache_entry *entry = &ctx->cache[i];
+
+		if (entry->query[0] != '\0' && entry->query_type == type &&
+		    strcmp(entry->query, query) == 0) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/* Copy a valid cached answer for the query. Returns the number of
+ * addresses (0 for a negative answer) or -ENOENT if there is nothing
+ * usable in the cache. Must be invoked with context lock held.
+ */
+static int dns_cache_lookup(struct dns_resolve_context *ctx,
+			    const char *query,
+			    enum dns_query_type type,
+			    struct dns_addrinfo *info)
+{
+	struct dns_cache_entry *entry;
+
+	entry = dns_cache_find(ctx, query, type);
+	if (!entry || !entry->complete) {
+		return -ENOENT;
+	}
+
+	if (entry->expiry <= k_uptime_get()) {
+		entry->query[0] = '\0';
+		return -ENOENT;
+	}
+
+	memcpy(info, entry->info, entry->count * sizeof(*info));
+
+	return entry->count;
+}
+
+/* Detach the pending queries from a cache entry about to be reused, or
+ * from all entries if NULL. Must be invoked with context lock held.
+ */
+static void dns_cache_detach(struct dns_resolve_context *ctx,
+			     struct dns_cache_entry *entry)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (entry == NULL || ctx->queries[i].cache_entry == entry) {
+			ctx->queries[i].cache_entry = NULL;
+		}
+	}
+}
+
+/* Reserve a cache entry for a query that is about to be sent. If the
+ * cache is full, expired and unfinished entries are reused first, then
+ * the entry that would expire soonest. Returns the entry, or NULL if the
+ * answers are not cached. Must be invoked with context lock held.
+ */
+static struct dns_cache_entry *dns_cache_start(struct dns_resolve_context *ctx,
+					       const char *query,
+					       enum dns_query_type type)
+{
+	struct dns_cache_entry *entry, *victim = NULL;
+	int64_t now = k_uptime_get();
+	int i;
+
+	if (strlen(query) > CONFIG_DNS_RESOLVER_CACHE_NAME_LEN) {
+		return NULL;
+	}
+
+	entry = dns_cache_find(ctx, query, type);
+	if (entry) {
+		victim = entry;
+		goto found;
+	}
+
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES; i++) {
+		entry = &ctx->cache[i];
+
+		if (entry->query[0] == '\0' || !entry->complete ||
+		    entry->expiry <= now) {
+			victim = entry;
+			break;
+		}
+
+		if (!victim || entry->expiry < victim->expiry) {
+			victim = entry;
+		}
+	}
+
+found:
+	dns_cache_detach(ctx, victim);
+
+	memset(victim, 0, sizeof(*victim));
+	strcpy(victim->query, query);
+	victim->query_type = type;
+	victim->ttl = UINT32_MAX;
+
+	return victim;
+}
+
+/* Must be invoked with context lock held */
+static void dns_cache_add(struct dns_resolve_context *ctx,
+			  struct dns_pending_query *pending_query,
+			  struct dns_addrinfo *info,
+			  uint32_t ttl)
+{
+	struct dns_cache_entry *entry = pending_query->cache_entry;
+
+	if (!entry || entry->complete) {
+		return;
+	}
+
+	if (entry->count < ARRAY_SIZE(entry->info)) {
+		memcpy(&entry->info[entry->count++], info, sizeof(*info));
+	}
+
+	entry->ttl = MIN(entry->ttl, ttl);
+}
+
+/* Called when the query has finished with the given status.
+ * Must be invoked with context lock held.
+ */
+static void dns_cache_done(struct dns_resolve_context *ctx,
+			   struct dns_pending_query *pending_query,
+			   int status,
+			   struct net_buf *dns_data)
+{
+	struct dns_cache_entry *entry = pending_query->cache_entry;
+	int rcode;
+
+	if (!entry || entry->complete) {
+		return;
+	}
+
+	pending_query->cache_entry = NULL;
+
+	if (status == DNS_EAI_ALLDONE && entry->count > 0 && entry->ttl > 0) {
+		entry->expiry = k_uptime_get() +
+				(int64_t)entry->ttl * MSEC_PER_SEC;
+		entry->complete = true;
+		return;
+	}
+
+	if (status == DNS_EAI_NODATA && dns_data &&
+	    CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL > 0) {
+		rcode = dns_header_rcode(dns_data->data);
+
+		if (rcode == DNS_HEADER_NOERROR ||
+		    rcode == DNS_HEADER_NAMEERROR) {
+			entry->count = 0U;
+			entry->ttl = CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL;
+			entry->expiry = k_uptime_get() +
+				(int64_t)entry->ttl * MSEC_PER_SEC;
+			entry->complete = true;
+			return;
+		}
+	}
+
+	entry->query[0] = '\0';
+}
+
+int dns_resolve_cache_foreach(struct dns_resolve_context *ctx,
+			      dns_resolve_cache_cb_t cb,
+			      void *user_data)
+{
+	int64_t now;
+	int i, count = 0;
+
+	if (!ctx || !cb) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&ctx->lock, K_FOREVER);
+
+	now = k_uptime_get();
+
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES; i++) {
+		struct dns_cache_entry *entry = &ctx->cache[i];
+
+		if (entry->query[0] == '\0' || !entry->complete ||
+		    entry->expiry <= now) {
+			continue;
+		}
+
+		cb(entry, (int32_t)(entry->expiry - now), user_data);
+		count++;
+	}
+
+	k_mutex_unlock(&ctx->lock);
+
+	return count;
+}
+
+int dns_resolve_cache_flush(struct dns_resolve_context *ctx)
+{
+	if (!ctx) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&ctx->lock, K_FOREVER);
+	dns_cache_detach(ctx, NULL);
+	memset(ctx->cache, 0, sizeof(ctx->cache));
+	k_mutex_unlock(&ctx->lock);
+
+	return 0;
+}
+#else
+#define dns_cache_add(ctx, pending_query, info, ttl)
+#define dns_cache_done(ctx, pending_query, status, dns_data)
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /* Unit test needs to be able to call this function */
 #if !defined(CONFIG_NET_TEST)
 static
@@ -546,6 +766,7 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 	answer_ptr = DNS_QUERY_POS;
 	items = 0;
 	server_idx = 0;
+	dns_msg->response_type = DNS_RESPONSE_INVALID;
 	enum dns_rr_type answer_type = DNS_RR_TYPE_INVALID;
 
 	while (server_idx < dns_header_ancount(dns_msg->msg)) {
@@ -633,6 +854,9 @@ query_known:
 			src = dns_msg->msg + dns_msg->response_position;
 			memcpy(addr, src, address_size);
 
+			dns_cache_add(ctx, &ctx->queries[*query_idx], &info,
+				      ttl);
+
 			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
 					      &ctx->queries[*query_idx]);
 			items++;
@@ -852,6 +1076,8 @@ quit:
 		goto free_buf;
 	}
 
+	dns_cache_done(ctx, &ctx->queries[i], ret, dns_data);
+
 	invoke_query_callback(ret, NULL, &ctx->queries[i]);
 
 	/* Marks the end of the results */
@@ -1187,6 +1413,35 @@ try_resolve:
 		goto fail;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (type == DNS_QUERY_TYPE_A || type == DNS_QUERY_TYPE_AAAA) {
+		struct dns_addrinfo cached[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+		int count;
+
+		count = dns_cache_lookup(ctx, query, type, cached);
+		if (count >= 0) {
+			k_mutex_unlock(&ctx->lock);
+
+			if (dns_id) {
+				*dns_id = 0U;
+			}
+
+			if (count == 0) {
+				cb(DNS_EAI_NODATA, NULL, user_data);
+				return 0;
+			}
+
+			for (j = 0; j < count; j++) {
+				cb(DNS_EAI_INPROGRESS, &cached[j], user_data);
+			}
+
+			cb(DNS_EAI_ALLDONE, NULL, user_data);
+
+			return 0;
+		}
+	}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 	i = get_cb_slot(ctx);
 	if (i < 0) {
 		ret = -EAGAIN;
@@ -1203,6 +1458,10 @@ try_resolve:
 
 	k_work_init_delayable(&ctx->queries[i].timer, query_timeout);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ctx->queries[i].cache_entry = dns_cache_start(ctx, query, type);
+#endif
+
 	dns_data = net_buf_alloc(&dns_msg_pool, ctx->buf_timeout);
 	if (!dns_data) {
 		ret = -ENOMEM;
@@ -1404,6 +1663,12 @@ int dns_resolve_reconfigure(struct dns_resolve_context *ctx,
 	if (ctx->state == DNS_RESOLVE_CONTEXT_ACTIVE) {
 		dns_resolve_cancel_all(ctx);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/* Answers from the old servers are not valid any more */
+		dns_cache_detach(ctx, NULL);
+		memset(ctx->cache, 0, sizeof(ctx->cache));
+#endif
+
 		err = dns_resolve_close_locked(ctx);
 		if (err) {
 			goto unlock;
@@ -25,14 +25,24 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 #define NETWORK_INIT_TIMEOUT	K_SECONDS(10)
 #define NETWORK_CONNECT_TIMEOUT	K_SECONDS(10)
-#define PACKET_TRANSFER_RETRY_MAX	3
+#define FIRMWARE_WINDOW		CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_WINDOW
 
 static char firmware_uri[URI_LEN];
 static struct lwm2m_ctx firmware_ctx = {
 	.sock_fd = -1
 };
-static int firmware_retry;
-static struct coap_block_context firmware_block_ctx;
+static struct coap_block_download firmware_download;
+
+#define FIRMWARE_WINDOW_BUF_LEN	\
+	((FIRMWARE_WINDOW - 1) * CONFIG_LWM2M_COAP_BLOCK_SIZE)
+
+#if FIRMWARE_WINDOW > 1
+/* Blocks received ahead of the next one to write */
+static uint8_t firmware_window_buf[FIRMWARE_WINDOW_BUF_LEN];
+#define FIRMWARE_WINDOW_BUF	firmware_window_buf
+#else
+#define FIRMWARE_WINDOW_BUF	NULL
+#endif
 
 #if defined(CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_COAP_PROXY_SUPPORT)
 #define COAP2COAP_PROXY_URI_PATH	"coap2coap"
@@ -62,9 +72,13 @@ static void set_update_result_from_error(int error_code)
 	}
 }
 
-static int transfer_request(struct coap_block_context *ctx,
-			    uint8_t *token, uint8_t tkl,
-			    coap_reply_t reply_cb)
+static int
+do_firmware_transfer_reply_cb(const struct coap_packet *response,
+			      struct coap_reply *reply,
+			      const struct sockaddr *from);
+
+static int transfer_request(struct coap_block_download *dl,
+			    struct coap_block_context *ctx)
 {
 	struct lwm2m_message *msg;
 	int ret;
@@ -84,9 +98,10 @@ static int transfer_request(struct coap_block_context *ctx,
 	msg->type = COAP_TYPE_CON;
 	msg->code = COAP_METHOD_GET;
 	msg->mid = coap_next_id();
-	msg->token = token;
-	msg->tkl = tkl;
-	msg->reply_cb = reply_cb;
+	/* Each block in flight is matched to its request by its token */
+	msg->token = NULL;
+	msg->tkl = LWM2M_MSG_TOKEN_GENERATE_NEW;
+	msg->reply_cb = do_firmware_transfer_reply_cb;
 	msg->message_timeout_cb = do_transmit_timeout_cb;
 
 	ret = lwm2m_init_message(msg);
@@ -164,6 +179,15 @@ static int transfer_request(struct coap_block_context *ctx,
 		goto cleanup;
 	}
 
+	/* Ask the server to provide a size estimate, without which the
+	 * blocks are requested one at a time
+	 */
+	ret = coap_append_option_int(&msg->cpkt, COAP_OPTION_SIZE2, 0);
+	if (ret < 0) {
+		LOG_ERR("Unable to add size2 option.");
+		goto cleanup;
+	}
+
 #if defined(CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_COAP_PROXY_SUPPORT)
 	ret = coap_packet_append_option(&msg->cpkt, COAP_OPTION_PROXY_URI,
 					firmware_uri, strlen(firmware_uri));
@@ -172,13 +196,6 @@ static int transfer_request(struct coap_block_context *ctx,
 			log_strdup(firmware_uri));
 		goto cleanup;
 	}
-#else
-	/* Ask the server to provide a size estimate */
-	ret = coap_append_option_int(&msg->cpkt, COAP_OPTION_SIZE2, 0);
-	if (ret < 0) {
-		LOG_ERR("Unable to add size2 option.");
-		goto cleanup;
-	}
 #endif
 
 	/* send request */
@@ -195,23 +212,70 @@ cleanup:
 	return ret;
 }
 
+static int firmware_write(struct coap_block_download *dl,
+			  const uint8_t *data, uint16_t len, size_t offset,
+			  bool last)
+{
+	int ret;
+	uint16_t chunk;
+	struct lwm2m_engine_res *res = NULL;
+	lwm2m_engine_set_data_cb_t write_cb;
+	size_t write_buflen;
+	uint8_t *write_buf;
+
+	if (len == 0U) {
+		return 0;
+	}
+
+	LOG_DBG("total: %zd, current: %zd", dl->ctx.total_size, offset);
+
+	/* look up firmware package resource */
+	ret = lwm2m_engine_get_resource("5/0/0", &res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* get buffer data */
+	write_buf = res->res_instances->data_ptr;
+	write_buflen = res->res_instances->max_data_len;
+
+	/* check for user override to buffer */
+	if (res->pre_write_cb) {
+		write_buf = res->pre_write_cb(0, 0, 0, &write_buflen);
+	}
+
+	write_cb = lwm2m_firmware_get_write_cb();
+	if (!write_cb) {
+		return 0;
+	}
+
+	/* flush incoming data to write_cb */
+	while (len > 0) {
+		chunk = (len > write_buflen) ? write_buflen : len;
+		memcpy(write_buf, data, chunk);
+		data += chunk;
+		len -= chunk;
+
+		ret = write_cb(0, 0, 0, write_buf, chunk, last && (len == 0U),
+			       dl->ctx.total_size);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 static int
 do_firmware_transfer_reply_cb(const struct coap_packet *response,
 			      struct coap_reply *reply,
 			      const struct sockaddr *from)
 {
 	int ret;
-	bool last_block;
 	uint8_t token[8];
 	uint8_t tkl;
-	uint16_t payload_len, payload_offset, len;
 	struct coap_packet *check_response = (struct coap_packet *)response;
-	struct lwm2m_engine_res *res = NULL;
-	lwm2m_engine_set_data_cb_t write_cb;
-	size_t write_buflen;
-	uint8_t resp_code, *write_buf;
-	struct coap_block_context received_block_ctx;
-	const uint8_t *payload_start;
+	uint8_t resp_code;
 
 	/* token is used to determine a valid ACK vs a separated response */
 	tkl = coap_header_get_token(check_response, token);
@@ -239,92 +303,17 @@ do_firmware_transfer_reply_cb(const struct coap_packet *response,
 		goto error;
 	}
 
-	/* save main firmware block context */
-	memcpy(&received_block_ctx, &firmware_block_ctx,
-	       sizeof(firmware_block_ctx));
-
-	ret = coap_update_from_block(check_response, &firmware_block_ctx);
-	if (ret < 0) {
+	/* Write the data in order and request the next block(s) */
+	ret = coap_block_download_response(&firmware_download, response);
+	if (ret == -EBADMSG) {
 		LOG_ERR("Error from block update: %d", ret);
 		ret = -EFAULT;
 		goto error;
+	} else if (ret < 0) {
+		goto error;
 	}
 
-	/* test for duplicate transfer */
-	if (firmware_block_ctx.current < received_block_ctx.current) {
-		LOG_WRN("Duplicate packet ignored");
-
-		/* restore main firmware block context */
-		memcpy(&firmware_block_ctx, &received_block_ctx,
-		       sizeof(firmware_block_ctx));
-
-		/* set reply->user_data to error to avoid releasing */
-		reply->user_data = (void *)COAP_REPLY_STATUS_ERROR;
-		return 0;
-	}
-
-	/* Reach last block if ret equals to 0 */
-	last_block = !coap_next_block(check_response, &firmware_block_ctx);
-
-	/* Process incoming data */
-	payload_start = coap_packet_get_payload(response, &payload_len);
-	if (payload_len > 0) {
-		payload_offset = payload_start - response->data;
-		LOG_DBG("total: %zd, current: %zd",
-			firmware_block_ctx.total_size,
-			firmware_block_ctx.current);
-
-		/* look up firmware package resource */
-		ret = lwm2m_engine_get_resource("5/0/0", &res);
-		if (ret < 0) {
-			goto error;
-		}
-
-		/* get buffer data */
-		write_buf = res->res_instances->data_ptr;
-		write_buflen = res->res_instances->max_data_len;
-
-		/* check for user override to buffer */
-		if (res->pre_write_cb) {
-			write_buf = res->pre_write_cb(0, 0, 0, &write_buflen);
-		}
-
-		write_cb = lwm2m_firmware_get_write_cb();
-		if (write_cb) {
-			/* flush incoming data to write_cb */
-			while (payload_len > 0) {
-				len = (payload_len > write_buflen) ?
-				       write_buflen : payload_len;
-				payload_len -= len;
-				/* check for end of packet */
-				if (buf_read(write_buf, len,
-					     CPKT_BUF_READ(response),
-					     &payload_offset) < 0) {
-					/* malformed packet */
-					ret = -EFAULT;
-					goto error;
-				}
-
-				ret = write_cb(0, 0, 0,
-					       write_buf, len,
-					       last_block &&
-							(payload_len == 0U),
-					       firmware_block_ctx.total_size);
-				if (ret < 0) {
-					goto error;
-				}
-			}
-		}
-	}
-
-	if (!last_block) {
-		/* More block(s) to come, setup next transfer */
-		ret = transfer_request(&firmware_block_ctx, token, tkl,
-				       do_firmware_transfer_reply_cb);
-		if (ret < 0) {
-			goto error;
-		}
-	} else {
+	if (ret > 0) {
 		/* Download finished */
 		lwm2m_firmware_set_update_state(STATE_DOWNLOADED);
 		lwm2m_engine_context_close(&firmware_ctx);
@@ -342,27 +331,19 @@ static void do_transmit_timeout_cb(struct lwm2m_message *msg)
 {
 	int ret;
 
-	if (firmware_retry < PACKET_TRANSFER_RETRY_MAX) {
-		/* retry block */
-		LOG_WRN("TIMEOUT - Sending a retry packet!");
-
-		ret = transfer_request(&firmware_block_ctx,
-				       msg->token, msg->tkl,
-				       do_firmware_transfer_reply_cb);
-		if (ret < 0) {
-			/* abort retries / transfer */
-			set_update_result_from_error(ret);
-			firmware_retry = PACKET_TRANSFER_RETRY_MAX;
-			lwm2m_engine_context_close(&firmware_ctx);
-			return;
-		}
-
-		firmware_retry++;
-	} else {
+	/* retry block */
+	ret = coap_block_download_timeout(&firmware_download, &msg->cpkt);
+	if (ret == -ETIMEDOUT) {
 		LOG_ERR("TIMEOUT - Too many retry packet attempts! "
 			"Aborting firmware download.");
 		lwm2m_firmware_set_update_result(RESULT_CONNECTION_LOST);
 		lwm2m_engine_context_close(&firmware_ctx);
+	} else if (ret < 0) {
+		/* abort retries / transfer */
+		set_update_result_from_error(ret);
+		lwm2m_engine_context_close(&firmware_ctx);
+	} else {
+		LOG_WRN("TIMEOUT - Sending a retry packet!");
 	}
 }
 
@@ -403,10 +384,16 @@ static void firmware_transfer(void)
 	LOG_INF("Connecting to server %s", log_strdup(firmware_uri));
 
 	/* reset block transfer context */
-	coap_block_transfer_init(&firmware_block_ctx,
-				 lwm2m_default_block_size(), 0);
-	ret = transfer_request(&firmware_block_ctx, coap_next_token(), 8,
-			       do_firmware_transfer_reply_cb);
+	ret = coap_block_download_init(&firmware_download, transfer_request,
+				       firmware_write,
+				       lwm2m_default_block_size(),
+				       FIRMWARE_WINDOW, FIRMWARE_WINDOW_BUF,
+				       FIRMWARE_WINDOW_BUF_LEN);
+	if (ret < 0) {
+		goto error;
+	}
+
+	ret = coap_block_download_start(&firmware_download);
 	if (ret < 0) {
 		goto error;
 	}
@@ -426,7 +413,7 @@ static void socket_fault_cb(int error)
 
 	lwm2m_engine_context_close(&firmware_ctx);
 
-	/* Reopen the socket and retransmit the last request. */
+	/* Reopen the socket and retransmit the pending requests. */
 	lwm2m_engine_context_init(&firmware_ctx);
 	ret = lwm2m_socket_start(&firmware_ctx);
 	if (ret < 0) {
@@ -434,9 +421,7 @@ static void socket_fault_cb(int error)
 		goto error;
 	}
 
-	ret = transfer_request(&firmware_block_ctx,
-			       NULL, LWM2M_MSG_TOKEN_GENERATE_NEW,
-			       do_firmware_transfer_reply_cb);
+	ret = coap_block_download_resend(&firmware_download);
 	if (ret < 0) {
 		LOG_ERR("Failed to send a retry packet: %d", ret);
 		goto error;
@@ -445,8 +430,6 @@ static void socket_fault_cb(int error)
 	return;
 
 error:
-	/* Abort retries. */
-	firmware_retry = PACKET_TRANSFER_RETRY_MAX;
 	set_update_result_from_error(ret);
 	lwm2m_engine_context_close(&firmware_ctx);
 }
@@ -467,7 +450,6 @@ int lwm2m_firmware_start_transfer(char *package_uri)
 	(void)memset(&firmware_ctx, 0, sizeof(struct lwm2m_ctx));
 	firmware_ctx.sock_fd = -1;
 	firmware_ctx.fault_cb = socket_fault_cb;
-	firmware_retry = 0;
 	lwm2m_firmware_set_update_state(STATE_DOWNLOADING);
 
 	/* start file transfer */
@@ -484,5 +466,5 @@ int lwm2m_firmware_start_transfer(char *package_uri)
  */
 struct coap_block_context *lwm2m_firmware_get_block_context()
 {
-	return &firmware_block_ctx;
+	return &firmware_download.ctx;
 }
@@ -26,6 +26,7 @@ LOG_MODULE_REGISTER(net_sock, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #endif
 
 #include "../../ip/net_stats.h"
+#include "../../ip/tcp_internal.h"
 
 #include "sockets_internal.h"
 
@@ -273,6 +274,11 @@ int z_impl_zsock_close(int sock)
 		return -1;
 	}
 
+	/* Done before locking the socket, epoll locks the socket when it
+	 * checks it.
+	 */
+	net_socket_epoll_close(sock, ctx);
+
 	(void)k_mutex_lock(lock, K_FOREVER);
 
 	NET_DBG("close: ctx=%p, fd=%d", ctx, sock);
@@ -738,93 +744,247 @@ ssize_t z_impl_zsock_sendmsg(int sock, const struct msghdr *msg, int flags)
 	VTABLE_CALL(sendmsg, sock, msg, flags);
 }
 
+/* Send the messages one by one with the given sendmsg method */
+static int sendmmsg_each(void *obj,
+			 ssize_t (*sendmsg)(void *obj, const struct msghdr *msg,
+					    int flags),
+			 struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+	int saved_errno = errno;
+	unsigned int i;
+	ssize_t ret;
+
+	for (i = 0; i < vlen; i++) {
+		ret = sendmsg(obj, &msgvec[i].msg_hdr, flags);
+		if (ret < 0) {
+			/* The error is reported only if nothing was sent */
+			if (i == 0) {
+				return -1;
+			}
+
+			errno = saved_errno;
+			return i;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return i;
+}
+
+static ssize_t sendmsg_ctx(void *obj, const struct msghdr *msg, int flags)
+{
+	return zsock_sendmsg_ctx(obj, msg, flags);
+}
+
+int zsock_sendmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+		       unsigned int vlen, int flags)
+{
+	return sendmmsg_each(ctx, sendmsg_ctx, msgvec, vlen, flags);
+}
+
+int z_impl_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX_VLEN);
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (vtable->sendmmsg == NULL && vtable->sendmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	/* Other socket types send the messages with their sendmsg method */
+	if (vtable->sendmmsg != NULL) {
+		ret = vtable->sendmmsg(obj, msgvec, vlen, flags);
+	} else {
+		ret = sendmmsg_each(obj, vtable->sendmsg, msgvec, vlen, flags);
+	}
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
 #ifdef CONFIG_USERSPACE
-static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
-					   const struct msghdr *msg,
-					   int flags)
+static void free_user_msghdr_copy(struct msghdr *msg_copy)
 {
-	struct msghdr msg_copy;
 	size_t i;
-	int ret;
 
-	Z_OOPS(z_user_from_copy(&msg_copy, (void *)msg, sizeof(msg_copy)));
+	k_free(msg_copy->msg_name);
+	k_free(msg_copy->msg_control);
 
-	msg_copy.msg_name = NULL;
-	msg_copy.msg_control = NULL;
+	if (msg_copy->msg_iov) {
+		for (i = 0; i < msg_copy->msg_iovlen; i++) {
+			k_free(msg_copy->msg_iov[i].iov_base);
+		}
 
-	msg_copy.msg_iov = z_user_alloc_from_copy(msg->msg_iov,
-				       msg->msg_iovlen * sizeof(struct iovec));
-	if (!msg_copy.msg_iov) {
-		errno = ENOMEM;
-		goto fail;
+		k_free(msg_copy->msg_iov);
+	}
+}
+
+/* Copy a message header given by user space and all the buffers it
+ * points to into kernel memory. The copy must be released with
+ * free_user_msghdr_copy() even if this fails.
+ */
+static int copy_user_msghdr(struct msghdr *msg_copy, const struct msghdr *msg)
+{
+	struct msghdr user_msg;
+	size_t iov_size;
+	size_t i;
+
+	memset(msg_copy, 0, sizeof(*msg_copy));
+
+	if (z_user_from_copy(&user_msg, (void *)msg, sizeof(user_msg))) {
+		return -EFAULT;
 	}
 
-	for (i = 0; i < msg->msg_iovlen; i++) {
-		msg_copy.msg_iov[i].iov_base =
-			z_user_alloc_from_copy(msg->msg_iov[i].iov_base,
-					       msg->msg_iov[i].iov_len);
-		if (!msg_copy.msg_iov[i].iov_base) {
-			errno = ENOMEM;
-			goto fail;
+	if (size_mul_overflow(user_msg.msg_iovlen, sizeof(struct iovec),
+			      &iov_size)) {
+		return -EINVAL;
+	}
+
+	msg_copy->msg_flags = user_msg.msg_flags;
+
+	msg_copy->msg_iov = z_user_alloc_from_copy(user_msg.msg_iov, iov_size);
+	if (!msg_copy->msg_iov) {
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < user_msg.msg_iovlen; i++) {
+		struct iovec *iov = &msg_copy->msg_iov[i];
+
+		iov->iov_base = z_user_alloc_from_copy(iov->iov_base,
+						       iov->iov_len);
+		if (!iov->iov_base) {
+			return -ENOMEM;
 		}
 
-		msg_copy.msg_iov[i].iov_len = msg->msg_iov[i].iov_len;
+		/* Only buffers that were copied are freed */
+		msg_copy->msg_iovlen = i + 1;
 	}
 
-	if (msg->msg_namelen > 0) {
-		msg_copy.msg_name = z_user_alloc_from_copy(msg->msg_name,
-							   msg->msg_namelen);
-		if (!msg_copy.msg_name) {
-			errno = ENOMEM;
-			goto fail;
+	if (user_msg.msg_namelen > 0) {
+		msg_copy->msg_name = z_user_alloc_from_copy(user_msg.msg_name,
+							user_msg.msg_namelen);
+		if (!msg_copy->msg_name) {
+			return -ENOMEM;
 		}
+
+		msg_copy->msg_namelen = user_msg.msg_namelen;
 	}
 
-	if (msg->msg_controllen > 0) {
-		msg_copy.msg_control = z_user_alloc_from_copy(msg->msg_control,
-							  msg->msg_controllen);
-		if (!msg_copy.msg_control) {
-			errno = ENOMEM;
-			goto fail;
+	if (user_msg.msg_controllen > 0) {
+		msg_copy->msg_control =
+			z_user_alloc_from_copy(user_msg.msg_control,
+					       user_msg.msg_controllen);
+		if (!msg_copy->msg_control) {
+			return -ENOMEM;
 		}
+
+		msg_copy->msg_controllen = user_msg.msg_controllen;
 	}
 
-	ret = z_impl_zsock_sendmsg(sock, (const struct msghdr *)&msg_copy,
-				   flags);
+	return 0;
+}
 
-	k_free(msg_copy.msg_name);
-	k_free(msg_copy.msg_control);
+static inline ssize_t z_vrfy_zsock_sendmsg(int sock,
+					   const struct msghdr *msg,
+					   int flags)
+{
+	struct msghdr msg_copy;
+	int ret;
+
+	ret = copy_user_msghdr(&msg_copy, msg);
+	if (ret == -EFAULT) {
+		free_user_msghdr_copy(&msg_copy);
+		Z_OOPS(ret);
+	}
 
-	for (i = 0; i < msg_copy.msg_iovlen; i++) {
-		k_free(msg_copy.msg_iov[i].iov_base);
+	if (ret < 0) {
+		errno = -ret;
+		ret = -1;
+	} else {
+		ret = z_impl_zsock_sendmsg(sock,
+					   (const struct msghdr *)&msg_copy,
+					   flags);
 	}
 
-	k_free(msg_copy.msg_iov);
+	free_user_msghdr_copy(&msg_copy);
 
 	return ret;
+}
+#include <syscalls/zsock_sendmsg_mrsh.c>
 
-fail:
-	if (msg_copy.msg_name) {
-		k_free(msg_copy.msg_name);
+static inline int z_vrfy_zsock_sendmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *msgvec_copy;
+	unsigned int i, copied = 0;
+	int ret;
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX_VLEN);
+	if (vlen == 0) {
+		return 0;
 	}
 
-	if (msg_copy.msg_control) {
-		k_free(msg_copy.msg_control);
+	msgvec_copy = z_user_alloc_from_copy(msgvec,
+					     vlen * sizeof(*msgvec_copy));
+	if (!msgvec_copy) {
+		Z_OOPS(Z_SYSCALL_MEMORY_READ(msgvec,
+					     vlen * sizeof(*msgvec_copy)));
+		errno = ENOMEM;
+		return -1;
 	}
 
-	if (msg_copy.msg_iov) {
-		for (i = 0; i < msg_copy.msg_iovlen; i++) {
-			if (msg_copy.msg_iov[i].iov_base) {
-				k_free(msg_copy.msg_iov[i].iov_base);
-			}
+	for (i = 0; i < vlen; i++, copied++) {
+		ret = copy_user_msghdr(&msgvec_copy[i].msg_hdr,
+				       &msgvec[i].msg_hdr);
+		if (ret < 0) {
+			copied++;
+			goto out;
 		}
+	}
 
-		k_free(msg_copy.msg_iov);
+	ret = z_impl_zsock_sendmmsg(sock, msgvec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < ret; i++) {
+		if (z_user_to_copy(&msgvec[i].msg_len, &msgvec_copy[i].msg_len,
+				   sizeof(msgvec[i].msg_len))) {
+			ret = -EFAULT;
+			break;
+		}
 	}
 
-	return -1;
+out:
+	for (i = 0; i < copied; i++) {
+		free_user_msghdr_copy(&msgvec_copy[i].msg_hdr);
+	}
+
+	k_free(msgvec_copy);
+
+	Z_OOPS(ret == -EFAULT);
+
+	if (ret < -1) {
+		errno = -ret;
+		ret = -1;
+	}
+
+	return ret;
 }
-#include <syscalls/zsock_sendmsg_mrsh.c>
+#include <syscalls/zsock_sendmmsg_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
 static int sock_get_pkt_src_addr(struct net_pkt *pkt,
@@ -981,18 +1141,17 @@ static int wait_data(struct net_context *ctx, k_timeout_t *timeout)
 	return 0;
 }
 
-static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+static ssize_t zsock_recv_dgram_msg(struct net_context *ctx,
+				    struct msghdr *msg,
+				    int flags)
 {
+	struct sockaddr *src_addr = msg->msg_name;
 	k_timeout_t timeout = K_FOREVER;
 	size_t recv_len = 0;
-	size_t read_len;
+	size_t read_len = 0;
 	struct net_pkt_cursor backup;
 	struct net_pkt *pkt;
+	size_t i;
 
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
 		timeout = K_NO_WAIT;
@@ -1030,7 +1189,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 
 	net_pkt_cursor_backup(pkt, &backup);
 
-	if (src_addr && addrlen) {
+	if (src_addr) {
 		if (IS_ENABLED(CONFIG_NET_OFFLOAD) &&
 		    net_if_is_ip_offloaded(net_context_get_iface(ctx))) {
 			/*
@@ -1041,7 +1200,8 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			 */
 			if (ctx->flags & NET_CONTEXT_REMOTE_ADDR_SET) {
 				memcpy(src_addr, &ctx->remote,
-				       MIN(*addrlen, sizeof(ctx->remote)));
+				       MIN(msg->msg_namelen,
+					   sizeof(ctx->remote)));
 			} else {
 				errno = ENOTSUP;
 				goto fail;
@@ -1050,7 +1210,7 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 			int rv;
 
 			rv = sock_get_pkt_src_addr(pkt, net_context_get_ip_proto(ctx),
-						   src_addr, *addrlen);
+						   src_addr, msg->msg_namelen);
 			if (rv < 0) {
 				errno = -rv;
 				LOG_ERR("sock_get_pkt_src_addr %d", rv);
@@ -1062,9 +1222,9 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 		 * size of source address
 		 */
 		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
+			msg->msg_namelen = sizeof(struct sockaddr_in);
 		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
+			msg->msg_namelen = sizeof(struct sockaddr_in6);
 		} else {
 			errno = ENOTSUP;
 			goto fail;
@@ -1072,13 +1232,20 @@ static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
 	}
 
 	recv_len = net_pkt_remaining_data(pkt);
-	read_len = MIN(recv_len, max_len);
 
-	if (net_pkt_read(pkt, buf, read_len)) {
-		errno = ENOBUFS;
-		goto fail;
+	for (i = 0; i < msg->msg_iovlen && read_len < recv_len; i++) {
+		size_t len = MIN(msg->msg_iov[i].iov_len, recv_len - read_len);
+
+		if (net_pkt_read(pkt, msg->msg_iov[i].iov_base, len)) {
+			errno = ENOBUFS;
+			goto fail;
+		}
+
+		read_len += len;
 	}
 
+	msg->msg_flags = read_len < recv_len ? ZSOCK_MSG_TRUNC : 0;
+
 	if (IS_ENABLED(CONFIG_NET_PKT_RXTIME_STATS) &&
 	    !(flags & ZSOCK_MSG_PEEK)) {
 		net_socket_update_tc_rx_time(pkt, k_cycle_get_32());
@@ -1100,6 +1267,33 @@ fail:
 	return -1;
 }
 
+static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
+				       void *buf,
+				       size_t max_len,
+				       int flags,
+				       struct sockaddr *src_addr,
+				       socklen_t *addrlen)
+{
+	struct iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+	struct msghdr msg = {
+		.msg_name = addrlen ? src_addr : NULL,
+		.msg_namelen = addrlen ? *addrlen : 0,
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	ssize_t ret;
+
+	ret = zsock_recv_dgram_msg(ctx, &msg, flags);
+	if (ret >= 0 && msg.msg_name) {
+		*addrlen = msg.msg_namelen;
+	}
+
+	return ret;
+}
+
 static inline ssize_t zsock_recv_stream(struct net_context *ctx,
 					void *buf,
 					size_t max_len,
@@ -1281,6 +1475,176 @@ ssize_t z_vrfy_zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 #include <syscalls/zsock_recvfrom_mrsh.c>
 #endif /* CONFIG_USERSPACE */
 
+int zsock_recvmmsg_ctx(struct net_context *ctx, struct mmsghdr *msgvec,
+		       unsigned int vlen, int flags)
+{
+	int saved_errno = errno;
+	unsigned int i;
+	ssize_t ret;
+
+	if (net_context_get_type(ctx) != SOCK_DGRAM) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < vlen; i++) {
+		struct msghdr *msg = &msgvec[i].msg_hdr;
+
+		msg->msg_controllen = 0;
+
+		/* Only wait for the first datagram, then drain the queue */
+		ret = zsock_recv_dgram_msg(ctx, msg, i == 0 ? flags :
+					   flags | ZSOCK_MSG_DONTWAIT);
+		if (ret < 0) {
+			/* The error is reported only if nothing was received */
+			if (i == 0) {
+				return -1;
+			}
+
+			errno = saved_errno;
+			return i;
+		}
+
+		msgvec[i].msg_len = ret;
+	}
+
+	return i;
+}
+
+int z_impl_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+			  unsigned int vlen, int flags)
+{
+	const struct socket_op_vtable *vtable;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX_VLEN);
+
+	obj = get_sock_vtable(sock, &vtable, &lock);
+	if (obj == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	/* There is no recvmsg method to fall back to */
+	if (vtable->recvmmsg == NULL) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+
+	ret = vtable->recvmmsg(obj, msgvec, vlen, flags);
+
+	k_mutex_unlock(lock);
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_recvmmsg(int sock, struct mmsghdr *msgvec,
+					unsigned int vlen, int flags)
+{
+	struct mmsghdr *msgvec_copy;
+	unsigned int i, copied = 0;
+	size_t iov_size;
+	int ret = 0;
+
+	vlen = MIN(vlen, ZSOCK_MMSG_MAX_VLEN);
+	if (vlen == 0) {
+		return 0;
+	}
+
+	msgvec_copy = z_user_alloc_from_copy(msgvec,
+					     vlen * sizeof(*msgvec_copy));
+	if (!msgvec_copy) {
+		Z_OOPS(Z_SYSCALL_MEMORY_READ(msgvec,
+					     vlen * sizeof(*msgvec_copy)));
+		errno = ENOMEM;
+		return -1;
+	}
+
+	/* The data is written directly to the user buffers, so only the
+	 * iovec arrays are copied after the buffers have been verified.
+	 */
+	for (i = 0; i < vlen; i++, copied++) {
+		struct msghdr *msg = &msgvec_copy[i].msg_hdr;
+		struct iovec *iov = msg->msg_iov;
+		size_t j;
+
+		msg->msg_control = NULL;
+		msg->msg_iov = NULL;
+
+		if (size_mul_overflow(msg->msg_iovlen, sizeof(struct iovec),
+				      &iov_size) ||
+		    (msg->msg_name &&
+		     Z_SYSCALL_MEMORY_WRITE(msg->msg_name,
+					    msg->msg_namelen))) {
+			ret = -EFAULT;
+			goto out;
+		}
+
+		msg->msg_iov = z_user_alloc_from_copy(iov, iov_size);
+		if (!msg->msg_iov) {
+			ret = Z_SYSCALL_MEMORY_READ(iov, iov_size) ?
+				-EFAULT : -ENOMEM;
+			goto out;
+		}
+
+		for (j = 0; j < msg->msg_iovlen; j++) {
+			if (Z_SYSCALL_MEMORY_WRITE(msg->msg_iov[j].iov_base,
+						   msg->msg_iov[j].iov_len)) {
+				copied++;
+				ret = -EFAULT;
+				goto out;
+			}
+		}
+	}
+
+	ret = z_impl_zsock_recvmmsg(sock, msgvec_copy, vlen, flags);
+
+	for (i = 0; ret > 0 && i < ret; i++) {
+		struct mmsghdr *msg = &msgvec[i];
+		struct mmsghdr *msg_copy = &msgvec_copy[i];
+
+		if (z_user_to_copy(&msg->msg_len, &msg_copy->msg_len,
+				   sizeof(msg->msg_len)) ||
+		    z_user_to_copy(&msg->msg_hdr.msg_namelen,
+				   &msg_copy->msg_hdr.msg_namelen,
+				   sizeof(msg->msg_hdr.msg_namelen)) ||
+		    z_user_to_copy(&msg->msg_hdr.msg_flags,
+				   &msg_copy->msg_hdr.msg_flags,
+				   sizeof(msg->msg_hdr.msg_flags))) {
+			ret = -EFAULT;
+			break;
+		}
+	}
+
+out:
+	for (i = 0; i < copied; i++) {
+		k_free(msgvec_copy[i].msg_hdr.msg_iov);
+	}
+
+	k_free(msgvec_copy);
+
+	Z_OOPS(ret == -EFAULT);
+
+	if (ret < -1) {
+		errno = -ret;
+		ret = -1;
+	}
+
+	return ret;
+}
+#include <syscalls/zsock_recvmmsg_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
 /* As this is limited function, we don't follow POSIX signature, with
  * "..." instead of last arg.
  */
@@ -1682,6 +2046,28 @@ int zsock_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 		}
 		}
 
+		break;
+
+	case IPPROTO_TCP:
+		switch (optname) {
+		case TCP_NODELAY:
+		case TCP_CORK: {
+			size_t len = *optlen;
+
+			ret = net_tcp_get_option(ctx, optname == TCP_NODELAY ?
+						 TCP_OPT_NODELAY : TCP_OPT_CORK,
+						 optval, &len);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			*optlen = len;
+
+			return 0;
+		}
+		}
+
 		break;
 	}
 
@@ -1900,9 +2286,23 @@ int zsock_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 	case IPPROTO_TCP:
 		switch (optname) {
 		case TCP_NODELAY:
-			/* Ignore for now. Provided to let port
-			 * existing apps.
-			 */
+			ret = net_tcp_set_option(ctx, TCP_OPT_NODELAY, optval,
+						 optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
+			return 0;
+
+		case TCP_CORK:
+			ret = net_tcp_set_option(ctx, TCP_OPT_CORK, optval,
+						 optlen);
+			if (ret < 0) {
+				errno = -ret;
+				return -1;
+			}
+
 			return 0;
 		}
 		break;
@@ -2165,6 +2565,18 @@ static ssize_t sock_recvfrom_vmeth(void *obj, void *buf, size_t max_len,
 				  src_addr, addrlen);
 }
 
+static int sock_sendmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
+static int sock_recvmmsg_vmeth(void *obj, struct mmsghdr *msgvec,
+			       unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg_ctx(obj, msgvec, vlen, flags);
+}
+
 static int sock_getsockopt_vmeth(void *obj, int level, int optname,
 				 void *optval, socklen_t *optlen)
 {
@@ -2205,6 +2617,8 @@ const struct socket_op_vtable sock_fd_op_vtable = {
 	.getsockopt = sock_getsockopt_vmeth,
 	.setsockopt = sock_setsockopt_vmeth,
 	.getsockname = sock_getsockname_vmeth,
+	.sendmmsg = sock_sendmmsg_vmeth,
+	.recvmmsg = sock_recvmmsg_vmeth,
 };
 
 #if defined(CONFIG_NET_NATIVE)
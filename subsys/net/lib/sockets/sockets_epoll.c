@@ -0,0 +1,718 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_sock_epoll, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <kernel.h>
+#include <sys/util.h>
+#include <net/socket.h>
+#include <syscall_handler.h>
+#include <sys/fdtable.h>
+
+#include "sockets_internal.h"
+
+/* Events that are passed to the poll methods of the sockets */
+#define EPOLL_POLL_EVENTS (ZSOCK_EPOLLIN | ZSOCK_EPOLLPRI | ZSOCK_EPOLLOUT)
+
+/* Events that are reported even if they were not asked for */
+#define EPOLL_ALWAYS_EVENTS (ZSOCK_EPOLLERR | ZSOCK_EPOLLHUP)
+
+/* Max number of k_poll events a socket adds in ZFD_IOCTL_POLL_PREPARE,
+ * one for each direction.
+ */
+#define EPOLL_POLL_EVENTS_PER_FD 2
+
+struct epoll_item {
+	/* Triggered work that puts the item on the ready list of the
+	 * instance when one of the k_poll events of the socket is signaled.
+	 */
+	struct k_work_poll work;
+	struct k_poll_event poll_events[EPOLL_POLL_EVENTS_PER_FD];
+	int num_poll_events;
+
+	/* Node in the ready list */
+	sys_dnode_t node;
+
+	struct epoll_instance *ep;
+	struct zsock_epoll_event event;
+	int fd;
+
+	/* Object of the descriptor when it was added, to detect that the
+	 * descriptor was closed and reused by another socket.
+	 */
+	void *obj;
+
+	/* Is this entry in use (true) or not (false) */
+	bool in_use;
+
+	/* The triggered work is registered on the socket or pending */
+	bool armed;
+
+	/* The entry was removed while the triggered work was pending, the
+	 * work handler releases it.
+	 */
+	bool removed;
+};
+
+__net_socket struct epoll_instance {
+	/* Protects the interest and the ready list */
+	struct k_mutex lock;
+
+	/* Raised when an item is put on the ready list or the instance is
+	 * closed, waiting threads wait for this signal only.
+	 */
+	struct k_poll_signal signal;
+
+	/* Interest list */
+	struct epoll_item items[CONFIG_NET_SOCKETS_EPOLL_MAX_FDS];
+
+	/* Items that are or may be ready, and must be checked by the next
+	 * wait. Items that are not on this list have their triggered work
+	 * registered on the socket, so they are not checked at all until
+	 * the socket signals them.
+	 */
+	sys_dlist_t ready;
+
+	/* Is this entry in use (true) or not (false) */
+	uint8_t is_in_use : 1;
+};
+
+static struct epoll_instance
+		epoll_instances[CONFIG_NET_SOCKETS_EPOLL_MAX_INSTANCES];
+
+static K_MUTEX_DEFINE(epoll_instances_lock);
+
+static const struct socket_op_vtable epoll_fd_op_vtable;
+
+
+/* Put the item on the ready list and wake up the waiting thread. Called
+ * with the instance locked.
+ */
+static void epoll_queue(struct epoll_instance *ep, struct epoll_item *item)
+{
+	if (!sys_dnode_is_linked(&item->node)) {
+		sys_dlist_append(&ep->ready, &item->node);
+	}
+
+	k_poll_signal_raise(&ep->signal, 0);
+}
+
+/* Remove the item from the interest list. Returns true if the triggered
+ * work of the item is pending, in which case the work handler releases
+ * the entry. Called with the instance locked.
+ */
+static bool epoll_drop(struct epoll_item *item)
+{
+	if (sys_dnode_is_linked(&item->node)) {
+		sys_dlist_remove(&item->node);
+	}
+
+	if (item->armed && k_work_poll_cancel(&item->work) < 0) {
+		item->removed = true;
+		return true;
+	}
+
+	item->armed = false;
+	item->in_use = false;
+
+	return false;
+}
+
+static struct epoll_item *epoll_find(struct epoll_instance *ep, int fd,
+				     void *obj)
+{
+	struct epoll_item *item;
+
+	for (item = ep->items; item < &ep->items[ARRAY_SIZE(ep->items)];
+	     item++) {
+		if (!item->in_use || item->removed || item->fd != fd) {
+			continue;
+		}
+
+		/* The descriptor was closed and reused by another object
+		 * without removing it from the interest list.
+		 */
+		if (item->obj != obj) {
+			(void)epoll_drop(item);
+			return NULL;
+		}
+
+		return item;
+	}
+
+	return NULL;
+}
+
+/* Let the socket of an item that is not armed add its k_poll events, and
+ * get the events that are currently reported. Returns -EBADF if the
+ * descriptor does not refer to the socket that was added anymore. Called
+ * with the instance locked.
+ */
+static int epoll_check(struct epoll_item *item, uint32_t *revents)
+{
+	const struct fd_op_vtable *vtable;
+	struct zsock_pollfd pfd;
+	struct k_poll_event *pev;
+	struct k_mutex *lock;
+	void *obj;
+	int ret;
+
+	obj = z_get_fd_obj_and_vtable(item->fd, &vtable, &lock);
+	if (obj == NULL || obj != item->obj) {
+		return -EBADF;
+	}
+
+	pfd.fd = item->fd;
+	pfd.events = item->event.events & EPOLL_POLL_EVENTS;
+	pfd.revents = 0;
+
+	pev = item->poll_events;
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_POLL_PREPARE,
+				   &pfd, &pev,
+				   item->poll_events +
+				   ARRAY_SIZE(item->poll_events));
+	k_mutex_unlock(lock);
+
+	if (ret == -EXDEV) {
+		/* Offloaded sockets cannot share k_poll() */
+		return -ENOTSUP;
+	}
+
+	/* A socket that is ready already is reported by the update below */
+	if (ret < 0 && ret != -EALREADY) {
+		return ret;
+	}
+
+	item->num_poll_events = pev - item->poll_events;
+	if (item->num_poll_events > 0) {
+		/* Only fetch the current state of the events */
+		(void)k_poll(item->poll_events, item->num_poll_events,
+			     K_NO_WAIT);
+	}
+
+	pev = item->poll_events;
+
+	(void)k_mutex_lock(lock, K_FOREVER);
+	ret = z_fdtable_call_ioctl(vtable, obj, ZFD_IOCTL_POLL_UPDATE,
+				   &pfd, &pev);
+	k_mutex_unlock(lock);
+
+	if (ret == -EAGAIN) {
+		/* Socket is not ready yet after all */
+		pfd.revents = 0;
+		ret = 0;
+	}
+
+	*revents = pfd.revents & (item->event.events | EPOLL_ALWAYS_EVENTS);
+
+	return ret;
+}
+
+/* Register the k_poll events prepared by epoll_check() on the socket, the
+ * item is queued again when one of them is signaled. An item without any
+ * event stays idle until it is modified. Called with the instance locked.
+ */
+static void epoll_arm(struct epoll_item *item)
+{
+	int i;
+
+	if (item->num_poll_events == 0) {
+		return;
+	}
+
+	for (i = 0; i < item->num_poll_events; i++) {
+		item->poll_events[i].state = K_POLL_STATE_NOT_READY;
+	}
+
+	if (k_work_poll_submit(&item->work, item->poll_events,
+			       item->num_poll_events, K_FOREVER) == 0) {
+		item->armed = true;
+	}
+}
+
+/* Check a new or modified item, and either queue or arm it */
+static int epoll_start(struct epoll_instance *ep, struct epoll_item *item)
+{
+	uint32_t revents;
+	int ret;
+
+	ret = epoll_check(item, &revents);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (revents != 0) {
+		epoll_queue(ep, item);
+	} else {
+		epoll_arm(item);
+	}
+
+	return 0;
+}
+
+static void epoll_work_handler(struct k_work *work)
+{
+	struct k_work_poll *pwork = CONTAINER_OF(work, struct k_work_poll,
+						 work);
+	struct epoll_item *item = CONTAINER_OF(pwork, struct epoll_item, work);
+	struct epoll_instance *ep = item->ep;
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	item->armed = false;
+
+	if (item->removed) {
+		item->removed = false;
+		item->in_use = false;
+	} else {
+		epoll_queue(ep, item);
+	}
+
+	k_mutex_unlock(&ep->lock);
+}
+
+int z_impl_zsock_epoll_create1(int flags)
+{
+	struct epoll_instance *ep = NULL;
+	int fd, i;
+
+	if (flags & ~ZSOCK_EPOLL_CLOEXEC) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	fd = z_reserve_fd();
+	if (fd < 0) {
+		return -1;
+	}
+
+	(void)k_mutex_lock(&epoll_instances_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(epoll_instances); i++) {
+		if (!epoll_instances[i].is_in_use) {
+			ep = &epoll_instances[i];
+			break;
+		}
+	}
+
+	if (ep != NULL) {
+		k_mutex_init(&ep->lock);
+		k_poll_signal_init(&ep->signal);
+		sys_dlist_init(&ep->ready);
+
+		for (i = 0; i < ARRAY_SIZE(ep->items); i++) {
+			k_work_poll_init(&ep->items[i].work,
+					 epoll_work_handler);
+			sys_dnode_init(&ep->items[i].node);
+			ep->items[i].ep = ep;
+			ep->items[i].in_use = false;
+			ep->items[i].armed = false;
+			ep->items[i].removed = false;
+		}
+
+		ep->is_in_use = true;
+	}
+
+	k_mutex_unlock(&epoll_instances_lock);
+
+	if (ep == NULL) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	z_finalize_fd(fd, ep, (const struct fd_op_vtable *)&epoll_fd_op_vtable);
+
+	return fd;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_create1(int flags)
+{
+	return z_impl_zsock_epoll_create1(flags);
+}
+#include <syscalls/zsock_epoll_create1_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+int z_impl_zsock_epoll_ctl(int epfd, int op, int fd,
+			   struct zsock_epoll_event *event)
+{
+	const struct fd_op_vtable *vtable;
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+	void *obj;
+	int ret = 0;
+
+	ep = z_get_fd_obj(epfd,
+			  (const struct fd_op_vtable *)&epoll_fd_op_vtable,
+			  EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	obj = z_get_fd_obj_and_vtable(fd, &vtable, NULL);
+	if (obj == NULL) {
+		return -1;
+	}
+
+	/* Nested epoll instances are not supported */
+	if (vtable == (const struct fd_op_vtable *)&epoll_fd_op_vtable) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (op != ZSOCK_EPOLL_CTL_DEL &&
+	    (event == NULL || (event->events & ZSOCK_EPOLLET))) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	item = epoll_find(ep, fd, obj);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (item != NULL) {
+			ret = -EEXIST;
+			break;
+		}
+
+		for (item = ep->items;
+		     item < &ep->items[ARRAY_SIZE(ep->items)]; item++) {
+			if (!item->in_use) {
+				break;
+			}
+		}
+
+		if (item == &ep->items[ARRAY_SIZE(ep->items)]) {
+			ret = -ENOSPC;
+			break;
+		}
+
+		item->fd = fd;
+		item->obj = obj;
+		item->event = *event;
+
+		ret = epoll_start(ep, item);
+		if (ret == 0) {
+			item->in_use = true;
+		}
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (item == NULL) {
+			ret = -ENOENT;
+			break;
+		}
+
+		item->event = *event;
+
+		if (item->armed && k_work_poll_cancel(&item->work) == 0) {
+			item->armed = false;
+		}
+
+		/* A queued item or an item whose work is pending is checked
+		 * with the new events by the next wait.
+		 */
+		if (!item->armed && !sys_dnode_is_linked(&item->node)) {
+			ret = epoll_start(ep, item);
+		}
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (item == NULL) {
+			ret = -ENOENT;
+		} else {
+			(void)epoll_drop(item);
+		}
+		break;
+
+	default:
+		ret = -EINVAL;
+		break;
+	}
+
+	k_mutex_unlock(&ep->lock);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_ctl(int epfd, int op, int fd,
+					 struct zsock_epoll_event *event)
+{
+	struct zsock_epoll_event event_copy;
+
+	/* Check that the caller has access to the socket, the wait is
+	 * done later on its behalf.
+	 */
+	if (z_impl_zsock_get_context_object(fd) == NULL) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (event != NULL) {
+		Z_OOPS(z_user_from_copy(&event_copy, event,
+					sizeof(event_copy)));
+		event = &event_copy;
+	}
+
+	return z_impl_zsock_epoll_ctl(epfd, op, fd, event);
+}
+#include <syscalls/zsock_epoll_ctl_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+/* Check the items of the ready list only. Items that are still ready are
+ * put back at the end of the list, as notification is level triggered,
+ * the others are armed again. The items that are not reported because
+ * of maxevents stay at the head of the list, so all ready sockets are
+ * eventually reported.
+ */
+static int epoll_collect(struct epoll_instance *ep,
+			 struct zsock_epoll_event *events, int maxevents)
+{
+	struct epoll_item *item;
+	sys_dnode_t *node;
+	sys_dlist_t again;
+	uint32_t revents;
+	int count = 0, ret = 0;
+
+	sys_dlist_init(&again);
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	if (!ep->is_in_use) {
+		k_mutex_unlock(&ep->lock);
+		return -EBADF;
+	}
+
+	k_poll_signal_reset(&ep->signal);
+
+	while (count < maxevents) {
+		node = sys_dlist_get(&ep->ready);
+		if (node == NULL) {
+			break;
+		}
+
+		item = CONTAINER_OF(node, struct epoll_item, node);
+
+		ret = epoll_check(item, &revents);
+		if (ret == -EBADF) {
+			/* Socket closed without removing it */
+			(void)epoll_drop(item);
+			ret = 0;
+			continue;
+		}
+
+		if (ret < 0) {
+			sys_dlist_append(&again, node);
+			break;
+		}
+
+		if (revents == 0) {
+			epoll_arm(item);
+			continue;
+		}
+
+		events[count].events = revents;
+		events[count].data = item->event.data;
+		count++;
+
+		/* A one shot item stays idle until it is modified */
+		if (!(item->event.events & ZSOCK_EPOLLONESHOT)) {
+			sys_dlist_append(&again, node);
+		}
+	}
+
+	while ((node = sys_dlist_get(&again)) != NULL) {
+		sys_dlist_append(&ep->ready, node);
+	}
+
+	k_mutex_unlock(&ep->lock);
+
+	return count > 0 ? count : ret;
+}
+
+int z_impl_zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+			    int maxevents, int timeout)
+{
+	struct k_poll_event signal_event;
+	struct epoll_instance *ep;
+	k_timeout_t poll_timeout;
+	k_timeout_t tout;
+	uint64_t end;
+	int ret;
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	ep = z_get_fd_obj(epfd,
+			  (const struct fd_op_vtable *)&epoll_fd_op_vtable,
+			  EINVAL);
+	if (ep == NULL) {
+		return -1;
+	}
+
+	if (timeout < 0) {
+		tout = K_FOREVER;
+	} else {
+		tout = K_MSEC(timeout);
+	}
+
+	end = sys_clock_timeout_end_calc(tout);
+
+	k_poll_event_init(&signal_event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &ep->signal);
+
+	do {
+		ret = epoll_collect(ep, events, maxevents);
+		if (ret != 0) {
+			break;
+		}
+
+		/* Nothing to report, wait until an item is queued unless
+		 * the time is up.
+		 */
+		poll_timeout = tout;
+
+		if (K_TIMEOUT_EQ(tout, K_NO_WAIT)) {
+			break;
+		} else if (!K_TIMEOUT_EQ(tout, K_FOREVER)) {
+			int64_t remaining = end - sys_clock_tick_get();
+
+			if (remaining <= 0) {
+				break;
+			}
+
+			poll_timeout = Z_TIMEOUT_TICKS(remaining);
+		}
+
+		signal_event.state = K_POLL_STATE_NOT_READY;
+
+		ret = k_poll(&signal_event, 1, poll_timeout);
+		if (ret != 0 && ret != -EAGAIN) {
+			break;
+		}
+	} while (true);
+
+	if (ret < 0) {
+		errno = -ret;
+		return -1;
+	}
+
+	return ret;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_zsock_epoll_wait(int epfd,
+					  struct zsock_epoll_event *events,
+					  int maxevents, int timeout)
+{
+	if (maxevents > 0) {
+		Z_OOPS(Z_SYSCALL_MEMORY_ARRAY_WRITE(events, maxevents,
+						    sizeof(*events)));
+	}
+
+	return z_impl_zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+#include <syscalls/zsock_epoll_wait_mrsh.c>
+#endif /* CONFIG_USERSPACE */
+
+void net_socket_epoll_close(int sock, void *obj)
+{
+	struct epoll_instance *ep;
+	struct epoll_item *item;
+	struct k_work_sync sync;
+	bool pending;
+	int i;
+
+	(void)k_mutex_lock(&epoll_instances_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(epoll_instances); i++) {
+		ep = &epoll_instances[i];
+		if (!ep->is_in_use) {
+			continue;
+		}
+
+		(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+		item = epoll_find(ep, sock, obj);
+		pending = item != NULL && epoll_drop(item);
+
+		k_mutex_unlock(&ep->lock);
+
+		/* Wait until the k_poll events are unregistered from the
+		 * socket before it is released.
+		 */
+		if (pending) {
+			(void)k_work_flush(&item->work.work, &sync);
+		}
+	}
+
+	k_mutex_unlock(&epoll_instances_lock);
+}
+
+static int epoll_close_vmeth(void *obj)
+{
+	struct epoll_instance *ep = obj;
+	struct k_work_sync sync;
+	int i;
+
+	(void)k_mutex_lock(&ep->lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		if (ep->items[i].in_use && !ep->items[i].removed) {
+			(void)epoll_drop(&ep->items[i]);
+		}
+	}
+
+	k_mutex_unlock(&ep->lock);
+
+	/* Pending work handlers still use the instance */
+	for (i = 0; i < ARRAY_SIZE(ep->items); i++) {
+		(void)k_work_flush(&ep->items[i].work.work, &sync);
+	}
+
+	(void)k_mutex_lock(&epoll_instances_lock, K_FOREVER);
+	ep->is_in_use = false;
+	k_mutex_unlock(&epoll_instances_lock);
+
+	/* Wake up threads still waiting on the instance */
+	k_poll_signal_raise(&ep->signal, 0);
+
+	return 0;
+}
+
+static int epoll_ioctl_vmeth(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		/* Polling an epoll instance is not supported */
+		return -EOPNOTSUPP;
+
+	default:
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+}
+
+static const struct socket_op_vtable epoll_fd_op_vtable = {
+	.fd_vtable = {
+		.close = epoll_close_vmeth,
+		.ioctl = epoll_ioctl_vmeth,
+	},
+};
@@ -43,6 +43,17 @@ static inline bool net_socket_is_tls(void *obj)
 }
 #endif
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+/* Remove a socket that is being closed from the epoll interest lists */
+void net_socket_epoll_close(int sock, void *obj);
+#else
+static inline void net_socket_epoll_close(int sock, void *obj)
+{
+	ARG_UNUSED(sock);
+	ARG_UNUSED(obj);
+}
+#endif
+
 #define sock_is_eof(ctx) sock_get_flag(ctx, SOCK_EOF)
 #define sock_set_eof(ctx) sock_set_flag(ctx, SOCK_EOF, SOCK_EOF)
 #define sock_is_nonblock(ctx) sock_get_flag(ctx, SOCK_NONBLOCK)
@@ -65,6 +76,10 @@ struct socket_op_vtable {
 	ssize_t (*sendmsg)(void *obj, const struct msghdr *msg, int flags);
 	int (*getsockname)(void *obj, struct sockaddr *addr,
 			   socklen_t *addrlen);
+	int (*sendmmsg)(void *obj, struct mmsghdr *msgvec, unsigned int vlen,
+			int flags);
+	int (*recvmmsg)(void *obj, struct mmsghdr *msgvec, unsigned int vlen,
+			int flags);
 };
 
 #endif /* _SOCKETS_INTERNAL_H_ */
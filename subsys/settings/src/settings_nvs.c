@@ -19,8 +19,30 @@ LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
 struct settings_nvs_read_fn_arg {
 	struct nvs_fs *fs;
 	uint16_t id;
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+	/* entry found by the load walk, read by id if NULL */
+	const struct nvs_entry *entry;
+	/* NVS write generation when entry was found */
+	uint32_t write_gen;
+#endif
 };
 
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+/* Name and value NVS entries of a setting, as found by the load walks.
+ * Missing and deleted entries both have a length of 0.
+ */
+struct settings_nvs_load_item {
+	struct nvs_entry name;
+	struct nvs_entry value;
+};
+
+/* Only used from settings_nvs_load(), which runs under the settings lock */
+static struct settings_nvs_load_item
+	load_items[CONFIG_SETTINGS_NVS_BULK_LOAD_MAX];
+static uint32_t
+	load_seen[NVS_WALK_BITMAP_SIZE(CONFIG_SETTINGS_NVS_BULK_LOAD_MAX)];
+#endif
+
 static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
 static int settings_nvs_save(struct settings_store *cs, const char *name,
@@ -38,7 +60,17 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 
 	rd_fn_arg = (struct settings_nvs_read_fn_arg *)back_end;
 
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+	/* The entry may have been moved if the handler wrote to NVS */
+	if (rd_fn_arg->entry &&
+	    (rd_fn_arg->write_gen == rd_fn_arg->fs->write_gen)) {
+		rc = nvs_entry_read(rd_fn_arg->fs, rd_fn_arg->entry, data, len);
+	} else {
+		rc = nvs_read(rd_fn_arg->fs, rd_fn_arg->id, data, len);
+	}
+#else
 	rc = nvs_read(rd_fn_arg->fs, rd_fn_arg->id, data, len);
+#endif
 	if (rc > (ssize_t)len) {
 		/* nvs_read signals that not all bytes were read
 		 * align read len to what was requested
@@ -64,6 +96,48 @@ int settings_nvs_dst(struct settings_nvs *cf)
 	return 0;
 }
 
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+static int settings_nvs_load_name_cb(struct nvs_fs *fs,
+				     const struct nvs_entry *entry, void *param)
+{
+	load_items[entry->id - (NVS_NAMECNT_ID + 1)].name = *entry;
+	return 0;
+}
+
+static int settings_nvs_load_value_cb(struct nvs_fs *fs,
+				      const struct nvs_entry *entry,
+				      void *param)
+{
+	load_items[entry->id - (NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET + 1)].value =
+		*entry;
+	return 0;
+}
+
+/* Find the most recent name and value entries of all settings with one NVS
+ * walk each, instead of scanning the NVS allocation table for every id.
+ */
+static int settings_nvs_load_walk(struct settings_nvs *cf)
+{
+	uint16_t count = cf->last_name_id - NVS_NAMECNT_ID;
+	int rc;
+
+	if (count > CONFIG_SETTINGS_NVS_BULK_LOAD_MAX) {
+		return -ENOMEM;
+	}
+
+	(void)memset(load_items, 0, count * sizeof(load_items[0]));
+
+	rc = nvs_walk(&cf->cf_nvs, NVS_NAMECNT_ID + 1, count, load_seen,
+		      settings_nvs_load_name_cb, NULL);
+	if (rc) {
+		return rc;
+	}
+
+	return nvs_walk(&cf->cf_nvs, NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET + 1,
+			count, load_seen, settings_nvs_load_value_cb, NULL);
+}
+#endif
+
 static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg)
 {
@@ -74,6 +148,14 @@ static int settings_nvs_load(struct settings_store *cs,
 	char buf;
 	ssize_t rc1, rc2;
 	uint16_t name_id = NVS_NAMECNT_ID;
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+	struct settings_nvs_load_item *item = NULL;
+	uint32_t write_gen;
+	bool bulk;
+
+	bulk = (settings_nvs_load_walk(cf) == 0);
+	write_gen = cf->cf_nvs.write_gen;
+#endif
 
 	name_id = cf->last_name_id + 1;
 
@@ -88,9 +170,32 @@ static int settings_nvs_load(struct settings_store *cs,
 		 * entries one for the setting's name and one with the
 		 * setting's value.
 		 */
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+		/* The walked entries can no longer be used once NVS has been
+		 * written to, either by the cleanup below or by a handler.
+		 */
+		if (bulk && (write_gen != cf->cf_nvs.write_gen)) {
+			bulk = false;
+		}
+
+		if (bulk) {
+			item = &load_items[name_id - (NVS_NAMECNT_ID + 1)];
+			rc1 = nvs_entry_read(&cf->cf_nvs, &item->name, &name,
+					     sizeof(name));
+			rc2 = item->value.len;
+		} else {
+			item = NULL;
+			rc1 = nvs_read(&cf->cf_nvs, name_id, &name,
+				       sizeof(name));
+			rc2 = nvs_read(&cf->cf_nvs,
+				       name_id + NVS_NAME_ID_OFFSET,
+				       &buf, sizeof(buf));
+		}
+#else
 		rc1 = nvs_read(&cf->cf_nvs, name_id, &name, sizeof(name));
 		rc2 = nvs_read(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET,
 			       &buf, sizeof(buf));
+#endif
 
 		if ((rc1 <= 0) && (rc2 <= 0)) {
 			continue;
@@ -116,6 +221,10 @@ static int settings_nvs_load(struct settings_store *cs,
 		name[rc1] = '\0';
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
+#if CONFIG_SETTINGS_NVS_BULK_LOAD_MAX > 0
+		read_fn_arg.entry = item ? &item->value : NULL;
+		read_fn_arg.write_gen = write_gen;
+#endif
 
 		ret = settings_call_set_handler(
 			name, rc2,
@@ -214,6 +214,177 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS_WINDOWS)
+#define USAGE_FMT "%3u.%02u%%"
+#define USAGE_ARG(u) ((u) / 100U), ((u) % 100U)
+
+static void shell_thread_usage_dump(const struct k_thread *cthread,
+				    void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	const struct shell *shell = (const struct shell *)user_data;
+	k_thread_runtime_stats_t stats;
+	const char *tname;
+	char name[16];
+
+	if (k_thread_runtime_stats_get(thread, &stats) != 0) {
+		return;
+	}
+
+	tname = k_thread_name_get(thread);
+	if (tname == NULL || tname[0] == '\0') {
+		snprintk(name, sizeof(name), "%p", thread);
+		tname = name;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "%-16s %4d " USAGE_FMT " " USAGE_FMT " " USAGE_FMT,
+		      tname, thread->base.prio,
+		      USAGE_ARG(stats.usage[0]), USAGE_ARG(stats.usage[1]),
+		      USAGE_ARG(stats.usage[2]));
+#ifdef CONFIG_SMP
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " %u",
+			      (uint32_t)stats.cpu_cycles[i]);
+	}
+#endif
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static int cmd_kernel_top(const struct shell *shell,
+			  size_t argc, char **argv)
+{
+	k_cpu_runtime_stats_t stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "%3s %7s %7s %7s  %s", "CPU", "1s", "10s", "60s",
+		    "idle cycles");
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (k_cpu_runtime_stats_get(i, &stats) != 0) {
+			continue;
+		}
+
+		shell_print(shell, "%3d " USAGE_FMT " " USAGE_FMT " "
+			    USAGE_FMT "  %u", i, USAGE_ARG(stats.usage[0]),
+			    USAGE_ARG(stats.usage[1]), USAGE_ARG(stats.usage[2]),
+			    (uint32_t)stats.idle_cycles);
+	}
+
+	shell_print(shell, "\n%-16s %4s %7s %7s %7s%s", "thread", "prio",
+		    "1s", "10s", "60s",
+		    IS_ENABLED(CONFIG_SMP) ? "  cycles per CPU" : "");
+	k_thread_foreach(shell_thread_usage_dump, (void *)shell);
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_SCHED_LATENCY_STATS)
+static void shell_latency_hist_dump(const struct shell *shell,
+				    const char *name, const char *type,
+				    const struct k_sched_latency_hist *hist)
+{
+	uint32_t count = 0;
+
+	for (int i = 0; i < CONFIG_SCHED_LATENCY_BUCKETS; i++) {
+		count += hist->buckets[i];
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "%-16s %-6s %8u %10u ", name, type,
+		      count, (uint32_t)hist->max_cycles);
+
+	for (int i = 0; i < CONFIG_SCHED_LATENCY_BUCKETS; i++) {
+		if (hist->buckets[i] != 0) {
+			shell_fprintf(shell, SHELL_NORMAL, " %d:%u", i,
+				      hist->buckets[i]);
+		}
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "\n");
+}
+
+static void shell_latency_dump(const struct shell *shell, const char *name,
+			       const k_sched_latency_stats_t *stats)
+{
+	shell_latency_hist_dump(shell, name, "wakeup", &stats->wakeup);
+	shell_latency_hist_dump(shell, name, "isr", &stats->isr);
+}
+
+#if defined(CONFIG_THREAD_MONITOR)
+static void shell_thread_latency_dump(const struct k_thread *cthread,
+				      void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	const struct shell *shell = (const struct shell *)user_data;
+	k_sched_latency_stats_t stats;
+	const char *tname;
+	char name[16];
+
+	if (k_thread_sched_latency_get(thread, &stats) != 0) {
+		return;
+	}
+
+	tname = k_thread_name_get(thread);
+	if (tname == NULL || tname[0] == '\0') {
+		snprintk(name, sizeof(name), "%p", thread);
+		tname = name;
+	}
+
+	shell_latency_dump(shell, tname, &stats);
+}
+#endif
+
+static int cmd_kernel_latency(const struct shell *shell,
+			      size_t argc, char **argv)
+{
+	k_sched_latency_stats_t stats;
+	char name[16];
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Latency in cycles, buckets are log2(cycles):count");
+	shell_print(shell, "%-16s %-6s %8s %10s  %s", "priority/thread", "type",
+		    "count", "max", "buckets");
+
+	for (int prio = K_HIGHEST_THREAD_PRIO; prio <= K_LOWEST_THREAD_PRIO;
+	     prio++) {
+		if (k_sched_latency_prio_get(prio, &stats) == 0) {
+			snprintk(name, sizeof(name), "prio %d", prio);
+			shell_latency_dump(shell, name, &stats);
+		}
+	}
+
+#if defined(CONFIG_THREAD_MONITOR)
+	k_thread_foreach(shell_thread_latency_dump, (void *)shell);
+#endif
+
+	return 0;
+}
+
+static int cmd_kernel_latency_reset(const struct shell *shell,
+				    size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	k_sched_latency_reset();
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_latency,
+	SHELL_CMD(reset, NULL, "Reset statistics.", cmd_kernel_latency_reset),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -248,6 +419,10 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel_reboot,
 
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(cycles, NULL, "Kernel cycles.", cmd_kernel_cycles),
+#if defined(CONFIG_SCHED_LATENCY_STATS)
+	SHELL_CMD(latency, &sub_kernel_latency,
+		  "Scheduling latency histograms.", cmd_kernel_latency),
+#endif
 #if defined(CONFIG_REBOOT)
 	SHELL_CMD(reboot, &sub_kernel_reboot, "Reboot.", NULL),
 #endif
@@ -255,6 +430,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 		defined(CONFIG_THREAD_MONITOR)
 	SHELL_CMD(stacks, NULL, "List threads stack usage.", cmd_kernel_stacks),
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
+#endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS_WINDOWS)
+	SHELL_CMD(top, NULL, "CPU usage of CPUs and threads.", cmd_kernel_top),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
@@ -160,6 +160,144 @@ static void uart_callback(const struct device *dev, void *user_data)
 }
 #endif /* CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN */
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+/* Start a transfer of the data at the beginning of the TX ring buffer. The
+ * data stays in the ring buffer until the transfer completes. Returns false
+ * if there was nothing to send.
+ */
+static bool async_tx_start(const struct shell_uart *sh_uart)
+{
+	struct shell_uart_ctrl_blk *ctrl_blk = sh_uart->ctrl_blk;
+	uint8_t *data;
+	int err;
+
+	ctrl_blk->tx_len = ring_buf_get_claim(sh_uart->tx_ringbuf, &data,
+					      sh_uart->tx_ringbuf->size);
+	if (ctrl_blk->tx_len == 0) {
+		return false;
+	}
+
+	err = uart_tx(ctrl_blk->dev, data, ctrl_blk->tx_len, SYS_FOREVER_MS);
+	if (err < 0) {
+		/* Data cannot be sent, discard it. */
+		err = ring_buf_get_finish(sh_uart->tx_ringbuf,
+					  ctrl_blk->tx_len);
+		__ASSERT_NO_MSG(err == 0);
+		return false;
+	}
+
+	return true;
+}
+
+static void async_tx_kick(const struct shell_uart *sh_uart)
+{
+	struct shell_uart_ctrl_blk *ctrl_blk = sh_uart->ctrl_blk;
+
+	/* Data may be added after the ring buffer was found empty but before
+	 * tx_busy was cleared, so check again after clearing it.
+	 */
+	do {
+		if (ctrl_blk->blocking_tx ||
+		    atomic_set(&ctrl_blk->tx_busy, 1) != 0) {
+			return;
+		}
+
+		if (async_tx_start(sh_uart)) {
+			return;
+		}
+
+		atomic_clear(&ctrl_blk->tx_busy);
+	} while (!ring_buf_is_empty(sh_uart->tx_ringbuf));
+}
+
+static void async_rx_enable(const struct shell_uart *sh_uart)
+{
+	struct shell_uart_ctrl_blk *ctrl_blk = sh_uart->ctrl_blk;
+	int err;
+
+	ctrl_blk->rx_buf_idx = 1;
+	err = uart_rx_enable(ctrl_blk->dev, ctrl_blk->rx_bufs[0],
+			     sizeof(ctrl_blk->rx_bufs[0]),
+			     CONFIG_SHELL_BACKEND_SERIAL_ASYNC_RX_TIMEOUT);
+	if (err < 0) {
+		LOG_ERR("Failed to enable RX (%d)", err);
+	}
+}
+
+static void async_callback(const struct device *dev, struct uart_event *evt,
+			   void *user_data)
+{
+	const struct shell_uart *sh_uart = (struct shell_uart *)user_data;
+	struct shell_uart_ctrl_blk *ctrl_blk = sh_uart->ctrl_blk;
+	uint32_t len;
+	int err;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		err = ring_buf_get_finish(sh_uart->tx_ringbuf,
+					  ctrl_blk->tx_len);
+		__ASSERT_NO_MSG(err == 0);
+		atomic_clear(&ctrl_blk->tx_busy);
+		async_tx_kick(sh_uart);
+		ctrl_blk->handler(SHELL_TRANSPORT_EVT_TX_RDY,
+				  ctrl_blk->context);
+		break;
+	case UART_RX_RDY:
+		len = ring_buf_put(sh_uart->rx_ringbuf,
+				   &evt->data.rx.buf[evt->data.rx.offset],
+				   evt->data.rx.len);
+		if (len < evt->data.rx.len) {
+			LOG_WRN("RX ring buffer full.");
+		}
+		ctrl_blk->handler(SHELL_TRANSPORT_EVT_RX_RDY,
+				  ctrl_blk->context);
+		break;
+	case UART_RX_BUF_REQUEST:
+		(void)uart_rx_buf_rsp(dev,
+				      ctrl_blk->rx_bufs[ctrl_blk->rx_buf_idx],
+				      sizeof(ctrl_blk->rx_bufs[0]));
+		ctrl_blk->rx_buf_idx ^= 1;
+		break;
+	case UART_RX_DISABLED:
+		/* Reception stops after an error, restart it. */
+		if (ctrl_blk->rx_enabled) {
+			async_rx_enable(sh_uart);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static int async_init(const struct shell_uart *sh_uart)
+{
+	struct shell_uart_ctrl_blk *ctrl_blk = sh_uart->ctrl_blk;
+	int err;
+
+	ring_buf_reset(sh_uart->tx_ringbuf);
+	ring_buf_reset(sh_uart->rx_ringbuf);
+	ctrl_blk->tx_busy = 0;
+
+	err = uart_callback_set(ctrl_blk->dev, async_callback,
+				(void *)sh_uart);
+	if (err < 0) {
+		return err;
+	}
+
+	ctrl_blk->rx_enabled = true;
+	async_rx_enable(sh_uart);
+
+	return 0;
+}
+
+static void async_uninit(const struct shell_uart *sh_uart)
+{
+	sh_uart->ctrl_blk->rx_enabled = false;
+	(void)uart_rx_disable(sh_uart->ctrl_blk->dev);
+	(void)uart_tx_abort(sh_uart->ctrl_blk->dev);
+}
+#else
 static void uart_irq_init(const struct shell_uart *sh_uart)
 {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
@@ -187,6 +325,7 @@ static void timer_handler(struct k_timer *timer)
 					   sh_uart->ctrl_blk->context);
 	}
 }
+#endif /* CONFIG_SHELL_BACKEND_SERIAL_ASYNC */
 
 static int init(const struct shell_transport *transport,
 		const void *config,
@@ -204,6 +343,9 @@ static int init(const struct shell_transport *transport,
 	k_fifo_init(&sh_uart->ctrl_blk->smp.buf_ready);
 #endif
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+	return async_init(sh_uart);
+#else
 	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)) {
 		uart_irq_init(sh_uart);
 	} else {
@@ -213,12 +355,16 @@ static int init(const struct shell_transport *transport,
 	}
 
 	return 0;
+#endif
 }
 
 static int uninit(const struct shell_transport *transport)
 {
 	const struct shell_uart *sh_uart = (struct shell_uart *)transport->ctx;
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+	async_uninit(sh_uart);
+#else
 	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN)) {
 		const struct device *dev = sh_uart->ctrl_blk->dev;
 
@@ -227,6 +373,7 @@ static int uninit(const struct shell_transport *transport)
 	} else {
 		k_timer_stop(sh_uart->timer);
 	}
+#endif
 
 	return 0;
 }
@@ -240,6 +387,9 @@ static int enable(const struct shell_transport *transport, bool blocking_tx)
 	if (blocking_tx) {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
 		uart_irq_tx_disable(sh_uart->ctrl_blk->dev);
+#endif
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+		(void)uart_tx_abort(sh_uart->ctrl_blk->dev);
 #endif
 	}
 
@@ -251,11 +401,15 @@ static void irq_write(const struct shell_uart *sh_uart, const void *data,
 {
 	*cnt = ring_buf_put(sh_uart->tx_ringbuf, data, length);
 
+#ifdef CONFIG_SHELL_BACKEND_SERIAL_ASYNC
+	async_tx_kick(sh_uart);
+#else
 	if (atomic_set(&sh_uart->ctrl_blk->tx_busy, 1) == 0) {
 #ifdef CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN
 		uart_irq_tx_enable(sh_uart->ctrl_blk->dev);
 #endif
 	}
+#endif
 }
 
 static int write(const struct shell_transport *transport,
@@ -264,7 +418,8 @@ static int write(const struct shell_transport *transport,
 	const struct shell_uart *sh_uart = (struct shell_uart *)transport->ctx;
 	const uint8_t *data8 = (const uint8_t *)data;
 
-	if (IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) &&
+	if ((IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_INTERRUPT_DRIVEN) ||
+	     IS_ENABLED(CONFIG_SHELL_BACKEND_SERIAL_ASYNC)) &&
 		!sh_uart->ctrl_blk->blocking_tx) {
 		irq_write(sh_uart, data, length, cnt);
 	} else {
@@ -8,7 +8,15 @@
 #include <kernel_structs.h>
 #include <kernel_internal.h>
 #include <ctf_top.h>
-
+#include <tracing/tracing_filter.h>
+
+#ifdef CONFIG_TRACING_RUNTIME_FILTER
+#define TRACING_CLASS_ENABLED(cls) z_tracing_class_enabled(cls)
+#define TRACING_OBJECT_ENABLED(cls, obj) z_tracing_object_enabled(cls, obj)
+#else
+#define TRACING_CLASS_ENABLED(cls) true
+#define TRACING_OBJECT_ENABLED(cls, obj) true
+#endif
 
 static void _get_thread_name(struct k_thread *thread,
 			     ctf_bounded_string_t *name)
@@ -28,6 +36,10 @@ void sys_trace_k_thread_switched_out(void)
 	struct k_thread *thread;
 
 	thread = k_current_get();
+	if (!TRACING_OBJECT_ENABLED(TRACING_CLASS_THREAD, thread)) {
+		return;
+	}
+
 	_get_thread_name(thread, &name);
 
 	ctf_top_thread_switched_out((uint32_t)(uintptr_t)thread, name);
@@ -39,6 +51,10 @@ void sys_trace_k_thread_switched_in(void)
 	ctf_bounded_string_t name = { "unknown" };
 
 	thread = k_current_get();
+	if (!TRACING_OBJECT_ENABLED(TRACING_CLASS_THREAD, thread)) {
+		return;
+	}
+
 	_get_thread_name(thread, &name);
 
 	ctf_top_thread_switched_in((uint32_t)(uintptr_t)thread, name);
@@ -150,22 +166,30 @@ void sys_trace_k_thread_name_set(struct k_thread *thread, int ret)
 
 void sys_trace_isr_enter(void)
 {
-	ctf_top_isr_enter();
+	if (TRACING_CLASS_ENABLED(TRACING_CLASS_ISR)) {
+		ctf_top_isr_enter();
+	}
 }
 
 void sys_trace_isr_exit(void)
 {
-	ctf_top_isr_exit();
+	if (TRACING_CLASS_ENABLED(TRACING_CLASS_ISR)) {
+		ctf_top_isr_exit();
+	}
 }
 
 void sys_trace_isr_exit_to_scheduler(void)
 {
-	ctf_top_isr_exit_to_scheduler();
+	if (TRACING_CLASS_ENABLED(TRACING_CLASS_ISR)) {
+		ctf_top_isr_exit_to_scheduler();
+	}
 }
 
 void sys_trace_idle(void)
 {
-	ctf_top_idle();
+	if (TRACING_CLASS_ENABLED(TRACING_CLASS_IDLE)) {
+		ctf_top_idle();
+	}
 }
 
 /* Semaphore */
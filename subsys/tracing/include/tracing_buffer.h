@@ -9,6 +9,7 @@
 
 #include <stdbool.h>
 #include <zephyr/types.h>
+#include <tracing/tracing_format.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -104,6 +105,31 @@ int tracing_buffer_get_finish(uint32_t size);
  */
 uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
 
+/**
+ * @brief Write a packet to the tracing buffer of the current CPU.
+ *
+ * Packet is written as a single record composed of the data chunks. It is
+ * dropped if it is longer than CONFIG_TRACING_PACKET_MAX_SIZE.
+ *
+ * @param data Array of data chunks.
+ * @param count Number of data chunks.
+ * @param was_empty Set to true if the buffer was empty before the write.
+ *
+ * @return true if the packet was written, false if it was dropped.
+ */
+bool tracing_buffer_cpu_put(const tracing_data_t *data, uint32_t count,
+			    bool *was_empty);
+
+/**
+ * @brief Read the oldest packet from the tracing buffers of all CPUs.
+ *
+ * @param data Address of the output buffer.
+ * @param size Output buffer size (in bytes).
+ *
+ * @return Packet length, 0 if all buffers are empty.
+ */
+uint32_t tracing_buffer_cpu_get(uint8_t *data, uint32_t size);
+
 /**
  * @brief Get buffer from tracing command buffer.
  *
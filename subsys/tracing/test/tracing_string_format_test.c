@@ -55,6 +55,11 @@ void sys_trace_k_thread_resume(struct k_thread *thread)
 	TRACING_STRING("%s: %p\n", __func__, thread);
 }
 
+void sys_trace_k_thread_resume_exit(struct k_thread *thread)
+{
+	TRACING_STRING("%s: %p\n", __func__, thread);
+}
+
 void sys_trace_k_thread_ready(struct k_thread *thread)
 {
 	TRACING_STRING("%s: %p\n", __func__, thread);
@@ -4,10 +4,14 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/atomic.h>
 #include <sys/ring_buffer.h>
+#include <tracing_core.h>
+#include <tracing_buffer.h>
 
-static struct ring_buf tracing_ring_buf;
-static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
 static uint8_t tracing_cmd_buffer[CONFIG_TRACING_CMD_BUFFER_SIZE];
 
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
@@ -17,6 +21,209 @@ uint32_t tracing_cmd_buffer_alloc(uint8_t **data)
 	return sizeof(tracing_cmd_buffer);
 }
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFER
+/*
+ * Each CPU writes packets to its own buffer and only masks its own
+ * interrupts while doing so, so no lock is shared between CPUs. A packet is
+ * stored as a record: a header followed by the data, padded to a word.
+ * Read and write indexes are free running and only the write index of a
+ * buffer is modified by its CPU. The read index is advanced by the tracing
+ * thread and, in overwrite mode, also by the CPU when it needs space. The
+ * CPU advances the read index before it overwrites a record, so the tracing
+ * thread detects that a record it has copied was overwritten when it fails
+ * to advance the read index.
+ */
+BUILD_ASSERT((CONFIG_TRACING_BUFFER_SIZE &
+	      (CONFIG_TRACING_BUFFER_SIZE - 1)) == 0,
+	     "Per-CPU tracing buffer size must be a power of two");
+
+struct tracing_record_hdr {
+	uint16_t len;
+	uint16_t reserved;
+	/* Used to output packets from all CPUs in order. */
+	uint32_t stamp;
+};
+
+struct tracing_cpu_buffer {
+	atomic_t wr;
+	atomic_t rd;
+	uint8_t data[CONFIG_TRACING_BUFFER_SIZE];
+} __aligned(sizeof(void *));
+
+#define RECORD_SIZE(len) \
+	ROUND_UP(sizeof(struct tracing_record_hdr) + (len), sizeof(uint32_t))
+
+BUILD_ASSERT(RECORD_SIZE(CONFIG_TRACING_PACKET_MAX_SIZE) <=
+	     CONFIG_TRACING_BUFFER_SIZE,
+	     "Tracing buffer cannot hold the largest packet");
+
+static struct tracing_cpu_buffer cpu_buffers[CONFIG_MP_NUM_CPUS];
+
+static void record_write(struct tracing_cpu_buffer *buf, uint32_t idx,
+			 const void *src, uint32_t len)
+{
+	uint32_t offset = idx & (CONFIG_TRACING_BUFFER_SIZE - 1);
+	uint32_t first = MIN(len, CONFIG_TRACING_BUFFER_SIZE - offset);
+
+	memcpy(&buf->data[offset], src, first);
+	memcpy(buf->data, (const uint8_t *)src + first, len - first);
+}
+
+static void record_read(struct tracing_cpu_buffer *buf, uint32_t idx,
+			void *dst, uint32_t len)
+{
+	uint32_t offset = idx & (CONFIG_TRACING_BUFFER_SIZE - 1);
+	uint32_t first = MIN(len, CONFIG_TRACING_BUFFER_SIZE - offset);
+
+	memcpy(dst, &buf->data[offset], first);
+	memcpy((uint8_t *)dst + first, buf->data, len - first);
+}
+
+/* Free space for a record by discarding the oldest ones. */
+static bool record_space_get(struct tracing_cpu_buffer *buf, uint32_t wr,
+			     uint32_t size)
+{
+	while (CONFIG_TRACING_BUFFER_SIZE - (wr - (uint32_t)atomic_get(&buf->rd))
+	       < size) {
+		struct tracing_record_hdr hdr;
+		uint32_t rd = atomic_get(&buf->rd);
+
+		if (!IS_ENABLED(CONFIG_TRACING_PER_CPU_BUFFER_OVERWRITE)) {
+			return false;
+		}
+
+		record_read(buf, rd, &hdr, sizeof(hdr));
+		if (atomic_cas(&buf->rd, rd, rd + RECORD_SIZE(hdr.len))) {
+			tracing_packet_drop_handle();
+		}
+	}
+
+	return true;
+}
+
+bool tracing_buffer_cpu_put(const tracing_data_t *data, uint32_t count,
+			    bool *was_empty)
+{
+	struct tracing_record_hdr hdr = { 0 };
+	struct tracing_cpu_buffer *buf;
+	unsigned int key;
+	uint32_t len = 0;
+	uint32_t wr, idx;
+	bool ok;
+
+	for (uint32_t i = 0; i < count; i++) {
+		len += data[i].length;
+	}
+
+	if (len > CONFIG_TRACING_PACKET_MAX_SIZE) {
+		return false;
+	}
+
+	hdr.len = len;
+
+	key = arch_irq_lock();
+
+	buf = &cpu_buffers[_current_cpu->id];
+	wr = atomic_get(&buf->wr);
+	*was_empty = (wr == (uint32_t)atomic_get(&buf->rd));
+
+	ok = record_space_get(buf, wr, RECORD_SIZE(hdr.len));
+	if (ok) {
+		hdr.stamp = k_cycle_get_32();
+		record_write(buf, wr, &hdr, sizeof(hdr));
+
+		idx = wr + sizeof(hdr);
+		for (uint32_t i = 0; i < count; i++) {
+			record_write(buf, idx, data[i].data, data[i].length);
+			idx += data[i].length;
+		}
+
+		atomic_set(&buf->wr, wr + RECORD_SIZE(hdr.len));
+	}
+
+	arch_irq_unlock(key);
+
+	return ok;
+}
+
+uint32_t tracing_buffer_cpu_get(uint8_t *data, uint32_t size)
+{
+	__ASSERT_NO_MSG(size >= CONFIG_TRACING_PACKET_MAX_SIZE);
+
+	while (true) {
+		struct tracing_cpu_buffer *oldest = NULL;
+		struct tracing_record_hdr hdr, oldest_hdr;
+		uint32_t rd, oldest_rd = 0;
+
+		for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+			struct tracing_cpu_buffer *buf = &cpu_buffers[i];
+			uint32_t wr = atomic_get(&buf->wr);
+
+			rd = atomic_get(&buf->rd);
+			if (rd == wr) {
+				continue;
+			}
+
+			record_read(buf, rd, &hdr, sizeof(hdr));
+			if (oldest == NULL ||
+			    (int32_t)(hdr.stamp - oldest_hdr.stamp) < 0) {
+				oldest = buf;
+				oldest_hdr = hdr;
+				oldest_rd = rd;
+			}
+		}
+
+		if (oldest == NULL) {
+			return 0;
+		}
+
+		/* Header may be garbage if the record is being overwritten,
+		 * in that case the read index has already moved.
+		 */
+		if (oldest_hdr.len > CONFIG_TRACING_PACKET_MAX_SIZE) {
+			__ASSERT_NO_MSG(
+				IS_ENABLED(CONFIG_TRACING_PER_CPU_BUFFER_OVERWRITE));
+			continue;
+		}
+
+		record_read(oldest, oldest_rd + sizeof(hdr), data,
+			    oldest_hdr.len);
+
+		if (atomic_cas(&oldest->rd, oldest_rd,
+			       oldest_rd + RECORD_SIZE(oldest_hdr.len))) {
+			return oldest_hdr.len;
+		}
+	}
+}
+
+void tracing_buffer_init(void)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		atomic_set(&cpu_buffers[i].wr, 0);
+		atomic_set(&cpu_buffers[i].rd, 0);
+	}
+}
+
+bool tracing_buffer_is_empty(void)
+{
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (atomic_get(&cpu_buffers[i].wr) !=
+		    atomic_get(&cpu_buffers[i].rd)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t tracing_buffer_capacity_get(void)
+{
+	return CONFIG_TRACING_BUFFER_SIZE;
+}
+#else
+static struct ring_buf tracing_ring_buf;
+static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
+
 uint32_t tracing_buffer_put_claim(uint8_t **data, uint32_t size)
 {
 	return ring_buf_put_claim(&tracing_ring_buf, data, size);
@@ -67,3 +274,4 @@ uint32_t tracing_buffer_space_get(void)
 {
 	return ring_buf_space_get(&tracing_ring_buf);
 }
+#endif /* CONFIG_TRACING_PER_CPU_BUFFER */
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <shell/shell.h>
+#include <tracing/tracing_filter.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct thread_lookup {
+	const char *name;
+	struct k_thread *thread;
+};
+
+static int class_find(const char *name)
+{
+	for (int i = 0; i < TRACING_CLASS_COUNT; i++) {
+		if (strcmp(name, tracing_class_name_get(i)) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void thread_match(const struct k_thread *thread, void *user_data)
+{
+	struct thread_lookup *lookup = user_data;
+	const char *name = k_thread_name_get((k_tid_t)thread);
+
+	if (lookup->thread == NULL && name != NULL &&
+	    strcmp(name, lookup->name) == 0) {
+		lookup->thread = (struct k_thread *)thread;
+	}
+}
+
+/* Object is given either as a thread name or as an address. */
+static const void *object_parse(const struct shell *shell, const char *arg)
+{
+	struct thread_lookup lookup = {
+		.name = arg,
+	};
+	unsigned long addr;
+	char *end;
+
+	k_thread_foreach(thread_match, &lookup);
+	if (lookup.thread != NULL) {
+		return lookup.thread;
+	}
+
+	addr = strtoul(arg, &end, 16);
+	if (*end != '\0' || addr == 0) {
+		shell_error(shell, "Invalid object: %s", arg);
+		return NULL;
+	}
+
+	return (const void *)addr;
+}
+
+static int classes_set(const struct shell *shell, size_t argc, char **argv,
+		       bool enable)
+{
+	int cls;
+
+	if (argc == 1) {
+		tracing_class_mask_set(enable ? TRACING_CLASS_ALL : 0);
+		return 0;
+	}
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "all") == 0) {
+			tracing_class_mask_set(enable ? TRACING_CLASS_ALL : 0);
+			continue;
+		}
+
+		cls = class_find(argv[i]);
+		if (cls < 0) {
+			shell_error(shell, "Unknown class: %s", argv[i]);
+			return -EINVAL;
+		}
+
+		tracing_class_set(cls, enable);
+	}
+
+	return 0;
+}
+
+static int cmd_tracing_enable(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	return classes_set(shell, argc, argv, true);
+}
+
+static int cmd_tracing_disable(const struct shell *shell, size_t argc,
+			       char **argv)
+{
+	return classes_set(shell, argc, argv, false);
+}
+
+static int cmd_tracing_filter(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	bool enable;
+	int cls;
+
+	cls = class_find(argv[1]);
+	if (cls < 0) {
+		shell_error(shell, "Unknown class: %s", argv[1]);
+		return -EINVAL;
+	}
+
+	if (strcmp(argv[2], "on") == 0) {
+		enable = true;
+	} else if (strcmp(argv[2], "off") == 0) {
+		enable = false;
+	} else {
+		shell_error(shell, "Expected on or off");
+		return -EINVAL;
+	}
+
+	tracing_object_filter_set(cls, enable);
+
+	return 0;
+}
+
+static int cmd_tracing_select(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	const void *obj;
+	int err;
+
+	for (int i = 1; i < argc; i++) {
+		obj = object_parse(shell, argv[i]);
+		if (obj == NULL) {
+			return -EINVAL;
+		}
+
+		err = tracing_object_select(obj);
+		if (err < 0) {
+			shell_error(shell, "Cannot select %s (%d)", argv[i], err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int cmd_tracing_deselect(const struct shell *shell, size_t argc,
+				char **argv)
+{
+	const void *obj;
+	int err;
+
+	for (int i = 1; i < argc; i++) {
+		obj = object_parse(shell, argv[i]);
+		if (obj == NULL) {
+			return -EINVAL;
+		}
+
+		err = tracing_object_deselect(obj);
+		if (err < 0) {
+			shell_error(shell, "%s is not selected", argv[i]);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static void object_print(const void *obj, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_print(shell, "  %p", obj);
+}
+
+static int cmd_tracing_status(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	uint32_t mask = tracing_class_mask_get();
+
+	shell_print(shell, "%-10s %-8s %s", "class", "state", "objects");
+	for (int i = 0; i < TRACING_CLASS_COUNT; i++) {
+		shell_print(shell, "%-10s %-8s %s", tracing_class_name_get(i),
+			    (mask & BIT(i)) ? "enabled" : "disabled",
+			    (z_tracing_object_mask & BIT(i)) ? "selected" :
+							       "all");
+	}
+
+	shell_print(shell, "Selected objects:");
+	tracing_object_foreach(object_print, (void *)shell);
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_tracing,
+	SHELL_CMD_ARG(enable, NULL,
+		"'tracing enable <class_0> .. <class_n>' enables tracing of "
+		"the specified classes (all if no class specified).",
+		cmd_tracing_enable, 1, TRACING_CLASS_COUNT),
+	SHELL_CMD_ARG(disable, NULL,
+		"'tracing disable <class_0> .. <class_n>' disables tracing of "
+		"the specified classes (all if no class specified).",
+		cmd_tracing_disable, 1, TRACING_CLASS_COUNT),
+	SHELL_CMD_ARG(filter, NULL,
+		"'tracing filter <class> on|off' traces the class only for "
+		"selected objects, or for all objects.",
+		cmd_tracing_filter, 3, 0),
+	SHELL_CMD_ARG(select, NULL,
+		"'tracing select <object_0> .. <object_n>' selects threads "
+		"(by name) or kernel objects (by hex address).",
+		cmd_tracing_select, 2, CONFIG_TRACING_RUNTIME_FILTER_OBJECTS - 1),
+	SHELL_CMD_ARG(deselect, NULL,
+		"'tracing deselect <object_0> .. <object_n>' removes objects "
+		"from the selection.",
+		cmd_tracing_deselect, 2, CONFIG_TRACING_RUNTIME_FILTER_OBJECTS - 1),
+	SHELL_CMD(status, NULL, "Tracing filter status", cmd_tracing_status),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(tracing, &sub_tracing,
+		   "Commands for controlling the runtime tracing filter", NULL);
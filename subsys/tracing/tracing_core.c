@@ -47,6 +47,37 @@ static K_SEM_DEFINE(tracing_thread_sem, 0, 1);
 static K_THREAD_STACK_DEFINE(tracing_thread_stack,
 			CONFIG_TRACING_THREAD_STACK_SIZE);
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFER
+/* Packets from all CPUs are gathered in this buffer before they are passed
+ * to the backend.
+ */
+static uint8_t tracing_output_buf[4 * CONFIG_TRACING_PACKET_MAX_SIZE];
+
+static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
+{
+	uint32_t length, packet_length;
+
+	tracing_thread_tid = k_current_get();
+
+	while (true) {
+		length = 0;
+		do {
+			packet_length = tracing_buffer_cpu_get(
+				&tracing_output_buf[length],
+				sizeof(tracing_output_buf) - length);
+			length += packet_length;
+		} while (packet_length > 0 &&
+			 sizeof(tracing_output_buf) - length >=
+			 CONFIG_TRACING_PACKET_MAX_SIZE);
+
+		if (length > 0) {
+			tracing_buffer_handle(tracing_output_buf, length);
+		} else {
+			k_sem_take(&tracing_thread_sem, K_FOREVER);
+		}
+	}
+}
+#else
 static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
 	uint8_t *transferring_buf;
@@ -70,6 +101,7 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 		}
 	}
 }
+#endif /* CONFIG_TRACING_PER_CPU_BUFFER */
 
 static void tracing_thread_timer_expiry_fn(struct k_timer *timer)
 {
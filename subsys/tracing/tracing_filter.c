@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <errno.h>
+#include <tracing/tracing_filter.h>
+
+/* Read without locking by every tracing hook, written only here. */
+uint32_t z_tracing_class_mask =
+	CONFIG_TRACING_RUNTIME_FILTER_INIT_MASK & TRACING_CLASS_ALL;
+uint32_t z_tracing_object_mask;
+
+/* Selected objects. Slots are only written under the lock, a reader may
+ * miss an object which is being selected, which is harmless.
+ */
+static const void *volatile objects[CONFIG_TRACING_RUNTIME_FILTER_OBJECTS];
+static struct k_spinlock lock;
+
+static const char *const class_names[] = {
+	[TRACING_CLASS_THREAD] = "thread",
+	[TRACING_CLASS_ISR] = "isr",
+	[TRACING_CLASS_IDLE] = "idle",
+	[TRACING_CLASS_WORK] = "work",
+	[TRACING_CLASS_POLL] = "poll",
+	[TRACING_CLASS_SEMAPHORE] = "sem",
+	[TRACING_CLASS_MUTEX] = "mutex",
+	[TRACING_CLASS_CONDVAR] = "condvar",
+	[TRACING_CLASS_QUEUE] = "queue",
+	[TRACING_CLASS_FIFO] = "fifo",
+	[TRACING_CLASS_LIFO] = "lifo",
+	[TRACING_CLASS_STACK] = "stack",
+	[TRACING_CLASS_MESSAGE_QUEUE] = "msgq",
+	[TRACING_CLASS_MAILBOX] = "mbox",
+	[TRACING_CLASS_PIPE] = "pipe",
+	[TRACING_CLASS_HEAP] = "heap",
+	[TRACING_CLASS_MEMORY_SLAB] = "mem_slab",
+	[TRACING_CLASS_TIMER] = "timer",
+	[TRACING_CLASS_PM] = "pm",
+};
+
+BUILD_ASSERT(ARRAY_SIZE(class_names) == TRACING_CLASS_COUNT,
+	     "Missing tracing class name");
+BUILD_ASSERT(TRACING_CLASS_COUNT <= 32, "Too many tracing classes");
+
+bool z_tracing_object_is_selected(const void *obj)
+{
+	for (int i = 0; i < ARRAY_SIZE(objects); i++) {
+		if (objects[i] == obj) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool z_tracing_current_is_selected(void)
+{
+	return z_tracing_object_is_selected(k_current_get());
+}
+
+void tracing_class_mask_set(uint32_t mask)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	z_tracing_class_mask = mask & TRACING_CLASS_ALL;
+
+	k_spin_unlock(&lock, key);
+}
+
+uint32_t tracing_class_mask_get(void)
+{
+	return z_tracing_class_mask;
+}
+
+void tracing_class_set(enum tracing_class cls, bool enable)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	WRITE_BIT(z_tracing_class_mask, cls, enable);
+
+	k_spin_unlock(&lock, key);
+}
+
+const char *tracing_class_name_get(enum tracing_class cls)
+{
+	if ((unsigned int)cls >= TRACING_CLASS_COUNT) {
+		return NULL;
+	}
+
+	return class_names[cls];
+}
+
+void tracing_object_filter_set(enum tracing_class cls, bool enable)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	WRITE_BIT(z_tracing_object_mask, cls, enable);
+
+	k_spin_unlock(&lock, key);
+}
+
+int tracing_object_select(const void *obj)
+{
+	k_spinlock_key_t key;
+	int free = -1;
+	int ret = 0;
+
+	if (obj == NULL) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&lock);
+
+	for (int i = 0; i < ARRAY_SIZE(objects); i++) {
+		if (objects[i] == obj) {
+			goto out;
+		}
+
+		if (objects[i] == NULL && free < 0) {
+			free = i;
+		}
+	}
+
+	if (free < 0) {
+		ret = -ENOMEM;
+	} else {
+		objects[free] = obj;
+	}
+
+out:
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+int tracing_object_deselect(const void *obj)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	int ret = -ENOENT;
+
+	for (int i = 0; i < ARRAY_SIZE(objects); i++) {
+		if (objects[i] == obj) {
+			objects[i] = NULL;
+			ret = 0;
+			break;
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return ret;
+}
+
+void tracing_object_foreach(void (*cb)(const void *obj, void *user_data),
+			    void *user_data)
+{
+	for (int i = 0; i < ARRAY_SIZE(objects); i++) {
+		const void *obj = objects[i];
+
+		if (obj != NULL) {
+			cb(obj, user_data);
+		}
+	}
+}
@@ -8,6 +8,60 @@
 #include <tracing_buffer.h>
 #include <tracing_format_common.h>
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFER
+static void tracing_cpu_put(tracing_data_t *tracing_data_array,
+			    uint32_t count)
+{
+	bool before_put_is_empty;
+
+	if (tracing_buffer_cpu_put(tracing_data_array, count,
+				   &before_put_is_empty)) {
+		tracing_trigger_output(before_put_is_empty);
+	} else {
+		tracing_packet_drop_handle();
+	}
+}
+
+void tracing_format_string(const char *str, ...)
+{
+	char buf[CONFIG_TRACING_PACKET_MAX_SIZE];
+	tracing_data_t tracing_data = { .data = (uint8_t *)buf };
+	va_list args;
+	int length;
+
+	if (!is_tracing_enabled() || is_tracing_thread()) {
+		return;
+	}
+
+	/* String is truncated to the maximum packet size. */
+	va_start(args, str);
+	length = vsnprintk(buf, sizeof(buf), str, args);
+	va_end(args);
+
+	tracing_data.length = MIN(length, sizeof(buf) - 1);
+	tracing_cpu_put(&tracing_data, 1);
+}
+
+void tracing_format_raw_data(uint8_t *data, uint32_t length)
+{
+	tracing_data_t tracing_data = { .data = data, .length = length };
+
+	if (!is_tracing_enabled() || is_tracing_thread()) {
+		return;
+	}
+
+	tracing_cpu_put(&tracing_data, 1);
+}
+
+void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count)
+{
+	if (!is_tracing_enabled() || is_tracing_thread()) {
+		return;
+	}
+
+	tracing_cpu_put(tracing_data_array, count);
+}
+#else
 void tracing_format_string(const char *str, ...)
 {
 	va_list args;
@@ -72,3 +126,4 @@ void tracing_format_data(tracing_data_t *tracing_data_array, uint32_t count)
 		tracing_packet_drop_handle();
 	}
 }
+#endif /* CONFIG_TRACING_PER_CPU_BUFFER */
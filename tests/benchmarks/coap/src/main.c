@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <stdio.h>
+#include <string.h>
+#include <net/coap.h>
+#include <timing/timing.h>
+
+/* This is a CoAP server request handling benchmark.  A table of
+ * N_RESOURCES resources with LwM2M-like paths, "<object>/<instance>/
+ * <resource>", is built and requests for them are dispatched as a
+ * server does: the request is parsed, routed with coap_handle_request()
+ * and the handler looks up a couple of options.
+ *
+ * It reports the average time to handle a request for the first
+ * resource of the table, for the last one, and for each resource in
+ * turn.  With CONFIG_COAP_RESOURCE_TRIE, the resources are found with
+ * a trie built from the table.
+ */
+
+#define N_RUNS 100
+#define N_RESOURCES 100
+#define N_OPTIONS 16
+#define BUF_SIZE 128
+
+static char segments[N_RESOURCES][3][6];
+static const char *paths[N_RESOURCES][4];
+static struct coap_resource resources[N_RESOURCES + 1];
+
+#if defined(CONFIG_COAP_RESOURCE_TRIE)
+static struct coap_resource_trie trie;
+static struct coap_resource_trie_node trie_nodes[3 * N_RESOURCES + 1];
+#endif
+
+static uint8_t requests[N_RESOURCES][BUF_SIZE];
+static uint16_t request_lens[N_RESOURCES];
+
+static struct sockaddr_in6 peer = {
+	.sin6_family = AF_INET6,
+};
+
+static int handled;
+
+static int resource_get(struct coap_resource *resource,
+			struct coap_packet *request,
+			struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_option query;
+
+	(void)coap_get_option_int(request, COAP_OPTION_ACCEPT);
+	(void)coap_find_options(request, COAP_OPTION_URI_QUERY, &query, 1);
+
+	handled++;
+
+	return 0;
+}
+
+static void setup(void)
+{
+	struct coap_packet cpkt;
+	const char query[] = "ep=bench";
+
+	for (int i = 0; i < N_RESOURCES; i++) {
+		snprintf(segments[i][0], sizeof(segments[i][0]), "%d",
+			 3300 + i / 10);
+		snprintf(segments[i][1], sizeof(segments[i][1]), "%d", i % 10);
+		snprintf(segments[i][2], sizeof(segments[i][2]), "5700");
+
+		for (int j = 0; j < 3; j++) {
+			paths[i][j] = segments[i][j];
+		}
+		paths[i][3] = NULL;
+
+		resources[i].path = paths[i];
+		resources[i].get = resource_get;
+
+		coap_packet_init(&cpkt, requests[i], BUF_SIZE, COAP_VERSION_1,
+				 COAP_TYPE_CON, 8, coap_next_token(),
+				 COAP_METHOD_GET, coap_next_id());
+		coap_append_option_int(&cpkt, COAP_OPTION_OBSERVE, 0);
+		for (int j = 0; j < 3; j++) {
+			coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+						  paths[i][j],
+						  strlen(paths[i][j]));
+		}
+		coap_packet_append_option(&cpkt, COAP_OPTION_URI_QUERY,
+					  query, strlen(query));
+		coap_append_option_int(&cpkt, COAP_OPTION_ACCEPT,
+				       COAP_CONTENT_FORMAT_TEXT_PLAIN);
+
+		request_lens[i] = cpkt.offset;
+	}
+
+#if defined(CONFIG_COAP_RESOURCE_TRIE)
+	if (coap_resource_trie_init(&trie, resources, trie_nodes,
+				    ARRAY_SIZE(trie_nodes)) < 0) {
+		printk("Could not build the resource trie\n");
+	}
+#endif
+}
+
+static int handle(int i)
+{
+	struct coap_option options[N_OPTIONS];
+	struct coap_packet cpkt;
+	int ret;
+
+	ret = coap_packet_parse(&cpkt, requests[i], request_lens[i], options,
+				N_OPTIONS);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return coap_handle_request(&cpkt, resources, options, N_OPTIONS,
+				   (struct sockaddr *)&peer, sizeof(peer));
+}
+
+static void bench(const char *name, int first, int last)
+{
+	uint64_t cycles = 0U;
+	timing_t start, end;
+	int count = 0;
+
+	handled = 0;
+
+	for (int run = 0; run < N_RUNS; run++) {
+		for (int i = first; i <= last; i++) {
+			start = timing_counter_get();
+			if (handle(i) < 0) {
+				printk("%s: request %d failed\n", name, i);
+				return;
+			}
+			end = timing_counter_get();
+
+			cycles += timing_cycles_get(&start, &end);
+			count++;
+		}
+	}
+
+	if (handled != count) {
+		printk("%s: %d requests not handled\n", name, count - handled);
+		return;
+	}
+
+	printk("%-6s %8u ns\n", name,
+	       (uint32_t)timing_cycles_to_ns(cycles / count));
+}
+
+void main(void)
+{
+	setup();
+
+	timing_init();
+	timing_start();
+
+	bench("first", 0, 0);
+	bench("last", N_RESOURCES - 1, N_RESOURCES - 1);
+	bench("all", 0, N_RESOURCES - 1);
+
+	timing_stop();
+
+	printk("fin\n");
+}
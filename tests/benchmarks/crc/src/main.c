@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <sys/crc.h>
+#include <timing/timing.h>
+
+/* This is a CRC throughput benchmark.  Each CRC function of sys/crc.h
+ * which has a slice-by-N implementation is run repeatedly over buffers
+ * of a few sizes, with the implementation selected by Kconfig, and the
+ * average number of bytes processed per cycle is reported.  Comparing
+ * the output of the testcase.yaml scenarios gives the gain of the
+ * larger tables on a given CPU.
+ */
+
+#define N_RUNS 100
+#define MAX_LEN 4096
+
+static uint8_t buf[MAX_LEN];
+
+static const size_t lens[] = { 16, 64, 256, MAX_LEN };
+
+/* The result is accumulated so that the calls cannot be optimized out */
+static volatile uint32_t sink;
+
+static uint32_t run_crc32_ieee(const uint8_t *data, size_t len)
+{
+	return crc32_ieee(data, len);
+}
+
+static uint32_t run_crc32_c(const uint8_t *data, size_t len)
+{
+	return crc32_c(0, data, len, true, true);
+}
+
+static uint32_t run_crc16_ccitt(const uint8_t *data, size_t len)
+{
+	return crc16_ccitt(0xffff, data, len);
+}
+
+static uint32_t run_crc16_itu_t(const uint8_t *data, size_t len)
+{
+	return crc16_itu_t(0, data, len);
+}
+
+static void bench(const char *name,
+		  uint32_t (*run)(const uint8_t *data, size_t len))
+{
+	for (int i = 0; i < ARRAY_SIZE(lens); i++) {
+		uint64_t cycles = 0U;
+		uint64_t rate;
+		timing_t start, end;
+
+		for (int j = 0; j < N_RUNS; j++) {
+			start = timing_counter_get();
+			sink += run(buf, lens[i]);
+			end = timing_counter_get();
+
+			cycles += timing_cycles_get(&start, &end);
+		}
+
+		cycles /= N_RUNS;
+		/* Hundredths of bytes per cycle */
+		rate = (cycles != 0U) ? (lens[i] * 100U) / cycles : 0U;
+
+		printk("%-12s %5zu bytes %8u cycles %3u.%02u bytes/cycle\n",
+		       name, lens[i], (uint32_t)cycles, (uint32_t)(rate / 100U),
+		       (uint32_t)(rate % 100U));
+	}
+}
+
+void main(void)
+{
+	for (size_t i = 0; i < sizeof(buf); i++) {
+		buf[i] = (uint8_t)(i * 31U + 7U);
+	}
+
+	timing_init();
+	timing_start();
+
+	bench("crc32_ieee", run_crc32_ieee);
+	bench("crc32_c", run_crc32_c);
+	bench("crc16_ccitt", run_crc16_ccitt);
+	bench("crc16_itu_t", run_crc16_itu_t);
+
+	timing_stop();
+
+	printk("fin\n");
+}
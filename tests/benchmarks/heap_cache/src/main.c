@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+/* This is a k_malloc()/k_free() microbenchmark.  A number of threads,
+ * one per CPU at least, run concurrently and each repeatedly allocates
+ * a few small blocks of pseudo-random sizes from the system heap and
+ * frees them again, which is the pattern a per-CPU block cache is
+ * meant for.  Every allocation and free is timestamped, and the
+ * average cost in cycles of each is reported once all threads are
+ * done, along with the cache statistics when CONFIG_HEAP_CACHE=y.
+ */
+
+#define N_THREADS MAX(2, CONFIG_MP_NUM_CPUS)
+#define N_ROUNDS 1000
+#define N_BLOCKS 4
+/* Fits the default cache size classes along with the k_malloc() header */
+#define MAX_BLOCK 48
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, N_THREADS, STACK_SIZE);
+static struct k_thread threads[N_THREADS];
+
+struct bench_result {
+	uint64_t alloc_cycles;
+	uint64_t free_cycles;
+	uint32_t ops;
+	uint32_t failed;
+};
+
+static struct bench_result results[N_THREADS];
+
+extern struct k_heap _system_heap;
+
+static void bench_fn(void *p1, void *p2, void *p3)
+{
+	struct bench_result *res = p1;
+	uint32_t rand_state = POINTER_TO_UINT(p2);
+	void *blocks[N_BLOCKS];
+	uint32_t t0, t1;
+
+	ARG_UNUSED(p3);
+
+	for (int round = 0; round < N_ROUNDS; round++) {
+		for (int i = 0; i < N_BLOCKS; i++) {
+			size_t bytes;
+
+			/* Numerical Recipes LCG */
+			rand_state = rand_state * 1664525U + 1013904223U;
+			bytes = 1 + (rand_state >> 8) % MAX_BLOCK;
+
+			t0 = k_cycle_get_32();
+			blocks[i] = k_malloc(bytes);
+			t1 = k_cycle_get_32();
+
+			res->alloc_cycles += t1 - t0;
+			if (blocks[i] == NULL) {
+				res->failed++;
+			}
+		}
+
+		for (int i = 0; i < N_BLOCKS; i++) {
+			t0 = k_cycle_get_32();
+			k_free(blocks[i]);
+			t1 = k_cycle_get_32();
+
+			res->free_cycles += t1 - t0;
+		}
+
+		res->ops += N_BLOCKS;
+
+		/* Let the other threads interleave on single CPU targets */
+		if ((round % 16) == 0) {
+			k_yield();
+		}
+	}
+}
+
+void main(void)
+{
+	struct bench_result tot = { 0 };
+
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, bench_fn,
+				&results[i], UINT_TO_POINTER(0x1234U + i), NULL,
+				K_PRIO_PREEMPT(1), 0, K_NO_WAIT);
+	}
+
+	for (int i = 0; i < N_THREADS; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+
+		tot.alloc_cycles += results[i].alloc_cycles;
+		tot.free_cycles += results[i].free_cycles;
+		tot.ops += results[i].ops;
+		tot.failed += results[i].failed;
+	}
+
+	printk("threads %d ops %u alloc avg %u free avg %u failed %u\n",
+	       N_THREADS, tot.ops, (uint32_t)(tot.alloc_cycles / tot.ops),
+	       (uint32_t)(tot.free_cycles / tot.ops), tot.failed);
+
+#ifdef CONFIG_HEAP_CACHE
+	struct k_heap_cache_stats stats;
+
+	k_heap_cache_stats_get(&_system_heap, &stats);
+	printk("cache hits %u misses %u cached %u\n",
+	       stats.hits, stats.misses, stats.cached);
+#endif
+
+	printk("fin\n");
+}
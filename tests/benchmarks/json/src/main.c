@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <string.h>
+#include <data/json.h>
+#include <timing/timing.h>
+
+/* This is a JSON decoding benchmark.  The same payload, an object
+ * holding a few fields and an array of objects, is decoded repeatedly:
+ *
+ * 1. With json_obj_parse(), from a fresh copy of the payload since it
+ *    is modified in place (the copy is not timed)
+ * 2. With the streaming parser, fed the whole payload at once
+ * 3. With the streaming parser, fed chunks of 64 bytes, as received
+ *    from a socket
+ * 4. With the streaming parser, fed one byte at a time
+ *
+ * It reports the average time to decode the payload and the resulting
+ * throughput of each.
+ */
+
+#define N_RUNS 200
+#define N_SENSORS 16
+
+struct sensor {
+	const char *name;
+	int value;
+	const char *unit;
+};
+
+struct report {
+	const char *device;
+	int sequence;
+	bool alarm;
+	struct sensor sensors[N_SENSORS];
+	size_t sensors_len;
+};
+
+static const struct json_obj_descr sensor_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct sensor, name, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct sensor, value, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct sensor, unit, JSON_TOK_STRING),
+};
+
+static const struct json_obj_descr report_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct report, device, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct report, sequence, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct report, alarm, JSON_TOK_TRUE),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct report, sensors, N_SENSORS,
+				 sensors_len, sensor_descr,
+				 ARRAY_SIZE(sensor_descr)),
+};
+
+static char payload[2048];
+static size_t payload_len;
+static char copy[sizeof(payload)];
+static char str_buf[512];
+static struct report report;
+
+static void payload_build(void)
+{
+	static char names[N_SENSORS][16];
+	struct report r = {
+		.device = "urn:dev:mac:0024befffe804ff1",
+		.sequence = 123456,
+		.alarm = false,
+		.sensors_len = N_SENSORS,
+	};
+
+	for (int i = 0; i < N_SENSORS; i++) {
+		snprintk(names[i], sizeof(names[i]), "temperature/%d", i);
+		r.sensors[i].name = names[i];
+		r.sensors[i].value = -40 + 7 * i;
+		r.sensors[i].unit = "Cel";
+	}
+
+	json_obj_encode_buf(report_descr, ARRAY_SIZE(report_descr), &r,
+			    payload, sizeof(payload));
+	payload_len = strlen(payload);
+}
+
+static int lexer_parse(size_t chunk_len)
+{
+	ARG_UNUSED(chunk_len);
+
+	return json_obj_parse(copy, payload_len, report_descr,
+			      ARRAY_SIZE(report_descr), &report);
+}
+
+static int stream_parse(size_t chunk_len)
+{
+	struct json_parser parser;
+	size_t n;
+	int ret = 0;
+
+	json_parser_init(&parser, report_descr, ARRAY_SIZE(report_descr),
+			 &report, str_buf, sizeof(str_buf));
+
+	for (size_t pos = 0; pos < payload_len && ret == 0; pos += n) {
+		n = MIN(chunk_len, payload_len - pos);
+		ret = json_parser_feed(&parser, payload + pos, n);
+	}
+
+	return json_parser_finish(&parser);
+}
+
+static void bench(const char *name, int (*parse)(size_t chunk_len),
+		  size_t chunk_len)
+{
+	uint64_t cycles = 0U;
+	uint64_t ns, rate;
+	timing_t start, end;
+	int ret;
+
+	for (int i = 0; i < N_RUNS; i++) {
+		memcpy(copy, payload, payload_len);
+
+		start = timing_counter_get();
+		ret = parse(chunk_len);
+		end = timing_counter_get();
+
+		if (ret != BIT_MASK(ARRAY_SIZE(report_descr)) ||
+		    report.sensors_len != N_SENSORS) {
+			printk("%s: decoding failed (%d)\n", name, ret);
+			return;
+		}
+
+		cycles += timing_cycles_get(&start, &end);
+	}
+
+	ns = timing_cycles_to_ns(cycles / N_RUNS);
+	/* Tenths of MB/s */
+	rate = (ns != 0U) ? (payload_len * 10000U) / ns : 0U;
+
+	printk("%-10s %5zu bytes %8u ns %4u.%u MB/s\n", name, payload_len,
+	       (uint32_t)ns, (uint32_t)(rate / 10U), (uint32_t)(rate % 10U));
+}
+
+void main(void)
+{
+	payload_build();
+
+	timing_init();
+	timing_start();
+
+	bench("lexer", lexer_parse, 0);
+	bench("stream", stream_parse, SIZE_MAX);
+	bench("stream 64", stream_parse, 64);
+	bench("stream 1", stream_parse, 1);
+
+	timing_stop();
+
+	printk("fin\n");
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <logging/log.h>
+#include <logging/log_backend.h>
+#include <logging/log_ctrl.h>
+
+/* Cost of creating a log message with 0 to 6 arguments.  Each case logs a
+ * burst of messages and reports the average number of cycles per LOG_INF.
+ * Integer arguments and string literals are packaged at compile time, while
+ * strings in RW memory require the format string to be walked at runtime.
+ * Build with CONFIG_LOG2_ALWAYS_RUNTIME=y to package every message at
+ * runtime for comparison.
+ */
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define MSG_CNT 32
+
+static uint32_t processed;
+static uint32_t dropped_cnt;
+
+static void process(const struct log_backend *const backend,
+		    union log_msg2_generic *msg)
+{
+	processed++;
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	dropped_cnt += cnt;
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.process = process,
+	.dropped = dropped,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, true);
+
+static void report(const char *name, int nargs, bool runtime, uint32_t cycles)
+{
+	processed = 0;
+	while (log_process(false)) {
+	}
+
+	dropped_cnt += MSG_CNT - processed;
+
+	printk("%-8s args %d %-7s cycles/msg %6u\n", name, nargs,
+	       runtime ? "runtime" : "static", cycles / MSG_CNT);
+}
+
+#define MEASURE(name, ...) do { \
+	bool _runtime = IS_ENABLED(CONFIG_LOG2_ALWAYS_RUNTIME) || \
+		CBPRINTF_MUST_RUNTIME_PACKAGE(0, __VA_ARGS__); \
+	uint32_t _t0 = k_cycle_get_32(); \
+	\
+	for (int _i = 0; _i < MSG_CNT; _i++) { \
+		LOG_INF(__VA_ARGS__); \
+	} \
+	\
+	report(name, NUM_VA_ARGS_LESS_1(__VA_ARGS__), _runtime, \
+	       k_cycle_get_32() - _t0); \
+} while (0)
+
+static void int_args(void)
+{
+	int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6;
+
+	MEASURE("int", "no arguments");
+	MEASURE("int", "%d", a);
+	MEASURE("int", "%d %d", a, b);
+	MEASURE("int", "%d %d %d", a, b, c);
+	MEASURE("int", "%d %d %d %d", a, b, c, d);
+	MEASURE("int", "%d %d %d %d %d", a, b, c, d, e);
+	MEASURE("int", "%d %d %d %d %d %d", a, b, c, d, e, f);
+}
+
+static void literal_args(void)
+{
+	MEASURE("literal", "%s", "a");
+	MEASURE("literal", "%s %s", "a", "b");
+	MEASURE("literal", "%s %s %s", "a", "b", "c");
+	MEASURE("literal", "%s %s %s %s", "a", "b", "c", "d");
+	MEASURE("literal", "%s %s %s %s %s", "a", "b", "c", "d", "e");
+	MEASURE("literal", "%s %s %s %s %s %s", "a", "b", "c", "d", "e", "f");
+}
+
+static void rw_str_args(void)
+{
+	char s[] = "rw";
+
+	MEASURE("rw str", "%s", s);
+	MEASURE("rw str", "%s %s", s, s);
+	MEASURE("rw str", "%s %s %s", s, s, s);
+	MEASURE("rw str", "%s %s %s %s", s, s, s, s);
+	MEASURE("rw str", "%s %s %s %s %s", s, s, s, s, s);
+	MEASURE("rw str", "%s %s %s %s %s %s", s, s, s, s, s, s);
+}
+
+void main(void)
+{
+	printk("LOG_INF cost, %d messages per run\n", MSG_CNT);
+
+	int_args();
+	literal_args();
+	rw_str_args();
+
+	printk("dropped %u\n", dropped_cnt);
+	printk("fin\n");
+}
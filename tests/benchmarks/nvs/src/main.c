@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+
+/* NVS read latency benchmark. A set of ids is written once, then a single
+ * "hot" id is rewritten many times so that the ids written first end up far
+ * away from the current write position. Every id is then read back and the
+ * average and worst case nvs_read() latency is reported.
+ *
+ * Without CONFIG_NVS_LOOKUP_CACHE the read latency grows with the number of
+ * ate's written since the id was last updated; with the cache it should stay
+ * flat. Build with and without the option to compare both.
+ */
+
+#define SECTOR_COUNT 8
+#define N_IDS 64
+#define N_REWRITES_MAX 2048
+#define N_ROUNDS 4
+#define HOT_ID (N_IDS + 1)
+
+static struct nvs_fs fs;
+
+static uint32_t read_cycles(uint16_t id)
+{
+	uint32_t val, start, end;
+	ssize_t len;
+
+	start = k_cycle_get_32();
+	len = nvs_read(&fs, id, &val, sizeof(val));
+	end = k_cycle_get_32();
+
+	if (len != sizeof(val) || val != id) {
+		printk("read of id %u failed: %d\n", id, (int)len);
+	}
+
+	return end - start;
+}
+
+static void run(uint16_t rewrites)
+{
+	uint32_t val, cycles, total = 0U, max = 0U;
+	ssize_t len;
+	int rc;
+
+	rc = nvs_clear(&fs);
+	if (rc == 0) {
+		rc = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	}
+	if (rc) {
+		printk("nvs reinit failed: %d\n", rc);
+		return;
+	}
+
+	for (val = 0U; val < N_IDS; val++) {
+		len = nvs_write(&fs, val, &val, sizeof(val));
+		if (len != sizeof(val)) {
+			printk("write of id %u failed: %d\n", val, (int)len);
+			return;
+		}
+	}
+
+	for (val = 0U; val < rewrites; val++) {
+		len = nvs_write(&fs, HOT_ID, &val, sizeof(val));
+		if (len != sizeof(val)) {
+			printk("rewrite %u failed: %d\n", val, (int)len);
+			return;
+		}
+	}
+
+	for (int round = 0; round < N_ROUNDS; round++) {
+		for (uint16_t id = 0U; id < N_IDS; id++) {
+			cycles = read_cycles(id);
+			total += cycles;
+			max = MAX(max, cycles);
+		}
+	}
+
+	printk("ids %u rewrites %u read avg %u ns max %u ns\n", N_IDS,
+	       rewrites,
+	       (uint32_t)k_cyc_to_ns_floor64(total / (N_IDS * N_ROUNDS)),
+	       (uint32_t)k_cyc_to_ns_floor64(max));
+}
+
+void main(void)
+{
+	const struct flash_area *fa;
+	struct flash_pages_info info;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (rc) {
+		printk("flash_area_open failed: %d\n", rc);
+		return;
+	}
+
+	fs.offset = FLASH_AREA_OFFSET(storage);
+	rc = flash_get_page_info_by_offs(flash_area_get_device(fa), fs.offset,
+					 &info);
+	if (rc) {
+		printk("unable to get page info: %d\n", rc);
+		return;
+	}
+
+	fs.sector_size = info.size;
+	fs.sector_count = SECTOR_COUNT;
+
+	rc = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	if (rc) {
+		printk("nvs_init failed: %d\n", rc);
+		return;
+	}
+
+	printk("NVS read benchmark, lookup cache %s\n",
+	       IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE) ? "enabled" : "disabled");
+
+	for (uint16_t rewrites = 0U; rewrites <= N_REWRITES_MAX;
+	     rewrites = rewrites ? rewrites * 4U : 32U) {
+		run(rewrites);
+	}
+
+	printk("fin\n");
+}
@@ -27,11 +27,21 @@
  * It then iterates this many times, reporting timestamp latencies
  * between each numbered step and for the whole cycle, and a running
  * average for all cycles run.
+ *
+ * With CONFIG_SCHED_CPU_MASK on SMP, the run queue is loaded first with
+ * threads pinned to CPU 1, which is kept busy by a cooperative thread
+ * pinned there too.  They stay runnable, at a higher priority than the
+ * partner, for the whole run, and measure how much the threads pinned
+ * to other CPUs cost the scheduler of CPU 0.
  */
 
 #define N_RUNS 1000
 #define N_SETTLE 10
 
+#if defined(CONFIG_SCHED_CPU_MASK) && (CONFIG_MP_NUM_CPUS > 1)
+#define N_PINNED 16
+#define PINNED_STACK_SIZE 512
+#endif
 
 static K_THREAD_STACK_DEFINE(partner_stack, 1024);
 static struct k_thread partner_thread;
@@ -86,6 +96,65 @@ static void partner_fn(void *arg1, void *arg2, void *arg3)
 	}
 }
 
+#ifdef N_PINNED
+static K_THREAD_STACK_DEFINE(hog_stack, PINNED_STACK_SIZE);
+static struct k_thread hog_thread;
+static K_THREAD_STACK_ARRAY_DEFINE(pinned_stacks, N_PINNED, PINNED_STACK_SIZE);
+static struct k_thread pinned_threads[N_PINNED];
+
+static volatile bool hog_running;
+static volatile bool hog_stop;
+
+static void hog_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+
+	hog_running = true;
+	while (!hog_stop) {
+	}
+}
+
+static void pinned_fn(void *arg1, void *arg2, void *arg3)
+{
+	ARG_UNUSED(arg1);
+	ARG_UNUSED(arg2);
+	ARG_UNUSED(arg3);
+}
+
+static void pinned_thread_start(struct k_thread *thread,
+				k_thread_stack_t *stack,
+				k_thread_entry_t fn, int prio)
+{
+	k_thread_create(thread, stack, PINNED_STACK_SIZE, fn, NULL, NULL, NULL,
+			prio, 0, K_FOREVER);
+	k_thread_cpu_mask_clear(thread);
+	k_thread_cpu_mask_enable(thread, 1);
+	k_thread_start(thread);
+}
+
+static void pinned_load_start(int prio)
+{
+	pinned_thread_start(&hog_thread, hog_stack, hog_fn,
+			    K_HIGHEST_APPLICATION_THREAD_PRIO);
+	while (!hog_running) {
+	}
+
+	for (int i = 0; i < N_PINNED; i++) {
+		pinned_thread_start(&pinned_threads[i], pinned_stacks[i],
+				    pinned_fn, prio);
+	}
+
+	printk("%d threads pinned to CPU 1\n", N_PINNED);
+}
+
+static void pinned_load_stop(void)
+{
+	hog_stop = true;
+}
+#endif
+
 void main(void)
 {
 	z_waitq_init(&waitq);
@@ -93,6 +162,10 @@ void main(void)
 	int main_prio = k_thread_priority_get(k_current_get());
 	int partner_prio = main_prio - 1;
 
+#ifdef N_PINNED
+	pinned_load_start(partner_prio - 1);
+#endif
+
 	k_tid_t th = k_thread_create(&partner_thread, partner_stack,
 				     K_THREAD_STACK_SIZEOF(partner_stack),
 				     partner_fn, NULL, NULL, NULL,
@@ -148,5 +221,8 @@ void main(void)
 		       stamps[4] - stamps[3],
 		       whole, avg);
 	}
+#ifdef N_PINNED
+	pinned_load_stop();
+#endif
 	printk("fin\n");
 }
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* UDP throughput over the loopback interface.  Bursts of datagrams are
+ * sent and then received either one datagram per call with
+ * sendto()/recvfrom(), or one burst per call with sendmmsg()/recvmmsg().
+ * The send and receive calls are timed separately and the average cost
+ * in cycles per datagram is reported for each API.  The network stack
+ * is given time to deliver each burst before it is received, so the
+ * receive side measures draining an already filled socket queue.
+ */
+
+#define BATCH 16
+#define ROUNDS 50
+#define DGRAM_SIZE 64
+#define SERVER_PORT 4242
+#define MY_IPV4_ADDR "192.0.2.1"
+
+struct bench_result {
+	uint64_t cycles;
+	uint32_t datagrams;
+};
+
+static uint8_t tx_data[BATCH][DGRAM_SIZE];
+static uint8_t rx_data[BATCH][DGRAM_SIZE];
+static struct iovec tx_iov[BATCH];
+static struct iovec rx_iov[BATCH];
+static struct mmsghdr tx_msgs[BATCH];
+static struct mmsghdr rx_msgs[BATCH];
+static struct sockaddr_in rx_addr[BATCH];
+
+static struct sockaddr_in server_addr;
+static uint32_t lost;
+
+static int send_single(int sock, struct bench_result *res)
+{
+	uint32_t t0, t1;
+	int sent = 0;
+
+	for (int i = 0; i < BATCH; i++) {
+		t0 = k_cycle_get_32();
+		if (sendto(sock, tx_data[i], DGRAM_SIZE, 0,
+			   (struct sockaddr *)&server_addr,
+			   sizeof(server_addr)) == DGRAM_SIZE) {
+			sent++;
+		}
+		t1 = k_cycle_get_32();
+
+		res->cycles += t1 - t0;
+	}
+
+	res->datagrams += sent;
+
+	return sent;
+}
+
+static int send_batch(int sock, struct bench_result *res)
+{
+	uint32_t t0, t1;
+	int sent;
+
+	t0 = k_cycle_get_32();
+	sent = sendmmsg(sock, tx_msgs, BATCH, 0);
+	t1 = k_cycle_get_32();
+
+	res->cycles += t1 - t0;
+
+	if (sent < 0) {
+		return 0;
+	}
+
+	res->datagrams += sent;
+
+	return sent;
+}
+
+static int recv_single(int sock, struct bench_result *res)
+{
+	uint32_t t0, t1;
+	int received = 0;
+	ssize_t ret;
+
+	for (int i = 0; i < BATCH; i++) {
+		t0 = k_cycle_get_32();
+		ret = recvfrom(sock, rx_data[i], DGRAM_SIZE, MSG_DONTWAIT,
+			       NULL, NULL);
+		t1 = k_cycle_get_32();
+
+		if (ret < 0) {
+			break;
+		}
+
+		res->cycles += t1 - t0;
+		received++;
+	}
+
+	res->datagrams += received;
+
+	return received;
+}
+
+static int recv_batch(int sock, struct bench_result *res)
+{
+	uint32_t t0, t1;
+	int received = 0;
+	int ret;
+
+	while (received < BATCH) {
+		for (int i = received; i < BATCH; i++) {
+			rx_msgs[i].msg_hdr.msg_namelen = sizeof(rx_addr[i]);
+		}
+
+		t0 = k_cycle_get_32();
+		ret = recvmmsg(sock, &rx_msgs[received], BATCH - received,
+			       MSG_DONTWAIT, NULL);
+		t1 = k_cycle_get_32();
+
+		if (ret <= 0) {
+			break;
+		}
+
+		res->cycles += t1 - t0;
+		received += ret;
+	}
+
+	res->datagrams += received;
+
+	return received;
+}
+
+static void print_result(const char *name, struct bench_result *res)
+{
+	printk("%-9s datagrams %6u cycles/datagram %6u\n", name,
+	       res->datagrams,
+	       res->datagrams ? (uint32_t)(res->cycles / res->datagrams) : 0);
+}
+
+static void run(const char *send_name, const char *recv_name,
+		int client, int server, bool batch)
+{
+	struct bench_result send_res = { 0 };
+	struct bench_result recv_res = { 0 };
+	int sent, received;
+
+	for (int round = 0; round < ROUNDS; round++) {
+		sent = batch ? send_batch(client, &send_res) :
+			       send_single(client, &send_res);
+
+		/* Let the loopback interface deliver the whole burst */
+		k_msleep(10);
+
+		received = batch ? recv_batch(server, &recv_res) :
+				   recv_single(server, &recv_res);
+
+		lost += sent - received;
+	}
+
+	print_result(send_name, &send_res);
+	print_result(recv_name, &recv_res);
+}
+
+void main(void)
+{
+	struct sockaddr_in client_addr = {
+		.sin_family = AF_INET,
+	};
+	int client, server;
+
+	server_addr.sin_family = AF_INET;
+	server_addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, MY_IPV4_ADDR, &server_addr.sin_addr);
+	inet_pton(AF_INET, MY_IPV4_ADDR, &client_addr.sin_addr);
+
+	for (int i = 0; i < BATCH; i++) {
+		memset(tx_data[i], i, DGRAM_SIZE);
+
+		tx_iov[i].iov_base = tx_data[i];
+		tx_iov[i].iov_len = DGRAM_SIZE;
+		tx_msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		tx_msgs[i].msg_hdr.msg_iovlen = 1;
+		tx_msgs[i].msg_hdr.msg_name = &server_addr;
+		tx_msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+
+		rx_iov[i].iov_base = rx_data[i];
+		rx_iov[i].iov_len = DGRAM_SIZE;
+		rx_msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		rx_msgs[i].msg_hdr.msg_iovlen = 1;
+		rx_msgs[i].msg_hdr.msg_name = &rx_addr[i];
+	}
+
+	server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (server < 0 || client < 0) {
+		printk("Cannot create sockets (%d)\n", errno);
+		return;
+	}
+
+	if (bind(server, (struct sockaddr *)&server_addr,
+		 sizeof(server_addr)) < 0 ||
+	    bind(client, (struct sockaddr *)&client_addr,
+		 sizeof(client_addr)) < 0) {
+		printk("Cannot bind sockets (%d)\n", errno);
+		return;
+	}
+
+	printk("UDP loopback, %d bursts of %d datagrams of %d bytes\n",
+	       ROUNDS, BATCH, DGRAM_SIZE);
+
+	run("sendto", "recvfrom", client, server, false);
+	run("sendmmsg", "recvmmsg", client, server, true);
+
+	printk("lost %u\n", lost);
+
+	close(client);
+	close(server);
+
+	printk("fin\n");
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <net/socket.h>
+
+/* TCP throughput over the loopback interface.  The same amount of data is
+ * sent over one connection in a few ways: with large writes, and with
+ * small writes using Nagle's algorithm (the default), TCP_NODELAY or
+ * TCP_CORK.  A receiver thread drains the connection, and the time from
+ * the first write until the receiver has got all the data is reported as
+ * the average cost in cycles per KiB.  Build with
+ * CONFIG_NET_TCP_TX_ZERO_COPY=n to compare against segments that copy the
+ * data from the send queue.
+ */
+
+#define TOTAL_LEN (32 * 1024)
+#define BULK_WRITE 1024
+#define SMALL_WRITE 64
+#define SERVER_PORT 4242
+#define MY_IPV4_ADDR "192.0.2.1"
+#define RECEIVER_STACK_SIZE 2048
+#define RECEIVER_PRIORITY K_PRIO_PREEMPT(1)
+#define RECEIVE_TIMEOUT K_SECONDS(10)
+
+enum mode {
+	MODE_DEFAULT,
+	MODE_NODELAY,
+	MODE_CORK,
+};
+
+K_THREAD_STACK_DEFINE(receiver_stack, RECEIVER_STACK_SIZE);
+static struct k_thread receiver_thread;
+static K_SEM_DEFINE(received_sem, 0, 1);
+
+static uint8_t tx_data[BULK_WRITE];
+static uint8_t rx_data[BULK_WRITE];
+
+static size_t expected;
+static size_t received;
+static uint32_t lost;
+
+static void receiver(void *p1, void *p2, void *p3)
+{
+	int sock = POINTER_TO_INT(p1);
+	ssize_t ret;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		ret = recv(sock, rx_data, sizeof(rx_data), 0);
+		if (ret <= 0) {
+			break;
+		}
+
+		received += ret;
+		if (received == expected) {
+			k_sem_give(&received_sem);
+		}
+	}
+}
+
+static int set_option(int sock, int option, int value)
+{
+	if (setsockopt(sock, IPPROTO_TCP, option, &value,
+		       sizeof(value)) < 0) {
+		printk("Cannot set TCP option %d (%d)\n", option, errno);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void run(const char *name, int sock, size_t write_len,
+		enum mode mode)
+{
+	uint32_t t0, t1;
+	size_t sent = 0;
+	ssize_t ret;
+
+	if ((mode == MODE_NODELAY && set_option(sock, TCP_NODELAY, 1) < 0) ||
+	    (mode == MODE_CORK && set_option(sock, TCP_CORK, 1) < 0)) {
+		return;
+	}
+
+	received = 0;
+	expected = TOTAL_LEN;
+	k_sem_reset(&received_sem);
+
+	t0 = k_cycle_get_32();
+
+	while (sent < TOTAL_LEN) {
+		ret = send(sock, tx_data, MIN(write_len, TOTAL_LEN - sent), 0);
+		if (ret < 0) {
+			printk("send failed (%d)\n", errno);
+			break;
+		}
+
+		sent += ret;
+	}
+
+	if (mode == MODE_CORK) {
+		(void)set_option(sock, TCP_CORK, 0);
+	}
+
+	if (k_sem_take(&received_sem, RECEIVE_TIMEOUT) < 0) {
+		lost += TOTAL_LEN - received;
+	}
+
+	t1 = k_cycle_get_32();
+
+	printk("%-8s write %5zu cycles/KiB %8u\n", name, write_len,
+	       (uint32_t)((uint64_t)(t1 - t0) * 1024 / TOTAL_LEN));
+
+	if (mode == MODE_NODELAY) {
+		(void)set_option(sock, TCP_NODELAY, 0);
+	}
+}
+
+void main(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+	};
+	int server, client, conn;
+
+	inet_pton(AF_INET, MY_IPV4_ADDR, &addr.sin_addr);
+
+	for (int i = 0; i < sizeof(tx_data); i++) {
+		tx_data[i] = i;
+	}
+
+	server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	client = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (server < 0 || client < 0) {
+		printk("Cannot create sockets (%d)\n", errno);
+		return;
+	}
+
+	if (bind(server, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(server, 1) < 0) {
+		printk("Cannot listen (%d)\n", errno);
+		return;
+	}
+
+	if (connect(client, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		printk("Cannot connect (%d)\n", errno);
+		return;
+	}
+
+	conn = accept(server, NULL, NULL);
+	if (conn < 0) {
+		printk("Cannot accept (%d)\n", errno);
+		return;
+	}
+
+	k_thread_create(&receiver_thread, receiver_stack,
+			K_THREAD_STACK_SIZEOF(receiver_stack), receiver,
+			INT_TO_POINTER(conn), NULL, NULL, RECEIVER_PRIORITY, 0,
+			K_NO_WAIT);
+
+	printk("TCP loopback, %d bytes per run\n", TOTAL_LEN);
+
+	run("bulk", client, BULK_WRITE, MODE_DEFAULT);
+	run("nagle", client, SMALL_WRITE, MODE_DEFAULT);
+	run("nodelay", client, SMALL_WRITE, MODE_NODELAY);
+	run("cork", client, SMALL_WRITE, MODE_CORK);
+
+	printk("lost %u\n", lost);
+
+	close(client);
+	k_thread_join(&receiver_thread, K_SECONDS(5));
+	close(conn);
+	close(server);
+
+	printk("fin\n");
+}
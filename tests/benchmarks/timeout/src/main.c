@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timeout_q.h>
+
+/* This is a timeout queue microbenchmark, measuring the cost of the
+ * kernel timeout primitives independent of the k_timer, k_work or
+ * scheduler APIs built on top of them.  For an increasing number of
+ * pending timeouts it:
+ *
+ * 1. Adds all timeouts with z_add_timeout(), at pseudo-random
+ *    absolute expiries spread over a few seconds
+ * 2. Aborts every other timeout with z_abort_timeout()
+ * 3. Sleeps until the remaining timeouts have expired, checking
+ *    that none of them fired before its expiry
+ * 4. Adds all timeouts again at the same expiry and measures the
+ *    time between the first and the last expiry callback
+ *
+ * It reports the average cost in cycles of a single add, abort and
+ * expiry.
+ */
+
+#define MAX_TIMEOUTS 1000
+#define SPREAD_TICKS k_ms_to_ticks_ceil64(2000)
+#define MARGIN_TICKS k_ms_to_ticks_ceil64(100)
+
+static const int n_timeouts[] = { 10, 100, 1000 };
+
+struct bench_timeout {
+	struct _timeout to;
+	k_ticks_t expiry;
+};
+
+static struct bench_timeout timeouts[MAX_TIMEOUTS];
+
+static uint32_t n_expired;
+static uint32_t n_early;
+static uint32_t first_stamp, last_stamp;
+
+static uint32_t rand_state = 0x12345678U;
+
+static inline uint32_t bench_rand(void)
+{
+	/* Numerical Recipes LCG, good enough to scatter expiries */
+	rand_state = rand_state * 1664525U + 1013904223U;
+	return rand_state >> 8;
+}
+
+static inline uint32_t stamp(void)
+{
+	uint32_t t;
+
+	/* See tests/benchmarks/sched for why rdtsc is used on x86 */
+#ifdef CONFIG_X86
+	__asm__ volatile("rdtsc" : "=a"(t) : : "edx");
+#else
+	t = k_cycle_get_32();
+#endif
+
+	return t;
+}
+
+static void expiry_fn(struct _timeout *to)
+{
+	struct bench_timeout *t = CONTAINER_OF(to, struct bench_timeout, to);
+
+	last_stamp = stamp();
+	if (n_expired++ == 0U) {
+		first_stamp = last_stamp;
+	}
+
+	if (k_uptime_ticks() < t->expiry) {
+		n_early++;
+	}
+}
+
+static void run(int n)
+{
+	k_ticks_t now = k_uptime_ticks() + MARGIN_TICKS;
+	uint32_t start, add, abort, expire;
+	int i;
+
+	n_expired = 0U;
+	n_early = 0U;
+
+	for (i = 0; i < n; i++) {
+		timeouts[i].expiry = now + bench_rand() % SPREAD_TICKS;
+	}
+
+	start = stamp();
+	for (i = 0; i < n; i++) {
+		z_add_timeout(&timeouts[i].to, expiry_fn,
+			      K_TIMEOUT_ABS_TICKS(timeouts[i].expiry));
+	}
+	add = stamp() - start;
+
+	start = stamp();
+	for (i = 0; i < n; i += 2) {
+		z_abort_timeout(&timeouts[i].to);
+	}
+	abort = stamp() - start;
+
+	k_sleep(K_TIMEOUT_ABS_TICKS(now + SPREAD_TICKS + MARGIN_TICKS));
+
+	if (n_expired != n / 2) {
+		printk("expired %u of %d timeouts\n", n_expired, n / 2);
+		n_early++;
+	}
+
+	/* All timeouts expiring on the same tick */
+	n_expired = 0U;
+	now = k_uptime_ticks() + SPREAD_TICKS;
+	for (i = 0; i < n; i++) {
+		timeouts[i].expiry = now;
+		z_add_timeout(&timeouts[i].to, expiry_fn,
+			      K_TIMEOUT_ABS_TICKS(now));
+	}
+
+	k_sleep(K_TIMEOUT_ABS_TICKS(now + MARGIN_TICKS));
+	expire = last_stamp - first_stamp;
+
+	/* For reference, on qemu_x86 with -icount shift=0,sleep=off,
+	 * align=off the cost of a single add grows linearly with the
+	 * number of pending timeouts with TIMEOUT_QUEUE_DUMB, and stays
+	 * constant with TIMEOUT_QUEUE_WHEEL.
+	 */
+	printk("timeouts %4d add %6u abort %6u expire %6u early %u\n",
+	       n, add / n, abort / (n - n / 2), expire / (n - 1), n_early);
+}
+
+void main(void)
+{
+	for (int i = 0; i < ARRAY_SIZE(n_timeouts); i++) {
+		run(n_timeouts[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <tracing/tracing_format.h>
+#include <tracing/tracing_filter.h>
+
+/* Cost of a traced event.  Events are generated in bursts small enough to
+ * fit in the tracing buffer and the tracing thread is given time to drain
+ * the buffer between bursts, so the reported cost does not include dropped
+ * events.  "raw event" is the cost of putting a CTF sized packet into the
+ * buffer, "sem give/take" is the cost of a kernel operation which emits
+ * four events.  Build with CONFIG_TRACING_PER_CPU_BUFFER=y to compare the
+ * shared ring buffer with the per-CPU buffers.  With
+ * CONFIG_TRACING_RUNTIME_FILTER=y, the kernel operation is also measured
+ * with its event class disabled at runtime and with the class restricted
+ * to another object.
+ */
+
+#define BURST 16
+#define RUNS 32
+#define DRAIN_TIME K_MSEC(5)
+
+static K_SEM_DEFINE(sem, 0, 1);
+static K_SEM_DEFINE(other_sem, 0, 1);
+
+static void report(const char *name, const char *unit, uint64_t cycles)
+{
+	printk("%-14s %-11s %6u\n", name, unit,
+	       (uint32_t)(cycles / (BURST * RUNS)));
+}
+
+static void raw_event(void)
+{
+	uint8_t packet[29] = { 0 };
+	uint64_t cycles = 0;
+	uint32_t t0;
+
+	for (int i = 0; i < RUNS; i++) {
+		t0 = k_cycle_get_32();
+		for (int j = 0; j < BURST; j++) {
+			tracing_format_raw_data(packet, sizeof(packet));
+		}
+		cycles += k_cycle_get_32() - t0;
+		k_sleep(DRAIN_TIME);
+	}
+
+	report("raw event", "cycles/event", cycles);
+}
+
+static void sem_give_take(const char *name)
+{
+	uint64_t cycles = 0;
+	uint32_t t0;
+
+	for (int i = 0; i < RUNS; i++) {
+		t0 = k_cycle_get_32();
+		for (int j = 0; j < BURST / 4; j++) {
+			k_sem_give(&sem);
+			(void)k_sem_take(&sem, K_NO_WAIT);
+		}
+		cycles += k_cycle_get_32() - t0;
+		k_sleep(DRAIN_TIME);
+	}
+
+	report(name, "cycles/op", cycles * 4);
+}
+
+#ifdef CONFIG_TRACING_RUNTIME_FILTER
+static void sem_give_take_filtered(void)
+{
+	tracing_class_set(TRACING_CLASS_SEMAPHORE, false);
+	sem_give_take("sem disabled");
+	tracing_class_set(TRACING_CLASS_SEMAPHORE, true);
+
+	(void)tracing_object_select(&other_sem);
+	tracing_object_filter_set(TRACING_CLASS_SEMAPHORE, true);
+	sem_give_take("sem filtered");
+	tracing_object_filter_set(TRACING_CLASS_SEMAPHORE, false);
+	(void)tracing_object_deselect(&other_sem);
+}
+#endif
+
+void main(void)
+{
+	printk("Tracing cost, %s buffer\n",
+	       IS_ENABLED(CONFIG_TRACING_PER_CPU_BUFFER) ? "per-CPU" :
+							   "shared");
+
+	raw_event();
+	sem_give_take("sem give/take");
+#ifdef CONFIG_TRACING_RUNTIME_FILTER
+	sem_give_take_filtered();
+#endif
+
+	printk("fin\n");
+}
@@ -190,3 +190,172 @@ void test_k_heap_alloc_pending(void)
 
 	k_thread_join(tid, K_FOREVER);
 }
+
+#ifdef CONFIG_HEAP_CACHE
+#define CACHE_BLOCKS (HEAP_SIZE / 16)
+
+static void *cache_blocks[CACHE_BLOCKS];
+
+static int cache_fill(size_t bytes)
+{
+	int n = 0;
+
+	while (n < CACHE_BLOCKS) {
+		cache_blocks[n] = k_heap_alloc(&k_heap_test, bytes, K_NO_WAIT);
+		if (cache_blocks[n] == NULL) {
+			break;
+		}
+		n++;
+	}
+
+	return n;
+}
+
+static void cache_release(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_heap_free(&k_heap_test, cache_blocks[i]);
+	}
+}
+#endif
+
+/**
+ * @brief Validate the per-CPU k_heap block cache
+ *
+ * @details Free a small block and check that the next allocation of
+ * the same size class returns it from the cache.  Then fill the heap
+ * with blocks of one size class, and check that the blocks cached once
+ * they are freed are given back to the heap when allocations of
+ * another size class run out of memory.
+ *
+ * @ingroup kernel_heap_tests
+ */
+void test_k_heap_cache(void)
+{
+#ifdef CONFIG_HEAP_CACHE
+	struct k_heap_cache_stats stats;
+	uint32_t hits;
+	char *p, *q;
+	int n;
+
+	p = k_heap_alloc(&k_heap_test, 24, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+	k_heap_free(&k_heap_test, p);
+
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.cached, 1, "freed block not cached");
+	hits = stats.hits;
+
+	q = k_heap_alloc(&k_heap_test, 17, K_NO_WAIT);
+	zassert_equal_ptr(p, q, "cached block not reused");
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.hits, hits + 1, "cache hit not accounted");
+	zassert_equal(stats.cached, 0, "cached block not taken");
+	k_heap_free(&k_heap_test, q);
+
+	n = cache_fill(32);
+	zassert_true(n > CONFIG_HEAP_CACHE_DEPTH, "heap too small");
+	cache_release(n);
+
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.cached, CONFIG_HEAP_CACHE_DEPTH,
+		      "unexpected number of cached blocks");
+
+	n = cache_fill(64);
+	zassert_true(n > 0, "k_heap_alloc operation failed");
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.cached, 0, "cache not flushed");
+	cache_release(n);
+
+	/* Large blocks can still be allocated */
+	p = k_heap_alloc(&k_heap_test, ALLOC_SIZE_2, K_NO_WAIT);
+	zassert_not_null(p, "k_heap_alloc operation failed");
+	k_heap_free(&k_heap_test, p);
+#else
+	ztest_test_skip();
+#endif
+}
+
+#if defined(CONFIG_HEAP_CACHE) && defined(CONFIG_SCHED_CPU_MASK) && \
+	(CONFIG_MP_NUM_CPUS > 1)
+#define CACHE_SMP_TESTS 1
+#define CACHE_SMP_BLOCK 128
+
+static K_THREAD_STACK_DEFINE(cache_cpu_stack, STACK_SIZE);
+static struct k_thread cache_cpu_thread;
+static int cache_cpu_count;
+
+/* Fills the heap with small blocks and frees them into the cache of
+ * the CPU the thread is pinned to
+ */
+static void cache_cpu_fill(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	cache_release(cache_fill(32));
+}
+
+/* Exhausts the heap with blocks too large to be cached */
+static void cache_cpu_exhaust(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	cache_cpu_count = cache_fill(CACHE_SMP_BLOCK);
+}
+
+static void cache_run_on_cpu(k_thread_entry_t entry, int cpu)
+{
+	k_tid_t tid;
+
+	tid = k_thread_create(&cache_cpu_thread, cache_cpu_stack, STACK_SIZE,
+			      entry, NULL, NULL, NULL, K_PRIO_PREEMPT(5), 0,
+			      K_FOREVER);
+	zassert_ok(k_thread_cpu_mask_clear(tid), NULL);
+	zassert_ok(k_thread_cpu_mask_enable(tid, cpu), NULL);
+	k_thread_start(tid);
+	k_thread_join(tid, K_FOREVER);
+}
+#endif
+
+/**
+ * @brief Validate that the k_heap caches of all CPUs are flushed
+ *
+ * @details Cache blocks freed on CPU 1, then exhaust the heap with
+ * K_NO_WAIT allocations of uncached blocks on CPU 0, and check that as
+ * many blocks are allocated as with empty caches, the blocks cached by
+ * CPU 1 having been given back to the heap.
+ *
+ * @ingroup kernel_heap_tests
+ */
+void test_k_heap_cache_smp(void)
+{
+#ifdef CACHE_SMP_TESTS
+	struct k_heap_cache_stats stats;
+	int n;
+
+	/* Number of blocks fitting in the heap, exhausting it also
+	 * empties the caches
+	 */
+	n = cache_fill(CACHE_SMP_BLOCK);
+	cache_release(n);
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.cached, 0, "caches not flushed");
+
+	cache_run_on_cpu(cache_cpu_fill, 1);
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.cached, CONFIG_HEAP_CACHE_DEPTH,
+		      "blocks not cached by CPU 1");
+
+	cache_run_on_cpu(cache_cpu_exhaust, 0);
+	k_heap_cache_stats_get(&k_heap_test, &stats);
+	zassert_equal(stats.cached, 0, "cache of CPU 1 not flushed");
+	zassert_equal(cache_cpu_count, n, "heap memory lost in a cache");
+	cache_release(cache_cpu_count);
+#else
+	ztest_test_skip();
+#endif
+}
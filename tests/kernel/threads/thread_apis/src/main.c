@@ -45,6 +45,7 @@ extern void test_threads_suspend(void);
 extern void test_abort_from_isr(void);
 extern void test_abort_from_isr_not_self(void);
 extern void test_essential_thread_abort(void);
+extern void test_threads_sched_latency(void);
 
 struct k_thread tdata;
 #define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
@@ -582,6 +583,54 @@ void test_k_busy_wait(void)
 	cycles = test_stats.execution_cycles;
 }
 
+/* The CPU usage of this thread and of the CPU over the last second is
+ * about half, as the thread busy waits half of the time and the CPU is
+ * idle the rest of the time.
+ */
+void test_thread_runtime_stats_usage(void)
+{
+	k_thread_runtime_stats_t stats;
+	k_cpu_runtime_stats_t cpu_stats;
+	uint64_t idle_cycles;
+
+	zassert_equal(k_cpu_runtime_stats_get(0, NULL), -EINVAL, NULL);
+	zassert_equal(k_cpu_runtime_stats_get(-1, &cpu_stats), -EINVAL, NULL);
+	zassert_equal(k_cpu_runtime_stats_get(CONFIG_MP_NUM_CPUS, &cpu_stats),
+		      -EINVAL, NULL);
+
+	zassert_ok(k_cpu_runtime_stats_get(0, &cpu_stats), NULL);
+	idle_cycles = cpu_stats.idle_cycles;
+
+	for (int i = 0; i < 4; i++) {
+		k_busy_wait(USEC_PER_MSEC * 100);
+		k_msleep(100);
+	}
+
+	zassert_ok(k_cpu_runtime_stats_get(0, &cpu_stats), NULL);
+	zassert_true(cpu_stats.idle_cycles > idle_cycles, NULL);
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS_WINDOWS
+	/* Settle on a whole number of usage samples */
+	k_msleep(MSEC_PER_SEC - k_uptime_get() % MSEC_PER_SEC + 10);
+
+	for (int i = 0; i < 10; i++) {
+		k_busy_wait(USEC_PER_MSEC * 50);
+		k_msleep(50);
+	}
+
+	k_thread_runtime_stats_get(k_current_get(), &stats);
+	zassert_within(stats.usage[0], 5000, 1000, "usage %u",
+		       stats.usage[0]);
+	zassert_true(stats.usage[1] < stats.usage[0], NULL);
+
+	zassert_ok(k_cpu_runtime_stats_get(0, &cpu_stats), NULL);
+	zassert_within(cpu_stats.usage[0], 5000, 1000, "usage %u",
+		       cpu_stats.usage[0]);
+#else
+	ARG_UNUSED(stats);
+#endif
+}
+
 static void tp_entry(void *p1, void *p2, void *p3)
 {
 	tp = 100;
@@ -696,7 +745,9 @@ void test_main(void)
 			 ztest_unit_test(test_abort_from_isr_not_self),
 			 ztest_user_unit_test(test_thread_timeout_remaining_expires),
 			 ztest_unit_test(test_k_busy_wait),
-			 ztest_1cpu_user_unit_test(test_k_busy_wait_user)
+			 ztest_1cpu_unit_test(test_thread_runtime_stats_usage),
+			 ztest_1cpu_user_unit_test(test_k_busy_wait_user),
+			 ztest_1cpu_unit_test(test_threads_sched_latency)
 			 );
 
 	ztest_run_test_suite(threads_lifecycle);
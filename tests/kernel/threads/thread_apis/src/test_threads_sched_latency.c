@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <irq_offload.h>
+
+#include "tests_thread_apis.h"
+
+#ifdef CONFIG_SCHED_LATENCY_STATS
+#define WAITER_PRIO K_PRIO_PREEMPT(0)
+#define ROUNDS 3
+
+static K_SEM_DEFINE(latency_sem, 0, 1);
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int i = 0; i < 2 * ROUNDS; i++) {
+		k_sem_take(&latency_sem, K_FOREVER);
+	}
+}
+
+static void sem_give_isr(const void *arg)
+{
+	k_sem_give((struct k_sem *)arg);
+}
+
+static uint32_t hist_count(const struct k_sched_latency_hist *hist)
+{
+	uint32_t count = 0;
+
+	for (int i = 0; i < CONFIG_SCHED_LATENCY_BUCKETS; i++) {
+		count += hist->buckets[i];
+	}
+
+	return count;
+}
+#endif
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Test scheduling latency statistics
+ *
+ * @details A higher priority thread is made ready by this thread and by
+ * an ISR and the number of latencies accounted to the thread and to its
+ * priority is checked.
+ *
+ * @see k_thread_sched_latency_get(), k_sched_latency_prio_get()
+ */
+void test_threads_sched_latency(void)
+{
+#ifdef CONFIG_SCHED_LATENCY_STATS
+	int prio = k_thread_priority_get(k_current_get());
+	k_sched_latency_stats_t stats;
+	k_tid_t tid;
+
+	zassert_equal(k_thread_sched_latency_get(NULL, &stats), -EINVAL, NULL);
+	zassert_equal(k_thread_sched_latency_get(k_current_get(), NULL),
+		      -EINVAL, NULL);
+	zassert_equal(k_sched_latency_prio_get(K_LOWEST_THREAD_PRIO + 1,
+					       &stats), -EINVAL, NULL);
+	zassert_equal(k_sched_latency_prio_get(K_HIGHEST_THREAD_PRIO - 1,
+					       &stats), -EINVAL, NULL);
+
+	/* Run below the waiter so that it preempts this thread each time it
+	 * is made ready
+	 */
+	k_thread_priority_set(k_current_get(), WAITER_PRIO + 1);
+
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, waiter, NULL, NULL,
+			      NULL, WAITER_PRIO, 0, K_FOREVER);
+	k_thread_start(tid);
+	k_sched_latency_reset();
+
+	for (int i = 0; i < ROUNDS; i++) {
+		k_sem_give(&latency_sem);
+		irq_offload(sem_give_isr, &latency_sem);
+	}
+
+	zassert_ok(k_thread_sched_latency_get(tid, &stats), NULL);
+	zassert_equal(hist_count(&stats.wakeup), ROUNDS, NULL);
+	zassert_equal(hist_count(&stats.isr), ROUNDS, NULL);
+
+	zassert_ok(k_sched_latency_prio_get(WAITER_PRIO, &stats), NULL);
+	zassert_equal(hist_count(&stats.wakeup), ROUNDS, NULL);
+	zassert_equal(hist_count(&stats.isr), ROUNDS, NULL);
+
+	k_thread_join(tid, K_FOREVER);
+	k_thread_priority_set(k_current_get(), prio);
+
+	k_sched_latency_reset();
+	zassert_ok(k_sched_latency_prio_get(WAITER_PRIO, &stats), NULL);
+	zassert_equal(hist_count(&stats.wakeup), 0, NULL);
+	zassert_equal(stats.wakeup.max_cycles, 0, NULL);
+#else
+	ztest_test_skip();
+#endif
+}
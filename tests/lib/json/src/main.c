@@ -332,12 +332,51 @@ struct encoding_test {
 	int result;
 };
 
+#ifdef CONFIG_JSON_STREAMING
+static char str_buf[256];
+
+/* Feeds the payload to a streaming parser in chunks of chunk_len bytes */
+static int stream_parse(const char *json, size_t len, size_t chunk_len,
+			const struct json_obj_descr *descr, size_t descr_len,
+			void *val)
+{
+	struct json_parser parser;
+	size_t n;
+	int ret;
+
+	json_parser_init(&parser, descr, descr_len, val, str_buf,
+			 sizeof(str_buf));
+
+	while (len > 0) {
+		n = MIN(len, chunk_len);
+		ret = json_parser_feed(&parser, json, n);
+		if (ret < 0) {
+			zassert_equal(json_parser_feed(&parser, json, n), ret,
+				      "Error is sticky");
+			return ret;
+		}
+
+		json += n;
+		len -= n;
+	}
+
+	return json_parser_finish(&parser);
+}
+#endif
+
 static void parse_harness(struct encoding_test encoded[], size_t size)
 {
 	struct test_struct ts;
 	int ret;
 
 	for (int i = 0; i < size; i++) {
+#ifdef CONFIG_JSON_STREAMING
+		ret = stream_parse(encoded[i].str, strlen(encoded[i].str), 1,
+				   test_descr, ARRAY_SIZE(test_descr), &ts);
+		zassert_equal(ret, encoded[i].result,
+			      "Stream decoding '%s' result %d, expected %d",
+			      encoded[i].str, ret, encoded[i].result);
+#endif
 		ret = json_obj_parse(encoded[i].str, strlen(encoded[i].str),
 				     test_descr, ARRAY_SIZE(test_descr), &ts);
 		zassert_equal(ret, encoded[i].result,
@@ -539,6 +578,288 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check rejected");
 }
 
+static void test_json_parser_chunks(void)
+{
+#ifdef CONFIG_JSON_STREAMING
+	const char encoded[] = "{\"some_string\":\"zephyr 123\\uABCD456\","
+		"\"some_int\":\t42\n,"
+		"\"some_bool\":true    \t  "
+		"\r   ,"
+		"\"some_nested_struct\":{    "
+		"\"nested_int\":-1234,\n\n"
+		"\"nested_bool\":false,\t"
+		"\"nested_string\":\"this should be escaped: \\t\"},"
+		"\"some_array\":[11,22, 33,\t45,\n299]"
+		"\"another_b!@l\":true,"
+		"\"if\":false,"
+		"\"another-array\":[2,3,5,7],"
+		"\"4nother_ne$+\":{\"nested_int\":1234,"
+		"\"nested_bool\":true,"
+		"\"nested_string\":\"no escape necessary\"}"
+		"}\n";
+	const int expected_array[] = { 11, 22, 33, 45, 299 };
+	const size_t chunk_lens[] = { 1, 2, 3, 7, 64, sizeof(encoded) };
+	struct test_struct ts;
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(chunk_lens); i++) {
+		memset(&ts, 0, sizeof(ts));
+
+		ret = stream_parse(encoded, sizeof(encoded) - 1, chunk_lens[i],
+				   test_descr, ARRAY_SIZE(test_descr), &ts);
+		zassert_equal(ret, (1 << ARRAY_SIZE(test_descr)) - 1,
+			      "All fields decoded in chunks of %zu",
+			      chunk_lens[i]);
+
+		zassert_true(!strcmp(ts.some_string, "zephyr 123\\uABCD456"),
+			     "String decoded correctly");
+		zassert_equal(ts.some_int, 42, "Integer decoded correctly");
+		zassert_true(ts.some_bool, "Boolean decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_int, -1234,
+			      "Nested integer decoded correctly");
+		zassert_false(ts.some_nested_struct.nested_bool,
+			      "Nested boolean decoded correctly");
+		zassert_true(!strcmp(ts.some_nested_struct.nested_string,
+				     "this should be escaped: \\t"),
+			     "Nested string decoded correctly");
+		zassert_equal(ts.some_array_len, 5, "Array length decoded");
+		zassert_true(!memcmp(ts.some_array, expected_array,
+				     sizeof(expected_array)),
+			     "Array decoded with expected values");
+		zassert_true(ts.another_bxxl, "Named boolean decoded");
+		zassert_false(ts.if_, "Reserved word boolean decoded");
+		zassert_equal(ts.another_array_len, 4, "Named array decoded");
+		zassert_equal(ts.xnother_nexx.nested_int, 1234,
+			      "Named nested integer decoded correctly");
+		zassert_true(!strcmp(ts.xnother_nexx.nested_string,
+				     "no escape necessary"),
+			     "Named nested string decoded correctly");
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_json_parser_arrays(void)
+{
+#ifdef CONFIG_JSON_STREAMING
+	const char objects[] = "{\"elements\":["
+		"{\"name\":\"Simón Bolívar\",\"height\":168},"
+		"{\"height\":160,\"name\":\"Muggsy Bogues\"},"
+		"{\"name\":\"Pelé\",\"height\":173}"
+		"]}";
+	const char arrays[] = "{\"objects_array\":["
+		"[{\"height\":168,\"name\":\"Simón Bolívar\"}],"
+		"[{\"height\":173,\"name\":\"Pelé\"}],"
+		"[{\"height\":195,\"name\":\"Usain Bolt\"}]]"
+		"}";
+	struct obj_array_array oaa;
+	struct obj_array oa;
+	int ret;
+
+	ret = stream_parse(objects, sizeof(objects) - 1, 5, obj_array_descr,
+			   ARRAY_SIZE(obj_array_descr), &oa);
+	zassert_equal(ret, 1, "Array of objects decoded");
+	zassert_equal(oa.num_elements, 3, "Number of elements decoded");
+	zassert_true(!strcmp(oa.elements[1].name, "Muggsy Bogues"),
+		     "Element name decoded");
+	zassert_equal(oa.elements[2].height, 173, "Element height decoded");
+
+	ret = stream_parse(arrays, sizeof(arrays) - 1, 3, array_array_descr,
+			   ARRAY_SIZE(array_array_descr), &oaa);
+	zassert_equal(ret, 1, "Array of arrays decoded");
+	zassert_equal(oaa.objects_array_len, 3, "Number of arrays decoded");
+	zassert_true(!strcmp(oaa.objects_array[1].objects.name, "Pelé"),
+		     "String decoded correctly");
+	zassert_equal(oaa.objects_array[2].objects.height, 195,
+		      "Usain Bolt height decoded correctly");
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_json_parser_skip(void)
+{
+#ifdef CONFIG_JSON_STREAMING
+	const char encoded[] = "{\"unknown\":{\"some_int\":[1,{\"a\":\"}\"}],"
+		"\"b\":true},\"some_i\":3,\"some_int\":5,\"some_int\":6,"
+		"\"some_intx\":7}";
+	struct test_struct ts;
+	int ret;
+
+	ret = stream_parse(encoded, sizeof(encoded) - 1, 4, test_descr,
+			   ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, BIT(1), "Only some_int decoded");
+	zassert_equal(ts.some_int, 5, "First value of the key decoded");
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_json_parser_limits(void)
+{
+#ifdef CONFIG_JSON_STREAMING
+	const char too_long[] = "{\"some_string\":\"0123456789\"}";
+	const char too_many[] = "{\"another-array\":[1,2,3,4,5,6,7,8,9,10,11]}";
+	const char too_deep[] = "{\"a\":[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[1]]]]]]]"
+		"]]]]]]]]]]]]]]]]]]]]]]]]]]}";
+	const char incomplete[] = "{\"some_int\":1";
+	struct test_struct ts;
+	struct json_parser parser;
+	char small_buf[10];
+	int ret;
+
+	json_parser_init(&parser, test_descr, ARRAY_SIZE(test_descr), &ts,
+			 small_buf, sizeof(small_buf));
+	ret = json_parser_feed(&parser, too_long, sizeof(too_long) - 1);
+	zassert_equal(ret, -ENOMEM, "String buffer bounds checked");
+	zassert_equal(json_parser_finish(&parser), -ENOMEM, "Error kept");
+
+	ret = stream_parse(too_many, sizeof(too_many) - 1, 8, test_descr,
+			   ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, -ENOSPC, "Array bounds checked");
+
+	ret = stream_parse(too_deep, sizeof(too_deep) - 1, 8, test_descr,
+			   ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, -ENOMEM, "Nesting depth checked");
+
+	ret = stream_parse(incomplete, sizeof(incomplete) - 1, 8, test_descr,
+			   ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, -EINVAL, "Incomplete object rejected");
+#else
+	ztest_test_skip();
+#endif
+}
+
+#ifdef CONFIG_JSON_STREAMING
+struct chunks {
+	char buf[512];
+	size_t used;
+	size_t max_chunk;
+};
+
+static int append_chunk(const char *bytes, size_t len, void *data)
+{
+	struct chunks *chunks = data;
+
+	if (len >= sizeof(chunks->buf) - chunks->used) {
+		return -ENOMEM;
+	}
+
+	memcpy(chunks->buf + chunks->used, bytes, len);
+	chunks->used += len;
+	chunks->buf[chunks->used] = '\0';
+	chunks->max_chunk = MAX(chunks->max_chunk, len);
+
+	return 0;
+}
+#endif
+
+static void test_json_encoder(void)
+{
+#ifdef CONFIG_JSON_STREAMING
+	static const struct elt elts[] = {
+		{ .name = "Pelé", .height = 173 },
+		{ .name = "Usain \"Lightning\" Bolt", .height = 195 },
+	};
+	const struct test_nested nested = {
+		.nested_int = -1,
+		.nested_bool = true,
+		.nested_string = "tab\t",
+	};
+	const char expected[] = "{\"nested_int\":-1,\"nested_bool\":true,"
+		"\"nested_string\":\"tab\\t\",\"elements\":["
+		"{\"name\":\"Pelé\",\"height\":173},"
+		"{\"name\":\"Usain \\\"Lightning\\\" Bolt\",\"height\":195}],"
+		"\"empty\":[],\"copy\":{\"nested_int\":-1,\"nested_bool\":true,"
+		"\"nested_string\":\"tab\\t\"}}";
+	struct json_encoder encoder;
+	struct chunks chunks = { 0 };
+	char buf[7];
+
+	json_encoder_init(&encoder, buf, sizeof(buf), append_chunk, &chunks);
+
+	zassert_ok(json_encoder_obj_start(&encoder, NULL), NULL);
+	zassert_ok(json_encoder_fields(&encoder, nested_descr,
+				       ARRAY_SIZE(nested_descr), &nested), NULL);
+	zassert_ok(json_encoder_arr_start(&encoder, "elements"), NULL);
+	zassert_equal(json_encoder_fields(&encoder, elt_descr,
+					  ARRAY_SIZE(elt_descr), &elts[0]),
+		      -EINVAL, "Fields outside of an object rejected");
+	zassert_equal(json_encoder_obj_end(&encoder), -EINVAL,
+		      "Closing an object in an array rejected");
+	for (int i = 0; i < ARRAY_SIZE(elts); i++) {
+		zassert_equal(json_encoder_obj(&encoder, "key", elt_descr,
+					       ARRAY_SIZE(elt_descr), &elts[i]),
+			      -EINVAL, "Key in an array rejected");
+		zassert_ok(json_encoder_obj(&encoder, NULL, elt_descr,
+					    ARRAY_SIZE(elt_descr), &elts[i]),
+			   NULL);
+	}
+	zassert_ok(json_encoder_arr_end(&encoder), NULL);
+	zassert_equal(json_encoder_arr_start(&encoder, NULL), -EINVAL,
+		      "Missing key in an object rejected");
+	zassert_ok(json_encoder_arr_start(&encoder, "empty"), NULL);
+	zassert_ok(json_encoder_arr_end(&encoder), NULL);
+	zassert_ok(json_encoder_obj(&encoder, "copy", nested_descr,
+				    ARRAY_SIZE(nested_descr), &nested), NULL);
+	zassert_ok(json_encoder_obj_end(&encoder), NULL);
+	zassert_equal(json_encoder_obj_end(&encoder), -EINVAL,
+		      "Closing more objects than opened rejected");
+	zassert_ok(json_encoder_flush(&encoder), NULL);
+
+	zassert_true(!strcmp(chunks.buf, expected), "Encoded in chunks");
+	zassert_equal(chunks.max_chunk, sizeof(buf), "Chunks of buffer size");
+#else
+	ztest_test_skip();
+#endif
+}
+
+static void test_json_encoder_obj(void)
+{
+#ifdef CONFIG_JSON_STREAMING
+	struct test_struct ts = {
+		.some_string = "zephyr 123",
+		.some_int = 42,
+		.some_nested_struct = {
+			.nested_string = "nested",
+		},
+		.some_array = { 1, 2, 3 },
+		.some_array_len = 3,
+		.xnother_nexx = {
+			.nested_string = "",
+		},
+	};
+	struct json_encoder encoder;
+	struct chunks chunks = { 0 };
+	char buffer[512];
+	char chunk_buf[16];
+	int ret;
+
+	ret = json_obj_encode_buf(test_descr, ARRAY_SIZE(test_descr), &ts,
+				  buffer, sizeof(buffer));
+	zassert_equal(ret, 0, "Encoded in one buffer");
+
+	json_encoder_init(&encoder, chunk_buf, sizeof(chunk_buf),
+			  append_chunk, &chunks);
+	ret = json_encoder_obj(&encoder, NULL, test_descr,
+			       ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, 0, "Encoded in chunks");
+	zassert_ok(json_encoder_flush(&encoder), NULL);
+	zassert_true(!strcmp(chunks.buf, buffer), "Same encoding");
+
+	memset(&chunks, 0, sizeof(chunks));
+	json_encoder_init(&encoder, NULL, 0, append_chunk, &chunks);
+	ret = json_encoder_obj(&encoder, NULL, test_descr,
+			       ARRAY_SIZE(test_descr), &ts);
+	zassert_equal(ret, 0, "Encoded without buffer");
+	zassert_ok(json_encoder_flush(&encoder), NULL);
+	zassert_true(!strcmp(chunks.buf, buffer), "Same encoding");
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -560,7 +881,13 @@ void test_main(void)
 			 ztest_unit_test(test_json_escape_empty),
 			 ztest_unit_test(test_json_escape_no_op),
 			 ztest_unit_test(test_json_escape_bounds_check),
-			 ztest_unit_test(test_json_encode_bounds_check)
+			 ztest_unit_test(test_json_encode_bounds_check),
+			 ztest_unit_test(test_json_parser_chunks),
+			 ztest_unit_test(test_json_parser_arrays),
+			 ztest_unit_test(test_json_parser_skip),
+			 ztest_unit_test(test_json_parser_limits),
+			 ztest_unit_test(test_json_encoder),
+			 ztest_unit_test(test_json_encoder_obj)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
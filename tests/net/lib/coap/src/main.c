@@ -439,6 +439,504 @@ static void test_match_path_uri(void)
 	zassert_false(r, "Matching %s failed", uri);
 }
 
+static struct coap_resource *routed_resource;
+
+static int route_get(struct coap_resource *resource,
+		     struct coap_packet *request,
+		     struct sockaddr *addr, socklen_t addr_len)
+{
+	routed_resource = resource;
+
+	return 0;
+}
+
+static const char * const route_a_path[] = { "a", NULL };
+static const char * const route_a_b_path[] = { "a", "b", NULL };
+static const char * const route_a_any_path[] = { "a", "+", "c", NULL };
+static struct coap_resource route_resources[] = {
+	{ .path = route_a_path, .get = route_get },
+	{ .path = route_a_b_path, .get = route_get },
+	{ .path = route_a_any_path, .get = route_get },
+	{ },
+};
+
+static int route_request(struct coap_resource *resources,
+			 const char * const *path, uint16_t len_before,
+			 int queries, bool parsed)
+{
+	struct coap_packet cpkt;
+	struct coap_option options[8];
+	uint8_t *data = data_buf[0];
+	char query[] = "q=0";
+	int r;
+
+	r = coap_packet_init(&cpkt, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Could not initialize packet");
+
+	if (len_before) {
+		r = coap_append_option_int(&cpkt, COAP_OPTION_URI_PORT,
+					   len_before);
+		zassert_equal(r, 0, "Could not append option");
+	}
+
+	for (int i = 0; path[i]; i++) {
+		r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH,
+					      path[i], strlen(path[i]));
+		zassert_equal(r, 0, "Could not append option");
+	}
+
+	for (int i = 0; i < queries; i++) {
+		query[2] = '0' + i;
+		r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_QUERY,
+					      query, strlen(query));
+		zassert_equal(r, 0, "Could not append option");
+	}
+
+	r = coap_packet_append_payload_marker(&cpkt);
+	zassert_equal(r, 0, "Could not append payload marker");
+	r = coap_packet_append_payload(&cpkt, "xy", 2);
+	zassert_equal(r, 0, "Could not append payload");
+
+	if (parsed) {
+		r = coap_packet_parse(&cpkt, data, cpkt.offset, options,
+				      ARRAY_SIZE(options));
+		zassert_equal(r, 0, "Could not parse packet");
+	}
+
+	r = coap_find_options(&cpkt, COAP_OPTION_URI_QUERY, options,
+			      ARRAY_SIZE(options));
+	zassert_equal(r, MIN(queries, ARRAY_SIZE(options)),
+		      "Wrong number of queries");
+	for (int i = 0; i < r; i++) {
+		query[2] = '0' + i;
+		zassert_equal(options[i].len, strlen(query), NULL);
+		zassert_mem_equal(options[i].value, query, strlen(query), NULL);
+	}
+
+	if (!parsed) {
+		return 0;
+	}
+
+	r = coap_packet_parse(&cpkt, data, cpkt.offset, options,
+			      ARRAY_SIZE(options));
+	zassert_equal(r, 0, "Could not parse packet");
+
+	routed_resource = NULL;
+
+	return coap_handle_request(&cpkt, resources, options,
+				   ARRAY_SIZE(options),
+				   (struct sockaddr *)&dummy_addr,
+				   sizeof(dummy_addr));
+}
+
+static void test_find_options_and_route(void)
+{
+	const char * const a_path[] = { "a", NULL };
+	const char * const a_b_path[] = { "a", "b", NULL };
+	const char * const a_x_c_path[] = { "a", "x", "c", NULL };
+	const char * const b_path[] = { "b", NULL };
+	const char * const a_b_c_path[] = { "a", "b", "c", "d", NULL };
+
+	/* Options of built packets */
+	route_request(route_resources, a_b_path, 0, 3, false);
+	route_request(route_resources, a_b_path, 5683, 0, false);
+
+	zassert_equal(route_request(route_resources, a_path, 0, 0, true), 0,
+		      NULL);
+	zassert_equal_ptr(routed_resource, &route_resources[0], NULL);
+
+	zassert_equal(route_request(route_resources, a_b_path, 5683, 2, true),
+		      0, NULL);
+	zassert_equal_ptr(routed_resource, &route_resources[1], NULL);
+
+	if (IS_ENABLED(CONFIG_COAP_URI_WILDCARD)) {
+		zassert_equal(route_request(route_resources, a_x_c_path, 0, 1,
+					    true), 0, NULL);
+		zassert_equal_ptr(routed_resource, &route_resources[2], NULL);
+	}
+
+	zassert_equal(route_request(route_resources, b_path, 0, 0, true),
+		      -ENOENT, NULL);
+	zassert_equal(route_request(route_resources, a_b_c_path, 0, 2, true),
+		      -ENOENT, NULL);
+}
+
+static void test_find_options_stop_at_marker(void)
+{
+	struct coap_packet cpkt;
+	struct coap_option options[4];
+	uint8_t *data = data_buf[0];
+	int r;
+
+	r = coap_packet_init(&cpkt, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Could not initialize packet");
+
+	r = coap_packet_append_option(&cpkt, COAP_OPTION_URI_PATH, "a", 1);
+	zassert_equal(r, 0, "Could not append option");
+
+	r = coap_packet_append_payload_marker(&cpkt);
+	zassert_equal(r, 0, "Could not append payload marker");
+	r = coap_packet_append_payload(&cpkt, "xy", 2);
+	zassert_equal(r, 0, "Could not append payload");
+
+	/* Left over from a previous lookup, must not be counted */
+	for (int i = 0; i < ARRAY_SIZE(options); i++) {
+		options[i].delta = COAP_OPTION_URI_PATH;
+	}
+
+	r = coap_find_options(&cpkt, COAP_OPTION_URI_PATH, options,
+			      ARRAY_SIZE(options));
+	zassert_equal(r, 1, "Payload marker taken as an option");
+	zassert_equal(options[0].len, 1, NULL);
+	zassert_mem_equal(options[0].value, "a", 1, NULL);
+}
+
+#if defined(CONFIG_COAP_RESOURCE_TRIE)
+#define TRIE_PATHS 10
+
+static const char * const trie_paths[TRIE_PATHS][5] = {
+	{ "a", "b", NULL },
+	{ "a", NULL },
+	{ "a", "+", "c", NULL },
+	{ "a", "b", "c", NULL },
+	{ "x", "#", NULL },
+	{ "x", "y", NULL },
+	{ "+", "b", NULL },
+	{ NULL },
+	{ "a", "b", NULL },
+	{ "long", "path", "with", "segments", NULL },
+};
+
+static struct coap_resource trie_resources[TRIE_PATHS + 1];
+static struct coap_resource linear_resources[TRIE_PATHS + 1];
+#endif
+
+static void test_resource_trie(void)
+{
+#if defined(CONFIG_COAP_RESOURCE_TRIE)
+	static const char * const requests[][5] = {
+		{ NULL },
+		{ "a", NULL },
+		{ "a", "b", NULL },
+		{ "a", "z", "c", NULL },
+		{ "a", "b", "c", NULL },
+		{ "a", "b", "d", NULL },
+		{ "x", NULL },
+		{ "x", "y", NULL },
+		{ "x", "y", "z", NULL },
+		{ "q", "b", NULL },
+		{ "b", NULL },
+		{ "long", "path", NULL },
+		{ "long", "path", "with", "segments", NULL },
+	};
+	static struct coap_resource_trie_node nodes[16];
+	static struct coap_resource_trie trie;
+	int r;
+
+	for (int i = 0; i < TRIE_PATHS; i++) {
+		trie_resources[i].path = trie_paths[i];
+		trie_resources[i].get = route_get;
+		linear_resources[i] = trie_resources[i];
+	}
+
+	r = coap_resource_trie_init(&trie, trie_resources, nodes, 8);
+	zassert_equal(r, -ENOMEM, "Trie should not fit");
+	r = coap_resource_trie_init(&trie, trie_resources, nodes,
+				    ARRAY_SIZE(nodes));
+	zassert_equal(r, 0, "Could not build trie");
+
+	for (int i = 0; i < ARRAY_SIZE(requests); i++) {
+		struct coap_resource *expected;
+		int expected_r;
+
+		expected_r = route_request(linear_resources, requests[i], 0, 1,
+					   true);
+		expected = routed_resource;
+
+		r = route_request(trie_resources, requests[i], 0, 1, true);
+		zassert_equal(r, expected_r, "Request %d", i);
+		if (expected == NULL) {
+			zassert_is_null(routed_resource, "Request %d", i);
+		} else {
+			zassert_equal(routed_resource - trie_resources,
+				      expected - linear_resources,
+				      "Request %d", i);
+		}
+	}
+
+	/* The resources are compared with the request path again */
+	coap_resource_trie_deinit(&trie);
+	memset(nodes, 0, sizeof(nodes));
+	zassert_equal(route_request(trie_resources, requests[2], 0, 1, true),
+		      0, NULL);
+	zassert_equal_ptr(routed_resource, &trie_resources[0], NULL);
+#else
+	ztest_test_skip();
+#endif
+}
+
+#if defined(CONFIG_COAP_BLOCK_DOWNLOAD)
+#define DOWNLOAD_SIZE 200
+#define DOWNLOAD_BLOCKS 7
+#define DOWNLOAD_WINDOW 4
+
+static uint8_t download_data[DOWNLOAD_SIZE];
+static uint8_t download_received[DOWNLOAD_SIZE];
+static size_t download_len;
+static bool download_last;
+static uint32_t download_requests[32];
+static int download_num_requests;
+
+static int download_request(struct coap_block_download *dl,
+			    struct coap_block_context *block)
+{
+	zassert_true(download_num_requests < ARRAY_SIZE(download_requests),
+		     "Too many requests");
+	zassert_equal(block->block_size, COAP_BLOCK_32, "Wrong block size");
+
+	download_requests[download_num_requests++] =
+		block->current / coap_block_size_to_bytes(COAP_BLOCK_32);
+
+	return 0;
+}
+
+static int download_sink(struct coap_block_download *dl,
+			 const uint8_t *data, uint16_t len, size_t offset,
+			 bool last)
+{
+	zassert_equal(offset, download_len, "Data not delivered in order");
+	zassert_false(download_last, "Data delivered after the last block");
+	zassert_true(offset + len <= DOWNLOAD_SIZE, "Too much data");
+
+	memcpy(download_received + offset, data, len);
+	download_len += len;
+	download_last = last;
+
+	return 0;
+}
+
+static void download_build_request(struct coap_packet *req, uint32_t num)
+{
+	struct coap_block_context ctx;
+	int r;
+
+	coap_block_transfer_init(&ctx, COAP_BLOCK_32, 0);
+	ctx.current = num * coap_block_size_to_bytes(COAP_BLOCK_32);
+
+	r = coap_packet_init(req, data_buf[0], COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Unable to initialize request");
+
+	r = coap_append_block2_option(req, &ctx);
+	zassert_equal(r, 0, "Unable to append block2 option");
+}
+
+static int download_respond(struct coap_block_download *dl, uint32_t num,
+			    bool size2)
+{
+	uint16_t bytes = coap_block_size_to_bytes(COAP_BLOCK_32);
+	struct coap_block_context ctx;
+	struct coap_packet rsp;
+	int r;
+
+	coap_block_transfer_init(&ctx, COAP_BLOCK_32, DOWNLOAD_SIZE);
+	ctx.current = num * bytes;
+
+	r = coap_packet_init(&rsp, data_buf[1], COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_ACK, 0, NULL,
+			     COAP_RESPONSE_CODE_CONTENT, coap_next_id());
+	zassert_equal(r, 0, "Unable to initialize response");
+
+	r = coap_append_block2_option(&rsp, &ctx);
+	zassert_equal(r, 0, "Unable to append block2 option");
+
+	if (size2) {
+		r = coap_append_size2_option(&rsp, &ctx);
+		zassert_equal(r, 0, "Unable to append size2 option");
+	}
+
+	r = coap_packet_append_payload_marker(&rsp);
+	zassert_equal(r, 0, "Unable to append payload marker");
+
+	r = coap_packet_append_payload(&rsp, download_data + ctx.current,
+				       MIN(bytes, DOWNLOAD_SIZE - ctx.current));
+	zassert_equal(r, 0, "Unable to append payload");
+
+	return coap_block_download_response(dl, &rsp);
+}
+
+static void download_reset(void)
+{
+	for (int i = 0; i < DOWNLOAD_SIZE; i++) {
+		download_data[i] = i * 7;
+	}
+
+	memset(download_received, 0, sizeof(download_received));
+	download_len = 0;
+	download_last = false;
+	download_num_requests = 0;
+}
+
+static void download_verify_requests(const uint32_t *expected, int count)
+{
+	zassert_equal(download_num_requests, count, "Wrong number of requests");
+
+	for (int i = 0; i < count; i++) {
+		zassert_equal(download_requests[i], expected[i],
+			      "Wrong block requested");
+	}
+
+	download_num_requests = 0;
+}
+#endif
+
+static void test_block_download(void)
+{
+#if defined(CONFIG_COAP_BLOCK_DOWNLOAD)
+	static uint8_t buf[(DOWNLOAD_WINDOW - 1) * 32];
+	static struct coap_block_download dl;
+	struct coap_packet req;
+	int r;
+
+	download_reset();
+
+	r = coap_block_download_init(&dl, download_request, download_sink,
+				     COAP_BLOCK_32, 0, NULL, 0);
+	zassert_equal(r, -EINVAL, "Window of 0 blocks accepted");
+	r = coap_block_download_init(&dl, download_request, download_sink,
+				     COAP_BLOCK_32, DOWNLOAD_WINDOW, buf,
+				     sizeof(buf) - 1);
+	zassert_equal(r, -ENOMEM, "Too small buffer accepted");
+	r = coap_block_download_init(&dl, download_request, download_sink,
+				     COAP_BLOCK_32, DOWNLOAD_WINDOW, buf,
+				     sizeof(buf));
+	zassert_equal(r, 0, "Unable to initialize download");
+
+	/* Only the first block is requested until the size is known */
+	r = coap_block_download_start(&dl);
+	zassert_equal(r, 0, "Unable to start download");
+	download_verify_requests((uint32_t []){ 0 }, 1);
+
+	r = download_respond(&dl, 0, true);
+	zassert_equal(r, 0, "Block 0 not handled");
+	zassert_equal(dl.ctx.total_size, DOWNLOAD_SIZE, "Wrong total size");
+	download_verify_requests((uint32_t []){ 1, 2, 3, 4 }, 4);
+
+	/* Out of order and duplicate blocks are stored once */
+	r = download_respond(&dl, 3, false);
+	zassert_equal(r, 0, "Block 3 not handled");
+	r = download_respond(&dl, 3, false);
+	zassert_equal(r, 0, "Duplicate block 3 not ignored");
+	r = download_respond(&dl, 0, true);
+	zassert_equal(r, 0, "Duplicate block 0 not ignored");
+	zassert_equal(download_len, 32, "Data delivered out of order");
+	download_verify_requests(NULL, 0);
+
+	/* Timed out blocks are requested again, unless received since */
+	download_build_request(&req, 2);
+	r = coap_block_download_timeout(&dl, &req);
+	zassert_equal(r, 0, "Timeout of block 2 not handled");
+	download_build_request(&req, 3);
+	r = coap_block_download_timeout(&dl, &req);
+	zassert_equal(r, 0, "Timeout of block 3 not handled");
+	download_verify_requests((uint32_t []){ 2 }, 1);
+
+	r = download_respond(&dl, 1, false);
+	zassert_equal(r, 0, "Block 1 not handled");
+	download_verify_requests((uint32_t []){ 5 }, 1);
+
+	r = download_respond(&dl, 2, false);
+	zassert_equal(r, 0, "Block 2 not handled");
+	zassert_equal(download_len, 4 * 32, "Stored block not delivered");
+	download_verify_requests((uint32_t []){ 6 }, 1);
+
+	r = coap_block_download_resend(&dl);
+	zassert_equal(r, 0, "Unable to resend requests");
+	download_verify_requests((uint32_t []){ 4, 5, 6 }, 3);
+
+	r = download_respond(&dl, 6, false);
+	zassert_equal(r, 0, "Block 6 not handled");
+	r = download_respond(&dl, 4, false);
+	zassert_equal(r, 0, "Block 4 not handled");
+	zassert_false(download_last, "Last block delivered too early");
+	r = download_respond(&dl, 5, false);
+	zassert_equal(r, 1, "Download not complete");
+	download_verify_requests(NULL, 0);
+
+	zassert_true(download_last, "Last block not flagged");
+	zassert_equal(download_len, DOWNLOAD_SIZE, "Wrong size downloaded");
+	zassert_mem_equal(download_received, download_data, DOWNLOAD_SIZE,
+			  "Wrong data downloaded");
+
+	/* Without Size2 the blocks are requested one at a time, and a
+	 * block is given up after the configured number of retries
+	 */
+	download_reset();
+	r = coap_block_download_start(&dl);
+	zassert_equal(r, 0, "Unable to start download");
+	r = download_respond(&dl, 0, false);
+	zassert_equal(r, 0, "Block 0 not handled");
+	download_verify_requests((uint32_t []){ 0, 1 }, 2);
+
+	download_build_request(&req, 1);
+	for (int i = 0; i < CONFIG_COAP_BLOCK_DOWNLOAD_MAX_RETRIES; i++) {
+		r = coap_block_download_timeout(&dl, &req);
+		zassert_equal(r, 0, "Block 1 not requested again");
+	}
+
+	r = coap_block_download_timeout(&dl, &req);
+	zassert_equal(r, -ETIMEDOUT, "Block 1 requested too many times");
+
+	for (int i = 1; i < DOWNLOAD_BLOCKS; i++) {
+		r = download_respond(&dl, i, false);
+		zassert_equal(r, i == DOWNLOAD_BLOCKS - 1 ? 1 : 0,
+			      "Block %d not handled", i);
+	}
+
+	zassert_true(download_last, "Last block not flagged");
+	zassert_mem_equal(download_received, download_data, DOWNLOAD_SIZE,
+			  "Wrong data downloaded");
+
+	/* A window of one block needs no buffer, even with Size2 */
+	download_reset();
+	r = coap_block_download_init(&dl, download_request, download_sink,
+				     COAP_BLOCK_32, 1, NULL, 0);
+	zassert_equal(r, 0, "Unable to initialize download");
+	r = coap_block_download_start(&dl);
+	zassert_equal(r, 0, "Unable to start download");
+	r = download_respond(&dl, 0, true);
+	zassert_equal(r, 0, "Block 0 not handled");
+	download_verify_requests((uint32_t []){ 0, 1 }, 2);
+
+	r = download_respond(&dl, 2, true);
+	zassert_equal(r, 0, "Block not requested not ignored");
+	download_build_request(&req, 1);
+	r = coap_block_download_timeout(&dl, &req);
+	zassert_equal(r, 0, "Timeout of block 1 not handled");
+	r = coap_block_download_resend(&dl);
+	zassert_equal(r, 0, "Unable to resend requests");
+	download_verify_requests((uint32_t []){ 1, 1 }, 2);
+
+	for (int i = 1; i < DOWNLOAD_BLOCKS; i++) {
+		r = download_respond(&dl, i, true);
+		zassert_equal(r, i == DOWNLOAD_BLOCKS - 1 ? 1 : 0,
+			      "Block %d not handled", i);
+	}
+
+	download_verify_requests((uint32_t []){ 2, 3, 4, 5, 6 }, 5);
+	zassert_true(download_last, "Last block not flagged");
+	zassert_mem_equal(download_received, download_data, DOWNLOAD_SIZE,
+			  "Wrong data downloaded");
+#else
+	ztest_test_skip();
+#endif
+}
+
 #define BLOCK_WISE_TRANSFER_SIZE_GET 128
 
 static void prepare_block1_request(struct coap_packet *req,
@@ -963,8 +1461,12 @@ void test_main(void)
 			 ztest_unit_test(test_parse_req_build_ack),
 			 ztest_unit_test(test_parse_req_build_empty_ack),
 			 ztest_unit_test(test_match_path_uri),
+			 ztest_unit_test(test_find_options_and_route),
+			 ztest_unit_test(test_find_options_stop_at_marker),
+			 ztest_unit_test(test_resource_trie),
 			 ztest_unit_test(test_block1_size),
 			 ztest_unit_test(test_block2_size),
+			 ztest_unit_test(test_block_download),
 			 ztest_unit_test(test_retransmit_second_round),
 			 ztest_unit_test(test_observer_server),
 			 ztest_unit_test(test_observer_client));
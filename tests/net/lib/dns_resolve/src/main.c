@@ -26,6 +26,8 @@ LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 
 #define NET_LOG_ENABLED 1
 #include "net_private.h"
+#include "ipv4.h"
+#include "udp_internal.h"
 
 #if defined(CONFIG_DNS_RESOLVER_LOG_LEVEL_DBG)
 #define DBG(fmt, ...) printk(fmt, ##__VA_ARGS__)
@@ -37,6 +39,10 @@ LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
 #define NAME6 "6.zephyr.test"
 #define NAME_IPV4 "192.0.2.1"
 #define NAME_IPV6 "2001:db8::1"
+#define NAME_CACHE "cache.zephyr.test"
+#define NAME_NX "nx.zephyr.test"
+#define NAME_NODATA "nodata.zephyr.test"
+#define NAME_HELD "held.zephyr.test"
 
 #define DNS_TIMEOUT 500 /* ms */
 #define THREAD_SLEEP 10
@@ -69,6 +75,26 @@ static struct k_sem wait_data2;
 static uint16_t current_dns_id;
 static struct dns_addrinfo addrinfo;
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* When set, the queries sent to 192.0.2.2:53 are answered by a stand-in
+ * DNS server instead of calling the query callback directly.
+ */
+static bool stand_in_server;
+static int stand_in_queries;
+static uint8_t stand_in_rcode;
+static bool stand_in_nodata;
+static bool stand_in_held;
+static uint32_t stand_in_ttl;
+static uint8_t stand_in_msg[256];
+static size_t stand_in_len;
+static uint16_t stand_in_port;
+static struct in_addr server_addr = { { { 192, 0, 2, 2 } } };
+static struct in_addr answer_addr = { { { 192, 0, 2, 10 } } };
+
+static void stand_in_reply(struct k_work *work);
+static K_WORK_DEFINE(stand_in_work, stand_in_reply);
+#endif
+
 /* this must be higher that the DNS_TIMEOUT */
 #define WAIT_TIME K_MSEC(DNS_TIMEOUT + 300)
 
@@ -132,6 +158,36 @@ static int sender_iface(const struct device *dev, struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (stand_in_server) {
+		uint8_t buf[NET_IPV4H_LEN + NET_UDPH_LEN + sizeof(stand_in_msg)];
+		size_t len = MIN(net_pkt_get_len(pkt), sizeof(buf));
+
+		net_pkt_cursor_init(pkt);
+		if (net_pkt_read(pkt, buf, len) < 0 ||
+		    len <= NET_IPV4H_LEN + NET_UDPH_LEN ||
+		    (buf[0] >> 4) != 4 || buf[9] != IPPROTO_UDP ||
+		    memcmp(&buf[16], &server_addr, sizeof(server_addr)) ||
+		    buf[22] != 0 || buf[23] != 53) {
+			goto out;
+		}
+
+		/* The reply is sent from a work item as the resolver is
+		 * still holding its lock while sending the query.
+		 */
+		stand_in_port = UNALIGNED_GET((uint16_t *)&buf[20]);
+		stand_in_len = len - NET_IPV4H_LEN - NET_UDPH_LEN;
+		memcpy(stand_in_msg, &buf[NET_IPV4H_LEN + NET_UDPH_LEN],
+		       stand_in_len);
+		stand_in_queries++;
+
+		if (!stand_in_held) {
+			k_work_submit(&stand_in_work);
+		}
+		goto out;
+	}
+#endif
+
 	if (!timeout_query) {
 		struct net_if_test *data = dev->data;
 		struct dns_resolve_context *ctx;
@@ -174,6 +230,52 @@ out:
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void stand_in_reply(struct k_work *work)
+{
+	uint8_t answer[] = {
+		0xc0, 0x0c,		/* pointer to the query name */
+		0x00, 0x01,		/* type A */
+		0x00, 0x01,		/* class IN */
+		0x00, 0x00, 0x00, 0x00,	/* TTL */
+		0x00, 0x04,		/* data length */
+		0x00, 0x00, 0x00, 0x00	/* address */
+	};
+	struct net_pkt *pkt;
+	bool has_answer = stand_in_rcode == 0 && !stand_in_nodata;
+
+	ARG_UNUSED(work);
+
+	stand_in_msg[2] = 0x81; /* response, recursion desired */
+	stand_in_msg[3] = 0x80 | stand_in_rcode;
+	stand_in_msg[7] = has_answer ? 1 : 0;
+
+	UNALIGNED_PUT(htonl(stand_in_ttl), (uint32_t *)&answer[6]);
+	memcpy(&answer[12], &answer_addr, sizeof(answer_addr));
+
+	pkt = net_pkt_alloc_with_buffer(iface1, stand_in_len + sizeof(answer),
+					AF_INET, IPPROTO_UDP, K_FOREVER);
+	zassert_not_null(pkt, "Cannot allocate reply");
+
+	zassert_ok(net_ipv4_create(pkt, &server_addr, &my_addr2),
+		   "Cannot create IPv4 header");
+	zassert_ok(net_udp_create(pkt, htons(53), stand_in_port),
+		   "Cannot create UDP header");
+	zassert_ok(net_pkt_write(pkt, stand_in_msg, stand_in_len),
+		   "Cannot write DNS message");
+
+	if (has_answer) {
+		zassert_ok(net_pkt_write(pkt, answer, sizeof(answer)),
+			   "Cannot write DNS answer");
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_ipv4_finalize(pkt, IPPROTO_UDP);
+
+	zassert_ok(net_recv_data(iface1, pkt), "Cannot receive reply");
+}
+#endif
+
 struct net_if_test net_iface1_data;
 
 static struct dummy_api net_iface_api = {
@@ -754,6 +856,172 @@ static void test_dns_query_ipv6_numeric(void)
 }
 #endif
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+struct cache_result {
+	int status;
+	int count;
+	struct in_addr addr;
+};
+
+static void dns_result_cache_cb(enum dns_resolve_status status,
+				struct dns_addrinfo *info,
+				void *user_data)
+{
+	struct cache_result *result = user_data;
+
+	if (status == DNS_EAI_INPROGRESS) {
+		if (info && info->ai_family == AF_INET) {
+			result->addr = net_sin(&info->ai_addr)->sin_addr;
+			result->count++;
+		}
+
+		return;
+	}
+
+	result->status = status;
+	k_sem_give(&wait_data2);
+}
+
+static int cache_query(const char *name)
+{
+	struct cache_result result = { 0 };
+	uint16_t dns_id;
+	int ret;
+
+	ret = dns_get_addr_info(name, DNS_QUERY_TYPE_A, &dns_id,
+				dns_result_cache_cb, &result, DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot create query for %s", name);
+
+	zassert_ok(k_sem_take(&wait_data2, WAIT_TIME),
+		   "Timeout while waiting data");
+
+	if (result.status == DNS_EAI_ALLDONE) {
+		zassert_equal(result.count, 1, "Invalid address count");
+		zassert_true(net_ipv4_addr_cmp(&result.addr, &answer_addr),
+			     "IPv4 address does not match");
+	} else {
+		zassert_equal(result.count, 0, "Unexpected address");
+	}
+
+	return result.status;
+}
+
+static void cache_count_cb(const struct dns_cache_entry *entry,
+			   int32_t remaining, void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+static void test_dns_query_cache(void)
+{
+	struct dns_resolve_context *ctx = dns_resolve_get_default();
+	struct cache_result result = { 0 };
+	char name[sizeof(NAME_HELD)];
+	uint16_t dns_id;
+	int count = 0;
+
+	zassert_ok(dns_resolve_cache_flush(ctx), "Cannot flush cache");
+
+	/* Earlier tests may have left extra counts in the semaphore */
+	k_sem_reset(&wait_data2);
+
+	stand_in_server = true;
+	stand_in_queries = 0;
+	stand_in_rcode = 0U;
+	stand_in_ttl = 60U;
+
+	/* First query goes to the server, the second one is cached */
+	zassert_equal(cache_query(NAME_CACHE), DNS_EAI_ALLDONE,
+		      "Invalid status");
+	zassert_equal(stand_in_queries, 1, "Query was not sent");
+
+	zassert_equal(cache_query(NAME_CACHE), DNS_EAI_ALLDONE,
+		      "Invalid cached status");
+	zassert_equal(stand_in_queries, 1, "Query was not cached");
+
+	/* NXDOMAIN is cached as negative answer */
+	stand_in_rcode = 3U;
+
+	zassert_equal(cache_query(NAME_NX), DNS_EAI_NODATA, "Invalid status");
+	zassert_equal(stand_in_queries, 2, "Query was not sent");
+
+	zassert_equal(cache_query(NAME_NX), DNS_EAI_NODATA,
+		      "Invalid cached status");
+	zassert_equal(stand_in_queries, 2, "Negative answer was not cached");
+
+	/* So is a NOERROR answer without any record (NODATA) */
+	stand_in_rcode = 0U;
+	stand_in_nodata = true;
+
+	zassert_equal(cache_query(NAME_NODATA), DNS_EAI_NODATA,
+		      "Invalid status");
+	zassert_equal(stand_in_queries, 3, "Query was not sent");
+
+	zassert_equal(cache_query(NAME_NODATA), DNS_EAI_NODATA,
+		      "Invalid cached status");
+	zassert_equal(stand_in_queries, 3, "Negative answer was not cached");
+
+	stand_in_nodata = false;
+
+	/* The name given by the caller is not used after the call, the
+	 * answer is cached under the name that was queried.
+	 */
+	stand_in_held = true;
+	strcpy(name, NAME_HELD);
+
+	zassert_ok(dns_get_addr_info(name, DNS_QUERY_TYPE_A, &dns_id,
+				     dns_result_cache_cb, &result,
+				     DNS_TIMEOUT),
+		   "Cannot create query for %s", NAME_HELD);
+	memset(name, 'x', sizeof(name) - 1);
+
+	while (stand_in_queries != 4) {
+		k_msleep(THREAD_SLEEP);
+	}
+
+	stand_in_held = false;
+	k_work_submit(&stand_in_work);
+
+	zassert_ok(k_sem_take(&wait_data2, WAIT_TIME),
+		   "Timeout while waiting data");
+	zassert_equal(result.status, DNS_EAI_ALLDONE, "Invalid status");
+
+	zassert_equal(cache_query(NAME_HELD), DNS_EAI_ALLDONE,
+		      "Invalid cached status");
+	zassert_equal(stand_in_queries, 4, "Query was not cached");
+
+	zassert_equal(dns_resolve_cache_foreach(ctx, cache_count_cb, &count),
+		      4, "Invalid number of cached entries");
+	zassert_equal(count, 4, "Invalid number of callbacks");
+
+	/* After flush the server is asked again */
+	zassert_ok(dns_resolve_cache_flush(ctx), "Cannot flush cache");
+	stand_in_ttl = 1U;
+
+	zassert_equal(cache_query(NAME_CACHE), DNS_EAI_ALLDONE,
+		      "Invalid status");
+	zassert_equal(stand_in_queries, 5, "Query was not sent after flush");
+
+	zassert_equal(cache_query(NAME_CACHE), DNS_EAI_ALLDONE,
+		      "Invalid cached status");
+	zassert_equal(stand_in_queries, 5, "Query was not cached");
+
+	/* The entry must not be used after the TTL has expired */
+	k_msleep(MSEC_PER_SEC + 100);
+
+	zassert_equal(cache_query(NAME_CACHE), DNS_EAI_ALLDONE,
+		      "Invalid status");
+	zassert_equal(stand_in_queries, 6, "Expired entry was used");
+
+	stand_in_server = false;
+}
+#else
+static void test_dns_query_cache(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(dns_tests,
@@ -771,7 +1039,8 @@ void test_main(void)
 			 ztest_unit_test(test_dns_query_ipv4_cancel),
 			 ztest_unit_test(test_dns_query_ipv6_cancel),
 			 ztest_unit_test(test_dns_query_ipv4),
-			 ztest_unit_test(test_dns_query_ipv4_numeric));
+			 ztest_unit_test(test_dns_query_ipv4_numeric),
+			 ztest_unit_test(test_dns_query_cache));
 
 	ztest_run_test_suite(dns_tests);
 }
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <stdio.h>
+#include <ztest_assert.h>
+
+#include <net/socket.h>
+
+#include "../../socket_helpers.h"
+
+#define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
+#define STRLEN(buf) (sizeof(buf) - 1)
+
+#define TEST_STR_SMALL "test"
+
+#define SERVER_PORT 4242
+#define CLIENT_PORT 9898
+
+/* On QEMU, a wait takes +10ms from the requested time. */
+#define FUZZ 10
+
+static int c_sock;
+static int s_sock;
+static struct sockaddr_in6 c_addr;
+static struct sockaddr_in6 s_addr;
+
+static void prepare_socks(void)
+{
+	int res;
+
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, CLIENT_PORT,
+			    &c_sock, &c_addr);
+	prepare_sock_udp_v6(CONFIG_NET_CONFIG_MY_IPV6_ADDR, SERVER_PORT,
+			    &s_sock, &s_addr);
+
+	res = bind(s_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "bind failed");
+
+	res = connect(c_sock, (struct sockaddr *)&s_addr, sizeof(s_addr));
+	zassert_equal(res, 0, "connect failed");
+}
+
+static void close_socks(void)
+{
+	zassert_equal(close(c_sock), 0, "close failed");
+	zassert_equal(close(s_sock), 0, "close failed");
+}
+
+static void epoll_add(int epfd, int fd, uint32_t events)
+{
+	struct epoll_event ev = {
+		.events = events,
+		.data.fd = fd,
+	};
+
+	zassert_equal(epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev), 0,
+		      "add failed (%d)", errno);
+}
+
+void test_epoll_ctl(void)
+{
+	struct epoll_event ev = { .events = EPOLLIN };
+	int epfd, fds[3];
+	int res, i;
+
+	prepare_socks();
+
+	zassert_equal(epoll_create(0), -1, "");
+	zassert_equal(errno, EINVAL, "");
+	zassert_equal(epoll_create1(1), -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	/* Only one instance is configured */
+	res = epoll_create1(0);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOMEM, "");
+
+	/* Not an epoll instance */
+	res = epoll_ctl(c_sock, EPOLL_CTL_ADD, s_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* Instance cannot be added to itself */
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, epfd, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	/* Not a valid descriptor */
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, CONFIG_POSIX_MAX_FDS - 1, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EBADF, "");
+
+	/* Edge triggered mode is not supported */
+	ev.events = EPOLLIN | EPOLLET;
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	ev.events = EPOLLIN;
+	res = epoll_ctl(epfd, 0, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOENT, "");
+
+	epoll_add(epfd, c_sock, EPOLLIN);
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, c_sock, &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EEXIST, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &ev);
+	zassert_equal(res, 0, "");
+
+	/* Fill the interest list */
+	for (i = 0; i < ARRAY_SIZE(fds); i++) {
+		fds[i] = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+		zassert_true(fds[i] >= 0, "socket open failed");
+	}
+
+	epoll_add(epfd, fds[0], EPOLLIN);
+	epoll_add(epfd, fds[1], EPOLLIN);
+
+	res = epoll_ctl(epfd, EPOLL_CTL_ADD, fds[2], &ev);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, ENOSPC, "");
+
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, fds[0], NULL);
+	zassert_equal(res, 0, "");
+
+	epoll_add(epfd, fds[2], EPOLLIN);
+
+	res = epoll_wait(epfd, &ev, 0, 0);
+	zassert_equal(res, -1, "");
+	zassert_equal(errno, EINVAL, "");
+
+	for (i = 0; i < ARRAY_SIZE(fds); i++) {
+		zassert_equal(close(fds[i]), 0, "close failed");
+	}
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	/* The instance can be created again after close */
+	epfd = epoll_create(1);
+	zassert_true(epfd >= 0, "epoll_create failed");
+	zassert_equal(close(epfd), 0, "close failed");
+
+	close_socks();
+}
+
+void test_epoll_wait(void)
+{
+	struct epoll_event events[2];
+	uint32_t tstamp;
+	ssize_t len;
+	char buf[10];
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	epoll_add(epfd, c_sock, EPOLLIN);
+	epoll_add(epfd, s_sock, EPOLLIN);
+
+	/* Wait for non-ready sockets with timeout of 0 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 0, "");
+
+	/* Wait for non-ready sockets with timeout of 30 */
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 0, "");
+
+	/* Send pkt for s_sock, only s_sock is reported */
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 30);
+	zassert_true(k_uptime_get_32() - tstamp <= FUZZ, "");
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLIN, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	/* Level triggered, reported again until the data is read */
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].data.fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	/* Writable socket does not wait */
+	events[0].events = EPOLLOUT;
+	events[0].data.fd = c_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &events[0]);
+	zassert_equal(res, 0, "");
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 200);
+	zassert_true(k_uptime_get_32() - tstamp < 100, "");
+	zassert_equal(res, 1, "");
+	zassert_equal(events[0].events, EPOLLOUT, "");
+	zassert_equal(events[0].data.fd, c_sock, "");
+
+	/* Removed socket is not reported */
+	res = epoll_ctl(epfd, EPOLL_CTL_DEL, c_sock, NULL);
+	zassert_equal(res, 0, "");
+
+	res = epoll_wait(epfd, events, ARRAY_SIZE(events), 0);
+	zassert_equal(res, 0, "");
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	close_socks();
+}
+
+void test_epoll_maxevents(void)
+{
+	struct epoll_event ev;
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	epoll_add(epfd, c_sock, EPOLLOUT);
+	epoll_add(epfd, s_sock, EPOLLOUT);
+
+	/* Both sockets are ready, they are reported in turns */
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.data.fd, c_sock, "");
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.data.fd, s_sock, "");
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.data.fd, c_sock, "");
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	close_socks();
+}
+
+void test_epoll_oneshot(void)
+{
+	struct epoll_event ev;
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	epoll_add(epfd, c_sock, EPOLLOUT | EPOLLONESHOT);
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.events, EPOLLOUT, "");
+
+	/* Disabled until modified */
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 0, "");
+
+	ev.events = EPOLLOUT | EPOLLONESHOT;
+	ev.data.fd = c_sock;
+	res = epoll_ctl(epfd, EPOLL_CTL_MOD, c_sock, &ev);
+	zassert_equal(res, 0, "");
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.data.fd, c_sock, "");
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	close_socks();
+}
+
+static int ctl_epfd;
+
+static void ctl_work_handler(struct k_work *work)
+{
+	struct epoll_event ev = {
+		.events = EPOLLOUT,
+		.data.fd = c_sock,
+	};
+
+	zassert_equal(epoll_ctl(ctl_epfd, EPOLL_CTL_ADD, c_sock, &ev), 0, "");
+}
+
+static K_WORK_DELAYABLE_DEFINE(ctl_work, ctl_work_handler);
+
+void test_epoll_ctl_while_waiting(void)
+{
+	struct epoll_event ev;
+	uint32_t tstamp;
+	int res;
+
+	prepare_socks();
+
+	ctl_epfd = epoll_create1(0);
+	zassert_true(ctl_epfd >= 0, "epoll_create1 failed");
+
+	epoll_add(ctl_epfd, s_sock, EPOLLIN);
+
+	/* Socket added from another thread is picked up by the wait */
+	k_work_schedule(&ctl_work, K_MSEC(30));
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(ctl_epfd, &ev, 1, 1000);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.events, EPOLLOUT, "");
+	zassert_equal(ev.data.fd, c_sock, "");
+
+	zassert_equal(close(ctl_epfd), 0, "close failed");
+
+	close_socks();
+}
+
+static void send_work_handler(struct k_work *work)
+{
+	ssize_t len;
+
+	len = send(c_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid send len");
+}
+
+static K_WORK_DELAYABLE_DEFINE(send_work, send_work_handler);
+
+void test_epoll_recv_while_waiting(void)
+{
+	struct epoll_event ev;
+	uint32_t tstamp;
+	ssize_t len;
+	char buf[10];
+	int epfd;
+	int res;
+
+	prepare_socks();
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	epoll_add(epfd, s_sock, EPOLLIN);
+
+	/* Socket signaled while waiting wakes up the wait */
+	k_work_schedule(&send_work, K_MSEC(30));
+
+	tstamp = k_uptime_get_32();
+	res = epoll_wait(epfd, &ev, 1, 1000);
+	tstamp = k_uptime_get_32() - tstamp;
+	zassert_true(tstamp >= 30U && tstamp <= 30 + FUZZ * 2, "tstamp %d",
+		     tstamp);
+	zassert_equal(res, 1, "");
+	zassert_equal(ev.events, EPOLLIN, "");
+	zassert_equal(ev.data.fd, s_sock, "");
+
+	len = recv(s_sock, BUF_AND_SIZE(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "invalid recv len");
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 0, "");
+
+	zassert_equal(close(epfd), 0, "close failed");
+
+	close_socks();
+}
+
+void test_epoll_close(void)
+{
+	struct epoll_event ev;
+	int epfd, fd;
+	int res;
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	fd = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(fd >= 0, "socket open failed");
+
+	epoll_add(epfd, fd, EPOLLIN);
+
+	/* Socket closed without removing it is not reported */
+	zassert_equal(close(fd), 0, "close failed");
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 0, "");
+
+	/* The descriptor reused by a new socket is not in the list */
+	res = socket(AF_INET6, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_equal(res, fd, "descriptor not reused");
+
+	epoll_add(epfd, fd, EPOLLIN);
+
+	res = epoll_wait(epfd, &ev, 1, 0);
+	zassert_equal(res, 0, "");
+
+	zassert_equal(close(fd), 0, "close failed");
+	zassert_equal(close(epfd), 0, "close failed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(socket_epoll,
+			 ztest_unit_test(test_epoll_ctl),
+			 ztest_unit_test(test_epoll_wait),
+			 ztest_unit_test(test_epoll_maxevents),
+			 ztest_unit_test(test_epoll_oneshot),
+			 ztest_unit_test(test_epoll_ctl_while_waiting),
+			 ztest_unit_test(test_epoll_recv_while_waiting),
+			 ztest_unit_test(test_epoll_close));
+
+	ztest_run_test_suite(socket_epoll);
+}
@@ -37,6 +37,7 @@ static void happy_path(
 	size_t actual_msg_len;
 	struct iovec iovec;
 	struct msghdr msghdr;
+	struct mmsghdr mmsghdr[2];
 
 	LOG_DBG("calling socketpair(%u, %u, %u, %p)", family, type, proto, sv);
 	res = socketpair(family, type, proto, sv);
@@ -154,6 +155,33 @@ static void happy_path(
 		zassert_true(strncmp(expected_msg, actual_msg,
 			actual_msg_len) == 0,
 			"the wrong message was passed through the socketpair");
+
+		/*
+		 * Test with sendmmsg(2) / recv(2) - sent with sendmsg(2)
+		 */
+
+		memset(mmsghdr, 0, sizeof(mmsghdr));
+		mmsghdr[0].msg_hdr = msghdr;
+		mmsghdr[1].msg_hdr = msghdr;
+
+		res = sendmmsg(sv[i], mmsghdr, ARRAY_SIZE(mmsghdr), 0);
+
+		zassert_equal(res, ARRAY_SIZE(mmsghdr),
+			      "sendmmsg(2) failed: %d", errno);
+		zassert_equal(mmsghdr[0].msg_len, expected_msg_len,
+			      "did not sendmmsg entire message");
+		zassert_equal(mmsghdr[1].msg_len, expected_msg_len,
+			      "did not sendmmsg entire message");
+
+		for (int j = 0; j < ARRAY_SIZE(mmsghdr); j++) {
+			res = read(sv[(!i) & 1], actual_msg, expected_msg_len);
+
+			zassert_equal(res, expected_msg_len,
+				      "read(2) failed: %d", errno);
+			zassert_true(strncmp(expected_msg, actual_msg,
+				expected_msg_len) == 0,
+				"the wrong message was passed through the socketpair");
+		}
 	}
 
 	res = close(sv[0]);
@@ -31,6 +31,17 @@ void test_socketpair_unsupported_calls(void)
 		.sun_family = AF_UNIX,
 	};
 	socklen_t len = sizeof(addr);
+	char buf[8];
+	struct iovec iovec = {
+		.iov_base = buf,
+		.iov_len = sizeof(buf),
+	};
+	struct mmsghdr mmsghdr = {
+		.msg_hdr = {
+			.msg_iov = &iovec,
+			.msg_iovlen = 1,
+		},
+	};
 
 	res = socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
 	zassert_equal(res, 0,
@@ -62,6 +73,12 @@ void test_socketpair_unsupported_calls(void)
 			"accept should fail on a socketpair endpoint");
 		zassert_equal(errno, EOPNOTSUPP,
 			"accept should set errno to EOPNOTSUPP");
+
+		res = recvmmsg(sv[i], &mmsghdr, 1, ZSOCK_MSG_DONTWAIT, NULL);
+		zassert_equal(res, -1,
+			"recvmmsg should fail on a socketpair endpoint");
+		zassert_equal(errno, EOPNOTSUPP,
+			"recvmmsg should set errno to EOPNOTSUPP");
 	}
 
 	res = close(sv[0]);
@@ -23,6 +23,9 @@ LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #define TCP_TEARDOWN_TIMEOUT K_SECONDS(1)
 #define THREAD_SLEEP 50 /* ms */
 
+/* TCP_NODELAY value of new sockets */
+#define TCP_NODELAY_DEFAULT (!IS_ENABLED(CONFIG_NET_TCP_NAGLE))
+
 static void test_bind(int sock, struct sockaddr *addr, socklen_t addrlen)
 {
 	zassert_equal(bind(sock, addr, addrlen),
@@ -877,6 +880,224 @@ void test_v6_msg_waitall(void)
 	test_close(c_sock);
 }
 
+static void test_connected_pair_v4(int *c_sock, int *s_sock, int *new_sock)
+{
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    s_sock, &s_saddr);
+
+	test_bind(*s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(*s_sock);
+
+	test_connect(*c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+
+	test_accept(*s_sock, new_sock, &addr, &addrlen);
+	zassert_equal(addrlen, sizeof(struct sockaddr_in), "Wrong addrlen");
+}
+
+void test_v4_nodelay_cork(void)
+{
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	int optval;
+	socklen_t optlen = sizeof(optval);
+	uint8_t rx_buf[2 * (sizeof(TEST_STR_SMALL) - 1)];
+	ssize_t ret;
+
+	test_connected_pair_v4(&c_sock, &s_sock, &new_sock);
+
+	ret = getsockopt(c_sock, IPPROTO_TCP, TCP_NODELAY, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optlen, sizeof(optval), "Invalid optlen");
+	zassert_equal(optval, TCP_NODELAY_DEFAULT, "Invalid TCP_NODELAY");
+
+	optval = !TCP_NODELAY_DEFAULT;
+	ret = setsockopt(c_sock, IPPROTO_TCP, TCP_NODELAY, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	optval = TCP_NODELAY_DEFAULT;
+	ret = getsockopt(c_sock, IPPROTO_TCP, TCP_NODELAY, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, !TCP_NODELAY_DEFAULT, "TCP_NODELAY not changed");
+
+	/* Partial segments are held back while the socket is corked */
+	optval = 1;
+	ret = setsockopt(c_sock, IPPROTO_TCP, TCP_CORK, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+	test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+
+	k_msleep(THREAD_SLEEP);
+
+	ret = recv(new_sock, rx_buf, sizeof(rx_buf), MSG_DONTWAIT);
+	zassert_equal(ret, -1, "Corked data was sent");
+	zassert_equal(errno, EAGAIN, "Unexpected errno (%d)", errno);
+
+	/* Removing the cork sends both writes in one segment */
+	optval = 0;
+	ret = setsockopt(c_sock, IPPROTO_TCP, TCP_CORK, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	k_msleep(THREAD_SLEEP);
+
+	ret = recv(new_sock, rx_buf, sizeof(rx_buf), MSG_DONTWAIT);
+	zassert_equal(ret, sizeof(rx_buf), "Invalid length received");
+	zassert_mem_equal(rx_buf, TEST_STR_SMALL TEST_STR_SMALL,
+			  sizeof(rx_buf), "Invalid data received");
+
+	/* Corked data is sent anyway after 200 ms */
+	optval = 1;
+	ret = setsockopt(c_sock, IPPROTO_TCP, TCP_CORK, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	test_send(c_sock, TEST_STR_SMALL, strlen(TEST_STR_SMALL), 0);
+
+	k_msleep(300);
+
+	test_recv(new_sock, MSG_DONTWAIT);
+
+	test_close(new_sock);
+	test_close(s_sock);
+	test_close(c_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+void test_v4_nodelay_cork_inherit(void)
+{
+	struct sockaddr_in c_saddr;
+	struct sockaddr_in s_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	int optval;
+	socklen_t optlen = sizeof(optval);
+	ssize_t ret;
+
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr);
+	prepare_sock_tcp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr);
+
+	/* Options set on the listening socket apply to accepted sockets */
+	optval = !TCP_NODELAY_DEFAULT;
+	ret = setsockopt(s_sock, IPPROTO_TCP, TCP_NODELAY, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	optval = 1;
+	ret = setsockopt(s_sock, IPPROTO_TCP, TCP_CORK, &optval,
+			 sizeof(optval));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	test_connect(c_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+	zassert_equal(addrlen, sizeof(struct sockaddr_in), "Wrong addrlen");
+
+	optval = TCP_NODELAY_DEFAULT;
+	ret = getsockopt(new_sock, IPPROTO_TCP, TCP_NODELAY, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, !TCP_NODELAY_DEFAULT, "TCP_NODELAY not inherited");
+
+	optval = 0;
+	ret = getsockopt(new_sock, IPPROTO_TCP, TCP_CORK, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, 1, "TCP_CORK not inherited");
+
+	/* The connecting socket keeps its own defaults */
+	ret = getsockopt(c_sock, IPPROTO_TCP, TCP_NODELAY, &optval, &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+	zassert_equal(optval, TCP_NODELAY_DEFAULT,
+		      "TCP_NODELAY changed on connecting socket");
+
+	test_close(new_sock);
+	test_close(s_sock);
+	test_close(c_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
+#define TEST_LARGE_LEN 4000
+#define TEST_LARGE_CHUNK 512
+
+static uint8_t tx_large[TEST_LARGE_LEN];
+static uint8_t rx_large[TEST_LARGE_LEN];
+
+void test_v4_send_recv_large(void)
+{
+	int c_sock;
+	int s_sock;
+	int new_sock;
+	size_t sent = 0;
+	size_t received = 0;
+	ssize_t ret;
+	int i;
+
+	for (i = 0; i < sizeof(tx_large); i++) {
+		tx_large[i] = (uint8_t)(i * 7);
+	}
+
+	memset(rx_large, 0, sizeof(rx_large));
+
+	test_connected_pair_v4(&c_sock, &s_sock, &new_sock);
+
+	/* The data is split into several segments and is acknowledged
+	 * piecewise while later segments are still queued for sending.
+	 */
+	for (i = 0; i < 100 && received < sizeof(rx_large); i++) {
+		if (sent < sizeof(tx_large)) {
+			ret = send(c_sock, tx_large + sent,
+				   MIN(TEST_LARGE_CHUNK, sizeof(tx_large) - sent),
+				   MSG_DONTWAIT);
+			if (ret > 0) {
+				sent += ret;
+			} else {
+				/* Running out of buffers is only temporary */
+				zassert_true(errno == EAGAIN || errno == ENOBUFS,
+					     "send failed (%d)", errno);
+			}
+		}
+
+		k_msleep(10);
+
+		ret = recv(new_sock, rx_large + received,
+			   sizeof(rx_large) - received, MSG_DONTWAIT);
+		if (ret > 0) {
+			received += ret;
+		} else {
+			zassert_equal(errno, EAGAIN, "recv failed (%d)", errno);
+		}
+	}
+
+	zassert_equal(received, sizeof(rx_large), "Not all data received");
+	zassert_mem_equal(rx_large, tx_large, sizeof(rx_large),
+			  "Invalid data received");
+
+	test_close(new_sock);
+	test_close(s_sock);
+	test_close(c_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 #ifdef CONFIG_USERSPACE
 #define CHILD_STACK_SZ		(2048 + CONFIG_TEST_EXTRA_STACKSIZE)
 struct k_thread child_thread;
@@ -969,6 +1190,9 @@ void test_main(void)
 		ztest_unit_test(test_v6_so_rcvtimeo),
 		ztest_unit_test(test_v4_msg_waitall),
 		ztest_unit_test(test_v6_msg_waitall),
+		ztest_unit_test(test_v4_nodelay_cork),
+		ztest_unit_test(test_v4_nodelay_cork_inherit),
+		ztest_unit_test(test_v4_send_recv_large),
 		ztest_user_unit_test(test_socket_permission)
 		);
 
@@ -1212,6 +1212,160 @@ void test_v6_msg_trunc(void)
 		       (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+static ZTEST_BMEM char rx_mbuf[2][16];
+
+void test_v4_sendmmsg_recvmmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr[3];
+	struct mmsghdr msgs[3];
+	struct iovec tx_iov[3];
+	struct iovec rx_iov[4];
+	int i;
+
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &client_sock, &client_addr);
+	prepare_sock_udp_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &server_sock, &server_addr);
+
+	rv = bind(server_sock,
+		  (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "server bind failed");
+
+	rv = bind(client_sock,
+		  (struct sockaddr *)&client_addr,
+		  sizeof(client_addr));
+	zassert_equal(rv, 0, "client bind failed");
+
+	tx_iov[0].iov_base = TEST_STR_SMALL;
+	tx_iov[0].iov_len = STRLEN(TEST_STR_SMALL);
+	tx_iov[1].iov_base = TEST_STR2;
+	tx_iov[1].iov_len = STRLEN(TEST_STR2);
+	tx_iov[2].iov_base = TEST_STR2;
+	tx_iov[2].iov_len = STRLEN(TEST_STR2);
+
+	memset(msgs, 0, sizeof(msgs));
+
+	for (i = 0; i < ARRAY_SIZE(msgs); i++) {
+		msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+		msgs[i].msg_hdr.msg_name = &server_addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+	}
+
+	rv = sendmmsg(client_sock, msgs, ARRAY_SIZE(msgs), 0);
+	zassert_equal(rv, ARRAY_SIZE(msgs), "sendmmsg failed");
+
+	for (i = 0; i < ARRAY_SIZE(msgs); i++) {
+		zassert_equal(msgs[i].msg_len, tx_iov[i].iov_len,
+			      "unexpected sent length");
+	}
+
+	/* Let the datagrams reach the server socket */
+	k_msleep(100);
+
+	/* 1st datagram to a single buffer, 2nd one scattered to two buffers
+	 * and 3rd one truncated.
+	 */
+	clear_buf(rx_buf);
+	rx_iov[0].iov_base = rx_mbuf[0];
+	rx_iov[0].iov_len = sizeof(rx_mbuf[0]);
+	rx_iov[1].iov_base = rx_buf;
+	rx_iov[1].iov_len = 100;
+	rx_iov[2].iov_base = rx_buf + 100;
+	rx_iov[2].iov_len = sizeof(rx_buf) - 100;
+	rx_iov[3].iov_base = rx_mbuf[1];
+	rx_iov[3].iov_len = sizeof(rx_mbuf[1]);
+
+	memset(msgs, 0, sizeof(msgs));
+	memset(addr, 0, sizeof(addr));
+
+	msgs[0].msg_hdr.msg_iov = &rx_iov[0];
+	msgs[0].msg_hdr.msg_iovlen = 1;
+	msgs[1].msg_hdr.msg_iov = &rx_iov[1];
+	msgs[1].msg_hdr.msg_iovlen = 2;
+	msgs[2].msg_hdr.msg_iov = &rx_iov[3];
+	msgs[2].msg_hdr.msg_iovlen = 1;
+
+	for (i = 0; i < ARRAY_SIZE(msgs); i++) {
+		msgs[i].msg_hdr.msg_name = &addr[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+	}
+
+	rv = recvmmsg(server_sock, msgs, ARRAY_SIZE(msgs), 0, NULL);
+	zassert_equal(rv, ARRAY_SIZE(msgs), "recvmmsg failed");
+
+	zassert_equal(msgs[0].msg_len, STRLEN(TEST_STR_SMALL),
+		      "unexpected received bytes");
+	zassert_mem_equal(rx_mbuf[0], BUF_AND_SIZE(TEST_STR_SMALL),
+			  "wrong data");
+	zassert_equal(msgs[0].msg_hdr.msg_flags, 0, "unexpected flags");
+
+	zassert_equal(msgs[1].msg_len, STRLEN(TEST_STR2),
+		      "unexpected received bytes");
+	zassert_mem_equal(rx_buf, BUF_AND_SIZE(TEST_STR2), "wrong data");
+	zassert_equal(msgs[1].msg_hdr.msg_flags, 0, "unexpected flags");
+
+	zassert_equal(msgs[2].msg_len, sizeof(rx_mbuf[1]),
+		      "unexpected received bytes");
+	zassert_mem_equal(rx_mbuf[1], TEST_STR2, sizeof(rx_mbuf[1]),
+			  "wrong data");
+	zassert_equal(msgs[2].msg_hdr.msg_flags, MSG_TRUNC,
+		      "truncation not reported");
+
+	for (i = 0; i < ARRAY_SIZE(msgs); i++) {
+		zassert_equal(msgs[i].msg_hdr.msg_namelen, sizeof(addr[i]),
+			      "unexpected addrlen");
+		zassert_equal(addr[i].sin_port, addr[0].sin_port,
+			      "unexpected client port");
+	}
+
+	/* Nothing left in the queue */
+	rv = recvmmsg(server_sock, msgs, ARRAY_SIZE(msgs), MSG_DONTWAIT,
+		      NULL);
+	zassert_equal(rv, -1, "recvmmsg should have failed");
+	zassert_equal(errno, EAGAIN, "incorrect errno value");
+
+	/* A failure after the first message is not reported, and leaves
+	 * errno untouched
+	 */
+	memset(msgs, 0, sizeof(msgs));
+	msgs[0].msg_hdr.msg_iov = &tx_iov[0];
+	msgs[0].msg_hdr.msg_iovlen = 1;
+	msgs[0].msg_hdr.msg_name = &server_addr;
+	msgs[0].msg_hdr.msg_namelen = sizeof(server_addr);
+	msgs[1].msg_hdr.msg_iov = &tx_iov[1];
+	msgs[1].msg_hdr.msg_iovlen = 1;
+
+	errno = 0;
+	rv = sendmmsg(client_sock, msgs, 2, 0);
+	zassert_equal(rv, 1, "sendmmsg should have sent one message");
+	zassert_equal(errno, 0, "errno set on success");
+
+	k_msleep(100);
+
+	memset(msgs, 0, sizeof(msgs));
+	msgs[0].msg_hdr.msg_iov = &rx_iov[0];
+	msgs[0].msg_hdr.msg_iovlen = 1;
+	msgs[1].msg_hdr.msg_iov = &rx_iov[3];
+	msgs[1].msg_hdr.msg_iovlen = 1;
+
+	errno = 0;
+	rv = recvmmsg(server_sock, msgs, 2, 0, NULL);
+	zassert_equal(rv, 1, "recvmmsg should have received one message");
+	zassert_equal(errno, 0, "errno set on success");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	k_thread_system_pool_assign(k_current_get());
@@ -1242,7 +1396,9 @@ void test_main(void)
 			 ztest_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_user_unit_test(test_v6_sendmsg_with_txtime),
 			 ztest_unit_test(test_v4_msg_trunc),
-			 ztest_unit_test(test_v6_msg_trunc)
+			 ztest_unit_test(test_v6_msg_trunc),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg),
+			 ztest_user_unit_test(test_v4_sendmmsg_recvmmsg)
 		);
 
 	ztest_run_test_suite(socket_udp);
@@ -125,6 +125,9 @@ static void handle_syn_resend(void);
 static void handle_client_fin_wait_2_test(sa_family_t af, struct tcphdr *th);
 static void handle_client_closing_test(sa_family_t af, struct tcphdr *th);
 static void handle_server_recv_out_of_order(struct net_pkt *pkt);
+static void handle_server_sack_test(struct net_pkt *pkt);
+static void handle_sack_retransmit(struct net_pkt *pkt);
+static void handle_sack_full_segment(struct net_pkt *pkt);
 
 static void verify_flags(struct tcphdr *th, uint8_t flags,
 			 const char *fun, int line)
@@ -213,6 +216,13 @@ static uint8_t tcp_options[20] = {
 	0x01, /* NOP */
 	0x03, 0x03, 0x07 /* Win scale*/ };
 
+/* SACK block sent with the ACKs when sack_options_len is set */
+static uint8_t sack_options[12] = {
+	0x01, 0x01, /* NOP */
+	0x05, 0x0a, /* SACK, one block */
+};
+static size_t sack_options_len;
+
 static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 					      uint16_t src_port,
 					      uint16_t dst_port,
@@ -223,11 +233,16 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	NET_PKT_DATA_ACCESS_DEFINE(tcp_access, struct tcphdr);
 	struct net_pkt *pkt;
 	struct tcphdr *th;
+	const uint8_t *opts = NULL;
 	uint8_t opts_len = 0;
 	int ret = -EINVAL;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if ((test_case_no == 4U || test_case_no == 10U) && (flags & SYN)) {
+		opts = tcp_options;
 		opts_len = sizeof(tcp_options);
+	} else if (sack_options_len && !(flags & SYN)) {
+		opts = sack_options;
+		opts_len = sack_options_len;
 	}
 
 	/* Allocate buffer */
@@ -262,11 +277,7 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 	th->th_sport = src_port;
 	th->th_dport = dst_port;
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
-		th->th_off = 10U;
-	} else {
-		th->th_off = 5U;
-	}
+	th->th_off = 5U + opts_len / 4U;
 
 	th->th_flags = flags;
 	th->th_win = NET_IPV6_MTU;
@@ -281,9 +292,9 @@ static struct net_pkt *tester_prepare_tcp_pkt(sa_family_t af,
 		goto fail;
 	}
 
-	if ((test_case_no == 4U) && (flags & SYN)) {
+	if (opts_len) {
 		/* Add TCP Options */
-		ret = net_pkt_write(pkt, tcp_options, opts_len);
+		ret = net_pkt_write(pkt, opts, opts_len);
 		if (ret < 0) {
 			goto fail;
 		}
@@ -420,6 +431,15 @@ static int tester_send(const struct device *dev, struct net_pkt *pkt)
 	case 9:
 		handle_server_recv_out_of_order(pkt);
 		break;
+	case 10:
+		handle_server_sack_test(pkt);
+		break;
+	case 11:
+		handle_sack_retransmit(pkt);
+		break;
+	case 12:
+		handle_sack_full_segment(pkt);
+		break;
 	default:
 		zassert_true(false, "Undefined test case");
 	}
@@ -696,6 +716,8 @@ static void test_server_timeout(struct k_work *work)
 		handle_server_test(AF_INET, NULL);
 	} else if (test_case_no == 5) {
 		handle_server_test(AF_INET6, NULL);
+	} else if (test_case_no == 10) {
+		handle_server_sack_test(NULL);
 	} else {
 		zassert_true(false, "Invalid test case");
 	}
@@ -713,6 +735,8 @@ static void test_tcp_recv_cb(struct net_context *context,
 	}
 }
 
+static struct net_context *accepted_ctx;
+
 static void test_tcp_accept_cb(struct net_context *ctx,
 			       struct sockaddr *addr,
 			       socklen_t addrlen,
@@ -725,6 +749,7 @@ static void test_tcp_accept_cb(struct net_context *ctx,
 
 	/* set callback on newly created context */
 	ctx->recv_cb = test_tcp_recv_cb;
+	accepted_ctx = ctx;
 
 	test_sem_give();
 }
@@ -1315,7 +1340,7 @@ static void test_client_invalid_rst(void)
 {
 	struct net_context *ctx;
 	struct tcp *conn;
-	uint16_t wnd;
+	uint32_t wnd;
 
 	ctx = create_server_socket(0, 0);
 
@@ -1484,6 +1509,433 @@ static void test_server_timeout_out_of_order_data(void)
 	net_tcp_put(ooo_ctx);
 }
 
+struct test_tcp_options {
+	int wnd_shift; /* -1 if the option is not present */
+	bool sack_perm;
+	int sack_count;
+	uint32_t sack_left;
+	uint32_t sack_right;
+};
+
+static int read_tcp_options(struct net_pkt *pkt, struct tcphdr *th,
+			    struct test_tcp_options *opts)
+{
+	int len = (th->th_off - 5) * 4;
+	uint8_t buf[40];
+	int i, ret;
+
+	memset(opts, 0, sizeof(*opts));
+	opts->wnd_shift = -1;
+
+	if (len == 0) {
+		return 0;
+	}
+
+	net_pkt_cursor_init(pkt);
+	net_pkt_set_overwrite(pkt, true);
+
+	ret = net_pkt_skip(pkt, net_pkt_ip_hdr_len(pkt) +
+			   net_pkt_ip_opts_len(pkt) + sizeof(struct tcphdr));
+	if (ret < 0) {
+		return ret;
+	}
+
+	ret = net_pkt_read(pkt, buf, len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	for (i = 0; i < len && buf[i] != 0; ) {
+		if (buf[i] == 1) {
+			i++;
+			continue;
+		}
+
+		if (buf[i] == 3) {
+			opts->wnd_shift = buf[i + 2];
+		} else if (buf[i] == 4) {
+			opts->sack_perm = true;
+		} else if (buf[i] == 5) {
+			opts->sack_count = (buf[i + 1] - 2) / 8;
+			opts->sack_left = sys_get_be32(&buf[i + 2]);
+			opts->sack_right = sys_get_be32(&buf[i + 6]);
+		}
+
+		i += buf[i + 1];
+	}
+
+	return 0;
+}
+
+static uint8_t sack_wnd_shift;
+
+static void handle_server_sack_test(struct net_pkt *pkt)
+{
+	struct test_tcp_options opts;
+	struct net_pkt *reply;
+	struct tcphdr th;
+	struct tcp *conn;
+	int ret;
+
+	if (pkt && (read_tcp_header(pkt, &th) < 0 ||
+		    read_tcp_options(pkt, &th, &opts) < 0)) {
+		goto fail;
+	}
+
+	switch (t_state) {
+	case T_SYN:
+		reply = prepare_syn_packet(AF_INET, htons(MY_PORT),
+					   htons(PEER_PORT));
+		t_state = T_SYN_ACK;
+		break;
+	case T_SYN_ACK:
+		test_verify_flags(&th, SYN | ACK);
+		zassert_true(opts.sack_perm, "SACK permitted option missing");
+		if (IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE)) {
+			zassert_true(opts.wnd_shift >= 0,
+				     "Window scale option missing");
+			sack_wnd_shift = opts.wnd_shift;
+		}
+		seq++;
+		ack = ntohl(th.th_seq) + 1U;
+		reply = prepare_ack_packet(AF_INET, htons(MY_PORT),
+					   htons(PEER_PORT));
+		t_state = T_DATA;
+		break;
+	case T_DATA:
+		/* The out-of-order data sent at seq is reported in a SACK
+		 * block
+		 */
+		test_verify_flags(&th, ACK);
+		conn = accepted_ctx->tcp;
+		zassert_equal(ntohs(th.th_win) << sack_wnd_shift,
+			      conn->recv_win, "Invalid scaled window %u",
+			      ntohs(th.th_win));
+		zassert_equal(ntohl(th.th_ack), seq - 10, "Invalid ACK");
+		zassert_equal(opts.sack_count, 1, "SACK block missing");
+		zassert_equal(opts.sack_left, seq, "Invalid SACK block");
+		zassert_equal(opts.sack_right, seq + 10, "Invalid SACK block");
+		t_state = T_DATA_ACK;
+		test_sem_give();
+		return;
+	case T_DATA_ACK:
+		/* The queued data is acknowledged once the hole is filled */
+		test_verify_flags(&th, ACK);
+		zassert_equal(ntohl(th.th_ack), seq + 20, "Invalid ACK");
+		zassert_equal(opts.sack_count, 0, "Unexpected SACK block");
+		t_state = T_FIN;
+		test_sem_give();
+		return;
+	default:
+		return;
+	}
+
+	ret = net_recv_data(iface, reply);
+	if (ret < 0) {
+		goto fail;
+	}
+
+	return;
+fail:
+	zassert_true(false, "%s failed", __func__);
+}
+
+static struct net_context *create_sack_server_socket(void)
+{
+	struct net_context *ctx;
+	int ret;
+
+	t_state = T_SYN;
+	test_case_no = 10;
+	seq = ack = 0;
+
+	ret = net_context_get(AF_INET, SOCK_STREAM, IPPROTO_TCP, &ctx);
+	if (ret < 0) {
+		zassert_true(false, "Failed to get net_context");
+	}
+
+	ret = net_context_bind(ctx, (struct sockaddr *)&my_addr_s,
+			       sizeof(struct sockaddr_in));
+	if (ret < 0) {
+		zassert_true(false, "Failed to bind net_context");
+	}
+
+	ret = net_context_listen(ctx, 1);
+	if (ret < 0) {
+		zassert_true(false, "Failed to listen on net_context");
+	}
+
+	/* Trigger the peer to send SYN with the SACK permitted option */
+	k_work_reschedule(&test_server, K_NO_WAIT);
+
+	ret = net_context_accept(ctx, test_tcp_accept_cb, K_FOREVER, NULL);
+	if (ret < 0) {
+		zassert_true(false, "Failed to set accept on net_context");
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	return ctx;
+}
+
+static void close_sack_server_socket(struct net_context *ctx)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	/* Reset the accepted connection so that the ports can be reused */
+	pkt = prepare_rst_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	k_msleep(10);
+
+	net_context_put(ctx);
+}
+
+/* Test case scenario IPv4
+ *   send SYN with SACK permitted option,
+ *   expect SYN ACK with SACK permitted option,
+ *   send out-of-order DATA,
+ *   expect ACK with SACK block,
+ *   send missing DATA,
+ *   expect ACK of all the data.
+ *   any failures cause test case to fail.
+ */
+static void test_server_sack_ipv4(void)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_SACK) ||
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT == 0) {
+		return;
+	}
+
+	ctx = create_sack_server_socket();
+
+	seq += 10;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT),
+				  lorem_ipsum + 10, 10);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	seq -= 10;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT),
+				  lorem_ipsum, 10);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	seq += 20;
+	close_sack_server_socket(ctx);
+}
+
+#define SACK_SEGMENTS 3
+static uint32_t sack_data_seq;
+static int sack_data_count;
+
+static void handle_sack_retransmit(struct net_pkt *pkt)
+{
+	struct tcphdr th;
+	size_t len;
+
+	if (read_tcp_header(pkt, &th) < 0) {
+		zassert_true(false, "%s failed", __func__);
+		return;
+	}
+
+	len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+	      net_pkt_ip_opts_len(pkt) - th.th_off * 4U;
+	if (len == 0) {
+		return;
+	}
+
+	if (sack_data_count == 0) {
+		sack_data_seq = ntohl(th.th_seq);
+	} else if (sack_data_count >= SACK_SEGMENTS) {
+		zassert_equal(ntohl(th.th_seq), sack_data_seq,
+			      "Wrong segment retransmitted");
+	}
+
+	if (++sack_data_count >= SACK_SEGMENTS) {
+		test_sem_give();
+	}
+}
+
+/* Test case scenario IPv4
+ *   send SYN with SACK permitted option,
+ *   expect SYN ACK with SACK permitted option,
+ *   expect three DATA segments,
+ *   send three duplicate ACKs with the last two segments SACKed,
+ *   expect the first segment to be resent before the retransmission
+ *   timeout.
+ *   any failures cause test case to fail.
+ */
+static void test_server_sack_fast_retransmit_ipv4(void)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	struct tcp *conn;
+	int ret, i;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_SACK)) {
+		return;
+	}
+
+	ctx = create_sack_server_socket();
+
+	conn = accepted_ctx->tcp;
+	conn->tcp_nodelay = true;
+
+	test_case_no = 11;
+	sack_data_count = 0;
+
+	for (i = 0; i < SACK_SEGMENTS; i++) {
+		ret = net_context_send(accepted_ctx, lorem_ipsum + i, 1, NULL,
+				       K_NO_WAIT, NULL);
+		zassert_equal(ret, 1, "Failed to send data to peer (%d)", ret);
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	/* The first segment is lost, the others are acknowledged */
+	ack = sack_data_seq;
+	sys_put_be32(sack_data_seq + 1, &sack_options[4]);
+	sys_put_be32(sack_data_seq + SACK_SEGMENTS, &sack_options[8]);
+	sack_options_len = sizeof(sack_options);
+
+	for (i = 0; i < TCP_DUP_ACK_THRESHOLD; i++) {
+		pkt = prepare_ack_packet(AF_INET, htons(MY_PORT),
+					 htons(PEER_PORT));
+		zassert_not_null(pkt, "Cannot create pkt");
+
+		ret = net_recv_data(iface, pkt);
+		zassert_true(ret == 0, "recv data failed (%d)", ret);
+	}
+
+	test_sem_take(K_MSEC(CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT / 2),
+		      __LINE__);
+
+	sack_options_len = 0;
+	ack = sack_data_seq + SACK_SEGMENTS;
+	pkt = prepare_ack_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT));
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	k_msleep(10);
+
+	zassert_equal(conn->send_data_total, 0, "Data not acknowledged");
+
+	close_sack_server_socket(ctx);
+}
+
+/* More than one segment, but within the window of the peer */
+#define SACK_FULL_SEGMENT_DATA 1000
+static int sack_full_segment_count;
+
+static void handle_sack_full_segment(struct net_pkt *pkt)
+{
+	struct test_tcp_options opts;
+	struct tcp *conn = accepted_ctx->tcp;
+	struct tcphdr th;
+	size_t opts_len;
+	size_t len;
+	int max_len;
+
+	if (read_tcp_header(pkt, &th) < 0 ||
+	    read_tcp_options(pkt, &th, &opts) < 0) {
+		zassert_true(false, "%s failed", __func__);
+		return;
+	}
+
+	opts_len = th.th_off * 4U - sizeof(struct tcphdr);
+	len = net_pkt_get_len(pkt) - net_pkt_ip_hdr_len(pkt) -
+	      net_pkt_ip_opts_len(pkt) - th.th_off * 4U;
+	if (len == 0) {
+		return;
+	}
+
+	/* The SACK block takes room from the data, not from the MTU */
+	max_len = MIN(conn_mss(conn),
+		      MAX(net_if_get_mtu(conn->iface), NET_IPV4_MTU) -
+		      NET_IPV4TCPH_LEN);
+
+	zassert_equal(opts.sack_count, 1, "SACK block missing");
+	zassert_true(len + opts_len <= max_len,
+		     "Segment too large (%zu data, %zu options)", len,
+		     opts_len);
+
+	if (sack_full_segment_count++ == 0) {
+		zassert_equal(len + opts_len, max_len, "Segment not full");
+		test_sem_give();
+	}
+}
+
+/* Test case scenario IPv4
+ *   send SYN with SACK permitted option,
+ *   expect SYN ACK with SACK permitted option,
+ *   send out-of-order DATA,
+ *   expect ACK with SACK block,
+ *   send more data than fits in one segment,
+ *   expect full-size DATA segments carrying the SACK block within the MSS.
+ *   any failures cause test case to fail.
+ */
+static void test_server_sack_full_segment_ipv4(void)
+{
+	struct net_context *ctx;
+	struct net_pkt *pkt;
+	size_t sent;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_SACK) ||
+	    CONFIG_NET_TCP_RECV_QUEUE_TIMEOUT == 0) {
+		return;
+	}
+
+	ctx = create_sack_server_socket();
+
+	seq += 10;
+	pkt = prepare_data_packet(AF_INET, htons(MY_PORT), htons(PEER_PORT),
+				  lorem_ipsum + 10, 10);
+	zassert_not_null(pkt, "Cannot create pkt");
+
+	ret = net_recv_data(iface, pkt);
+	zassert_true(ret == 0, "recv data failed (%d)", ret);
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	test_case_no = 12;
+	sack_full_segment_count = 0;
+
+	/* Each call queues at most what fits in one packet */
+	for (sent = 0; sent < SACK_FULL_SEGMENT_DATA; sent += ret) {
+		ret = net_context_send(accepted_ctx, lorem_ipsum + sent,
+				       SACK_FULL_SEGMENT_DATA - sent, NULL,
+				       K_NO_WAIT, NULL);
+		zassert_true(ret > 0, "Failed to send data to peer (%d)", ret);
+	}
+
+	test_sem_take(K_MSEC(100), __LINE__);
+
+	seq -= 10;
+	close_sack_server_socket(ctx);
+}
+
 /** Test case main entry */
 void test_main(void)
 {
@@ -1499,7 +1951,10 @@ void test_main(void)
 			 ztest_unit_test(test_client_closing_ipv6),
 			 ztest_unit_test(test_client_invalid_rst),
 			 ztest_unit_test(test_server_recv_out_of_order_data),
-			 ztest_unit_test(test_server_timeout_out_of_order_data)
+			 ztest_unit_test(test_server_timeout_out_of_order_data),
+			 ztest_unit_test(test_server_sack_ipv4),
+			 ztest_unit_test(test_server_sack_fast_retransmit_ipv4),
+			 ztest_unit_test(test_server_sack_full_segment_ipv4)
 			 );
 
 	ztest_run_test_suite(test_tcp_fn);
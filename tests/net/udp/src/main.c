@@ -49,6 +49,7 @@ LOG_MODULE_REGISTER(net_test, NET_LOG_LEVEL);
 #endif
 #include "net_private.h"
 #include "ipv4.h"
+#include "net_stats.h"
 
 static bool test_failed;
 static bool fail = true;
@@ -671,9 +672,157 @@ void test_udp(void)
 	zassert_false(test_failed, "udp tests failed");
 }
 
+static struct net_conn_handle *conn_register(sa_family_t family,
+					     struct sockaddr_in *raddr,
+					     struct sockaddr_in *laddr,
+					     uint16_t rport, uint16_t lport,
+					     struct ud *ud, char *test)
+{
+	struct net_conn_handle *handle;
+	int ret;
+
+	ud->test = test;
+
+	ret = net_udp_register(family, (struct sockaddr *)raddr,
+			       (struct sockaddr *)laddr, rport, lport,
+			       NULL, test_ok, ud, &handle);
+	zassert_equal(ret, 0, "UDP register %s failed (%d)", test, ret);
+
+	return handle;
+}
+
+static void conn_unregister(struct net_conn_handle *handle)
+{
+	zassert_equal(net_udp_unregister(handle), 0, "UDP unregister failed");
+}
+
+/* The handlers of a port share a hash bucket with CONFIG_NET_CONN_HASH, the
+ * handler of a connected socket must still win over a listener.
+ */
+static void check_conn_specific(struct net_if *iface, bool specific_first)
+{
+	struct in_addr in4addr_my = { { { 192, 0, 2, 1 } } };
+	struct in_addr in4addr_peer = { { { 192, 0, 2, 9 } } };
+	struct sockaddr_in my_addr4 = { .sin_family = AF_INET };
+	struct sockaddr_in peer_addr4 = { .sin_family = AF_INET };
+	static struct ud listener_ud, specific_ud;
+	struct net_conn_handle *listener, *specific;
+
+	net_ipaddr_copy(&my_addr4.sin_addr, &in4addr_my);
+	net_ipaddr_copy(&peer_addr4.sin_addr, &in4addr_peer);
+
+	if (specific_first) {
+		specific = conn_register(AF_INET, &peer_addr4, &my_addr4,
+					 1234, 5000, &specific_ud, "specific");
+		listener = conn_register(AF_INET, NULL, NULL, 0, 5000,
+					 &listener_ud, "listener");
+	} else {
+		listener = conn_register(AF_INET, NULL, NULL, 0, 5000,
+					 &listener_ud, "listener");
+		specific = conn_register(AF_INET, &peer_addr4, &my_addr4,
+					 1234, 5000, &specific_ud, "specific");
+	}
+
+	zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my,
+				       1234, 5000, &specific_ud, false),
+		     "Specific handler not matched");
+	zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my,
+				       1235, 5000, &listener_ud, false),
+		     "Listener not matched");
+
+	conn_unregister(specific);
+	conn_unregister(listener);
+}
+
+/* Among handlers of the same rank, the most recently registered one wins */
+static void check_conn_order(struct net_if *iface, uint16_t lport)
+{
+	struct in_addr in4addr_my = { { { 192, 0, 2, 1 } } };
+	struct in_addr in4addr_peer = { { { 192, 0, 2, 9 } } };
+	static struct ud first_ud, second_ud;
+	struct net_conn_handle *first, *second;
+
+	first = conn_register(AF_INET, NULL, NULL, 0, lport, &first_ud,
+			      "first");
+	second = conn_register(AF_UNSPEC, NULL, NULL, 0, lport, &second_ud,
+			       "second");
+
+	zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my,
+				       1234, 5001, &second_ud, false),
+		     "Last registered handler not matched");
+
+	conn_unregister(second);
+
+	zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer, &in4addr_my,
+				       1234, 5001, &first_ud, false),
+		     "Remaining handler not matched");
+
+	conn_unregister(first);
+}
+
+void test_udp_conn_lookup(void)
+{
+	struct net_if *iface;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	check_conn_specific(iface, true);
+	check_conn_specific(iface, false);
+
+	/* Handlers of a hashed local port, then of any local port */
+	check_conn_order(iface, 5001);
+	check_conn_order(iface, 0);
+
+	zassert_false(fail, "Tests failed");
+}
+
+void test_udp_conn_stats(void)
+{
+#if defined(CONFIG_NET_STATISTICS_CONN)
+	struct in_addr in4addr_my = { { { 192, 0, 2, 1 } } };
+	struct in_addr in4addr_peer = { { { 192, 0, 2, 9 } } };
+	/* One port more than buckets, so that two of them share a bucket */
+	static struct ud ud[CONFIG_NET_CONN_HASH_BUCKETS + 1];
+	struct net_conn_handle *handles[ARRAY_SIZE(ud)];
+	net_stats_t lookups, collisions;
+	struct net_if *iface;
+	int i;
+
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+
+	for (i = 0; i < ARRAY_SIZE(ud); i++) {
+		handles[i] = conn_register(AF_INET, NULL, NULL, 0, 6000 + i,
+					   &ud[i], "port");
+	}
+
+	lookups = net_stats.conn.lookups;
+	collisions = net_stats.conn.collisions;
+
+	for (i = 0; i < ARRAY_SIZE(ud); i++) {
+		zassert_true(send_ipv4_udp_msg(iface, &in4addr_peer,
+					       &in4addr_my, 1234, 6000 + i,
+					       &ud[i], false),
+			     "Handler of port %d not matched", 6000 + i);
+	}
+
+	zassert_equal(net_stats.conn.lookups - lookups, ARRAY_SIZE(ud),
+		      "Wrong number of lookups");
+	zassert_true(net_stats.conn.collisions != collisions,
+		     "No collision counted");
+
+	for (i = 0; i < ARRAY_SIZE(ud); i++) {
+		conn_unregister(handles[i]);
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_udp_fn,
-		ztest_unit_test(test_udp));
+		ztest_unit_test(test_udp),
+		ztest_unit_test(test_udp_conn_lookup),
+		ztest_unit_test(test_udp_conn_stats));
 	ztest_run_test_suite(test_udp_fn);
 }
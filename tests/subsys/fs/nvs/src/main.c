@@ -39,8 +39,8 @@ void setup(void)
 	sim_stats = stats_group_find("flash_sim_stats");
 	sim_thresholds = stats_group_find("flash_sim_thresholds");
 
-	/* Verify if NVS is initialized. */
-	if (fs.sector_count != 0) {
+	/* Verify if NVS is initialized. A skipped test leaves it cleared. */
+	if (fs.ready) {
 		int err;
 
 		err = nvs_clear(&fs);
@@ -706,6 +706,236 @@ void test_nvs_gc_corrupt_ate(void)
 	zassert_true(err == 0,  "nvs_init call failure: %d", err);
 }
 
+struct walk_result {
+	uint16_t calls;
+	uint16_t len[4];
+	uint32_t data[4];
+};
+
+static int walk_cb(struct nvs_fs *fs, const struct nvs_entry *entry,
+		   void *param)
+{
+	struct walk_result *res = param;
+	uint16_t idx = entry->id - TEST_DATA_ID;
+	ssize_t len;
+
+	zassert_true(idx < ARRAY_SIZE(res->len), "id %u out of range",
+		     entry->id);
+
+	res->calls++;
+	res->len[idx] = entry->len;
+	if (entry->len) {
+		len = nvs_entry_read(fs, entry, &res->data[idx],
+				     sizeof(res->data[idx]));
+		zassert_equal(len, sizeof(res->data[idx]),
+			      "nvs_entry_read unexpected failure: %d", len);
+	}
+
+	return 0;
+}
+
+/*
+ * Test that nvs_walk() reports only the most recent entry of every id in the
+ * requested range, including deleted ones.
+ */
+void test_nvs_walk(void)
+{
+	int err;
+	ssize_t len;
+	uint32_t data, gen;
+	uint32_t seen[NVS_WALK_BITMAP_SIZE(3)];
+	struct walk_result res = { 0 };
+
+	fs.sector_count = 3;
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* id TEST_DATA_ID + 3 is outside of the walked range */
+	for (data = 0; data < 40; data++) {
+		len = nvs_write(&fs, TEST_DATA_ID + (data % 4), &data,
+				sizeof(data));
+		zassert_equal(len, sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	err = nvs_delete(&fs, TEST_DATA_ID + 1);
+	zassert_true(err == 0,  "nvs_delete call failure: %d", err);
+
+	err = nvs_walk(&fs, TEST_DATA_ID, 3, seen, walk_cb, &res);
+	zassert_true(err == 0,  "nvs_walk call failure: %d", err);
+
+	zassert_equal(res.calls, 3, "unexpected number of reported entries");
+	zassert_equal(res.len[0], sizeof(data), "wrong length");
+	zassert_equal(res.data[0], 36, "not the most recent entry");
+	zassert_equal(res.len[1], 0, "deleted entry not reported");
+	zassert_equal(res.len[2], sizeof(data), "wrong length");
+	zassert_equal(res.data[2], 38, "not the most recent entry");
+	zassert_equal(res.len[3], 0, "entry outside of range reported");
+
+	/* The walked entries are stale once NVS is written to */
+	gen = fs.write_gen;
+	err = nvs_walk(&fs, TEST_DATA_ID, 3, seen, walk_cb, &res);
+	zassert_true(err == 0,  "nvs_walk call failure: %d", err);
+	zassert_equal(fs.write_gen, gen, "write generation changed by walk");
+
+	len = nvs_write(&fs, TEST_DATA_ID, &data, sizeof(data));
+	zassert_equal(len, sizeof(data), "nvs_write failed: %d", len);
+	zassert_not_equal(fs.write_gen, gen, "write generation not changed");
+}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+static size_t num_matching_cache_entries(uint32_t addr, bool compare_sector_only,
+					 struct nvs_fs *fs)
+{
+	size_t i, num = 0;
+	uint32_t mask = compare_sector_only ? ADDR_SECT_MASK : UINT32_MAX;
+
+	for (i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if ((fs->lookup_cache[i] & mask) == addr) {
+			num++;
+		}
+	}
+
+	return num;
+}
+#endif
+
+/*
+ * Test that the lookup cache is properly rebuilt on nvs_init(), or initialized
+ * to NVS_LOOKUP_CACHE_NO_ADDR if the store is empty.
+ */
+void test_nvs_cache_init(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	int err;
+	size_t num;
+	uint32_t ate_addr;
+	uint8_t data = 0;
+
+	/* Test cache initialization when the store is empty */
+
+	fs.sector_count = 3;
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	num = num_matching_cache_entries(NVS_LOOKUP_CACHE_NO_ADDR, false, &fs);
+	zassert_equal(num, CONFIG_NVS_LOOKUP_CACHE_SIZE, "uninitialized cache");
+
+	/* Test cache update after nvs_write() */
+
+	ate_addr = fs.ate_wra;
+	err = nvs_write(&fs, 1, &data, sizeof(data));
+	zassert_equal(err, sizeof(data), "nvs_write call failure: %d", err);
+
+	num = num_matching_cache_entries(NVS_LOOKUP_CACHE_NO_ADDR, false, &fs);
+	zassert_equal(num, CONFIG_NVS_LOOKUP_CACHE_SIZE - 1,
+		      "cache not updated after write");
+
+	num = num_matching_cache_entries(ate_addr, false, &fs);
+	zassert_equal(num, 1, "invalid cache entry after write");
+
+	/* Test cache initialization when the store is non-empty */
+
+	memset(fs.lookup_cache, 0xAA, sizeof(fs.lookup_cache));
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	num = num_matching_cache_entries(NVS_LOOKUP_CACHE_NO_ADDR, false, &fs);
+	zassert_equal(num, CONFIG_NVS_LOOKUP_CACHE_SIZE - 1,
+		      "uninitialized cache after restart");
+
+	num = num_matching_cache_entries(ate_addr, false, &fs);
+	zassert_equal(num, 1, "invalid cache entry after restart");
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Test that even after writing more NVS IDs than the number of NVS lookup
+ * cache entries they all can be read correctly.
+ */
+void test_nvs_cache_collision(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	int err;
+	uint16_t id;
+	uint16_t data;
+
+	fs.sector_count = 4;
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	for (id = 0; id < CONFIG_NVS_LOOKUP_CACHE_SIZE + 1; id++) {
+		data = id;
+		err = nvs_write(&fs, id, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d",
+			      err);
+	}
+
+	for (id = 0; id < CONFIG_NVS_LOOKUP_CACHE_SIZE + 1; id++) {
+		err = nvs_read(&fs, id, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_read call failure: %d",
+			      err);
+		zassert_equal(data, id, "incorrect data read");
+	}
+#else
+	ztest_test_skip();
+#endif
+}
+
+/*
+ * Test that NVS lookup cache does not contain any address from gc-ed sector
+ */
+void test_nvs_cache_gc(void)
+{
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	int err;
+	size_t num;
+	uint16_t data = 0;
+
+	fs.sector_count = 3;
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	/* Fill the first sector with writes of ID 1 */
+
+	while (fs.data_wra + sizeof(data) + sizeof(struct nvs_ate) <=
+	       fs.ate_wra) {
+		++data;
+		err = nvs_write(&fs, 1, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d",
+			      err);
+	}
+
+	/* Verify that cache contains a single entry for sector 0 */
+
+	num = num_matching_cache_entries(0 << ADDR_SECT_SHIFT, true, &fs);
+	zassert_equal(num, 1, "invalid cache content after filling sector 0");
+
+	/* Fill the second sector with writes of ID 2 */
+
+	while ((fs.ate_wra >> ADDR_SECT_SHIFT) != 2) {
+		++data;
+		err = nvs_write(&fs, 2, &data, sizeof(data));
+		zassert_equal(err, sizeof(data), "nvs_write call failure: %d",
+			      err);
+	}
+
+	/*
+	 * At this point sector 0 should have been gc-ed. Verify that action is
+	 * reflected by the cache content.
+	 */
+
+	num = num_matching_cache_entries(0 << ADDR_SECT_SHIFT, true, &fs);
+	zassert_equal(num, 0, "not invalidated cache entries after gc");
+
+	num = num_matching_cache_entries(2 << ADDR_SECT_SHIFT, true, &fs);
+	zassert_equal(num, 2, "invalid cache content after gc");
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -729,7 +959,15 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				 test_nvs_gc_corrupt_close_ate, setup, teardown),
 			 ztest_unit_test_setup_teardown(
-				 test_nvs_gc_corrupt_ate, setup, teardown)
+				 test_nvs_gc_corrupt_ate, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_walk, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_cache_init, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_cache_collision, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_cache_gc, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test UART backend using the asynchronous UART API
+ */
+
+#include <zephyr.h>
+#include <ztest.h>
+#include <string.h>
+#include <logging/log.h>
+#include <logging/log_ctrl.h>
+#include "uart_emul.h"
+
+LOG_MODULE_REGISTER(test, LOG_LEVEL_INF);
+
+#if defined(CONFIG_LOG_PROCESS_BATCH_SIZE) && \
+	(CONFIG_LOG_PROCESS_BATCH_SIZE > 1)
+#define BATCH 1
+#else
+#define BATCH 0
+#endif
+
+static void process_all(void)
+{
+	while (log_process(false)) {
+	}
+}
+
+static void setup(void)
+{
+	process_all();
+	uart_emul_reset();
+}
+
+/* Messages formatted while a transfer is in progress are sent together in
+ * the next transfer.
+ */
+static void test_double_buffering(void)
+{
+	struct uart_emul_stats *stats = &uart_emul_stats;
+	char *first, *second, *third;
+
+	setup();
+
+	LOG_INF("first");
+	LOG_INF("second");
+	LOG_INF("third");
+	process_all();
+
+	zassert_equal(stats->tx_cnt, 1, "Unexpected number of transfers");
+
+	uart_emul_tx_complete();
+	if (BATCH) {
+		/* All messages were processed in one batch. */
+		zassert_false(stats->tx_busy, "Unexpected transfer");
+	} else {
+		zassert_true(stats->tx_busy, "Expected second transfer");
+		zassert_equal(stats->tx_cnt, 2, "Unexpected number of transfers");
+		zassert_is_null(strstr(stats->sent, "second"),
+				"Second message sent with the first one");
+	}
+
+	uart_emul_tx_flush();
+
+	first = strstr(stats->sent, "first");
+	second = strstr(stats->sent, "second");
+	third = strstr(stats->sent, "third");
+	zassert_true(first && second && third, "Missing messages: %s",
+		     stats->sent);
+	zassert_true(first < second && second < third, "Wrong order");
+}
+
+/* When the transfer in progress does not complete in time, messages which do
+ * not fit in the buffer are dropped and reported when output resumes.
+ */
+static void test_dropped(void)
+{
+	struct uart_emul_stats *stats = &uart_emul_stats;
+
+	setup();
+
+	for (int i = 0; i < 10; i++) {
+		LOG_INF("message which does not fit %d", i);
+	}
+	process_all();
+
+	zassert_equal(stats->tx_cnt, 1, "Unexpected number of transfers");
+	uart_emul_tx_flush();
+	zassert_is_null(strstr(stats->sent, "fit 9"),
+			"Last message should be dropped");
+
+	LOG_INF("resumed");
+	process_all();
+	uart_emul_tx_flush();
+
+	zassert_not_null(strstr(stats->sent, "messages dropped ---"),
+			 "Missing dropped messages report: %s", stats->sent);
+	zassert_not_null(strstr(stats->sent, "resumed"), "Missing message");
+}
+
+#define TEXT10 "0123456789"
+#define TEXT50 TEXT10 TEXT10 TEXT10 TEXT10 TEXT10
+
+/* A message which is partially sent when the transfer in progress does not
+ * complete in time is terminated before the next output.
+ */
+static void test_truncated(void)
+{
+	struct uart_emul_stats *stats = &uart_emul_stats;
+	char *report;
+
+	setup();
+
+	/* Longer than both buffers. */
+	LOG_INF("long " TEXT50 TEXT50 TEXT50 TEXT50 TEXT50 TEXT50 "end");
+	process_all();
+	uart_emul_tx_flush();
+	zassert_not_null(strstr(stats->sent, "long"), "Message not sent");
+	zassert_is_null(strstr(stats->sent, "end"),
+			"Message should be truncated");
+
+	LOG_INF("resumed");
+	process_all();
+	uart_emul_tx_flush();
+
+	report = strstr(stats->sent, "--- ");
+	zassert_not_null(report, "Missing dropped messages report: %s",
+			 stats->sent);
+	zassert_equal(report[-1], '\n', "Message not terminated: %s",
+		      stats->sent);
+	zassert_not_null(strstr(stats->sent, "resumed"), "Missing message");
+}
+
+/* In panic mode, pending data and new messages are output by polling. */
+static void test_panic(void)
+{
+	struct uart_emul_stats *stats = &uart_emul_stats;
+
+	setup();
+
+	LOG_INF("transfer");
+	process_all();
+	zassert_true(stats->tx_busy, "Expected transfer");
+
+	LOG_INF("pending");
+	process_all();
+
+	/* Only the beginning of the transfer in progress is sent. */
+	stats->abort_len = 4;
+	LOG_PANIC();
+	zassert_false(stats->tx_busy, "Transfer not aborted");
+	zassert_equal(stats->sent_len, 4, "Unexpected data sent");
+	zassert_not_null(strstr(stats->polled, "transfer"),
+			 "Rest of the aborted transfer not output");
+	zassert_not_null(strstr(stats->polled, "pending"),
+			 "Pending data not output");
+
+	LOG_INF("in panic");
+	zassert_not_null(strstr(stats->polled, "in panic"),
+			 "Message not output in panic mode");
+	zassert_equal(stats->tx_cnt, 1, "Unexpected transfer");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_log_backend_uart,
+			 ztest_unit_test(test_double_buffering),
+			 ztest_unit_test(test_dropped),
+			 ztest_unit_test(test_truncated),
+			 ztest_unit_test(test_panic));
+	ztest_run_test_suite(test_log_backend_uart);
+}
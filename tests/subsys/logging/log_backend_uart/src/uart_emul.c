@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* UART with asynchronous transmit API. Bytes output with uart_poll_out(),
+ * such as the console output of the test, are also printed to stdout.
+ */
+
+#include <device.h>
+#include <drivers/uart.h>
+#include <string.h>
+#include <arch/posix/posix_trace.h>
+#include "uart_emul.h"
+
+DEVICE_DECLARE(uart_async_emul);
+
+struct uart_emul_stats uart_emul_stats;
+
+static uart_callback_t tx_callback;
+static void *tx_user_data;
+static const uint8_t *tx_buf;
+static size_t tx_len;
+
+static char line[128];
+static size_t line_len;
+
+static int emul_callback_set(const struct device *dev,
+			     uart_callback_t callback, void *user_data)
+{
+	tx_callback = callback;
+	tx_user_data = user_data;
+
+	return 0;
+}
+
+static int emul_tx(const struct device *dev, const uint8_t *buf, size_t len,
+		   int32_t timeout)
+{
+	if (uart_emul_stats.tx_busy) {
+		return -EBUSY;
+	}
+
+	tx_buf = buf;
+	tx_len = len;
+	uart_emul_stats.tx_busy = true;
+	uart_emul_stats.tx_cnt++;
+
+	return 0;
+}
+
+static void tx_event(enum uart_event_type type, size_t len)
+{
+	struct uart_event evt = {
+		.type = type,
+		.data.tx = {
+			.buf = tx_buf,
+			.len = len,
+		},
+	};
+
+	uart_emul_stats.tx_busy = false;
+	if (tx_callback) {
+		tx_callback(DEVICE_GET(uart_async_emul), &evt, tx_user_data);
+	}
+}
+
+static void tx_sent(size_t len)
+{
+	struct uart_emul_stats *stats = &uart_emul_stats;
+
+	len = MIN(len, sizeof(stats->sent) - 1 - stats->sent_len);
+	memcpy(&stats->sent[stats->sent_len], tx_buf, len);
+	stats->sent_len += len;
+}
+
+static int emul_tx_abort(const struct device *dev)
+{
+	size_t len = MIN(uart_emul_stats.abort_len, tx_len);
+
+	if (!uart_emul_stats.tx_busy) {
+		return -EFAULT;
+	}
+
+	tx_sent(len);
+	tx_event(UART_TX_ABORTED, len);
+
+	return 0;
+}
+
+static int emul_poll_in(const struct device *dev, unsigned char *c)
+{
+	return -1;
+}
+
+static void emul_poll_out(const struct device *dev, unsigned char c)
+{
+	struct uart_emul_stats *stats = &uart_emul_stats;
+
+	if (stats->polled_len < sizeof(stats->polled) - 1) {
+		stats->polled[stats->polled_len++] = c;
+	}
+
+	if (c == '\n' || line_len == sizeof(line) - 1) {
+		line[line_len] = '\0';
+		posix_print_trace("%s\n", line);
+		line_len = 0;
+	} else if (c != '\r') {
+		line[line_len++] = c;
+	}
+}
+
+void uart_emul_tx_complete(void)
+{
+	if (!uart_emul_stats.tx_busy) {
+		return;
+	}
+
+	tx_sent(tx_len);
+	tx_event(UART_TX_DONE, tx_len);
+}
+
+void uart_emul_tx_flush(void)
+{
+	while (uart_emul_stats.tx_busy) {
+		uart_emul_tx_complete();
+	}
+}
+
+void uart_emul_reset(void)
+{
+	uart_emul_tx_flush();
+	memset(&uart_emul_stats, 0, sizeof(uart_emul_stats));
+}
+
+static const struct uart_driver_api emul_api = {
+	.poll_in = emul_poll_in,
+	.poll_out = emul_poll_out,
+	.callback_set = emul_callback_set,
+	.tx = emul_tx,
+	.tx_abort = emul_tx_abort,
+};
+
+static int emul_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(uart_async_emul, "UART_ASYNC_EMUL", emul_init, NULL, NULL,
+	      NULL, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_DEVICE,
+	      &emul_api);
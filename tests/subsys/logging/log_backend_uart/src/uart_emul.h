@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef UART_EMUL_H__
+#define UART_EMUL_H__
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+
+/* Transfers are completed by the test, not by the emulated device. */
+struct uart_emul_stats {
+	/* Number of transfers started with uart_tx(). */
+	uint32_t tx_cnt;
+	/* Transfer in progress. */
+	bool tx_busy;
+	/* Data of completed transfers. */
+	char sent[1024];
+	size_t sent_len;
+	/* Number of bytes reported as sent when a transfer is aborted. */
+	size_t abort_len;
+	/* Data output with uart_poll_out(). */
+	char polled[256];
+	size_t polled_len;
+};
+
+extern struct uart_emul_stats uart_emul_stats;
+
+/* Complete the transfer in progress. */
+void uart_emul_tx_complete(void);
+
+/* Complete transfers until the device is idle. */
+void uart_emul_tx_flush(void);
+
+void uart_emul_reset(void);
+
+#endif /* UART_EMUL_H__ */
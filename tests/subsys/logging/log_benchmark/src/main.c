@@ -51,6 +51,9 @@ struct backend_cb {
 static void put(struct log_backend const *const backend,
 		struct log_msg *msg)
 {
+	struct backend_cb *cb = (struct backend_cb *)backend->cb->ctx;
+
+	cb->counter++;
 	log_msg_get(msg);
 	log_msg_put(msg);
 }
@@ -58,6 +61,17 @@ static void put(struct log_backend const *const backend,
 static void process(struct log_backend const *const backend,
 		    union log_msg2_generic *msg)
 {
+	struct backend_cb *cb = (struct backend_cb *)backend->cb->ctx;
+
+	cb->counter++;
+}
+
+static void process_batch(struct log_backend const *const backend,
+			  union log_msg2_generic **msgs, uint32_t cnt)
+{
+	struct backend_cb *cb = (struct backend_cb *)backend->cb->ctx;
+
+	cb->counter += cnt;
 }
 
 static void panic(struct log_backend const *const backend)
@@ -77,6 +91,7 @@ static void dropped(struct log_backend const *const backend, uint32_t cnt)
 const struct log_backend_api log_backend_test_api = {
 	.put = IS_ENABLED(CONFIG_LOG_MODE_DEFERRED) ? put : NULL,
 	.process = IS_ENABLED(CONFIG_LOG2) ? process : NULL,
+	.process_batch = IS_ENABLED(CONFIG_LOG2) ? process_batch : NULL,
 	.panic = panic,
 	.dropped = dropped,
 };
@@ -237,6 +252,116 @@ void test_log_message_with_string(void)
 		cyc / repeat, us / repeat);
 }
 
+/** Test the time of processing a full log buffer. Messages are processed one
+ * by one or in batches, depending on CONFIG_LOG_PROCESS_BATCH_SIZE.
+ */
+void test_log_message_process_time(void)
+{
+	struct log_process_batch_stats stats;
+	int msg_cnt = 0;
+	uint32_t cyc;
+
+	if (!IS_ENABLED(CONFIG_LOG_MODE_DEFERRED) &&
+	    !IS_ENABLED(CONFIG_LOG2_MODE_DEFERRED)) {
+		ztest_test_skip();
+	}
+
+	TEST_LOG_CAPACITY(2, msg_cnt, 0);
+	test_helpers_log_setup();
+	for (int i = 0; i < msg_cnt; i++) {
+		LOG_ERR("test %d %d", i, 2);
+	}
+
+	backend_ctrl_blk.counter = 0;
+	log_backend_enable(&backend, &backend_ctrl_blk, LOG_LEVEL_DBG);
+	log_process_batch_stats_get(&stats, true);
+
+	cyc = test_helpers_cycle_get();
+	while (log_process(false)) {
+	}
+	cyc = test_helpers_cycle_get() - cyc;
+
+	log_backend_disable(&backend);
+	log_process_batch_stats_get(&stats, true);
+
+	zassert_equal(backend_ctrl_blk.counter, msg_cnt,
+		      "Unexpected number of processed messages");
+
+	PRINT("Processing a message: %u cycles (%u us), %u batches, "
+	      "largest %u messages\n",
+	      cyc / msg_cnt, k_cyc_to_us_ceil32(cyc) / msg_cnt,
+	      stats.batch_cnt, stats.max_size);
+}
+
+#define RATE_MSG_CNT 500
+#define RATE_STACK_SIZE 1024
+
+struct rate_stats {
+	uint32_t total_cyc;
+	uint32_t max_cyc;
+};
+
+static K_THREAD_STACK_ARRAY_DEFINE(rate_stacks, CONFIG_MP_NUM_CPUS,
+				   RATE_STACK_SIZE);
+static struct k_thread rate_threads[CONFIG_MP_NUM_CPUS];
+static struct rate_stats rate_stats[CONFIG_MP_NUM_CPUS];
+static K_SEM_DEFINE(rate_start, 0, CONFIG_MP_NUM_CPUS);
+
+static void rate_thread(void *p1, void *p2, void *p3)
+{
+	struct rate_stats *stats = p1;
+
+	k_sem_take(&rate_start, K_FOREVER);
+
+	for (int i = 0; i < RATE_MSG_CNT; i++) {
+		uint32_t cyc = test_helpers_cycle_get();
+
+		LOG_ERR("test %d %d", i, 2);
+
+		cyc = test_helpers_cycle_get() - cyc;
+		stats->total_cyc += cyc;
+		stats->max_cyc = MAX(stats->max_cyc, cyc);
+	}
+}
+
+/** Test logging from a thread on each CPU at the same time. Reports the
+ * rate of storing messages and the worst case duration of a log call on
+ * each CPU, which shows the contention on the log buffer.
+ */
+void test_log_message_rate_per_cpu(void)
+{
+	test_helpers_log_setup();
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		rate_stats[i] = (struct rate_stats){ 0 };
+		k_thread_create(&rate_threads[i], rate_stacks[i],
+				RATE_STACK_SIZE, rate_thread, &rate_stats[i],
+				NULL, NULL, K_PRIO_COOP(1), 0, K_FOREVER);
+#if defined(CONFIG_SCHED_CPU_MASK)
+		k_thread_cpu_mask_clear(&rate_threads[i]);
+		k_thread_cpu_mask_enable(&rate_threads[i], i);
+#endif
+		k_thread_start(&rate_threads[i]);
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_sem_give(&rate_start);
+	}
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct rate_stats *stats = &rate_stats[i];
+		uint32_t rate;
+
+		k_thread_join(&rate_threads[i], K_FOREVER);
+
+		rate = stats->total_cyc ? (uint64_t)RATE_MSG_CNT *
+			sys_clock_hw_cycles_per_sec() / stats->total_cyc : 0;
+
+		PRINT("CPU %d: %u messages/s, worst case %u cycles (%u us)\n",
+		      i, rate, stats->max_cyc, k_cyc_to_us_ceil32(stats->max_cyc));
+	}
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -247,14 +372,22 @@ void test_main(void)
 	PRINT("\tOVERWRITE: %d\n", IS_ENABLED(CONFIG_LOG_MODE_OVERFLOW));
 	PRINT("\tBUFFER_SIZE: %d\n", CONFIG_LOG_BUFFER_SIZE);
 	if (IS_ENABLED(CONFIG_LOG2_MODE_DEFERRED)) {
-		PRINT("\tSPEED: %d", IS_ENABLED(CONFIG_LOG_SPEED));
+		PRINT("\tSPEED: %d\n", IS_ENABLED(CONFIG_LOG_SPEED));
+		PRINT("\tPER_CPU_BUFFERS: %d\n",
+		      IS_ENABLED(CONFIG_LOG_PER_CPU_BUFFERS));
+#if defined(CONFIG_LOG_PROCESS_BATCH_SIZE)
+		PRINT("\tPROCESS_BATCH_SIZE: %d",
+		      CONFIG_LOG_PROCESS_BATCH_SIZE);
+#endif
 	}
 	ztest_test_suite(test_log_benchmark,
 			 ztest_unit_test(test_log_capacity),
 			 ztest_unit_test(test_log_message_store_time_no_overwrite),
 			 ztest_unit_test(test_log_message_store_time_overwrite),
 			 ztest_user_unit_test(test_log_message_store_time_no_overwrite_from_user),
-			 ztest_user_unit_test(test_log_message_with_string)
+			 ztest_user_unit_test(test_log_message_with_string),
+			 ztest_unit_test(test_log_message_process_time),
+			 ztest_unit_test(test_log_message_rate_per_cpu)
 			 );
 	ztest_run_test_suite(test_log_benchmark);
 }
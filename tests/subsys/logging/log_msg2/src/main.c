@@ -478,6 +478,53 @@ void test_mode_size_str_with_strings(void)
 	get_msg_validate_length(exp_len);
 }
 
+void test_mode_size_str_literal_args(void)
+{
+#undef TEST_STR
+#define TEST_STR "%s test %s %d"
+
+	static const uint8_t domain = 3;
+	static const uint8_t level = 2;
+	const void *source = (const void *)123;
+	uint32_t exp_len;
+	int mode;
+	bool runtime = CBPRINTF_MUST_RUNTIME_PACKAGE(0, TEST_STR, "prefix",
+						     "sufix", 100);
+
+#if defined(__GNUC__) && !defined(__clang__) && Z_C_GENERIC
+	zassert_false(runtime, "String literals should be packaged statically");
+#endif
+
+	Z_LOG_MSG2_CREATE2(1, mode, 0, domain, source, level,
+			   NULL, 0, TEST_STR, "prefix", "sufix", 100);
+	zassert_equal(mode, runtime ? EXP_MODE(RUNTIME) : EXP_MODE(ZERO_COPY),
+			"Unexpected creation mode");
+	Z_LOG_MSG2_CREATE2(0, mode, 0, domain, source, level,
+			   NULL, 0, TEST_STR, "prefix", "sufix", 100);
+	zassert_equal(mode, runtime ? EXP_MODE(RUNTIME) : EXP_MODE(FROM_STACK),
+			"Unexpected creation mode");
+
+	/* Calculate expected message length. Message consists of:
+	 * - header
+	 * - package: header + fmt pointer + 2 pointers + int (on some
+	 *   platforms strings are included in the package)
+	 *
+	 * Message size is rounded up to the required alignment.
+	 */
+	exp_len = sizeof(struct log_msg2_hdr) +
+			 /* package */4 * sizeof(const char *) + sizeof(int);
+	if (runtime && TEST_LOG_MSG2_RW_STRINGS) {
+		exp_len += strlen("prefix") + 2 /* null + header */ +
+			  strlen("sufix") + 2 /* null + header */ +
+			  strlen(TEST_STR) + 2 /* null + header */;
+	}
+
+	exp_len = ROUND_UP(exp_len, Z_LOG_MSG2_ALIGNMENT) / sizeof(int);
+
+	get_msg_validate_length(exp_len);
+	get_msg_validate_length(exp_len);
+}
+
 void test_mode_size_str_with_2strings(void)
 {
 #undef TEST_STR
@@ -489,18 +536,23 @@ void test_mode_size_str_with_2strings(void)
 	uint32_t exp_len;
 	int mode;
 	static const char *prefix = "prefix";
+	/* String literal argument is packaged statically if compiler can
+	 * detect it.
+	 */
+	bool runtime = CBPRINTF_MUST_RUNTIME_PACKAGE(1, TEST_STR, prefix,
+						     "sufix");
 
 	Z_LOG_MSG2_CREATE2(1, mode,
 			   1 /* accept one string pointer*/,
 			   domain, source, level,
 			   NULL, 0, TEST_STR, prefix, "sufix");
-	zassert_equal(mode, EXP_MODE(RUNTIME),
+	zassert_equal(mode, runtime ? EXP_MODE(RUNTIME) : EXP_MODE(ZERO_COPY),
 			"Unexpected creation mode");
 	Z_LOG_MSG2_CREATE2(0, mode,
 			   1 /* accept one string pointer*/,
 			   domain, source, level,
 			   NULL, 0, TEST_STR, prefix, "sufix");
-	zassert_equal(mode, EXP_MODE(RUNTIME),
+	zassert_equal(mode, runtime ? EXP_MODE(RUNTIME) : EXP_MODE(FROM_STACK),
 			"Unexpected creation mode");
 
 	/* Calculate expected message length. Message consists of:
@@ -512,7 +564,7 @@ void test_mode_size_str_with_2strings(void)
 	 */
 	exp_len = sizeof(struct log_msg2_hdr) +
 			 /* package */4 * sizeof(const char *);
-	if (TEST_LOG_MSG2_RW_STRINGS) {
+	if (runtime && TEST_LOG_MSG2_RW_STRINGS) {
 		exp_len += strlen("sufix") + 2 /* null + header */ +
 			  strlen(prefix) + 2 /* null + header */+
 			  strlen(TEST_STR) + 2 /* null + header */;
@@ -581,6 +633,7 @@ void test_main(void)
 		ztest_unit_test(test_mode_size_plain_string),
 		ztest_unit_test(test_mode_size_data_only),
 		ztest_unit_test(test_mode_size_plain_str_data),
+		ztest_unit_test(test_mode_size_str_literal_args),
 		ztest_unit_test(test_mode_size_str_with_2strings),
 		ztest_unit_test(test_saturate)
 		);
@@ -0,0 +1,393 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Test compact dictionary-based log output
+ *
+ * Messages are encoded with the compact encoding and decoded again the way
+ * the log parser does it. The package is rebuilt from the decoded stream
+ * and formatted, so the whole message takes the round trip.
+ */
+
+#include <logging/log.h>
+#include <logging/log_output.h>
+#include <logging/log_output_dict.h>
+#include <sys/cbprintf.h>
+
+#include <zephyr.h>
+#include <ztest.h>
+
+#define LOG_MODULE_NAME test
+LOG_MODULE_REGISTER(LOG_MODULE_NAME);
+
+#define SYNC_INTERVAL CONFIG_LOG_DICTIONARY_COMPACT_SYNC_INTERVAL
+
+static uint8_t mock_buffer[1024];
+static uint8_t log_output_buf[8];
+static uint32_t mock_len;
+
+static int mock_output_func(uint8_t *buf, size_t size, void *ctx)
+{
+	zassert_true(mock_len + size <= sizeof(mock_buffer),
+		     "Output buffer full");
+
+	memcpy(&mock_buffer[mock_len], buf, size);
+	mock_len += size;
+
+	return size;
+}
+
+LOG_OUTPUT_DEFINE(log_output, mock_output_func,
+		  log_output_buf, sizeof(log_output_buf));
+
+static void setup(void)
+{
+	mock_len = 0U;
+	memset(mock_buffer, 0, sizeof(mock_buffer));
+
+	log_output.control_block->timestamp = 0U;
+	log_output.control_block->sync_cnt = 0U;
+}
+
+static void teardown(void)
+{
+
+}
+
+/* Encode one message. The format string is NULL for a message with
+ * hexdump data only.
+ */
+static void msg_process(uint8_t level, uint8_t domain,
+			log_timestamp_t timestamp, const void *data,
+			size_t dlen, const char *fmt, ...)
+{
+	static uint8_t buf[256] __aligned(CBPRINTF_PACKAGE_ALIGNMENT);
+	struct log_msg2 *msg = (struct log_msg2 *)buf;
+	int plen = 0;
+	va_list ap;
+
+	if (fmt != NULL) {
+		va_start(ap, fmt);
+		plen = cbvprintf_package(msg->data,
+					 sizeof(buf) - sizeof(*msg) - dlen,
+					 fmt, ap);
+		va_end(ap);
+		zassert_true(plen > 0, "Packaging failed (%d)", plen);
+	}
+
+	msg->hdr.desc = (struct log_msg2_desc)
+		Z_LOG_MSG_DESC_INITIALIZER(domain, level, plen, dlen);
+	msg->hdr.source = __log_current_const_data;
+	msg->hdr.timestamp = timestamp;
+	memcpy(&msg->data[plen], data, dlen);
+
+	log_dict_output_msg2_process(&log_output, msg, 0);
+}
+
+struct decoder {
+	size_t offset;
+	log_timestamp_t timestamp;
+	int syncs;
+};
+
+struct decoded_msg {
+	bool dropped;
+	uint32_t dropped_cnt;
+	uint8_t level;
+	uint8_t domain;
+	uint32_t source_id;
+	log_timestamp_t timestamp;
+	char str[64];
+	size_t str_len;
+	uint8_t data[16];
+	size_t dlen;
+};
+
+static uint8_t get_byte(struct decoder *d)
+{
+	zassert_true(d->offset < mock_len, "Data ends in a message");
+
+	return mock_buffer[d->offset++];
+}
+
+static uint64_t get_num(struct decoder *d)
+{
+	uint64_t num = 0U;
+	uint8_t byte;
+	int shift = 0;
+
+	do {
+		byte = get_byte(d);
+		num |= (uint64_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	return num;
+}
+
+static void get_bytes(struct decoder *d, uint8_t *buf, size_t len)
+{
+	zassert_true(d->offset + len <= mock_len, "Data ends in a message");
+
+	memcpy(buf, &mock_buffer[d->offset], len);
+	d->offset += len;
+}
+
+static int str_out(int c, void *ctx)
+{
+	struct decoded_msg *out = ctx;
+
+	zassert_true(out->str_len < sizeof(out->str) - 1, "String too long");
+	out->str[out->str_len++] = c;
+
+	return c;
+}
+
+/* Decode the next message, following any sync records before it */
+static void decode_msg(struct decoder *d, struct decoded_msg *out)
+{
+	static uint8_t pkg[128] __aligned(CBPRINTF_PACKAGE_ALIGNMENT);
+	size_t args_len, len;
+	uint8_t hdr;
+
+	memset(out, 0, sizeof(*out));
+
+	hdr = get_byte(d);
+
+	while (hdr == LOG_DICT_COMPACT_SYNC) {
+		zassert_equal(get_byte(d), LOG_DICT_COMPACT_SYNC_MAGIC >> 8,
+			      "Invalid sync record");
+		zassert_equal(get_byte(d), LOG_DICT_COMPACT_SYNC_MAGIC & 0xFF,
+			      "Invalid sync record");
+		d->timestamp = get_num(d);
+		d->syncs++;
+
+		hdr = get_byte(d);
+	}
+
+	if (hdr == LOG_DICT_COMPACT_DROPPED) {
+		out->dropped = true;
+		out->dropped_cnt = get_num(d);
+		return;
+	}
+
+	out->level = hdr & LOG_DICT_COMPACT_LEVEL_MASK;
+	out->domain = (hdr & LOG_DICT_COMPACT_DOMAIN_MASK) >>
+		      LOG_DICT_COMPACT_DOMAIN_SHIFT;
+	out->source_id = get_num(d);
+
+	d->timestamp += (log_timestamp_t)get_num(d);
+	out->timestamp = d->timestamp;
+
+	/* Rebuild the package: header, argument words and strings */
+	memset(pkg, 0, sizeof(pkg));
+	pkg[0] = get_byte(d);
+	pkg[1] = get_byte(d);
+
+	args_len = pkg[0] * sizeof(int);
+	zassert_true(args_len <= sizeof(pkg), "Package too long");
+
+	for (size_t i = sizeof(void *); i < args_len; i += sizeof(uint32_t)) {
+		*(uint32_t *)&pkg[i] = get_num(d);
+	}
+
+	len = get_num(d);
+	zassert_true(args_len + len <= sizeof(pkg), "Package too long");
+	get_bytes(d, &pkg[args_len], len);
+
+	if (args_len > 0) {
+		cbpprintf(str_out, out, pkg);
+	}
+
+	if (hdr & LOG_DICT_COMPACT_DATA) {
+		out->dlen = get_num(d);
+		zassert_true(out->dlen <= sizeof(out->data), "Data too long");
+		get_bytes(d, out->data, out->dlen);
+	}
+}
+
+static void check_msg(struct decoder *d, uint8_t level, uint8_t domain,
+		      log_timestamp_t timestamp, const char *str)
+{
+	struct decoded_msg msg;
+
+	decode_msg(d, &msg);
+
+	zassert_false(msg.dropped, "Unexpected dropped message");
+	zassert_equal(msg.level, level, "Invalid level");
+	zassert_equal(msg.domain, domain, "Invalid domain");
+	zassert_equal(msg.source_id,
+		      log_const_source_id(__log_current_const_data),
+		      "Invalid source ID");
+	zassert_equal(msg.timestamp, timestamp, "Invalid timestamp");
+	zassert_equal(msg.str_len, strlen(str), "Invalid string length");
+	zassert_mem_equal(msg.str, str, msg.str_len, "Invalid string");
+}
+
+void test_compact_round_trip(void)
+{
+	static const uint8_t data[] = { 0x00, 0x80, 0xff, 0x7f, 0x12 };
+	char rw_str[] = "rw";
+	struct decoded_msg msg;
+	struct decoder d = { 0 };
+	char ptr_str[32];
+	void *ptr = &d;
+
+	msg_process(LOG_LEVEL_INF, 0, 100, NULL, 0, "int %d %u %x", -1, 5U,
+		    0x12345678);
+	msg_process(LOG_LEVEL_ERR, 2, 1000, NULL, 0, "str %s %s", "ro",
+		    rw_str);
+	msg_process(LOG_LEVEL_WRN, 7, 1000, NULL, 0, "ptr %p", ptr);
+	msg_process(LOG_LEVEL_DBG, 1, 2000000, data, sizeof(data), "hexdump");
+	msg_process(LOG_LEVEL_DBG, 1, 2000001, data, 2, NULL);
+
+	check_msg(&d, LOG_LEVEL_INF, 0, 100, "int -1 5 12345678");
+	check_msg(&d, LOG_LEVEL_ERR, 2, 1000, "str ro rw");
+
+	snprintk(ptr_str, sizeof(ptr_str), "ptr %p", ptr);
+	check_msg(&d, LOG_LEVEL_WRN, 7, 1000, ptr_str);
+
+	check_msg(&d, LOG_LEVEL_DBG, 1, 2000000, "hexdump");
+
+	decode_msg(&d, &msg);
+	zassert_equal(msg.timestamp, 2000001, "Invalid timestamp");
+	zassert_equal(msg.str_len, 0, "Unexpected string");
+	zassert_equal(msg.dlen, 2, "Invalid data length");
+	zassert_mem_equal(msg.data, data, 2, "Invalid data");
+
+	zassert_equal(d.offset, mock_len, "Data left after the messages");
+}
+
+void test_compact_hexdump(void)
+{
+	static const uint8_t data[] = { 0x00, 0x80, 0xff, 0x7f, 0x12 };
+	struct decoded_msg msg;
+	struct decoder d = { 0 };
+
+	msg_process(LOG_LEVEL_INF, 0, 10, data, sizeof(data), "dump %d", 3);
+
+	decode_msg(&d, &msg);
+	zassert_equal(msg.str_len, strlen("dump 3"), "Invalid string length");
+	zassert_mem_equal(msg.str, "dump 3", msg.str_len, "Invalid string");
+	zassert_equal(msg.dlen, sizeof(data), "Invalid data length");
+	zassert_mem_equal(msg.data, data, sizeof(data), "Invalid data");
+}
+
+void test_compact_timestamp_wrap(void)
+{
+	log_timestamp_t start = (log_timestamp_t)-10;
+	struct decoder d = { 0 };
+	uint32_t len, wrap_len;
+
+	/* The first message is preceded by a sync record */
+	msg_process(LOG_LEVEL_INF, 0, start, NULL, 0, "wrap %d", 1);
+
+	len = mock_len;
+	msg_process(LOG_LEVEL_INF, 0, start + 5, NULL, 0, "wrap %d", 2);
+	len = mock_len - len;
+
+	wrap_len = mock_len;
+	msg_process(LOG_LEVEL_INF, 0, start + 15, NULL, 0, "wrap %d", 3);
+	wrap_len = mock_len - wrap_len;
+
+	msg_process(LOG_LEVEL_INF, 0, start + 20, NULL, 0, "wrap %d", 4);
+
+	/* The difference over the wrap-around is as short as without it */
+	zassert_equal(wrap_len, len, "Wrapped timestamp difference too long");
+
+	check_msg(&d, LOG_LEVEL_INF, 0, start, "wrap 1");
+	check_msg(&d, LOG_LEVEL_INF, 0, start + 5, "wrap 2");
+	check_msg(&d, LOG_LEVEL_INF, 0, 5, "wrap 3");
+	check_msg(&d, LOG_LEVEL_INF, 0, 10, "wrap 4");
+
+	zassert_equal(d.offset, mock_len, "Data left after the messages");
+	zassert_equal(d.syncs, 1, "Unexpected sync records");
+}
+
+void test_compact_sync(void)
+{
+	const uint8_t sync[] = {
+		LOG_DICT_COMPACT_SYNC,
+		LOG_DICT_COMPACT_SYNC_MAGIC >> 8,
+		LOG_DICT_COMPACT_SYNC_MAGIC & 0xFF,
+	};
+	size_t msg_offset[3 * SYNC_INTERVAL];
+	struct decoder d = { 0 };
+	char str[16];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(msg_offset); i++) {
+		msg_offset[i] = mock_len;
+		msg_process(LOG_LEVEL_INF, 0, 1000 * (i + 1), NULL, 0,
+			    "msg %d", i);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(msg_offset); i++) {
+		snprintk(str, sizeof(str), "msg %d", i);
+		check_msg(&d, LOG_LEVEL_INF, 0, 1000 * (i + 1), str);
+	}
+
+	zassert_equal(d.syncs, 3, "Sync record not sent every %d messages",
+		      SYNC_INTERVAL);
+
+	/* A host that lost bytes in the first messages skips to the next
+	 * sync record and gets the right timestamps from there on, although
+	 * the timestamp differences before it were lost.
+	 */
+	memset(&d, 0, sizeof(d));
+	d.offset = msg_offset[1] + 2;
+
+	while (memcmp(&mock_buffer[d.offset], sync, sizeof(sync)) != 0) {
+		d.offset++;
+		zassert_true(d.offset + sizeof(sync) <= mock_len,
+			     "Sync record not found");
+	}
+
+	zassert_equal(d.offset, msg_offset[SYNC_INTERVAL],
+		      "Sync record not in front of a message");
+
+	for (i = SYNC_INTERVAL; i < ARRAY_SIZE(msg_offset); i++) {
+		snprintk(str, sizeof(str), "msg %d", i);
+		check_msg(&d, LOG_LEVEL_INF, 0, 1000 * (i + 1), str);
+	}
+}
+
+void test_compact_dropped(void)
+{
+	struct decoded_msg msg;
+	struct decoder d = { 0 };
+
+	msg_process(LOG_LEVEL_INF, 0, 100, NULL, 0, "before");
+	log_dict_output_dropped_process(&log_output, 300);
+	msg_process(LOG_LEVEL_INF, 0, 200, NULL, 0, "after");
+
+	check_msg(&d, LOG_LEVEL_INF, 0, 100, "before");
+
+	decode_msg(&d, &msg);
+	zassert_true(msg.dropped, "Dropped messages not reported");
+	zassert_equal(msg.dropped_cnt, 300, "Invalid number of messages");
+
+	/* Message after dropped ones is preceded by a sync record */
+	check_msg(&d, LOG_LEVEL_INF, 0, 200, "after");
+	zassert_equal(d.syncs, 2, "No sync record after dropped messages");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_log_output_dict,
+		ztest_unit_test_setup_teardown(test_compact_round_trip,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_compact_hexdump,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_compact_timestamp_wrap,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_compact_sync,
+					       setup, teardown),
+		ztest_unit_test_setup_teardown(test_compact_dropped,
+					       setup, teardown));
+	ztest_run_test_suite(test_log_output_dict);
+}
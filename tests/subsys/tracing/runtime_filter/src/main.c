@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2021 Intellinium
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <tracing/tracing_filter.h>
+
+/* The test tracing format writes one line of text per event, which the
+ * tracing thread passes to the RAM backend. The backend appends it to
+ * ram_tracing, which starts zeroed. All classes are disabled at boot, so
+ * the events of a test step are the lines after the end of the text at
+ * the start of the step, once the tracing thread has run.
+ */
+extern uint8_t ram_tracing[];
+
+#define DRAIN_TIME K_MSEC(CONFIG_TRACING_THREAD_WAIT_THRESHOLD + 10)
+
+#define HELPER_STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+static K_THREAD_STACK_DEFINE(helper_stack, HELPER_STACK_SIZE);
+static struct k_thread helper;
+
+static K_SEM_DEFINE(sem_a, 0, 1);
+static K_SEM_DEFINE(sem_b, 0, 1);
+
+static size_t mark;
+
+static void trace_mark(void)
+{
+	k_sleep(DRAIN_TIME);
+
+	mark = strlen((char *)ram_tracing);
+	zassert_true(mark < CONFIG_RAM_TRACING_BUFFER_SIZE / 2,
+		     "Tracing buffer almost full");
+}
+
+static bool traced(const char *event, const void *obj)
+{
+	char line[CONFIG_TRACING_PACKET_MAX_SIZE];
+
+	k_sleep(DRAIN_TIME);
+
+	if (obj != NULL) {
+		snprintk(line, sizeof(line), "%s: %p\n", event, obj);
+	} else {
+		snprintk(line, sizeof(line), "%s\n", event);
+	}
+
+	return strstr((char *)ram_tracing + mark, line) != NULL;
+}
+
+static void give_take(struct k_sem *sem)
+{
+	k_sem_give(sem);
+	zassert_equal(k_sem_take(sem, K_NO_WAIT), 0, "Semaphore not given");
+}
+
+static void helper_entry(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sleep(K_FOREVER);
+	}
+}
+
+static void test_class_enable(void)
+{
+	tracing_class_set(TRACING_CLASS_SEMAPHORE, true);
+	zassert_true(tracing_class_mask_get() & BIT(TRACING_CLASS_SEMAPHORE),
+		     "Class not enabled");
+
+	trace_mark();
+	give_take(&sem_a);
+	zassert_true(traced("sys_trace_k_sem_give_enter", &sem_a),
+		     "Event of an enabled class not traced");
+
+	tracing_class_set(TRACING_CLASS_SEMAPHORE, false);
+
+	trace_mark();
+	give_take(&sem_a);
+	zassert_false(traced("sys_trace_k_sem_give_enter", &sem_a),
+		      "Event of a disabled class traced");
+
+	/* Other classes are not affected */
+	tracing_class_mask_set(BIT(TRACING_CLASS_MUTEX));
+
+	trace_mark();
+	give_take(&sem_a);
+	zassert_false(traced("sys_trace_k_sem_give_enter", &sem_a),
+		      "Event of a disabled class traced");
+
+	tracing_class_mask_set(0);
+}
+
+static void test_object_select(void)
+{
+	zassert_equal(tracing_object_select(NULL), -EINVAL,
+		      "NULL object selected");
+	zassert_equal(tracing_object_deselect(&sem_a), -ENOENT,
+		      "Object not selected was deselected");
+
+	tracing_class_set(TRACING_CLASS_SEMAPHORE, true);
+	tracing_object_filter_set(TRACING_CLASS_SEMAPHORE, true);
+	zassert_equal(tracing_object_select(&sem_a), 0, "Select failed");
+	zassert_equal(tracing_object_select(&sem_a), 0,
+		      "Selecting an object twice failed");
+
+	trace_mark();
+	give_take(&sem_a);
+	give_take(&sem_b);
+	zassert_true(traced("sys_trace_k_sem_give_enter", &sem_a),
+		     "Event of a selected object not traced");
+	zassert_false(traced("sys_trace_k_sem_give_enter", &sem_b),
+		      "Event of an object not selected traced");
+
+	zassert_equal(tracing_object_deselect(&sem_a), 0, "Deselect failed");
+
+	trace_mark();
+	give_take(&sem_a);
+	zassert_false(traced("sys_trace_k_sem_give_enter", &sem_a),
+		      "Event of a deselected object traced");
+
+	/* Without the restriction, all objects are traced again */
+	tracing_object_filter_set(TRACING_CLASS_SEMAPHORE, false);
+
+	trace_mark();
+	give_take(&sem_b);
+	zassert_true(traced("sys_trace_k_sem_give_enter", &sem_b),
+		     "Event of an unrestricted class not traced");
+
+	tracing_class_mask_set(0);
+}
+
+static void test_object_select_full(void)
+{
+	static struct k_sem sems[CONFIG_TRACING_RUNTIME_FILTER_OBJECTS + 1];
+	int i;
+
+	for (i = 0; i < CONFIG_TRACING_RUNTIME_FILTER_OBJECTS; i++) {
+		zassert_equal(tracing_object_select(&sems[i]), 0,
+			      "Select failed");
+	}
+
+	zassert_equal(tracing_object_select(&sems[i]), -ENOMEM,
+		      "Too many objects selected");
+
+	for (i = 0; i < CONFIG_TRACING_RUNTIME_FILTER_OBJECTS; i++) {
+		zassert_equal(tracing_object_deselect(&sems[i]), 0,
+			      "Deselect failed");
+	}
+}
+
+static void test_thread_select(void)
+{
+	k_tid_t tid;
+
+	/* A lower priority thread, which does not run during the test */
+	tid = k_thread_create(&helper, helper_stack,
+			      K_THREAD_STACK_SIZEOF(helper_stack),
+			      helper_entry, NULL, NULL, NULL,
+			      K_LOWEST_APPLICATION_THREAD_PRIO, 0, K_NO_WAIT);
+
+	tracing_class_set(TRACING_CLASS_THREAD, true);
+	tracing_object_filter_set(TRACING_CLASS_THREAD, true);
+	zassert_equal(tracing_object_select(k_current_get()), 0,
+		      "Select failed");
+
+	/* Events about a thread are checked against that thread */
+	trace_mark();
+	k_thread_suspend(tid);
+	zassert_false(traced("sys_trace_k_thread_suspend", tid),
+		      "Event of a thread not selected traced");
+	zassert_false(traced("sys_trace_k_thread_sched_suspend", tid),
+		      "Event of a thread not selected traced");
+
+	/* Other events are checked against the current thread */
+	trace_mark();
+	k_yield();
+	zassert_true(traced("sys_trace_k_thread_yield", NULL),
+		     "Event of the selected current thread not traced");
+
+	zassert_equal(tracing_object_deselect(k_current_get()), 0,
+		      "Deselect failed");
+	zassert_equal(tracing_object_select(tid), 0, "Select failed");
+
+	trace_mark();
+	k_yield();
+	zassert_false(traced("sys_trace_k_thread_yield", NULL),
+		      "Event of a current thread not selected traced");
+
+	k_thread_resume(tid);
+	zassert_true(traced("sys_trace_k_thread_sched_resume", tid),
+		     "Event of a selected thread not traced");
+
+	zassert_equal(tracing_object_deselect(tid), 0, "Deselect failed");
+	tracing_object_filter_set(TRACING_CLASS_THREAD, false);
+	tracing_class_mask_set(0);
+
+	k_thread_abort(tid);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tracing_runtime_filter,
+			 ztest_unit_test(test_class_enable),
+			 ztest_unit_test(test_object_select),
+			 ztest_unit_test(test_object_select_full),
+			 ztest_unit_test(test_thread_select));
+	ztest_run_test_suite(tracing_runtime_filter);
+}
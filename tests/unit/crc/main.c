@@ -6,6 +6,26 @@
 
 #include <ztest.h>
 #include <sys/crc.h>
+
+/* Implementation variants, as selected by Kconfig in a Zephyr build */
+#if defined(CRC_TEST_SLICES) && (CRC_TEST_SLICES == 8)
+#define CONFIG_CRC32_IEEE_SLICE_BY_8 1
+#define CONFIG_CRC32C_SLICE_BY_8 1
+#define CONFIG_CRC16_CCITT_SLICE_BY_8 1
+#define CONFIG_CRC16_ITU_T_SLICE_BY_8 1
+#elif defined(CRC_TEST_SLICES) && (CRC_TEST_SLICES == 4)
+#define CONFIG_CRC32_IEEE_SLICE_BY_4 1
+#define CONFIG_CRC32C_SLICE_BY_4 1
+#define CONFIG_CRC16_CCITT_SLICE_BY_4 1
+#define CONFIG_CRC16_ITU_T_SLICE_BY_4 1
+#endif
+
+#ifdef CRC_TEST_HW
+#define CONFIG_CRC_HW 1
+#define CONFIG_CRC_HW_MIN_LEN 16
+#include "../../../lib/os/crc_hw.c"
+#endif
+
 #include "../../../lib/os/crc8_sw.c"
 #include "../../../lib/os/crc16_sw.c"
 #include "../../../lib/os/crc32_sw.c"
@@ -229,6 +249,137 @@ void test_crc8(void)
 	zassert_equal(fcs, expected, "0x%02x vs 0x%02x", fcs, expected);
 }
 
+/* Bitwise references for the CRC registers */
+static uint32_t ref_lsb(uint32_t crc, uint32_t poly, const uint8_t *data,
+			size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+		for (int b = 0; b < 8; b++) {
+			crc = (crc >> 1) ^ ((crc & 1U) ? poly : 0U);
+		}
+	}
+
+	return crc;
+}
+
+static uint16_t ref_msb16(uint16_t crc, uint16_t poly, const uint8_t *data,
+			  size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= (uint16_t)data[i] << 8;
+		for (int b = 0; b < 8; b++) {
+			crc = (crc << 1) ^ ((crc & 0x8000U) ? poly : 0U);
+		}
+	}
+
+	return crc;
+}
+
+static uint8_t long_buf[256];
+
+static void long_buf_fill(void)
+{
+	uint32_t x = 0x12345678;
+
+	for (size_t i = 0; i < sizeof(long_buf); i++) {
+		x = x * 1103515245U + 12345U;
+		long_buf[i] = x >> 24;
+	}
+}
+
+/* Covers the unrolled loops and their tails at every alignment */
+void test_crc_long_buffers(void)
+{
+	long_buf_fill();
+
+	for (size_t off = 0; off < 8; off++) {
+		for (size_t len = 0; len < 80; len++) {
+			const uint8_t *p = &long_buf[off];
+
+			zassert_equal(crc32_ieee(p, len),
+				      ~ref_lsb(~0U, 0xedb88320, p, len),
+				      "crc32_ieee off %zu len %zu", off, len);
+			zassert_equal(crc32_c(0, p, len, true, true),
+				      ~ref_lsb(~0U, 0x82f63b78, p, len),
+				      "crc32_c off %zu len %zu", off, len);
+			zassert_equal(crc16_ccitt(0x1d0f, p, len),
+				      ref_lsb(0x1d0f, 0x8408, p, len),
+				      "crc16_ccitt off %zu len %zu", off, len);
+			zassert_equal(crc16_itu_t(0x1d0f, p, len),
+				      ref_msb16(0x1d0f, 0x1021, p, len),
+				      "crc16_itu_t off %zu len %zu", off, len);
+		}
+	}
+
+	/* Streamed in uneven chunks */
+	zassert_equal(crc32_ieee_update(crc32_ieee_update(0, long_buf, 13),
+					&long_buf[13], sizeof(long_buf) - 13),
+		      crc32_ieee(long_buf, sizeof(long_buf)), NULL);
+	zassert_equal(crc32_c(crc32_c(0, long_buf, 13, true, false),
+			      &long_buf[13], sizeof(long_buf) - 13, false, true),
+		      crc32_c(0, long_buf, sizeof(long_buf), true, true), NULL);
+}
+
+#ifdef CRC_TEST_HW
+static int hw_calls;
+
+static int fake_crc_hw(enum crc_type type, uint32_t *crc, const uint8_t *src,
+		       size_t len)
+{
+	hw_calls++;
+
+	switch (type) {
+	case CRC_TYPE_CRC32_IEEE:
+		*crc = ref_lsb(*crc, 0xedb88320, src, len);
+		return 0;
+	case CRC_TYPE_CRC16_CCITT:
+		*crc = ref_lsb(*crc, 0x8408, src, len);
+		return 0;
+	default:
+		return -ENOTSUP;
+	}
+}
+
+void test_crc_hw(void)
+{
+	uint8_t test2[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+	long_buf_fill();
+	crc_hw_handler_set(fake_crc_hw);
+
+	/* Short buffers stay in software */
+	zassert_equal(crc32_ieee(test2, sizeof(test2)), 0xCBF43926, NULL);
+	zassert_equal(hw_calls, 0, NULL);
+
+	zassert_equal(crc32_ieee(long_buf, sizeof(long_buf)),
+		      ~ref_lsb(~0U, 0xedb88320, long_buf, sizeof(long_buf)),
+		      NULL);
+	zassert_equal(crc16_ccitt(0xffff, long_buf, sizeof(long_buf)),
+		      ref_lsb(0xffff, 0x8408, long_buf, sizeof(long_buf)),
+		      NULL);
+	zassert_equal(hw_calls, 2, NULL);
+
+	/* Unsupported types fall back to software */
+	zassert_equal(crc32_c(0, long_buf, sizeof(long_buf), true, true),
+		      ~ref_lsb(~0U, 0x82f63b78, long_buf, sizeof(long_buf)),
+		      NULL);
+	zassert_equal(crc16_itu_t(0, long_buf, sizeof(long_buf)),
+		      ref_msb16(0, 0x1021, long_buf, sizeof(long_buf)), NULL);
+	zassert_equal(hw_calls, 4, NULL);
+
+	crc_hw_handler_set(NULL);
+	zassert_equal(crc16_ccitt(0xffff, long_buf, sizeof(long_buf)),
+		      ref_lsb(0xffff, 0x8408, long_buf, sizeof(long_buf)),
+		      NULL);
+	zassert_equal(hw_calls, 4, NULL);
+}
+
+#define CRC_HW_TESTS , ztest_unit_test(test_crc_hw)
+#else
+#define CRC_HW_TESTS
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
@@ -241,6 +392,8 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_itu_t),
 			 ztest_unit_test(test_crc8_ccitt),
 			 ztest_unit_test(test_crc7_be),
-			 ztest_unit_test(test_crc8));
+			 ztest_unit_test(test_crc8),
+			 ztest_unit_test(test_crc_long_buffers)
+			 CRC_HW_TESTS);
 	ztest_run_test_suite(test_crc);
 }